@@ -543,9 +543,9 @@ ErrorCode ArbiterAI::loadModel(const std::string &model, const std::string &vari
     return ModelRuntime::instance().loadModel(model, variant, contextSize, opts, targetDevices);
 }
 
-ErrorCode ArbiterAI::downloadModel(const std::string &model, const std::string &variant)
+ErrorCode ArbiterAI::downloadModel(const std::string &model, const std::string &variant, DownloadPriority priority)
 {
-    return ModelRuntime::instance().downloadModel(model, variant);
+    return ModelRuntime::instance().downloadModel(model, variant, priority);
 }
 
 void ArbiterAI::setMaxConcurrentDownloads(int max)
@@ -76,7 +76,30 @@ enum class ErrorCode
     ModelLoadError,
     ModelDownloading,
     ModelDownloadFailed,
-    InsufficientStorage
+    InsufficientStorage,
+    QueueFull,
+    TooManyRequests
+};
+
+/**
+ * @enum RequestPriority
+ * @brief Scheduling class of a request waiting for a local model
+ */
+enum class RequestPriority
+{
+    Interactive=0,  ///< Admitted ahead of any waiting batch request
+    Batch=1         ///< Runs when no interactive request is waiting
+};
+
+/**
+ * @enum DownloadPriority
+ * @brief Scheduling class of a model download
+ */
+enum class DownloadPriority
+{
+    UserBlocking=0, ///< A load is waiting on it; pauses less urgent transfers
+    Explicit=1,     ///< Requested through the download API
+    Prefetch=2      ///< Speculative; uses whatever connections are left over
 };
 
 /**
@@ -360,6 +383,11 @@ struct CompletionRequest
     std::optional<std::vector<ToolDefinition>> tools;  ///< Available tools for the model
     std::optional<std::string> tool_choice;            ///< Tool selection mode: "auto", "none", or specific tool name
     std::optional<std::map<std::string, double>> logit_bias;  ///< Token ID to bias value
+    std::optional<std::map<std::string, double>> lora;        ///< LoRA adapter name to scale (adapter models; 0 disables an adapter)
+    // Local model scheduling (not serialized, so not part of cache keys)
+    std::optional<std::string> tenant;                 ///< Fair-share key in the model's admission queue (API key or user)
+    std::optional<RequestPriority> priority;           ///< Queue class (default Interactive)
+    std::function<void(int)> onQueuePosition;          ///< Called with the 1-based queue position while waiting
 };
 
 inline void to_json(nlohmann::json &j, const CompletionRequest &r)
@@ -378,6 +406,7 @@ inline void to_json(nlohmann::json &j, const CompletionRequest &r)
     if (r.stop.has_value()) j["stop"] = r.stop.value();
     if (r.tools.has_value()) j["tools"] = r.tools.value();
     if (r.tool_choice.has_value()) j["tool_choice"] = r.tool_choice.value();
+    if (r.lora.has_value()) j["lora"] = r.lora.value();
 }
 
 inline void from_json(const nlohmann::json &j, CompletionRequest &r)
@@ -394,6 +423,7 @@ inline void from_json(const nlohmann::json &j, CompletionRequest &r)
     if (j.contains("stop")) r.stop = j.at("stop").get<std::vector<std::string>>();
     if (j.contains("tools")) r.tools = j.at("tools").get<std::vector<ToolDefinition>>();
     if (j.contains("tool_choice")) r.tool_choice = j.at("tool_choice").get<std::string>();
+    if (j.contains("lora")) r.lora = j.at("lora").get<std::map<std::string, double>>();
 }
 
 /**
@@ -660,9 +690,11 @@ public:
      * Success if files are already present, or an error code.
      * @param model Model name
      * @param variant Quantization variant (empty = auto-select)
+     * @param priority Scheduling class relative to other downloads
      * @return ErrorCode::ModelDownloading, Success, ModelNotFound, InsufficientStorage
      */
-    ErrorCode downloadModel(const std::string &model, const std::string &variant="");
+    ErrorCode downloadModel(const std::string &model, const std::string &variant="",
+        DownloadPriority priority=DownloadPriority::Explicit);
 
     /**
      * @brief Set the maximum number of concurrent model downloads
@@ -0,0 +1,393 @@
+#include "arbiterAI/autotuner.h"
+
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <fstream>
+#include <set>
+
+namespace arbiterAI
+{
+
+namespace
+{
+
+/// Key identifying the tuned fields of a configuration, so a value shared by
+/// two dimensions is only benchmarked once.
+std::string configKey(const RuntimeOptions &options)
+{
+    return std::to_string(options.flashAttn.value_or(false))+"|"+
+        options.kvCacheTypeK.value_or("")+"|"+
+        options.kvCacheTypeV.value_or("")+"|"+
+        std::to_string(options.nBatch.value_or(0))+"|"+
+        std::to_string(options.nUbatch.value_or(0))+"|"+
+        std::to_string(options.nThreads.value_or(0))+"|"+
+        std::to_string(options.nThreadsBatch.value_or(0));
+}
+
+nlohmann::json tunedToJson(const RuntimeOptions &options)
+{
+    nlohmann::json j=nlohmann::json::object();
+    if(options.flashAttn.has_value()) j["flash_attn"]=options.flashAttn.value();
+    if(options.kvCacheTypeK.has_value()) j["kv_cache_type_k"]=options.kvCacheTypeK.value();
+    if(options.kvCacheTypeV.has_value()) j["kv_cache_type_v"]=options.kvCacheTypeV.value();
+    if(options.nBatch.has_value()) j["n_batch"]=options.nBatch.value();
+    if(options.nUbatch.has_value()) j["n_ubatch"]=options.nUbatch.value();
+    if(options.nThreads.has_value()) j["n_threads"]=options.nThreads.value();
+    if(options.nThreadsBatch.has_value()) j["n_threads_batch"]=options.nThreadsBatch.value();
+    return j;
+}
+
+RuntimeOptions tunedFromJson(const nlohmann::json &j)
+{
+    RuntimeOptions options;
+    if(!j.is_object())
+    {
+        return options;
+    }
+    if(j.contains("flash_attn")&&j["flash_attn"].is_boolean()) options.flashAttn=j["flash_attn"].get<bool>();
+    if(j.contains("kv_cache_type_k")&&j["kv_cache_type_k"].is_string()) options.kvCacheTypeK=j["kv_cache_type_k"].get<std::string>();
+    if(j.contains("kv_cache_type_v")&&j["kv_cache_type_v"].is_string()) options.kvCacheTypeV=j["kv_cache_type_v"].get<std::string>();
+    if(j.contains("n_batch")&&j["n_batch"].is_number_integer()) options.nBatch=j["n_batch"].get<int>();
+    if(j.contains("n_ubatch")&&j["n_ubatch"].is_number_integer()) options.nUbatch=j["n_ubatch"].get<int>();
+    if(j.contains("n_threads")&&j["n_threads"].is_number_integer()) options.nThreads=j["n_threads"].get<int>();
+    if(j.contains("n_threads_batch")&&j["n_threads_batch"].is_number_integer()) options.nThreadsBatch=j["n_threads_batch"].get<int>();
+    return options;
+}
+
+nlohmann::json benchmarkToJson(const BenchmarkResult &result)
+{
+    return {
+        {"prompt_tokens", result.promptTokens},
+        {"generated_tokens", result.generatedTokens},
+        {"prompt_tokens_per_sec", result.promptTokensPerSec},
+        {"generation_tokens_per_sec", result.generationTokensPerSec}
+    };
+}
+
+BenchmarkResult benchmarkFromJson(const nlohmann::json &j)
+{
+    BenchmarkResult result;
+    result.promptTokens=j.value("prompt_tokens", 0);
+    result.generatedTokens=j.value("generated_tokens", 0);
+    result.promptTokensPerSec=j.value("prompt_tokens_per_sec", 0.0);
+    result.generationTokensPerSec=j.value("generation_tokens_per_sec", 0.0);
+    return result;
+}
+
+} // anonymous namespace
+
+AutotuneResult Autotuner::sweep(int cores, const AutotuneConfig &config, const BenchmarkFn &benchmark)
+{
+    cores=std::max(1, cores);
+
+    AutotuneResult result;
+    result.best.flashAttn=true;
+    result.best.kvCacheTypeK="f16";
+    result.best.kvCacheTypeV="f16";
+    result.best.nBatch=2048;
+    result.best.nUbatch=512;
+    result.best.nThreads=cores;
+    result.best.nThreadsBatch=cores;
+
+    std::set<std::string> tried;
+    auto run=[&](const RuntimeOptions &options)
+    {
+        std::string key=configKey(options);
+        if(tried.count(key))
+        {
+            return;
+        }
+
+        AutotuneTrial trial;
+        trial.options=options;
+        trial.ok=benchmark(options, trial.result);
+        trial.score=trial.ok?score(trial.result, config):0.0;
+        tried.insert(key);
+
+        spdlog::info("Autotune trial fa={} kv={} n_batch={} n_ubatch={} threads={}/{}: {}",
+            options.flashAttn.value_or(false), options.kvCacheTypeK.value_or("f16"),
+            options.nBatch.value_or(0), options.nUbatch.value_or(0),
+            options.nThreads.value_or(0), options.nThreadsBatch.value_or(0),
+            trial.ok
+                ?fmt::format("pp {:.1f} tok/s, tg {:.1f} tok/s", trial.result.promptTokensPerSec, trial.result.generationTokensPerSec)
+                :std::string("failed"));
+
+        if(trial.ok&&trial.score>result.bestScore)
+        {
+            result.best=options;
+            result.bestResult=trial.result;
+            result.bestScore=trial.score;
+        }
+        result.trials.push_back(trial);
+    };
+
+    std::vector<int> threadCounts={cores, cores*3/4, cores/2};
+    threadCounts.erase(std::remove_if(threadCounts.begin(), threadCounts.end(), [](int t) { return t<1; }), threadCounts.end());
+    threadCounts.erase(std::unique(threadCounts.begin(), threadCounts.end()), threadCounts.end());
+
+    // Baseline first so every later dimension has something to beat
+    run(result.best);
+
+    for(bool flashAttn:{true, false})
+    {
+        RuntimeOptions options=result.best;
+        options.flashAttn=flashAttn;
+        if(!flashAttn)
+        {
+            // A quantized V cache needs flash attention
+            options.kvCacheTypeK="f16";
+            options.kvCacheTypeV="f16";
+        }
+        run(options);
+    }
+
+    if(result.best.flashAttn.value_or(false))
+    {
+        for(const char *type:{"f16", "q8_0"})
+        {
+            RuntimeOptions options=result.best;
+            options.kvCacheTypeK=type;
+            options.kvCacheTypeV=type;
+            run(options);
+        }
+    }
+
+    for(int nUbatch:{128, 256, 512, 1024})
+    {
+        RuntimeOptions options=result.best;
+        if(nUbatch>options.nBatch.value_or(2048))
+        {
+            continue;
+        }
+        options.nUbatch=nUbatch;
+        run(options);
+    }
+
+    for(int nBatch:{512, 1024, 2048, 4096})
+    {
+        RuntimeOptions options=result.best;
+        if(nBatch<options.nUbatch.value_or(512))
+        {
+            continue;
+        }
+        options.nBatch=nBatch;
+        run(options);
+    }
+
+    for(int threads:threadCounts)
+    {
+        RuntimeOptions options=result.best;
+        options.nThreads=threads;
+        run(options);
+    }
+
+    for(int threads:threadCounts)
+    {
+        RuntimeOptions options=result.best;
+        options.nThreadsBatch=threads;
+        run(options);
+    }
+
+    result.updatedAt=std::chrono::system_clock::now();
+    return result;
+}
+
+double Autotuner::score(const BenchmarkResult &result, const AutotuneConfig &config)
+{
+    if(result.promptTokensPerSec<=0.0||result.generationTokensPerSec<=0.0)
+    {
+        return 0.0;
+    }
+
+    double seconds=config.promptTokens/result.promptTokensPerSec+
+        config.generateTokens/result.generationTokensPerSec;
+    return seconds>0.0?1.0/seconds:0.0;
+}
+
+std::string Autotuner::hardwareFingerprint(const SystemInfo &hw)
+{
+    // Round RAM and VRAM to whole GB so small reporting differences between
+    // boots do not invalidate a tuning
+    std::string fingerprint="cpu"+std::to_string(hw.cpuCores)+
+        "-ram"+std::to_string((hw.totalRamMb+512)/1024)+"g";
+
+    for(const GpuInfo &gpu:hw.gpus)
+    {
+        std::string backend=gpu.backend==GpuBackend::CUDA?"cuda":
+            gpu.backend==GpuBackend::Vulkan?"vulkan":"none";
+        fingerprint+="-"+backend+":"+gpu.name+":"+std::to_string((gpu.vramTotalMb+512)/1024)+"g";
+    }
+    return fingerprint;
+}
+
+AutotuneStore &AutotuneStore::instance()
+{
+    static AutotuneStore store;
+    return store;
+}
+
+void AutotuneStore::reset()
+{
+    AutotuneStore &store=instance();
+    std::lock_guard<std::mutex> lock(store.m_mutex);
+    store.m_results.clear();
+    store.m_path.clear();
+}
+
+std::string AutotuneStore::key(const std::string &model, const std::string &variant, const std::string &hardwareFingerprint)
+{
+    return model+"/"+variant+"/"+hardwareFingerprint;
+}
+
+void AutotuneStore::load(const std::filesystem::path &path)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_path=path;
+    m_results.clear();
+
+    if(!std::filesystem::exists(path))
+    {
+        return;
+    }
+
+    try
+    {
+        std::ifstream file(path);
+        nlohmann::json data;
+        file>>data;
+
+        if(data.contains("results")&&data["results"].is_array())
+        {
+            for(const nlohmann::json &r:data["results"])
+            {
+                AutotuneResult result;
+                result.model=r.value("model", "");
+                result.variant=r.value("variant", "");
+                result.hardwareFingerprint=r.value("hardware_fingerprint", "");
+                result.best=tunedFromJson(r.value("options", nlohmann::json::object()));
+                result.bestResult=benchmarkFromJson(r.value("benchmark", nlohmann::json::object()));
+                result.bestScore=r.value("score", 0.0);
+                result.updatedAt=std::chrono::system_clock::time_point(
+                    std::chrono::seconds(r.value("updated_at", int64_t(0))));
+
+                if(r.contains("trials")&&r["trials"].is_array())
+                {
+                    for(const nlohmann::json &t:r["trials"])
+                    {
+                        AutotuneTrial trial;
+                        trial.options=tunedFromJson(t.value("options", nlohmann::json::object()));
+                        trial.result=benchmarkFromJson(t);
+                        trial.ok=t.value("ok", false);
+                        trial.score=t.value("score", 0.0);
+                        result.trials.push_back(trial);
+                    }
+                }
+
+                if(!result.model.empty())
+                {
+                    m_results[key(result.model, result.variant, result.hardwareFingerprint)]=result;
+                }
+            }
+        }
+
+        spdlog::info("Loaded {} autotune results from {}", m_results.size(), path.string());
+    }
+    catch(const std::exception &e)
+    {
+        spdlog::warn("Failed to load autotune results from {}: {}", path.string(), e.what());
+    }
+}
+
+void AutotuneStore::record(const AutotuneResult &result)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_results[key(result.model, result.variant, result.hardwareFingerprint)]=result;
+
+    spdlog::info("Autotuned '{}' variant '{}': pp {:.1f} tok/s, tg {:.1f} tok/s over {} trials",
+        result.model, result.variant, result.bestResult.promptTokensPerSec,
+        result.bestResult.generationTokensPerSec, result.trials.size());
+
+    save();
+}
+
+std::optional<AutotuneResult> AutotuneStore::get(const std::string &model, const std::string &variant,
+    const std::string &hardwareFingerprint) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it=m_results.find(key(model, variant, hardwareFingerprint));
+    if(it==m_results.end())
+    {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+std::map<std::string, AutotuneResult> AutotuneStore::getAll() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_results;
+}
+
+void AutotuneStore::save() const
+{
+    // NOTE: caller must hold m_mutex
+
+    if(m_path.empty())
+    {
+        return;
+    }
+
+    nlohmann::json results=nlohmann::json::array();
+    for(const auto &pair:m_results)
+    {
+        const AutotuneResult &result=pair.second;
+
+        nlohmann::json trials=nlohmann::json::array();
+        for(const AutotuneTrial &trial:result.trials)
+        {
+            nlohmann::json t=benchmarkToJson(trial.result);
+            t["options"]=tunedToJson(trial.options);
+            t["ok"]=trial.ok;
+            t["score"]=trial.score;
+            trials.push_back(t);
+        }
+
+        results.push_back({
+            {"model", result.model},
+            {"variant", result.variant},
+            {"hardware_fingerprint", result.hardwareFingerprint},
+            {"options", tunedToJson(result.best)},
+            {"benchmark", benchmarkToJson(result.bestResult)},
+            {"score", result.bestScore},
+            {"trials", trials},
+            {"updated_at", std::chrono::duration_cast<std::chrono::seconds>(
+                result.updatedAt.time_since_epoch()).count()}
+        });
+    }
+
+    nlohmann::json data;
+    data["version"]=1;
+    data["results"]=results;
+
+    // Write to a temp file and rename so a crash never leaves a torn file
+    std::filesystem::path tmpPath=m_path;
+    tmpPath+=".tmp";
+    try
+    {
+        {
+            std::ofstream file(tmpPath);
+            file<<data.dump(4);
+        }
+        std::filesystem::rename(tmpPath, m_path);
+    }
+    catch(const std::exception &e)
+    {
+        spdlog::error("Failed to save autotune results to {}: {}", m_path.string(), e.what());
+    }
+}
+
+} // namespace arbiterAI
@@ -0,0 +1,110 @@
+#ifndef _ARBITERAI_AUTOTUNER_H_
+#define _ARBITERAI_AUTOTUNER_H_
+
+#include "arbiterAI/modelManager.h"
+#include "arbiterAI/hardwareDetector.h"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <chrono>
+#include <functional>
+#include <filesystem>
+
+namespace arbiterAI
+{
+
+/// Throughput measured by one synthetic prefill + decode run.
+struct BenchmarkResult {
+    int promptTokens=0;
+    int generatedTokens=0;
+    double promptTokensPerSec=0.0;
+    double generationTokensPerSec=0.0;
+};
+
+/// One configuration tried by the autotuner.
+struct AutotuneTrial {
+    RuntimeOptions options;     // only the tuned fields are set
+    BenchmarkResult result;
+    bool ok=false;              // false when the context could not be created or decode failed
+    double score=0.0;
+};
+
+/// Outcome of an autotune sweep for one model variant on one machine.
+struct AutotuneResult {
+    std::string model;
+    std::string variant;
+    std::string hardwareFingerprint;
+    RuntimeOptions best;        // winning options (tuned fields only)
+    BenchmarkResult bestResult;
+    double bestScore=0.0;
+    std::vector<AutotuneTrial> trials;
+    std::chrono::system_clock::time_point updatedAt;
+};
+
+struct AutotuneConfig {
+    int promptTokens=512;       // synthetic prompt length per trial
+    int generateTokens=64;      // tokens decoded per trial
+};
+
+/// Sweeps the llama.cpp options that trade prefill against decode speed —
+/// flash attention, KV cache type, n_batch, n_ubatch and thread counts —
+/// one dimension at a time, keeping the best value of each before moving on.
+class Autotuner {
+public:
+    /// Runs a configuration and fills in its throughput; false on failure.
+    using BenchmarkFn=std::function<bool(const RuntimeOptions &options, BenchmarkResult &result)>;
+
+    /// Run the sweep.  cores is the number of CPUs the model may use.
+    static AutotuneResult sweep(int cores, const AutotuneConfig &config, const BenchmarkFn &benchmark);
+
+    /// Requests per second for a request of config.promptTokens prompt and
+    /// config.generateTokens output tokens; 0 for a failed trial.
+    static double score(const BenchmarkResult &result, const AutotuneConfig &config);
+
+    /// Stable identifier for the machine the options were tuned on: CPU
+    /// count, RAM and each GPU's name, backend and VRAM.
+    static std::string hardwareFingerprint(const SystemInfo &hw);
+};
+
+/// Autotune results persisted next to the models, keyed by model, variant
+/// and hardware fingerprint, so a load on the same machine reuses them.
+class AutotuneStore {
+public:
+    static AutotuneStore &instance();
+    static void reset(); // For testing
+
+    /// Load results from a JSON file and persist future updates there.
+    void load(const std::filesystem::path &path);
+
+    /// Store the result of a sweep, replacing any earlier one for the same key.
+    void record(const AutotuneResult &result);
+
+    /// Get the stored result for a model variant on this hardware.
+    std::optional<AutotuneResult> get(const std::string &model, const std::string &variant,
+        const std::string &hardwareFingerprint) const;
+
+    /// Get all results keyed by "model/variant/fingerprint".
+    std::map<std::string, AutotuneResult> getAll() const;
+
+private:
+    AutotuneStore()=default;
+
+    AutotuneStore(const AutotuneStore &)=delete;
+    AutotuneStore &operator=(const AutotuneStore &)=delete;
+
+    /// Write all results to m_path (caller holds m_mutex).
+    void save() const;
+
+    static std::string key(const std::string &model, const std::string &variant, const std::string &hardwareFingerprint);
+
+    mutable std::mutex m_mutex;
+    std::filesystem::path m_path;
+    std::map<std::string, AutotuneResult> m_results;
+};
+
+} // namespace arbiterAI
+
+#endif//_ARBITERAI_AUTOTUNER_H_
@@ -0,0 +1,246 @@
+#include "arbiterAI/blobStore.h"
+
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cctype>
+
+namespace arbiterAI
+{
+
+namespace
+{
+
+std::string toLower(std::string text)
+{
+    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+/// Replace path with a hard link to target. Linking to a temporary name
+/// first and renaming over path means path is never missing.
+bool replaceWithLink(const std::filesystem::path &target, const std::filesystem::path &path)
+{
+    std::error_code ec;
+    std::filesystem::path tmp=path;
+    tmp+=".link";
+    std::filesystem::remove(tmp, ec);
+
+    std::filesystem::create_hard_link(target, tmp, ec);
+    if(ec)
+    {
+        spdlog::warn("BlobStore: cannot link {} to {}: {}", path.string(), target.string(), ec.message());
+        return false;
+    }
+    std::filesystem::rename(tmp, path, ec);
+    if(ec)
+    {
+        spdlog::warn("BlobStore: cannot replace {}: {}", path.string(), ec.message());
+        std::filesystem::remove(tmp, ec);
+        return false;
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+BlobStore::BlobStore(const std::filesystem::path &root):
+    m_root(root)
+{
+}
+
+void BlobStore::setRoot(const std::filesystem::path &root)
+{
+    m_root=root;
+}
+
+bool BlobStore::isValidHash(const std::string &hash)
+{
+    return hash.size()==64&&std::all_of(hash.begin(), hash.end(), [](unsigned char c) { return std::isxdigit(c)!=0; });
+}
+
+std::filesystem::path BlobStore::blobPath(const std::string &hash) const
+{
+    return m_root/"sha256"/toLower(hash);
+}
+
+bool BlobStore::contains(const std::string &hash) const
+{
+    if(m_root.empty()||!isValidHash(hash))
+    {
+        return false;
+    }
+    std::error_code ec;
+    return std::filesystem::is_regular_file(blobPath(hash), ec);
+}
+
+int64_t BlobStore::blobSize(const std::string &hash) const
+{
+    if(!contains(hash))
+    {
+        return -1;
+    }
+    std::error_code ec;
+    std::uintmax_t size=std::filesystem::file_size(blobPath(hash), ec);
+    return ec?-1:static_cast<int64_t>(size);
+}
+
+int BlobStore::refCount(const std::string &hash) const
+{
+    if(!contains(hash))
+    {
+        return 0;
+    }
+    std::error_code ec;
+    std::uintmax_t links=std::filesystem::hard_link_count(blobPath(hash), ec);
+    return ec||links==0?0:static_cast<int>(links-1);
+}
+
+bool BlobStore::isLinked(const std::string &hash, const std::filesystem::path &path) const
+{
+    return contains(hash)&&sameFile(blobPath(hash), path);
+}
+
+bool BlobStore::adopt(const std::string &hash, const std::filesystem::path &path, int64_t *duplicateBytes)
+{
+    if(duplicateBytes)
+    {
+        *duplicateBytes=0;
+    }
+    if(m_root.empty()||!isValidHash(hash))
+    {
+        return false;
+    }
+
+    std::error_code ec;
+    if(!std::filesystem::is_regular_file(path, ec))
+    {
+        return false;
+    }
+
+    std::filesystem::path blob=blobPath(hash);
+    std::filesystem::create_directories(blob.parent_path(), ec);
+
+    if(contains(hash))
+    {
+        if(sameFile(blob, path))
+        {
+            return true;
+        }
+
+        // Known content under a new name: keep one copy
+        int64_t size=static_cast<int64_t>(std::filesystem::file_size(path, ec));
+        bool lastCopy=std::filesystem::hard_link_count(path, ec)==1;
+        if(!replaceWithLink(blob, path))
+        {
+            return false;
+        }
+        if(duplicateBytes&&lastCopy)
+        {
+            *duplicateBytes=size;
+        }
+        spdlog::info("BlobStore: {} duplicates blob {}; linked", path.filename().string(), toLower(hash).substr(0, 12));
+        return true;
+    }
+
+    std::filesystem::create_hard_link(path, blob, ec);
+    if(ec)
+    {
+        spdlog::warn("BlobStore: cannot add {} to the store: {}", path.string(), ec.message());
+        return false;
+    }
+    return true;
+}
+
+bool BlobStore::link(const std::string &hash, const std::filesystem::path &path)
+{
+    if(!contains(hash))
+    {
+        return false;
+    }
+
+    std::filesystem::path blob=blobPath(hash);
+    std::error_code ec;
+    if(std::filesystem::exists(path, ec)&&sameFile(blob, path))
+    {
+        return true;
+    }
+    if(path.has_parent_path())
+    {
+        std::filesystem::create_directories(path.parent_path(), ec);
+    }
+    return replaceWithLink(blob, path);
+}
+
+int64_t BlobStore::release(const std::string &hash, const std::filesystem::path &path)
+{
+    std::error_code ec;
+    bool stored=contains(hash);
+    std::filesystem::path blob=stored?blobPath(hash):std::filesystem::path();
+
+    int64_t freed=0;
+    if(std::filesystem::is_regular_file(path, ec))
+    {
+        bool linked=stored&&sameFile(blob, path);
+        int64_t size=static_cast<int64_t>(std::filesystem::file_size(path, ec));
+        std::uintmax_t links=std::filesystem::hard_link_count(path, ec);
+
+        if(!std::filesystem::remove(path, ec)||ec)
+        {
+            spdlog::error("BlobStore: failed to delete {}: {}", path.string(), ec.message());
+            return 0;
+        }
+        if(!linked&&links==1)
+        {
+            freed=size;
+        }
+    }
+
+    // Drop the blob once no model path references it
+    if(stored&&std::filesystem::hard_link_count(blob, ec)==1&&!ec)
+    {
+        int64_t size=static_cast<int64_t>(std::filesystem::file_size(blob, ec));
+        if(std::filesystem::remove(blob, ec))
+        {
+            freed+=size;
+            spdlog::info("BlobStore: removed unreferenced blob {}", toLower(hash).substr(0, 12));
+        }
+    }
+    return freed;
+}
+
+int64_t BlobStore::collectGarbage()
+{
+    std::filesystem::path dir=m_root/"sha256";
+    std::error_code ec;
+    if(m_root.empty()||!std::filesystem::is_directory(dir, ec))
+    {
+        return 0;
+    }
+
+    int64_t freed=0;
+    for(const std::filesystem::directory_entry &entry:std::filesystem::directory_iterator(dir, ec))
+    {
+        std::error_code entryEc;
+        if(!entry.is_regular_file(entryEc)||entry.hard_link_count(entryEc)!=1)
+        {
+            continue;
+        }
+
+        int64_t size=static_cast<int64_t>(entry.file_size(entryEc));
+        if(std::filesystem::remove(entry.path(), entryEc))
+        {
+            freed+=size;
+            spdlog::info("BlobStore: removed unreferenced blob {}", entry.path().filename().string().substr(0, 12));
+        }
+    }
+    return freed;
+}
+
+bool BlobStore::sameFile(const std::filesystem::path &a, const std::filesystem::path &b)
+{
+    std::error_code ec;
+    bool same=std::filesystem::equivalent(a, b, ec);
+    return !ec&&same;
+}
+
+} // namespace arbiterAI
@@ -0,0 +1,76 @@
+#ifndef _ARBITERAI_BLOBSTORE_H_
+#define _ARBITERAI_BLOBSTORE_H_
+
+#include <string>
+#include <filesystem>
+#include <cstdint>
+
+namespace arbiterAI
+{
+
+/// Content-addressed store for model files, keyed by sha256.
+///
+/// Each blob lives once under <root>/sha256/<hash>; the model paths that
+/// use it are hard links to the same inode.  The link count is the
+/// reference count: a path is released by unlinking it, and the blob itself
+/// is only removed once no model path links to it any more.  Keeping the
+/// count in the filesystem means it can't drift from what is on disk.
+///
+/// Hard links need the blob and the model path on one filesystem; when
+/// linking fails the model path is kept as a plain, unshared file.
+class BlobStore {
+public:
+    BlobStore()=default;
+    explicit BlobStore(const std::filesystem::path &root);
+
+    void setRoot(const std::filesystem::path &root);
+    const std::filesystem::path &root() const { return m_root; }
+
+    /// True for a 64 character hex sha256 (any case).
+    static bool isValidHash(const std::string &hash);
+
+    /// Where the blob for hash lives (hash lowercased).
+    std::filesystem::path blobPath(const std::string &hash) const;
+
+    bool contains(const std::string &hash) const;
+
+    /// Size of the blob, or -1 if it isn't stored.
+    int64_t blobSize(const std::string &hash) const;
+
+    /// Model paths linked to the blob (0 if it isn't stored).
+    int refCount(const std::string &hash) const;
+
+    /// True if path is a link to the stored blob for hash.
+    bool isLinked(const std::string &hash, const std::filesystem::path &path) const;
+
+    /// Take a verified file into the store.  If the blob is new, path
+    /// becomes its first link; if it is already stored, path is replaced by
+    /// a link to it and the duplicate's space is returned.
+    /// @param duplicateBytes  [out] optional, bytes freed by deduplication.
+    /// @return true if path now links to the blob.
+    bool adopt(const std::string &hash, const std::filesystem::path &path, int64_t *duplicateBytes=nullptr);
+
+    /// Create (or replace) path as a link to a stored blob.
+    /// @return false if the blob isn't stored or the link failed.
+    bool link(const std::string &hash, const std::filesystem::path &path);
+
+    /// Unlink path and drop the blob if that was its last model path.
+    /// Paths that aren't links to the blob are simply removed.
+    /// @return Bytes actually freed on disk.
+    int64_t release(const std::string &hash, const std::filesystem::path &path);
+
+    /// Remove blobs no model path links to (e.g. after files were deleted
+    /// by hand).
+    /// @return Bytes freed.
+    int64_t collectGarbage();
+
+private:
+    /// True if both paths name the same inode.
+    static bool sameFile(const std::filesystem::path &a, const std::filesystem::path &b);
+
+    std::filesystem::path m_root;
+};
+
+} // namespace arbiterAI
+
+#endif//_ARBITERAI_BLOBSTORE_H_
@@ -232,6 +232,10 @@ CompletionRequest ChatClient::buildRequest(const CompletionRequest& userRequest)
     fullRequest.tool_choice = userRequest.tool_choice;
     fullRequest.stop = userRequest.stop;
 
+    fullRequest.tenant = userRequest.tenant;
+    fullRequest.priority = userRequest.priority;
+    fullRequest.onQueuePosition = userRequest.onQueuePosition;
+
     return fullRequest;
 }
 
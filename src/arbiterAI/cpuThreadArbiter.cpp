@@ -0,0 +1,240 @@
+#include "arbiterAI/cpuThreadArbiter.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace arbiterAI
+{
+
+CpuThreadArbiter::CpuThreadArbiter()
+{
+    reset();
+}
+
+void CpuThreadArbiter::reset()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    int count=std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    std::vector<int> cpus(count);
+    for(int i=0; i<count; ++i)
+    {
+        cpus[i]=i;
+    }
+    m_nodeCpus={cpus};
+    m_maxThreads=0;
+    m_queueDepth.clear();
+    m_homeNode.clear();
+    m_generation.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void CpuThreadArbiter::setNodes(const std::vector<std::vector<int>> &nodeCpus)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_nodeCpus.clear();
+    for(const std::vector<int> &cpus:nodeCpus)
+    {
+        if(!cpus.empty())
+        {
+            m_nodeCpus.push_back(cpus);
+        }
+    }
+    if(m_nodeCpus.empty())
+    {
+        m_nodeCpus.push_back({0});
+    }
+    m_homeNode.clear();
+    m_generation.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void CpuThreadArbiter::setMaxThreads(int maxThreads)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_maxThreads=std::max(0, maxThreads);
+    m_generation.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void CpuThreadArbiter::begin(const std::string &model)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_queueDepth[model]++;
+    homeNode(model);
+    m_generation.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void CpuThreadArbiter::end(const std::string &model)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it=m_queueDepth.find(model);
+    if(it!=m_queueDepth.end()&&--it->second<=0)
+    {
+        m_queueDepth.erase(it);
+    }
+    m_generation.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void CpuThreadArbiter::remove(const std::string &model)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_homeNode.erase(model);
+    m_generation.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void CpuThreadArbiter::setHomeNode(const std::string &model, int node)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if(node!=ALL_NODES&&(node<0||node>=static_cast<int>(m_nodeCpus.size())))
+    {
+        return;
+    }
+    m_homeNode[model]=node;
+    m_generation.fetch_add(1, std::memory_order_acq_rel);
+}
+
+int CpuThreadArbiter::queueDepth(const std::string &model) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it=m_queueDepth.find(model);
+    return it!=m_queueDepth.end()?it->second:0;
+}
+
+CpuThreadShare CpuThreadArbiter::share(const std::string &model, int maxThreads, int maxBatchThreads)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    CpuThreadShare share;
+    share.node=homeNode(model);
+
+    // Weight every active model sharing CPUs with this one by its queue
+    // depth; a model asking before its request is counted weighs as one.
+    // Models spread over all nodes share CPUs with every node.
+    int totalWeight=0;
+    int ownWeight=1;
+    for(const auto &pair:m_queueDepth)
+    {
+        auto home=m_homeNode.find(pair.first);
+        if(home==m_homeNode.end())
+        {
+            continue;
+        }
+        if(home->second!=share.node&&home->second!=ALL_NODES&&share.node!=ALL_NODES)
+        {
+            continue;
+        }
+        if(pair.first==model)
+        {
+            ownWeight=pair.second;
+        }
+        else
+        {
+            totalWeight+=pair.second;
+        }
+    }
+    totalWeight+=ownWeight;
+
+    int cpus=usableCpus(share.node);
+    int threads=std::max(1, cpus*ownWeight/totalWeight);
+
+    share.nThreads=maxThreads>0?std::min(threads, maxThreads):threads;
+    share.nThreadsBatch=maxBatchThreads>0?std::min(threads, maxBatchThreads):threads;
+    return share;
+}
+
+std::vector<int> CpuThreadArbiter::nodeCpus(int node) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if(node==ALL_NODES)
+    {
+        std::vector<int> cpus;
+        for(int n=0; n<static_cast<int>(m_nodeCpus.size()); ++n)
+        {
+            cpus.insert(cpus.end(), m_nodeCpus[n].begin(), m_nodeCpus[n].begin()+usableCpus(n));
+        }
+        return cpus;
+    }
+    if(node<0||node>=static_cast<int>(m_nodeCpus.size()))
+    {
+        return {};
+    }
+    std::vector<int> cpus=m_nodeCpus[node];
+    cpus.resize(usableCpus(node));
+    return cpus;
+}
+
+int CpuThreadArbiter::nodeCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return static_cast<int>(m_nodeCpus.size());
+}
+
+int CpuThreadArbiter::homeNode(const std::string &model)
+{
+    // NOTE: caller must hold m_mutex
+
+    auto it=m_homeNode.find(model);
+    if(it!=m_homeNode.end())
+    {
+        return it->second;
+    }
+
+    // Least models per usable CPU wins; ties go to the lower node
+    std::vector<int> homed(m_nodeCpus.size(), 0);
+    for(const auto &pair:m_homeNode)
+    {
+        if(pair.second!=ALL_NODES)
+        {
+            homed[pair.second]++;
+        }
+    }
+
+    int best=0;
+    for(int node=1; node<static_cast<int>(m_nodeCpus.size()); ++node)
+    {
+        if(homed[node]*usableCpus(best)<homed[best]*usableCpus(node))
+        {
+            best=node;
+        }
+    }
+
+    m_homeNode[model]=best;
+    return best;
+}
+
+int CpuThreadArbiter::usableCpus(int node) const
+{
+    // NOTE: caller must hold m_mutex
+
+    if(node==ALL_NODES)
+    {
+        int cpus=0;
+        for(int n=0; n<static_cast<int>(m_nodeCpus.size()); ++n)
+        {
+            cpus+=usableCpus(n);
+        }
+        return cpus;
+    }
+
+    int cpus=static_cast<int>(m_nodeCpus[node].size());
+    if(m_maxThreads<=0)
+    {
+        return cpus;
+    }
+
+    int total=0;
+    for(const std::vector<int> &list:m_nodeCpus)
+    {
+        total+=static_cast<int>(list.size());
+    }
+    if(m_maxThreads>=total)
+    {
+        return cpus;
+    }
+    return std::max(1, cpus*m_maxThreads/total);
+}
+
+} // namespace arbiterAI
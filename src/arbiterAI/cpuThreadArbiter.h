@@ -0,0 +1,95 @@
+#ifndef _ARBITERAI_CPUTHREADARBITER_H_
+#define _ARBITERAI_CPUTHREADARBITER_H_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+namespace arbiterAI
+{
+
+/// CPU threads one model may use for its next decode.
+struct CpuThreadShare {
+    int nThreads=0;         // decode (token generation)
+    int nThreadsBatch=0;    // prefill (prompt processing)
+    int node=0;             // NUMA node whose CPUs the model's threadpool is pinned to (ALL_NODES = every node)
+
+    bool operator==(const CpuThreadShare &other) const
+    {
+        return nThreads==other.nThreads&&nThreadsBatch==other.nThreadsBatch&&node==other.node;
+    }
+    bool operator!=(const CpuThreadShare &other) const { return !(*this==other); }
+};
+
+/// Divides CPU cores among models that are running inference at the same
+/// time so concurrent decodes never oversubscribe the machine.  Each model is
+/// homed on one NUMA node; a node's cores are split between its active models
+/// in proportion to their queue depth (requests in flight).
+class CpuThreadArbiter {
+public:
+    /// Home node of a model spread over every node (interleaved memory).
+    static constexpr int ALL_NODES=-1;
+
+    CpuThreadArbiter();
+
+    /// Restore defaults: one node with every CPU, no limit, no models.
+    void reset();
+
+    /// Set the CPUs to divide, one list per NUMA node.  A single list means
+    /// no NUMA split.  Resets node assignments.
+    void setNodes(const std::vector<std::vector<int>> &nodeCpus);
+
+    /// Limit the number of CPUs handed out (0 = all).  Applied per node in
+    /// proportion to its size.
+    void setMaxThreads(int maxThreads);
+
+    /// A request for the model started / finished.  The first request homes
+    /// the model on the least-loaded node.
+    void begin(const std::string &model);
+    void end(const std::string &model);
+
+    /// Forget a model that was unloaded (drops its node assignment).
+    void remove(const std::string &model);
+
+    /// Home a model on a node chosen by the caller, or on ALL_NODES to let
+    /// it use every CPU.  Out-of-range nodes are ignored.
+    void setHomeNode(const std::string &model, int node);
+
+    /// Current share for a model.  maxThreads/maxBatchThreads cap the decode
+    /// and prefill counts (0 = no cap).  Assigns a home node on first use.
+    CpuThreadShare share(const std::string &model, int maxThreads=0, int maxBatchThreads=0);
+
+    /// Changes whenever shares may have changed (a request started or
+    /// finished, nodes or limits changed).  Lock-free, so a decoding thread
+    /// can check it per token and only ask for its share when it moved.
+    uint64_t generation() const { return m_generation.load(std::memory_order_acquire); }
+
+    /// Requests in flight for a model.
+    int queueDepth(const std::string &model) const;
+
+    /// CPUs of a node (or of every node for ALL_NODES) after the
+    /// max-threads limit.
+    std::vector<int> nodeCpus(int node) const;
+    int nodeCount() const;
+
+private:
+    /// Home node for a model, assigning the least-loaded node (caller holds m_mutex).
+    int homeNode(const std::string &model);
+
+    /// Usable CPU count of a node (caller holds m_mutex).
+    int usableCpus(int node) const;
+
+    mutable std::mutex m_mutex;
+    std::vector<std::vector<int>> m_nodeCpus;
+    int m_maxThreads=0;
+    std::map<std::string, int> m_queueDepth;
+    std::map<std::string, int> m_homeNode;
+    std::atomic<uint64_t> m_generation{0};
+};
+
+} // namespace arbiterAI
+
+#endif//_ARBITERAI_CPUTHREADARBITER_H_
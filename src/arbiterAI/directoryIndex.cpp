@@ -0,0 +1,280 @@
+#include "arbiterAI/directoryIndex.h"
+
+#include <spdlog/spdlog.h>
+#include <nlohmann/json.hpp>
+#include <fstream>
+
+#ifdef __linux__
+    #include <sys/stat.h>
+#endif
+
+namespace arbiterAI
+{
+
+bool IndexedFile::sameVersion(const IndexedFile &other) const
+{
+    return sizeBytes==other.sizeBytes&&mtimeNs==other.mtimeNs&&inode==other.inode;
+}
+
+bool DirectoryIndex::load(const std::filesystem::path &path)
+{
+    m_files.clear();
+    m_dirty=false;
+
+    std::ifstream file(path);
+    if(!file.is_open())
+    {
+        return false;
+    }
+
+    try
+    {
+        nlohmann::json data;
+        file>>data;
+
+        if(data.value("version", 0)!=1||!data.contains("files")||!data["files"].is_array())
+        {
+            return false;
+        }
+
+        for(const nlohmann::json &f:data["files"])
+        {
+            IndexedFile record;
+            record.filename=f.value("filename", "");
+            record.sizeBytes=f.value("size_bytes", int64_t(0));
+            record.mtimeNs=f.value("mtime_ns", int64_t(0));
+            record.inode=f.value("inode", uint64_t(0));
+            record.sha256=f.value("sha256", "");
+            if(!record.filename.empty())
+            {
+                m_files[record.filename]=record;
+            }
+        }
+    }
+    catch(const std::exception &e)
+    {
+        spdlog::warn("DirectoryIndex: ignoring unreadable index {}: {}", path.string(), e.what());
+        m_files.clear();
+        return false;
+    }
+    return true;
+}
+
+bool DirectoryIndex::save(const std::filesystem::path &path)
+{
+    nlohmann::json files=nlohmann::json::array();
+    for(auto it=m_files.begin(); it!=m_files.end(); ++it)
+    {
+        const IndexedFile &record=it->second;
+        nlohmann::json f;
+        f["filename"]=record.filename;
+        f["size_bytes"]=record.sizeBytes;
+        f["mtime_ns"]=record.mtimeNs;
+        f["inode"]=record.inode;
+        if(!record.sha256.empty())
+        {
+            f["sha256"]=record.sha256;
+        }
+        files.push_back(f);
+    }
+
+    nlohmann::json data;
+    data["version"]=1;
+    data["files"]=files;
+
+    std::filesystem::path tmp=path;
+    tmp+=".tmp";
+    {
+        std::ofstream file(tmp, std::ios::trunc);
+        if(!file.is_open())
+        {
+            spdlog::error("DirectoryIndex: cannot write {}", tmp.string());
+            return false;
+        }
+        file<<data.dump(1);
+        if(!file.good())
+        {
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    if(ec)
+    {
+        spdlog::error("DirectoryIndex: cannot replace {}: {}", path.string(), ec.message());
+        std::filesystem::remove(tmp, ec);
+        return false;
+    }
+    m_dirty=false;
+    return true;
+}
+
+bool DirectoryIndex::refresh(const std::filesystem::path &dir, const std::function<bool(const std::string &)> &filter)
+{
+    std::error_code ec;
+    std::filesystem::directory_iterator it(dir, ec);
+    if(ec)
+    {
+        spdlog::warn("DirectoryIndex: cannot list {}: {}", dir.string(), ec.message());
+        return false;
+    }
+
+    // The entry's type comes from readdir, so listing stats nothing
+    std::map<std::string, IndexedFile> files;
+    int statted=0;
+    for(; it!=std::filesystem::directory_iterator(); it.increment(ec))
+    {
+        std::error_code entryEc;
+        if(!it->is_regular_file(entryEc))
+        {
+            continue;
+        }
+
+        std::string filename=it->path().filename().string();
+        if(filter&&!filter(filename))
+        {
+            continue;
+        }
+
+        std::map<std::string, IndexedFile>::iterator known=m_files.find(filename);
+        if(known!=m_files.end())
+        {
+            files[filename]=known->second;
+            continue;
+        }
+
+        std::optional<IndexedFile> record=statFile(it->path());
+        ++statted;
+        if(record)
+        {
+            files[filename]=*record;
+        }
+    }
+
+    if(files.size()!=m_files.size()||statted>0)
+    {
+        m_dirty=true;
+    }
+    m_files.swap(files);
+
+    spdlog::debug("DirectoryIndex: {} file(s) in {}, {} new", m_files.size(), dir.string(), statted);
+    return true;
+}
+
+std::optional<IndexedFile> DirectoryIndex::update(const std::filesystem::path &dir, const std::string &filename)
+{
+    std::optional<IndexedFile> record=statFile(dir/filename);
+    std::map<std::string, IndexedFile>::iterator known=m_files.find(filename);
+
+    if(!record)
+    {
+        if(known!=m_files.end())
+        {
+            m_files.erase(known);
+            m_dirty=true;
+        }
+        return std::nullopt;
+    }
+
+    if(known!=m_files.end())
+    {
+        if(known->second.sameVersion(*record))
+        {
+            return known->second;
+        }
+        if(!known->second.sha256.empty())
+        {
+            spdlog::info("DirectoryIndex: {} changed on disk; its recorded hash no longer applies", filename);
+        }
+    }
+
+    m_files[filename]=*record;
+    m_dirty=true;
+    return record;
+}
+
+void DirectoryIndex::remove(const std::string &filename)
+{
+    if(m_files.erase(filename)>0)
+    {
+        m_dirty=true;
+    }
+}
+
+const IndexedFile *DirectoryIndex::find(const std::string &filename) const
+{
+    std::map<std::string, IndexedFile>::const_iterator it=m_files.find(filename);
+    return it==m_files.end()?nullptr:&it->second;
+}
+
+std::vector<std::string> DirectoryIndex::filenames() const
+{
+    std::vector<std::string> names;
+    names.reserve(m_files.size());
+    for(auto it=m_files.begin(); it!=m_files.end(); ++it)
+    {
+        names.push_back(it->first);
+    }
+    return names;
+}
+
+void DirectoryIndex::setHash(const std::string &filename, const std::string &sha256)
+{
+    std::map<std::string, IndexedFile>::iterator it=m_files.find(filename);
+    if(it!=m_files.end()&&it->second.sha256!=sha256)
+    {
+        it->second.sha256=sha256;
+        m_dirty=true;
+    }
+}
+
+bool DirectoryIndex::isCurrent(const std::filesystem::path &dir, const std::string &filename) const
+{
+    const IndexedFile *known=find(filename);
+    if(!known)
+    {
+        return false;
+    }
+    std::optional<IndexedFile> record=statFile(dir/filename);
+    return record&&known->sameVersion(*record);
+}
+
+void DirectoryIndex::clear()
+{
+    m_files.clear();
+    m_dirty=false;
+}
+
+std::optional<IndexedFile> DirectoryIndex::statFile(const std::filesystem::path &path)
+{
+    IndexedFile record;
+    record.filename=path.filename().string();
+
+#ifdef __linux__
+    struct stat st;
+    if(::stat(path.c_str(), &st)!=0||!S_ISREG(st.st_mode))
+    {
+        return std::nullopt;
+    }
+    record.sizeBytes=static_cast<int64_t>(st.st_size);
+    record.mtimeNs=static_cast<int64_t>(st.st_mtim.tv_sec)*1000000000LL+static_cast<int64_t>(st.st_mtim.tv_nsec);
+    record.inode=static_cast<uint64_t>(st.st_ino);
+#else
+    std::error_code ec;
+    if(!std::filesystem::is_regular_file(path, ec))
+    {
+        return std::nullopt;
+    }
+    record.sizeBytes=static_cast<int64_t>(std::filesystem::file_size(path, ec));
+    record.mtimeNs=static_cast<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::filesystem::last_write_time(path, ec).time_since_epoch()).count());
+    if(ec)
+    {
+        return std::nullopt;
+    }
+#endif
+    return record;
+}
+
+} // namespace arbiterAI
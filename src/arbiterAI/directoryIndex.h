@@ -0,0 +1,83 @@
+#ifndef _ARBITERAI_DIRECTORYINDEX_H_
+#define _ARBITERAI_DIRECTORYINDEX_H_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <optional>
+#include <filesystem>
+#include <functional>
+#include <cstdint>
+
+namespace arbiterAI
+{
+
+/// What the index remembers about one file.
+struct IndexedFile {
+    std::string filename;
+    int64_t sizeBytes=0;
+    int64_t mtimeNs=0;          // modification time, ns since the epoch
+    uint64_t inode=0;           // 0 where the platform has none
+    std::string sha256;         // "" = unknown
+
+    /// True if both describe the same bytes on disk (size, mtime, inode).
+    bool sameVersion(const IndexedFile &other) const;
+};
+
+/// Persistent index of the files in one directory.
+///
+/// Startup lists the directory (names and types only, no per-file stat)
+/// and stats just the names the index hasn't seen, so a large models
+/// directory costs one readdir. A recorded hash is only trusted while the
+/// file's size, mtime and inode still match, so a file replaced outside the
+/// server loses its hash instead of being served as verified content.
+///
+/// Not thread safe; the owner serializes access.
+class DirectoryIndex {
+public:
+    /// Read a saved index. A missing or unreadable file leaves the index
+    /// empty, which just makes the next refresh stat everything.
+    /// @return true if an index was loaded.
+    bool load(const std::filesystem::path &path);
+
+    /// Write the index to a temporary file and rename it over path.
+    bool save(const std::filesystem::path &path);
+
+    /// Bring the index in line with the files in dir accepted by filter.
+    /// Known names are kept as indexed; new names are stat()ed.
+    /// @return false if dir couldn't be listed (index left unchanged).
+    bool refresh(const std::filesystem::path &dir, const std::function<bool(const std::string &)> &filter);
+
+    /// Re-stat one file after a change notification. Drops it from the
+    /// index if it no longer exists; clears its hash if it changed.
+    /// @return The file's record, or nullopt if it is gone.
+    std::optional<IndexedFile> update(const std::filesystem::path &dir, const std::string &filename);
+
+    void remove(const std::string &filename);
+
+    const IndexedFile *find(const std::string &filename) const;
+
+    /// Names of every indexed file, sorted.
+    std::vector<std::string> filenames() const;
+
+    /// Record the verified sha256 of a file (ignored if not indexed).
+    void setHash(const std::string &filename, const std::string &sha256);
+
+    /// True if the file's current state on disk matches its record.
+    bool isCurrent(const std::filesystem::path &dir, const std::string &filename) const;
+
+    bool isDirty() const { return m_dirty; }
+    size_t size() const { return m_files.size(); }
+    void clear();
+
+    /// stat() a file into a record (no hash).
+    static std::optional<IndexedFile> statFile(const std::filesystem::path &path);
+
+private:
+    std::map<std::string, IndexedFile> m_files;
+    bool m_dirty=false;
+};
+
+} // namespace arbiterAI
+
+#endif//_ARBITERAI_DIRECTORYINDEX_H_
@@ -0,0 +1,189 @@
+#include "arbiterAI/directoryWatcher.h"
+
+#include <spdlog/spdlog.h>
+#include <map>
+#include <cstring>
+#include <cerrno>
+
+#ifdef __linux__
+    #include <sys/inotify.h>
+    #include <sys/eventfd.h>
+    #include <poll.h>
+    #include <unistd.h>
+#endif
+
+namespace arbiterAI
+{
+
+DirectoryWatcher::~DirectoryWatcher()
+{
+    stop();
+}
+
+bool DirectoryWatcher::start(const std::filesystem::path &dir, DirectoryChangeCallback callback, std::chrono::milliseconds settleTime)
+{
+    stop();
+
+#ifdef __linux__
+    m_inotifyFd=::inotify_init1(IN_NONBLOCK|IN_CLOEXEC);
+    if(m_inotifyFd<0)
+    {
+        spdlog::warn("DirectoryWatcher: inotify unavailable: {}", std::strerror(errno));
+        return false;
+    }
+
+    // CLOSE_WRITE and MOVED_TO report files once complete; CREATE catches
+    // hard links, which are never written
+    uint32_t mask=IN_CREATE|IN_CLOSE_WRITE|IN_MOVED_TO|IN_MOVED_FROM|IN_DELETE|IN_DELETE_SELF|IN_MOVE_SELF|IN_ONLYDIR;
+    if(::inotify_add_watch(m_inotifyFd, dir.c_str(), mask)<0)
+    {
+        spdlog::warn("DirectoryWatcher: cannot watch {}: {}", dir.string(), std::strerror(errno));
+        ::close(m_inotifyFd);
+        m_inotifyFd=-1;
+        return false;
+    }
+
+    m_wakeFd=::eventfd(0, EFD_NONBLOCK|EFD_CLOEXEC);
+    if(m_wakeFd<0)
+    {
+        spdlog::warn("DirectoryWatcher: eventfd failed: {}", std::strerror(errno));
+        ::close(m_inotifyFd);
+        m_inotifyFd=-1;
+        return false;
+    }
+
+    m_running=true;
+    m_thread=std::thread(&DirectoryWatcher::run, this, dir, std::move(callback), settleTime);
+    spdlog::info("DirectoryWatcher: watching {}", dir.string());
+    return true;
+#else
+    (void)dir;
+    (void)callback;
+    (void)settleTime;
+    return false;
+#endif
+}
+
+void DirectoryWatcher::stop()
+{
+#ifdef __linux__
+    if(m_wakeFd>=0)
+    {
+        uint64_t one=1;
+        ssize_t written=::write(m_wakeFd, &one, sizeof(one));
+        (void)written;
+    }
+    if(m_thread.joinable())
+    {
+        m_thread.join();
+    }
+    if(m_inotifyFd>=0)
+    {
+        ::close(m_inotifyFd);
+        m_inotifyFd=-1;
+    }
+    if(m_wakeFd>=0)
+    {
+        ::close(m_wakeFd);
+        m_wakeFd=-1;
+    }
+#endif
+    m_running=false;
+}
+
+void DirectoryWatcher::run(std::filesystem::path dir, DirectoryChangeCallback callback, std::chrono::milliseconds settleTime)
+{
+#ifdef __linux__
+    // Last state per name until the directory settles
+    std::map<std::string, bool> pending;
+    bool overflowed=false;
+    bool watching=true;
+
+    alignas(struct inotify_event) char buffer[16*1024];
+
+    while(watching)
+    {
+        struct pollfd fds[2];
+        fds[0].fd=m_inotifyFd;
+        fds[0].events=POLLIN;
+        fds[1].fd=m_wakeFd;
+        fds[1].events=POLLIN;
+
+        bool hasPending=!pending.empty()||overflowed;
+        int ready=::poll(fds, 2, hasPending?static_cast<int>(settleTime.count()):-1);
+        if(ready<0)
+        {
+            if(errno==EINTR)
+            {
+                continue;
+            }
+            spdlog::error("DirectoryWatcher: poll failed: {}", std::strerror(errno));
+            break;
+        }
+        if(fds[1].revents&POLLIN)
+        {
+            break;
+        }
+
+        if(ready==0)
+        {
+            // Quiet for the settle time: hand over the batch
+            std::vector<DirectoryChange> changes;
+            changes.reserve(pending.size());
+            for(auto it=pending.begin(); it!=pending.end(); ++it)
+            {
+                changes.push_back({it->first, it->second});
+            }
+            pending.clear();
+
+            bool rescan=overflowed;
+            overflowed=false;
+            if(callback)
+            {
+                callback(changes, rescan);
+            }
+            continue;
+        }
+
+        ssize_t length=::read(m_inotifyFd, buffer, sizeof(buffer));
+        if(length<=0)
+        {
+            continue;
+        }
+
+        for(char *ptr=buffer; ptr<buffer+length; )
+        {
+            const struct inotify_event *event=reinterpret_cast<const struct inotify_event *>(ptr);
+            ptr+=sizeof(struct inotify_event)+event->len;
+
+            if(event->mask&IN_Q_OVERFLOW)
+            {
+                spdlog::warn("DirectoryWatcher: event queue overflowed for {}; rescanning", dir.string());
+                overflowed=true;
+                continue;
+            }
+            if(event->mask&(IN_DELETE_SELF|IN_MOVE_SELF|IN_IGNORED))
+            {
+                spdlog::warn("DirectoryWatcher: {} was removed or moved; no longer watching", dir.string());
+                watching=false;
+                break;
+            }
+            if(event->len==0||(event->mask&IN_ISDIR))
+            {
+                continue;
+            }
+
+            pending[event->name]=(event->mask&(IN_DELETE|IN_MOVED_FROM))==0;
+        }
+    }
+
+    // Changes still settling when stopped are picked up by the next scan
+#else
+    (void)dir;
+    (void)callback;
+    (void)settleTime;
+#endif
+    m_running=false;
+}
+
+} // namespace arbiterAI
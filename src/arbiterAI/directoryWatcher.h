@@ -0,0 +1,62 @@
+#ifndef _ARBITERAI_DIRECTORYWATCHER_H_
+#define _ARBITERAI_DIRECTORYWATCHER_H_
+
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <functional>
+#include <chrono>
+#include <thread>
+#include <atomic>
+
+namespace arbiterAI
+{
+
+/// A file in the watched directory that appeared, changed or went away.
+struct DirectoryChange {
+    std::string filename;
+    bool exists=true;   // false = deleted or moved out
+};
+
+/// Receives a batch of changes, last state per name. overflowed means
+/// events were lost and the directory should be rescanned.
+using DirectoryChangeCallback=std::function<void(const std::vector<DirectoryChange> &changes, bool overflowed)>;
+
+/// Watches one directory (not recursively) with inotify.
+///
+/// Events are coalesced until the directory has been quiet for the settle
+/// time, so a file copied in over several seconds is reported once, after
+/// its last write. The callback runs on the watcher's own thread.
+///
+/// On platforms without inotify start() returns false and nothing is
+/// reported; the owner falls back to scanning.
+class DirectoryWatcher {
+public:
+    DirectoryWatcher()=default;
+    ~DirectoryWatcher();
+
+    DirectoryWatcher(const DirectoryWatcher &)=delete;
+    DirectoryWatcher &operator=(const DirectoryWatcher &)=delete;
+
+    /// Start watching dir, replacing any previous watch.
+    /// @return false if the watch could not be set up.
+    bool start(const std::filesystem::path &dir, DirectoryChangeCallback callback,
+        std::chrono::milliseconds settleTime=std::chrono::milliseconds(500));
+
+    /// Stop watching and join the thread. Must not be called from the callback.
+    void stop();
+
+    bool isRunning() const { return m_running; }
+
+private:
+    void run(std::filesystem::path dir, DirectoryChangeCallback callback, std::chrono::milliseconds settleTime);
+
+    int m_inotifyFd=-1;
+    int m_wakeFd=-1;        // eventfd used to interrupt poll() on stop
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+};
+
+} // namespace arbiterAI
+
+#endif//_ARBITERAI_DIRECTORYWATCHER_H_
@@ -0,0 +1,244 @@
+#include "arbiterAI/downloadScheduler.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace arbiterAI
+{
+
+namespace
+{
+
+/// A bucket holds at most this much time worth of its rate, so an idle
+/// transfer can't bank a large burst.
+constexpr double BUCKET_SECONDS=0.25;
+
+} // anonymous namespace
+
+void DownloadScheduler::setMaxConnections(int max)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_maxConnections=std::max(1, max);
+        publishMostUrgent();
+    }
+    m_cv.notify_all();
+}
+
+int DownloadScheduler::getMaxConnections() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_maxConnections;
+}
+
+void DownloadScheduler::acquire(DownloadPriority priority)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    ++m_waiting[priority];
+    publishMostUrgent();
+
+    m_cv.wait(lock, [this, priority]()
+    {
+        // Lower values are more urgent
+        return m_inUse<m_maxConnections&&mostUrgentWaiting()>=static_cast<int>(priority);
+    });
+
+    if(--m_waiting[priority]==0)
+    {
+        m_waiting.erase(priority);
+    }
+    ++m_inUse;
+
+    // A connection a holder gave up has reached a waiter
+    int yielding=m_yielding.load();
+    while(yielding>0&&!m_yielding.compare_exchange_weak(yielding, yielding-1))
+    {
+    }
+    publishMostUrgent();
+
+    // Another waiter may fit in a remaining slot
+    m_cv.notify_all();
+}
+
+void DownloadScheduler::release()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        --m_inUse;
+        publishMostUrgent();
+    }
+    m_cv.notify_all();
+}
+
+int DownloadScheduler::inUse() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_inUse;
+}
+
+bool DownloadScheduler::shouldYield(DownloadPriority priority)
+{
+    int waiting=m_mostUrgentWaiting.load();
+    if(waiting<0||waiting>=static_cast<int>(priority))
+    {
+        return false;
+    }
+
+    // Take one of the yields still needed, if any are left
+    int tickets=m_yieldTickets.load();
+    while(tickets>0)
+    {
+        if(m_yieldTickets.compare_exchange_weak(tickets, tickets-1))
+        {
+            ++m_yielding;
+            return true;
+        }
+    }
+    return false;
+}
+
+int DownloadScheduler::mostUrgentWaiting() const
+{
+    // std::map orders priorities from most to least urgent
+    return m_waiting.empty()?-1:static_cast<int>(m_waiting.begin()->first);
+}
+
+void DownloadScheduler::publishMostUrgent()
+{
+    m_mostUrgentWaiting=mostUrgentWaiting();
+
+    // Waiters of the most urgent class that a free connection won't serve,
+    // less the holders already yielding to them
+    int needed=0;
+    if(!m_waiting.empty())
+    {
+        int free=std::max(0, m_maxConnections-m_inUse);
+        needed=std::max(0, m_waiting.begin()->second-free-m_yielding.load());
+    }
+    m_yieldTickets=needed;
+}
+
+void DownloadScheduler::setBandwidthLimit(int64_t bytesPerSecond)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_bandwidthLimit=std::max<int64_t>(0, bytesPerSecond);
+}
+
+int64_t DownloadScheduler::getBandwidthLimit() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_bandwidthLimit;
+}
+
+int DownloadScheduler::addTransfer(DownloadPriority priority)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    int id=m_nextTransferId++;
+    Bucket &bucket=m_buckets[id];
+    bucket.priority=priority;
+    bucket.refilled=std::chrono::steady_clock::now();
+    return id;
+}
+
+void DownloadScheduler::setTransferPriority(int id, DownloadPriority priority)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::map<int, Bucket>::iterator it=m_buckets.find(id);
+    if(it!=m_buckets.end())
+    {
+        it->second.priority=priority;
+    }
+}
+
+void DownloadScheduler::removeTransfer(int id)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_buckets.erase(id);
+}
+
+void DownloadScheduler::throttle(int id, size_t bytes)
+{
+    std::chrono::duration<double> wait{0.0};
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if(m_bandwidthLimit<=0)
+        {
+            return;
+        }
+
+        std::map<int, Bucket>::iterator it=m_buckets.find(id);
+        if(it==m_buckets.end())
+        {
+            return;
+        }
+
+        // This transfer's share of the limit among those registered now
+        double totalWeight=0.0;
+        for(const std::pair<const int, Bucket> &entry:m_buckets)
+        {
+            totalWeight+=weight(entry.second.priority);
+        }
+        Bucket &bucket=it->second;
+        double rate=static_cast<double>(m_bandwidthLimit)*weight(bucket.priority)/totalWeight;
+
+        std::chrono::steady_clock::time_point now=std::chrono::steady_clock::now();
+        double elapsed=std::chrono::duration<double>(now-bucket.refilled).count();
+        bucket.refilled=now;
+        bucket.tokens=std::min(bucket.tokens+elapsed*rate, rate*BUCKET_SECONDS);
+        bucket.tokens-=static_cast<double>(bytes);
+
+        if(bucket.tokens<0.0)
+        {
+            wait=std::chrono::duration<double>(-bucket.tokens/rate);
+        }
+    }
+
+    if(wait.count()>0.0)
+    {
+        std::this_thread::sleep_for(wait);
+    }
+}
+
+double DownloadScheduler::weight(DownloadPriority priority)
+{
+    switch(priority)
+    {
+        case DownloadPriority::UserBlocking: return 4.0;
+        case DownloadPriority::Explicit:     return 2.0;
+        default:                             return 1.0;
+    }
+}
+
+std::string DownloadScheduler::priorityToString(DownloadPriority priority)
+{
+    switch(priority)
+    {
+        case DownloadPriority::UserBlocking: return "user_blocking";
+        case DownloadPriority::Explicit:     return "explicit";
+        default:                             return "prefetch";
+    }
+}
+
+bool DownloadScheduler::parsePriority(const std::string &text, DownloadPriority &priority)
+{
+    if(text=="user_blocking")
+    {
+        priority=DownloadPriority::UserBlocking;
+    }
+    else if(text=="explicit")
+    {
+        priority=DownloadPriority::Explicit;
+    }
+    else if(text=="prefetch")
+    {
+        priority=DownloadPriority::Prefetch;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+} // namespace arbiterAI
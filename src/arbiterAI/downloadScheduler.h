@@ -0,0 +1,114 @@
+#ifndef _ARBITERAI_DOWNLOADSCHEDULER_H_
+#define _ARBITERAI_DOWNLOADSCHEDULER_H_
+
+#include "arbiterAI/arbiterAI.h"
+
+#include <string>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+namespace arbiterAI
+{
+
+/// Connections and bandwidth shared by every download.
+///
+/// Models, the shards of a model and the Range segments of a shard all take
+/// HTTP connections from one pool, so parallelism is spent on byte streams
+/// rather than on whole models.  Waiting transfers get free connections in
+/// priority order, and a transfer that holds a connection while a more
+/// urgent one waits is asked to yield (shouldYield) so it can pause at a
+/// segment boundary and resume later.  Only as many holders are asked as
+/// the urgent waiters are short of free connections.
+///
+/// With a bandwidth limit set, each registered transfer draws from its own
+/// token bucket.  The limit is split between the active transfers by
+/// priority weight (user-blocking 4, explicit 2, prefetch 1).
+class DownloadScheduler {
+public:
+    DownloadScheduler()=default;
+
+    DownloadScheduler(const DownloadScheduler &)=delete;
+    DownloadScheduler &operator=(const DownloadScheduler &)=delete;
+
+    /// Set the number of connections (at least 1). Waiters are woken if
+    /// the limit grows.
+    void setMaxConnections(int max);
+    int getMaxConnections() const;
+
+    /// Block until a connection is free and no more urgent transfer is
+    /// waiting for one, then take it.
+    void acquire(DownloadPriority priority);
+
+    /// Return a connection taken with acquire().
+    void release();
+
+    /// Connections currently taken.
+    int inUse() const;
+
+    /// True when this holder should hand its connection to a transfer more
+    /// urgent than priority.  A true result claims one of the yields still
+    /// needed, so the caller must release() its connection.  Cheap enough
+    /// to call for every received chunk.
+    bool shouldYield(DownloadPriority priority);
+
+    /// Set the total bandwidth in bytes per second (0 = unlimited).
+    void setBandwidthLimit(int64_t bytesPerSecond);
+    int64_t getBandwidthLimit() const;
+
+    /// Register a transfer for bandwidth accounting.
+    /// @return Id to pass to throttle() and removeTransfer().
+    int addTransfer(DownloadPriority priority);
+
+    /// Change the priority (and so the bandwidth share) of a transfer.
+    void setTransferPriority(int id, DownloadPriority priority);
+
+    void removeTransfer(int id);
+
+    /// Account for bytes just received by a transfer, sleeping as long as
+    /// needed to keep it within its share of the bandwidth limit.
+    void throttle(int id, size_t bytes);
+
+    static std::string priorityToString(DownloadPriority priority);
+
+    /// Parse "user_blocking", "explicit" or "prefetch".
+    static bool parsePriority(const std::string &text, DownloadPriority &priority);
+
+private:
+    struct Bucket {
+        DownloadPriority priority=DownloadPriority::Explicit;
+        double tokens=0.0;
+        std::chrono::steady_clock::time_point refilled;
+    };
+
+    /// Bandwidth weight of a priority class.
+    static double weight(DownloadPriority priority);
+
+    /// Most urgent waiting priority, or -1 when nobody waits.
+    /// NOTE: caller must hold m_mutex
+    int mostUrgentWaiting() const;
+
+    /// NOTE: caller must hold m_mutex
+    void publishMostUrgent();
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    int m_maxConnections=8;
+    int m_inUse=0;
+    std::map<DownloadPriority, int> m_waiting;      // waiters per priority
+    std::atomic<int> m_mostUrgentWaiting{-1};        // mirror of mostUrgentWaiting() for shouldYield
+    std::atomic<int> m_yieldTickets{0};              // holders still to be asked to yield
+    std::atomic<int> m_yielding{0};                  // yields claimed but not yet handed over
+
+    int64_t m_bandwidthLimit=0;
+    int m_nextTransferId=1;
+    std::map<int, Bucket> m_buckets;
+};
+
+} // namespace arbiterAI
+
+#endif//_ARBITERAI_DOWNLOADSCHEDULER_H_
@@ -0,0 +1,390 @@
+#include "arbiterAI/downloadWriter.h"
+
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <filesystem>
+#include <new>
+#include <cstring>
+#include <cerrno>
+
+#ifdef __linux__
+    #include <fcntl.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace arbiterAI
+{
+
+DownloadFile::~DownloadFile()
+{
+    close();
+}
+
+bool DownloadFile::open(const std::string &path, int64_t expectedBytes, bool truncate, const DownloadWriteConfig &config)
+{
+    close();
+    m_path=path;
+    m_preallocate=config.preallocate;
+    m_preallocated=false;
+    setError("");
+
+#ifdef __linux__
+    m_fd=::open(path.c_str(), O_RDWR|O_CREAT|O_CLOEXEC|(truncate?O_TRUNC:0), 0644);
+    if(m_fd<0)
+    {
+        setError("Failed to open "+path+": "+std::strerror(errno));
+        return false;
+    }
+
+    if(config.directIo)
+    {
+        // Some filesystems (tmpfs, some FUSE mounts) refuse O_DIRECT
+        m_directFd=::open(path.c_str(), O_WRONLY|O_DIRECT|O_CLOEXEC);
+        if(m_directFd<0)
+        {
+            spdlog::info("O_DIRECT not available for {} ({}); using buffered writes", path, std::strerror(errno));
+        }
+    }
+#else
+    if(truncate||!std::filesystem::exists(path))
+    {
+        std::ofstream create(path, std::ios::binary|std::ios::trunc);
+    }
+    m_stream.open(path, std::ios::binary|std::ios::in|std::ios::out);
+    if(!m_stream.is_open())
+    {
+        setError("Failed to open "+path);
+        return false;
+    }
+#endif
+
+    return preallocate(expectedBytes);
+}
+
+bool DownloadFile::preallocate(int64_t bytes)
+{
+    if(!m_preallocate||m_preallocated||bytes<=0||!isOpen())
+    {
+        return true;
+    }
+    m_preallocated=true;
+
+#ifdef __linux__
+    // Mode 0 keeps data already in the file, so a resumed download is safe
+    if(::fallocate(m_fd, 0, 0, static_cast<off_t>(bytes))==0)
+    {
+        return true;
+    }
+    if(errno==ENOSPC||errno==EFBIG)
+    {
+        setError("Cannot reserve "+std::to_string(bytes)+" bytes for "+m_path+": "+std::strerror(errno));
+        return false;
+    }
+
+    // Filesystem without fallocate support; writes will allocate as they go
+    spdlog::debug("fallocate unsupported for {}: {}", m_path, std::strerror(errno));
+#endif
+    return true;
+}
+
+bool DownloadFile::writeAt(const char *data, size_t size, int64_t offset)
+{
+#ifdef __linux__
+    bool aligned=reinterpret_cast<uintptr_t>(data)%DIRECT_ALIGNMENT==0&&
+        offset%static_cast<int64_t>(DIRECT_ALIGNMENT)==0&&
+        size%DIRECT_ALIGNMENT==0;
+    int fd=m_directFd>=0&&aligned?m_directFd:m_fd;
+
+    while(size>0)
+    {
+        ssize_t written=::pwrite(fd, data, size, static_cast<off_t>(offset));
+        if(written<0)
+        {
+            if(errno==EINTR)
+            {
+                continue;
+            }
+            if(fd==m_directFd&&errno==EINVAL)
+            {
+                // Alignment rules stricter than expected; write this one buffered
+                fd=m_fd;
+                continue;
+            }
+            setError("Write to "+m_path+" failed: "+std::strerror(errno));
+            return false;
+        }
+        data+=written;
+        size-=static_cast<size_t>(written);
+        offset+=written;
+
+        // A short direct write leaves the rest unaligned
+        fd=m_fd;
+    }
+    return true;
+#else
+    std::lock_guard<std::mutex> lock(m_streamMutex);
+    m_stream.seekp(static_cast<std::streamoff>(offset));
+    m_stream.write(data, static_cast<std::streamsize>(size));
+    if(!m_stream.good())
+    {
+        setError("Write to "+m_path+" failed");
+        return false;
+    }
+    return true;
+#endif
+}
+
+bool DownloadFile::datasync()
+{
+#ifdef __linux__
+    return m_fd>=0&&::fdatasync(m_fd)==0;
+#else
+    std::lock_guard<std::mutex> lock(m_streamMutex);
+    m_stream.flush();
+    return m_stream.good();
+#endif
+}
+
+bool DownloadFile::finish(int64_t finalBytes)
+{
+    if(!isOpen())
+    {
+        return false;
+    }
+
+    bool ok=true;
+#ifdef __linux__
+    struct stat st;
+    if(finalBytes>=0&&(::fstat(m_fd, &st)!=0||st.st_size!=finalBytes))
+    {
+        ok=::ftruncate(m_fd, static_cast<off_t>(finalBytes))==0;
+    }
+
+    // The one sync of the download: everything must be on disk before the
+    // caller renames the file into place
+    if(ok&&::fsync(m_fd)!=0)
+    {
+        ok=false;
+    }
+    if(!ok)
+    {
+        setError("Failed to finish "+m_path+": "+std::strerror(errno));
+    }
+    if(m_directFd>=0)
+    {
+        ::close(m_directFd);
+        m_directFd=-1;
+    }
+    if(::close(m_fd)!=0&&ok)
+    {
+        setError("Failed to close "+m_path+": "+std::strerror(errno));
+        ok=false;
+    }
+    m_fd=-1;
+#else
+    m_stream.close();
+    ok=!m_stream.fail();
+    if(ok&&finalBytes>=0)
+    {
+        std::error_code ec;
+        std::filesystem::resize_file(m_path, static_cast<std::uintmax_t>(finalBytes), ec);
+        ok=!ec;
+    }
+    if(!ok)
+    {
+        setError("Failed to finish "+m_path);
+    }
+#endif
+    return ok;
+}
+
+void DownloadFile::close()
+{
+#ifdef __linux__
+    if(m_directFd>=0)
+    {
+        ::close(m_directFd);
+        m_directFd=-1;
+    }
+    if(m_fd>=0)
+    {
+        ::close(m_fd);
+        m_fd=-1;
+    }
+#else
+    if(m_stream.is_open())
+    {
+        m_stream.close();
+    }
+#endif
+}
+
+bool DownloadFile::isOpen() const
+{
+#ifdef __linux__
+    return m_fd>=0;
+#else
+    return m_stream.is_open();
+#endif
+}
+
+std::string DownloadFile::error() const
+{
+    std::lock_guard<std::mutex> lock(m_errorMutex);
+    return m_error;
+}
+
+void DownloadFile::setError(const std::string &error)
+{
+    std::lock_guard<std::mutex> lock(m_errorMutex);
+    m_error=error;
+}
+
+bool DownloadFile::syncDirectory(const std::string &path)
+{
+#ifdef __linux__
+    int fd=::open(path.c_str(), O_RDONLY|O_DIRECTORY|O_CLOEXEC);
+    if(fd<0)
+    {
+        return false;
+    }
+    bool ok=::fsync(fd)==0;
+    ::close(fd);
+    return ok;
+#else
+    (void)path;
+    return true;
+#endif
+}
+
+void BufferedFileWriter::AlignedDeleter::operator()(char *buffer) const
+{
+    ::operator delete[](buffer, std::align_val_t(DownloadFile::DIRECT_ALIGNMENT));
+}
+
+BufferedFileWriter::BufferedFileWriter(DownloadFile &file, int64_t offset, size_t bufferBytes, std::atomic<int64_t> *published):
+    m_file(file),
+    m_published(published),
+    m_activeOffset(offset),
+    m_offset(offset)
+{
+    // Whole buffers must be a multiple of the O_DIRECT alignment
+    m_bufferBytes=bufferBytes==0?0:
+        (bufferBytes+DownloadFile::DIRECT_ALIGNMENT-1)/DownloadFile::DIRECT_ALIGNMENT*DownloadFile::DIRECT_ALIGNMENT;
+}
+
+BufferedFileWriter::~BufferedFileWriter()
+{
+    flush();
+}
+
+bool BufferedFileWriter::write(const char *data, size_t size)
+{
+    if(m_failed)
+    {
+        return false;
+    }
+
+    if(m_bufferBytes==0)
+    {
+        if(!m_file.writeAt(data, size, m_offset))
+        {
+            m_failed=true;
+            return false;
+        }
+        m_offset+=static_cast<int64_t>(size);
+        m_activeOffset=m_offset;
+        if(m_published)
+        {
+            *m_published=m_offset;
+        }
+        return true;
+    }
+
+    while(size>0)
+    {
+        // Buffers are allocated on first use so idle segments hold no memory
+        if(!m_buffers[m_active])
+        {
+            m_buffers[m_active]=Buffer(static_cast<char *>(::operator new[](m_bufferBytes, std::align_val_t(DownloadFile::DIRECT_ALIGNMENT))));
+        }
+
+        size_t capacity=activeCapacity();
+        size_t count=std::min(size, capacity-m_used);
+        std::memcpy(m_buffers[m_active].get()+m_used, data, count);
+        m_used+=count;
+        m_offset+=static_cast<int64_t>(count);
+        data+=count;
+        size-=count;
+
+        if(m_used==capacity&&!submit())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool BufferedFileWriter::flush()
+{
+    if(m_bufferBytes==0)
+    {
+        return !m_failed;
+    }
+    bool submitted=submit();
+    return waitPending()&&submitted;
+}
+
+bool BufferedFileWriter::submit()
+{
+    if(m_used==0)
+    {
+        return !m_failed;
+    }
+
+    // The other buffer must be written out before it can be refilled
+    if(!waitPending())
+    {
+        return false;
+    }
+
+    const char *data=m_buffers[m_active].get();
+    size_t size=m_used;
+    int64_t offset=m_activeOffset;
+    DownloadFile &file=m_file;
+    m_pending=std::async(std::launch::async, [&file, data, size, offset]()
+    {
+        return file.writeAt(data, size, offset);
+    });
+    m_pendingEnd=offset+static_cast<int64_t>(size);
+
+    m_active^=1;
+    m_activeOffset+=static_cast<int64_t>(size);
+    m_used=0;
+    return true;
+}
+
+bool BufferedFileWriter::waitPending()
+{
+    if(m_pending.valid())
+    {
+        if(!m_pending.get())
+        {
+            m_failed=true;
+        }
+        else if(m_published)
+        {
+            *m_published=m_pendingEnd;
+        }
+    }
+    return !m_failed;
+}
+
+size_t BufferedFileWriter::activeCapacity() const
+{
+    size_t misalignment=static_cast<size_t>(m_activeOffset%static_cast<int64_t>(DownloadFile::DIRECT_ALIGNMENT));
+    return m_bufferBytes-misalignment;
+}
+
+} // namespace arbiterAI
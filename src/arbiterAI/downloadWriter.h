@@ -0,0 +1,159 @@
+#ifndef _ARBITERAI_DOWNLOADWRITER_H_
+#define _ARBITERAI_DOWNLOADWRITER_H_
+
+#include <string>
+#include <future>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+#ifndef __linux__
+    #include <fstream>
+#endif
+
+namespace arbiterAI
+{
+
+/// How downloads are written to disk.
+struct DownloadWriteConfig {
+    size_t bufferBytes=4*1024*1024;    // per buffer, two per stream/segment; 0 = write every chunk as it arrives
+    bool preallocate=true;              // fallocate() the full size when it is known
+    bool directIo=false;                // write whole aligned buffers with O_DIRECT, bypassing the page cache
+};
+
+/// A partial download file written at explicit offsets, possibly by several
+/// segment threads at once.
+///
+/// The full size is reserved up front with fallocate() when known, so the
+/// filesystem can place the file in few large extents instead of growing it
+/// chunk by chunk; a fragmented GGUF is slower to mmap later.  Nothing is
+/// forced to disk until finish(), which fsyncs once before the caller
+/// renames the file into place.
+class DownloadFile {
+public:
+    /// Offset and size alignment needed for O_DIRECT writes.
+    static constexpr size_t DIRECT_ALIGNMENT=4096;
+
+    DownloadFile()=default;
+    ~DownloadFile();
+
+    DownloadFile(const DownloadFile &)=delete;
+    DownloadFile &operator=(const DownloadFile &)=delete;
+
+    /// Open (creating if needed) the file.
+    /// @param expectedBytes  Final size if known (0 = unknown); reserved when
+    ///                       config.preallocate is set.
+    /// @param truncate       Discard existing contents; otherwise they are
+    ///                       kept so a download can resume.
+    bool open(const std::string &path, int64_t expectedBytes, bool truncate, const DownloadWriteConfig &config);
+
+    /// Reserve space for bytes, e.g. once a single stream learns its length.
+    /// Does nothing if preallocation is off or already done.
+    bool preallocate(int64_t bytes);
+
+    /// Write all of size bytes at offset.  Aligned writes go through O_DIRECT
+    /// when enabled.  Thread-safe.
+    bool writeAt(const char *data, size_t size, int64_t offset);
+
+    /// Flush written data (not metadata), e.g. before saving a checkpoint.
+    bool datasync();
+
+    /// Trim the file to finalBytes (if >=0), fsync and close it.
+    bool finish(int64_t finalBytes);
+
+    /// Close without syncing, e.g. after a failed download.
+    void close();
+
+    bool isOpen() const;
+    const std::string &path() const { return m_path; }
+    bool directIo() const { return m_directFd>=0; }
+
+    /// Descriptor for reading back written data (Linux only, else -1).
+    int fd() const { return m_fd; }
+
+    /// Why the last failed call failed.
+    std::string error() const;
+
+    /// fsync a directory so a rename into it survives a crash.
+    static bool syncDirectory(const std::string &path);
+
+private:
+    void setError(const std::string &error);
+
+    std::string m_path;
+    int m_fd=-1;
+    int m_directFd=-1;
+    bool m_preallocate=true;
+    bool m_preallocated=false;
+
+    mutable std::mutex m_errorMutex;
+    std::string m_error;
+
+#ifndef __linux__
+    std::mutex m_streamMutex;
+    std::fstream m_stream;
+#endif
+};
+
+/// Sequential writer into a DownloadFile from a start offset.
+///
+/// Incoming chunks (often only 16 KB each) are gathered in one buffer while
+/// the other is written out on a background task, so the network thread
+/// rarely waits for the disk and the file sees a few large writes instead of
+/// thousands of small ones.  Buffers end on DIRECT_ALIGNMENT boundaries so
+/// whole buffers qualify for O_DIRECT.
+class BufferedFileWriter {
+public:
+    /// @param published  Optional; set to the offset up to which data has
+    ///                   been handed to the file, e.g. for checkpoints and
+    ///                   hashing that read the file back.
+    BufferedFileWriter(DownloadFile &file, int64_t offset, size_t bufferBytes, std::atomic<int64_t> *published=nullptr);
+    ~BufferedFileWriter();
+
+    BufferedFileWriter(const BufferedFileWriter &)=delete;
+    BufferedFileWriter &operator=(const BufferedFileWriter &)=delete;
+
+    /// Append data.  Returns false once any write has failed.
+    bool write(const char *data, size_t size);
+
+    /// Write out everything appended so far and wait for it.
+    bool flush();
+
+    /// Offset the next appended byte goes to.
+    int64_t offset() const { return m_offset; }
+
+private:
+    struct AlignedDeleter {
+        void operator()(char *buffer) const;
+    };
+    using Buffer=std::unique_ptr<char, AlignedDeleter>;
+
+    /// Hand the active buffer to a background write and switch buffers.
+    bool submit();
+
+    /// Wait for the background write, if any.
+    bool waitPending();
+
+    /// Capacity of the active buffer: short the first time so later buffers
+    /// start aligned.
+    size_t activeCapacity() const;
+
+    DownloadFile &m_file;
+    size_t m_bufferBytes;
+    std::atomic<int64_t> *m_published;
+
+    Buffer m_buffers[2];
+    int m_active=0;
+    size_t m_used=0;
+    int64_t m_activeOffset;             // file offset of the active buffer
+    int64_t m_offset;                   // next byte to append
+    std::future<bool> m_pending;
+    int64_t m_pendingEnd=0;
+    bool m_failed=false;
+};
+
+} // namespace arbiterAI
+
+#endif//_ARBITERAI_DOWNLOADWRITER_H_
@@ -1,24 +1,186 @@
 #include "arbiterAI/fileVerifier.h"
-#include <picosha2.h>
+#include <openssl/evp.h>
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
 #include <fstream>
+#include <memory>
 #include <vector>
 
+#ifdef __linux__
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
 namespace arbiterAI
 {
 
+namespace
+{
+
+/// Read size for standalone hashing. Large enough to amortize syscalls and
+/// keep readahead busy; memory use stays the same whatever the file size.
+constexpr size_t HASH_CHUNK_BYTES=8*1024*1024;
+
+/// Buffer alignment; matches the page size so the same buffer works for
+/// direct I/O.
+constexpr size_t HASH_CHUNK_ALIGNMENT=4096;
+
+void logThroughput(const std::string &filePath, int64_t bytes, std::chrono::steady_clock::time_point start)
+{
+    double seconds=std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+    double mb=static_cast<double>(bytes)/(1024.0*1024.0);
+    spdlog::info("SHA-256 of {}: {:.0f} MB in {:.2f}s ({:.0f} MB/s)",
+        filePath, mb, seconds, seconds>0.0?mb/seconds:0.0);
+}
+
+} // anonymous namespace
+
+Sha256Hasher::Sha256Hasher():
+    m_context(EVP_MD_CTX_new())
+{
+    reset();
+}
+
+Sha256Hasher::~Sha256Hasher()
+{
+    EVP_MD_CTX_free(m_context);
+}
+
+void Sha256Hasher::reset()
+{
+    m_bytesHashed=0;
+    m_failed=m_context==nullptr||EVP_DigestInit_ex(m_context, EVP_sha256(), nullptr)!=1;
+}
+
+void Sha256Hasher::update(const void *data, size_t size)
+{
+    if(m_failed)
+    {
+        return;
+    }
+    if(EVP_DigestUpdate(m_context, data, size)!=1)
+    {
+        m_failed=true;
+        return;
+    }
+    m_bytesHashed+=static_cast<int64_t>(size);
+}
+
+std::string Sha256Hasher::finalizeHex()
+{
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int length=0;
+
+    bool ok=!m_failed&&EVP_DigestFinal_ex(m_context, digest, &length)==1;
+    reset();
+    if(!ok)
+    {
+        return "";
+    }
+
+    static const char hexDigits[]="0123456789abcdef";
+    std::string hex;
+    hex.reserve(length*2);
+    for(unsigned int i=0; i<length; ++i)
+    {
+        hex.push_back(hexDigits[digest[i]>>4]);
+        hex.push_back(hexDigits[digest[i]&0x0f]);
+    }
+    return hex;
+}
+
 bool FileVerifier::verifyFile(const std::string &filePath, const std::string &expectedHash)
 {
+    std::optional<std::string> hash=hashFile(filePath);
+    return hash.has_value()&&hashesMatch(*hash, expectedHash);
+}
+
+bool FileVerifier::verifyComputedHash(const std::string &filePath, const std::string &computedHash, const std::string &expectedHash)
+{
+    (void)filePath;
+    return !computedHash.empty()&&hashesMatch(computedHash, expectedHash);
+}
+
+std::optional<std::string> FileVerifier::hashFile(const std::string &filePath)
+{
+    Sha256Hasher hasher;
+    std::chrono::steady_clock::time_point start=std::chrono::steady_clock::now();
+
+#ifdef __linux__
+    int fd=::open(filePath.c_str(), O_RDONLY|O_CLOEXEC);
+    if(fd<0)
+    {
+        return std::nullopt;
+    }
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    void *memory=nullptr;
+    if(::posix_memalign(&memory, HASH_CHUNK_ALIGNMENT, HASH_CHUNK_BYTES)!=0)
+    {
+        ::close(fd);
+        return std::nullopt;
+    }
+    std::unique_ptr<char, decltype(&std::free)> buffer(static_cast<char *>(memory), &std::free);
+
+    while(true)
+    {
+        ssize_t bytesRead=::read(fd, buffer.get(), HASH_CHUNK_BYTES);
+        if(bytesRead<0)
+        {
+            if(errno==EINTR)
+            {
+                continue;
+            }
+            ::close(fd);
+            return std::nullopt;
+        }
+        if(bytesRead==0)
+        {
+            break;
+        }
+        hasher.update(buffer.get(), static_cast<size_t>(bytesRead));
+    }
+    ::close(fd);
+#else
     std::ifstream file(filePath, std::ios::binary);
-    if (!file.is_open())
+    if(!file.is_open())
     {
-        return false;
+        return std::nullopt;
     }
 
-    std::vector<unsigned char> buffer(std::istreambuf_iterator<char>(file), {});
-    std::string hash_hex_str;
-    picosha2::hash256_hex_string(buffer, hash_hex_str);
+    std::vector<char> buffer(HASH_CHUNK_BYTES);
+    while(file)
+    {
+        file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        hasher.update(buffer.data(), static_cast<size_t>(file.gcount()));
+    }
+    if(file.bad())
+    {
+        return std::nullopt;
+    }
+#endif
 
-    return hash_hex_str == expectedHash;
+    int64_t bytes=hasher.bytesHashed();
+    std::string hex=hasher.finalizeHex();
+    if(hex.empty())
+    {
+        return std::nullopt;
+    }
+
+    logThroughput(filePath, bytes, start);
+    return hex;
+}
+
+bool FileVerifier::hashesMatch(const std::string &a, const std::string &b)
+{
+    return a.size()==b.size()&&std::equal(a.begin(), a.end(), b.begin(), [](char x, char y)
+    {
+        return std::tolower(static_cast<unsigned char>(x))==std::tolower(static_cast<unsigned char>(y));
+    });
 }
 
-} // namespace arbiterAI
\ No newline at end of file
+} // namespace arbiterAI
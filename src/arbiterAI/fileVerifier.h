@@ -2,23 +2,79 @@
 #define _arbiterAI_fileVerifier_h_
 
 #include <string>
+#include <optional>
+#include <cstddef>
+#include <cstdint>
+
+struct evp_md_ctx_st;
 
 namespace arbiterAI
 {
 
+/**
+ * @class Sha256Hasher
+ * @brief Incremental SHA-256 over OpenSSL EVP
+ *
+ * EVP picks the CPU's SHA extensions when available, so hashing keeps up
+ * with fast disks and networks.
+ */
+class Sha256Hasher
+{
+public:
+    Sha256Hasher();
+    ~Sha256Hasher();
+
+    Sha256Hasher(const Sha256Hasher &)=delete;
+    Sha256Hasher &operator=(const Sha256Hasher &)=delete;
+
+    /// Feed the next bytes of the message.
+    void update(const void *data, size_t size);
+
+    /// Finish and return the lowercase hex digest ("" on failure).
+    /// The hasher is reset for a new message afterwards.
+    std::string finalizeHex();
+
+    /// Start over with an empty message.
+    void reset();
+
+    /// Bytes fed since the last reset.
+    int64_t bytesHashed() const { return m_bytesHashed; }
+
+private:
+    evp_md_ctx_st *m_context;
+    int64_t m_bytesHashed=0;
+    bool m_failed=false;
+};
+
 class IFileVerifier
 {
 public:
     virtual ~IFileVerifier() = default;
     virtual bool verifyFile(const std::string &filePath, const std::string &expectedHash) = 0;
+
+    /// Verify a file whose hash was computed while it was written. Verifiers
+    /// that can't trust computedHash re-check the file instead.
+    virtual bool verifyComputedHash(const std::string &filePath, const std::string &computedHash, const std::string &expectedHash)
+    {
+        (void)computedHash;
+        return verifyFile(filePath, expectedHash);
+    }
 };
 
 class FileVerifier : public IFileVerifier
 {
 public:
     bool verifyFile(const std::string &filePath, const std::string &expectedHash) override;
+    bool verifyComputedHash(const std::string &filePath, const std::string &computedHash, const std::string &expectedHash) override;
+
+    /// SHA-256 of a file, streamed in large aligned chunks with constant memory.
+    /// Returns nullopt if the file can't be read.
+    static std::optional<std::string> hashFile(const std::string &filePath);
+
+    /// Compare hex digests ignoring case.
+    static bool hashesMatch(const std::string &a, const std::string &b);
 };
 
 } // namespace arbiterAI
 
-#endif // _arbiterAI_fileVerifier_h_
\ No newline at end of file
+#endif // _arbiterAI_fileVerifier_h_
@@ -0,0 +1,519 @@
+#include "arbiterAI/ggufReader.h"
+
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <fstream>
+#include <cstring>
+
+namespace arbiterAI
+{
+
+// GGUF metadata value types
+enum GgufValueType : uint32_t {
+    GGUF_VALUE_UINT8=0,
+    GGUF_VALUE_INT8=1,
+    GGUF_VALUE_UINT16=2,
+    GGUF_VALUE_INT16=3,
+    GGUF_VALUE_UINT32=4,
+    GGUF_VALUE_INT32=5,
+    GGUF_VALUE_FLOAT32=6,
+    GGUF_VALUE_BOOL=7,
+    GGUF_VALUE_STRING=8,
+    GGUF_VALUE_ARRAY=9,
+    GGUF_VALUE_UINT64=10,
+    GGUF_VALUE_INT64=11,
+    GGUF_VALUE_FLOAT64=12
+};
+
+/// Sanity limits so a corrupt header cannot trigger huge allocations.
+static constexpr uint64_t MAX_GGUF_STRING=16*1024*1024;
+static constexpr uint64_t MAX_GGUF_TENSORS=1000000;
+static constexpr uint64_t MAX_GGUF_DIMS=8;
+static constexpr uint64_t MAX_CAPTURED_ARRAY=65536;
+
+/// Metadata values the reader keeps; everything else is skipped.
+struct GgufValues {
+    std::map<std::string, int64_t> ints;
+    std::map<std::string, std::string> strings;
+    std::map<std::string, std::vector<int64_t>> arrays;
+};
+
+template<typename T>
+static bool readPod(std::ifstream &file, T &value)
+{
+    file.read(reinterpret_cast<char *>(&value), sizeof(T));
+    return static_cast<bool>(file);
+}
+
+static bool readString(std::ifstream &file, std::string &value)
+{
+    uint64_t length=0;
+    if(!readPod(file, length)||length>MAX_GGUF_STRING)
+    {
+        return false;
+    }
+    value.resize(length);
+    file.read(value.data(), static_cast<std::streamsize>(length));
+    return static_cast<bool>(file);
+}
+
+static size_t scalarSize(uint32_t type)
+{
+    switch(type)
+    {
+        case GGUF_VALUE_UINT8:
+        case GGUF_VALUE_INT8:
+        case GGUF_VALUE_BOOL:    return 1;
+        case GGUF_VALUE_UINT16:
+        case GGUF_VALUE_INT16:   return 2;
+        case GGUF_VALUE_UINT32:
+        case GGUF_VALUE_INT32:
+        case GGUF_VALUE_FLOAT32: return 4;
+        case GGUF_VALUE_UINT64:
+        case GGUF_VALUE_INT64:
+        case GGUF_VALUE_FLOAT64: return 8;
+        default:                 return 0;
+    }
+}
+
+/// Read an integer-like scalar (floats are truncated).
+static bool readScalar(std::ifstream &file, uint32_t type, int64_t &value)
+{
+    switch(type)
+    {
+        case GGUF_VALUE_UINT8:  { uint8_t v;  if(!readPod(file, v)) return false; value=v; return true; }
+        case GGUF_VALUE_INT8:   { int8_t v;   if(!readPod(file, v)) return false; value=v; return true; }
+        case GGUF_VALUE_BOOL:   { uint8_t v;  if(!readPod(file, v)) return false; value=v!=0; return true; }
+        case GGUF_VALUE_UINT16: { uint16_t v; if(!readPod(file, v)) return false; value=v; return true; }
+        case GGUF_VALUE_INT16:  { int16_t v;  if(!readPod(file, v)) return false; value=v; return true; }
+        case GGUF_VALUE_UINT32: { uint32_t v; if(!readPod(file, v)) return false; value=v; return true; }
+        case GGUF_VALUE_INT32:  { int32_t v;  if(!readPod(file, v)) return false; value=v; return true; }
+        case GGUF_VALUE_UINT64: { uint64_t v; if(!readPod(file, v)) return false; value=static_cast<int64_t>(v); return true; }
+        case GGUF_VALUE_INT64:  { int64_t v;  if(!readPod(file, v)) return false; value=v; return true; }
+        case GGUF_VALUE_FLOAT32:{ float v;    if(!readPod(file, v)) return false; value=static_cast<int64_t>(v); return true; }
+        case GGUF_VALUE_FLOAT64:{ double v;   if(!readPod(file, v)) return false; value=static_cast<int64_t>(v); return true; }
+        default:                return false;
+    }
+}
+
+static bool readValue(std::ifstream &file, const std::string &key, uint32_t type, GgufValues &values)
+{
+    if(type==GGUF_VALUE_STRING)
+    {
+        std::string value;
+        if(!readString(file, value))
+        {
+            return false;
+        }
+        values.strings[key]=value;
+        return true;
+    }
+
+    if(type==GGUF_VALUE_ARRAY)
+    {
+        uint32_t itemType=0;
+        uint64_t count=0;
+        if(!readPod(file, itemType)||!readPod(file, count))
+        {
+            return false;
+        }
+
+        if(itemType==GGUF_VALUE_STRING)
+        {
+            // Vocabularies — skip item by item
+            std::string skipped;
+            for(uint64_t i=0; i<count; ++i)
+            {
+                if(!readString(file, skipped))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        size_t itemSize=scalarSize(itemType);
+        if(itemSize==0)
+        {
+            return false; // nested arrays are not used by llama.cpp models
+        }
+
+        if(count>MAX_CAPTURED_ARRAY)
+        {
+            file.seekg(static_cast<std::streamoff>(count*itemSize), std::ios::cur);
+            return static_cast<bool>(file);
+        }
+
+        std::vector<int64_t> items(count);
+        for(uint64_t i=0; i<count; ++i)
+        {
+            if(!readScalar(file, itemType, items[i]))
+            {
+                return false;
+            }
+        }
+        values.arrays[key]=std::move(items);
+        return true;
+    }
+
+    int64_t value=0;
+    if(!readScalar(file, type, value))
+    {
+        return false;
+    }
+    values.ints[key]=value;
+    return true;
+}
+
+static int64_t intValue(const GgufValues &values, const std::string &key, int64_t fallback=0)
+{
+    auto it=values.ints.find(key);
+    if(it!=values.ints.end())
+    {
+        return it->second;
+    }
+
+    // Some per-layer keys are stored as arrays when every layer has the same value
+    auto arrIt=values.arrays.find(key);
+    if(arrIt!=values.arrays.end()&&!arrIt->second.empty())
+    {
+        return *std::max_element(arrIt->second.begin(), arrIt->second.end());
+    }
+    return fallback;
+}
+
+static bool isExpertTensor(const std::string &name)
+{
+    return name.find("_exps")!=std::string::npos;
+}
+
+/// Parse one file.  When hyperparams is false only tensors are collected.
+static bool readGgufFile(const std::string &path, GgufModelInfo &info, bool hyperparams)
+{
+    std::ifstream file(path, std::ios::binary);
+    if(!file.is_open())
+    {
+        return false;
+    }
+
+    char magic[4];
+    file.read(magic, 4);
+    if(!file||std::memcmp(magic, "GGUF", 4)!=0)
+    {
+        spdlog::debug("Not a GGUF file: {}", path);
+        return false;
+    }
+
+    uint32_t version=0;
+    uint64_t tensorCount=0;
+    uint64_t kvCount=0;
+    if(!readPod(file, version)||!readPod(file, tensorCount)||!readPod(file, kvCount))
+    {
+        return false;
+    }
+    if(version<2||tensorCount>MAX_GGUF_TENSORS)
+    {
+        spdlog::warn("Unsupported GGUF header in {} (version={}, tensors={})", path, version, tensorCount);
+        return false;
+    }
+
+    GgufValues values;
+    for(uint64_t i=0; i<kvCount; ++i)
+    {
+        std::string key;
+        uint32_t type=0;
+        if(!readString(file, key)||!readPod(file, type)||!readValue(file, key, type, values))
+        {
+            spdlog::warn("Truncated GGUF metadata in {}", path);
+            return false;
+        }
+    }
+
+    std::vector<GgufTensorInfo> tensors;
+    tensors.reserve(tensorCount);
+    for(uint64_t i=0; i<tensorCount; ++i)
+    {
+        GgufTensorInfo tensor;
+        uint32_t nDims=0;
+        if(!readString(file, tensor.name)||!readPod(file, nDims)||nDims>MAX_GGUF_DIMS)
+        {
+            return false;
+        }
+        tensor.dims.resize(nDims);
+        for(uint32_t d=0; d<nDims; ++d)
+        {
+            uint64_t dim=0;
+            if(!readPod(file, dim))
+            {
+                return false;
+            }
+            tensor.dims[d]=static_cast<int64_t>(dim);
+        }
+        if(!readPod(file, tensor.type)||!readPod(file, tensor.offset))
+        {
+            return false;
+        }
+        tensors.push_back(std::move(tensor));
+    }
+
+    // Tensor data starts at the next alignment boundary; each tensor's size is
+    // the distance to the next one (the last runs to the end of the file)
+    int64_t alignment=intValue(values, "general.alignment", 32);
+    if(alignment<=0)
+    {
+        alignment=32;
+    }
+    int64_t headerEnd=static_cast<int64_t>(file.tellg());
+    int64_t dataStart=(headerEnd+alignment-1)/alignment*alignment;
+
+    std::error_code ec;
+    int64_t fileSize=static_cast<int64_t>(std::filesystem::file_size(path, ec));
+    if(ec)
+    {
+        return false;
+    }
+    int64_t dataSize=std::max<int64_t>(0, fileSize-dataStart);
+
+    std::vector<size_t> order(tensors.size());
+    for(size_t i=0; i<order.size(); ++i)
+    {
+        order[i]=i;
+    }
+    std::sort(order.begin(), order.end(),
+        [&tensors](size_t a, size_t b)
+        {
+            return tensors[a].offset<tensors[b].offset;
+        });
+
+    for(size_t i=0; i<order.size(); ++i)
+    {
+        GgufTensorInfo &tensor=tensors[order[i]];
+        int64_t end=i+1<order.size()?static_cast<int64_t>(tensors[order[i+1]].offset):dataSize;
+        tensor.sizeBytes=std::max<int64_t>(0, end-static_cast<int64_t>(tensor.offset));
+
+        info.weightBytes+=tensor.sizeBytes;
+        if(isExpertTensor(tensor.name))
+        {
+            info.expertWeightBytes+=tensor.sizeBytes;
+        }
+    }
+    info.tensors.insert(info.tensors.end(), tensors.begin(), tensors.end());
+
+    if(!hyperparams)
+    {
+        return true;
+    }
+
+    auto stringIt=values.strings.find("general.architecture");
+    info.architecture=stringIt!=values.strings.end()?stringIt->second:"";
+    const std::string prefix=info.architecture+".";
+
+    info.nLayer=static_cast<int>(intValue(values, prefix+"block_count"));
+    info.nEmbd=static_cast<int>(intValue(values, prefix+"embedding_length"));
+    info.nHead=static_cast<int>(intValue(values, prefix+"attention.head_count"));
+    info.nHeadKv=static_cast<int>(intValue(values, prefix+"attention.head_count_kv", info.nHead));
+    info.contextLength=static_cast<int>(intValue(values, prefix+"context_length"));
+    info.expertCount=static_cast<int>(intValue(values, prefix+"expert_count"));
+    info.expertUsedCount=static_cast<int>(intValue(values, prefix+"expert_used_count"));
+    info.slidingWindow=static_cast<int>(intValue(values, prefix+"attention.sliding_window"));
+
+    int defaultHeadDim=info.nHead>0?info.nEmbd/info.nHead:0;
+    info.headDimK=static_cast<int>(intValue(values, prefix+"attention.key_length", defaultHeadDim));
+    info.headDimV=static_cast<int>(intValue(values, prefix+"attention.value_length", defaultHeadDim));
+
+    auto kvArrIt=values.arrays.find(prefix+"attention.head_count_kv");
+    if(kvArrIt!=values.arrays.end())
+    {
+        for(int64_t heads:kvArrIt->second)
+        {
+            info.nHeadKvPerLayer.push_back(static_cast<int>(heads));
+        }
+    }
+
+    // Sliding-window layout: explicit per-layer flags, a repeating pattern
+    // (every Nth layer is full attention), or gemma2's alternating layers
+    if(info.slidingWindow>0&&info.nLayer>0)
+    {
+        const std::string patternKey=prefix+"attention.sliding_window_pattern";
+        auto patternArrIt=values.arrays.find(patternKey);
+        auto patternIt=values.ints.find(patternKey);
+
+        if(patternArrIt!=values.arrays.end())
+        {
+            for(int64_t flag:patternArrIt->second)
+            {
+                info.swaLayers.push_back(flag!=0);
+            }
+        }
+        else
+        {
+            int pattern=patternIt!=values.ints.end()?static_cast<int>(patternIt->second):0;
+            if(pattern==0&&info.architecture=="gemma2")
+            {
+                pattern=2;
+            }
+            if(pattern>1)
+            {
+                for(int il=0; il<info.nLayer; ++il)
+                {
+                    info.swaLayers.push_back(il%pattern<pattern-1);
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+int GgufModelInfo::headCountKv(int layer) const
+{
+    if(layer>=0&&layer<static_cast<int>(nHeadKvPerLayer.size()))
+    {
+        return nHeadKvPerLayer[layer];
+    }
+    return nHeadKv;
+}
+
+double GgufModelInfo::kvBytesPerToken(double bytesPerElement) const
+{
+    double bytes=0.0;
+    for(int il=0; il<nLayer; ++il)
+    {
+        bytes+=static_cast<double>(headCountKv(il))*(headDimK+headDimV)*bytesPerElement;
+    }
+    return bytes;
+}
+
+int64_t GgufModelInfo::kvCacheBytes(int contextSize, double bytesPerElement, bool swaFull) const
+{
+    int64_t bytes=0;
+    for(int il=0; il<nLayer; ++il)
+    {
+        bytes+=layerKvCacheBytes(il, contextSize, bytesPerElement, swaFull);
+    }
+    return bytes;
+}
+
+int64_t GgufModelInfo::layerKvCacheBytes(int layer, int contextSize, double bytesPerElement, bool swaFull) const
+{
+    bool swa=!swaFull&&layer<static_cast<int>(swaLayers.size())&&swaLayers[layer];
+    int tokens=swa?std::min(contextSize, slidingWindow):contextSize;
+    return static_cast<int64_t>(static_cast<double>(tokens)*headCountKv(layer)*(headDimK+headDimV)*bytesPerElement);
+}
+
+bool GgufReader::read(const std::string &path, GgufModelInfo &info)
+{
+    info=GgufModelInfo{};
+    return readGgufFile(path, info, true);
+}
+
+bool GgufReader::readFiles(const std::vector<std::string> &paths, GgufModelInfo &info)
+{
+    info=GgufModelInfo{};
+    if(paths.empty())
+    {
+        return false;
+    }
+
+    for(size_t i=0; i<paths.size(); ++i)
+    {
+        if(!readGgufFile(paths[i], info, i==0))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+GgufMetadataCache &GgufMetadataCache::instance()
+{
+    static GgufMetadataCache cache;
+    return cache;
+}
+
+void GgufMetadataCache::reset()
+{
+    GgufMetadataCache &cache=instance();
+    std::lock_guard<std::mutex> lock(cache.m_mutex);
+    cache.m_entries.clear();
+    cache.m_modelsDir.clear();
+}
+
+void GgufMetadataCache::setModelsDir(const std::filesystem::path &dir)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if(m_modelsDir!=dir)
+    {
+        m_modelsDir=dir;
+        m_entries.clear();
+    }
+}
+
+std::optional<GgufModelInfo> GgufMetadataCache::get(const ModelVariant &variant)
+{
+    std::vector<std::string> paths;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if(m_modelsDir.empty())
+        {
+            return std::nullopt;
+        }
+        for(const VariantDownload &file:variant.getAllFiles())
+        {
+            if(!file.filename.empty())
+            {
+                paths.push_back((m_modelsDir/file.filename).string());
+            }
+        }
+    }
+    return get(paths);
+}
+
+std::optional<GgufModelInfo> GgufMetadataCache::get(const std::vector<std::string> &paths)
+{
+    if(paths.empty())
+    {
+        return std::nullopt;
+    }
+
+    std::error_code ec;
+    int64_t fileSize=static_cast<int64_t>(std::filesystem::file_size(paths.front(), ec));
+    if(ec)
+    {
+        return std::nullopt;
+    }
+    std::filesystem::file_time_type mtime=std::filesystem::last_write_time(paths.front(), ec);
+    if(ec)
+    {
+        return std::nullopt;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it=m_entries.find(paths.front());
+        if(it!=m_entries.end()&&it->second.fileSize==fileSize&&it->second.mtime==mtime)
+        {
+            return it->second.info;
+        }
+    }
+
+    // Parse outside the lock; headers of large models take a few milliseconds
+    CacheEntry entry;
+    entry.fileSize=fileSize;
+    entry.mtime=mtime;
+    if(!GgufReader::readFiles(paths, entry.info))
+    {
+        return std::nullopt;
+    }
+
+    spdlog::debug("GGUF header {}: arch={} layers={} kv_heads={} head_dim={}/{} swa={} experts={} weights={}MB",
+        paths.front(), entry.info.architecture, entry.info.nLayer, entry.info.nHeadKv,
+        entry.info.headDimK, entry.info.headDimV, entry.info.slidingWindow, entry.info.expertCount,
+        entry.info.weightBytes/(1024*1024));
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries[paths.front()]=entry;
+    return entry.info;
+}
+
+} // namespace arbiterAI
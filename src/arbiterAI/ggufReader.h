@@ -0,0 +1,105 @@
+#ifndef _ARBITERAI_GGUFREADER_H_
+#define _ARBITERAI_GGUFREADER_H_
+
+#include "arbiterAI/modelManager.h"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <cstdint>
+#include <filesystem>
+
+namespace arbiterAI
+{
+
+struct GgufTensorInfo {
+    std::string name;
+    uint32_t type=0;            // ggml_type id
+    std::vector<int64_t> dims;
+    uint64_t offset=0;          // relative to the start of the tensor data section
+    int64_t sizeBytes=0;        // derived from the distance to the next tensor
+};
+
+/// Model dimensions and tensor sizes read from a GGUF header without loading
+/// the weights.  For split models, tensors and byte totals cover every shard.
+struct GgufModelInfo {
+    std::string architecture;
+    int nLayer=0;
+    int nEmbd=0;
+    int nHead=0;
+    int nHeadKv=0;
+    std::vector<int> nHeadKvPerLayer;   // set when head_count_kv is stored per layer
+    int headDimK=0;                     // attention.key_length (default n_embd/n_head)
+    int headDimV=0;                     // attention.value_length (default n_embd/n_head)
+    int contextLength=0;
+    int slidingWindow=0;                // 0 = no sliding-window attention
+    std::vector<bool> swaLayers;        // per layer: true = sliding-window attention
+    int expertCount=0;
+    int expertUsedCount=0;
+    int64_t weightBytes=0;              // all tensors
+    int64_t expertWeightBytes=0;        // MoE expert tensors (*_exps)
+    std::vector<GgufTensorInfo> tensors;
+
+    /// KV cache bytes for one token on full-attention layers.
+    double kvBytesPerToken(double bytesPerElement) const;
+
+    /// KV cache bytes for a context.  Sliding-window layers hold at most
+    /// slidingWindow tokens unless swaFull is set.
+    int64_t kvCacheBytes(int contextSize, double bytesPerElement, bool swaFull=false) const;
+
+    /// KV cache bytes a single layer holds for a context.
+    int64_t layerKvCacheBytes(int layer, int contextSize, double bytesPerElement, bool swaFull=false) const;
+
+    /// Number of KV heads on a layer.
+    int headCountKv(int layer) const;
+};
+
+class GgufReader {
+public:
+    /// Parse the header and tensor table of a single GGUF file.
+    /// @return false if the file is missing or not a valid GGUF file.
+    static bool read(const std::string &path, GgufModelInfo &info);
+
+    /// Parse a (possibly split) model.  Hyperparameters come from the first
+    /// file; tensors and byte totals are summed across all files.
+    static bool readFiles(const std::vector<std::string> &paths, GgufModelInfo &info);
+};
+
+/// Parsed GGUF headers for downloaded variants, keyed by primary file path
+/// and re-read when the file's size or mtime changes.
+class GgufMetadataCache {
+public:
+    static GgufMetadataCache &instance();
+    static void reset(); // For testing
+
+    /// Set the directory variant files are resolved against.
+    void setModelsDir(const std::filesystem::path &dir);
+
+    /// Get header info for a variant whose files are on disk.
+    std::optional<GgufModelInfo> get(const ModelVariant &variant);
+
+    /// Get header info for a set of GGUF files (primary shard first).
+    std::optional<GgufModelInfo> get(const std::vector<std::string> &paths);
+
+private:
+    GgufMetadataCache()=default;
+
+    GgufMetadataCache(const GgufMetadataCache &)=delete;
+    GgufMetadataCache &operator=(const GgufMetadataCache &)=delete;
+
+    struct CacheEntry {
+        int64_t fileSize=0;
+        std::filesystem::file_time_type mtime;
+        GgufModelInfo info;
+    };
+
+    mutable std::mutex m_mutex;
+    std::filesystem::path m_modelsDir;
+    std::map<std::string, CacheEntry> m_entries;
+};
+
+} // namespace arbiterAI
+
+#endif//_ARBITERAI_GGUFREADER_H_
@@ -1,6 +1,8 @@
 #include "arbiterAI/hardwareDetector.h"
 
 #include <spdlog/spdlog.h>
+#include <algorithm>
+#include <filesystem>
 #include <fstream>
 #include <sstream>
 #include <string>
@@ -206,6 +208,7 @@ void HardwareDetector::refresh()
     detectSystemRam();
     detectCpuInfo();
     detectCpuUtilization();
+    detectNumaNodes();
     detectNvmlGpus();
     detectVulkanGpus();
     detectUnifiedMemory();
@@ -382,6 +385,110 @@ void HardwareDetector::detectCpuInfo()
     m_systemInfo.cpuCores=static_cast<int>(std::thread::hardware_concurrency());
 }
 
+// --- NUMA topology detection ---
+
+void HardwareDetector::detectNumaNodes()
+{
+#ifdef __linux__
+    m_systemInfo.numaNodes=readNumaNodes();
+
+    if(!m_firstRefreshDone&&m_systemInfo.numaNodes.size()>1)
+    {
+        for(const NumaNode &node:m_systemInfo.numaNodes)
+        {
+            spdlog::info("NUMA node {}: {} CPUs, {}MB RAM ({}MB free)",
+                node.id, node.cpus.size(), node.totalRamMb, node.freeRamMb);
+        }
+    }
+#endif
+}
+
+std::vector<NumaNode> HardwareDetector::readNumaNodes(const std::string &nodeDir)
+{
+    std::vector<NumaNode> nodes;
+
+    std::error_code ec;
+    for(const std::filesystem::directory_entry &dirEntry:std::filesystem::directory_iterator(nodeDir, ec))
+    {
+        std::string name=dirEntry.path().filename().string();
+        if(name.size()<5||name.compare(0, 4, "node")!=0||
+            !std::all_of(name.begin()+4, name.end(), [](char c) { return c>='0'&&c<='9'; }))
+        {
+            continue;
+        }
+
+        NumaNode node;
+        node.id=std::stoi(name.substr(4));
+
+        std::ifstream cpulist(dirEntry.path()/"cpulist");
+        std::string list;
+        if(cpulist.is_open()&&std::getline(cpulist, list))
+        {
+            node.cpus=parseCpuList(list);
+        }
+
+        // Lines look like "Node 0 MemTotal:       65843180 kB"
+        std::ifstream meminfo(dirEntry.path()/"meminfo");
+        std::string line;
+        long long freeKb=0;
+        while(std::getline(meminfo, line))
+        {
+            std::istringstream iss(line);
+            std::string nodeWord, nodeId, key;
+            long long value=0;
+            if(!(iss>>nodeWord>>nodeId>>key>>value))
+            {
+                continue;
+            }
+
+            if(key=="MemTotal:")
+            {
+                node.totalRamMb=static_cast<int>(value/1024);
+            }
+            else if(key=="MemFree:"||key=="Inactive(file):")
+            {
+                freeKb+=value;
+            }
+        }
+        node.freeRamMb=static_cast<int>(freeKb/1024);
+
+        // Memory-only nodes (CXL, HBM) have no CPUs to run threads on
+        if(!node.cpus.empty())
+        {
+            nodes.push_back(node);
+        }
+    }
+
+    std::sort(nodes.begin(), nodes.end(), [](const NumaNode &a, const NumaNode &b) { return a.id<b.id; });
+    return nodes;
+}
+
+std::vector<int> HardwareDetector::parseCpuList(const std::string &list)
+{
+    std::vector<int> cpus;
+    std::istringstream iss(list);
+    std::string range;
+
+    while(std::getline(iss, range, ','))
+    {
+        try
+        {
+            size_t dash=range.find('-');
+            int first=std::stoi(range.substr(0, dash));
+            int last=dash==std::string::npos?first:std::stoi(range.substr(dash+1));
+            for(int cpu=first; cpu<=last; ++cpu)
+            {
+                cpus.push_back(cpu);
+            }
+        }
+        catch(const std::exception &)
+        {
+            // Blank or malformed entry (e.g. trailing newline only)
+        }
+    }
+    return cpus;
+}
+
 void HardwareDetector::detectCpuUtilization()
 {
 #ifdef __linux__
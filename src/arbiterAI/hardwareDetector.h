@@ -39,12 +39,20 @@ struct GpuInfo {
     std::vector<MemoryHeapInfo> memoryHeaps; // per-heap details from Vulkan
 };
 
+struct NumaNode {
+    int id=0;                   // kernel node id (nodeN in sysfs)
+    std::vector<int> cpus;      // online CPUs of the node
+    int totalRamMb=0;
+    int freeRamMb=0;            // free pages plus inactive page cache
+};
+
 struct SystemInfo {
     int totalRamMb=0;
     int freeRamMb=0;
     int cpuCores=0;
     float cpuUtilizationPercent=0.0f;
     std::vector<GpuInfo> gpus;
+    std::vector<NumaNode> numaNodes; // empty when sysfs has no node directory
 };
 
 class HardwareDetector {
@@ -88,6 +96,12 @@ public:
     /// Get the VRAM override value for a GPU (0 if not set)
     int getVramOverride(int gpuIndex) const;
 
+    /// Read NUMA nodes (CPUs and memory) from a sysfs node directory.
+    static std::vector<NumaNode> readNumaNodes(const std::string &nodeDir="/sys/devices/system/node");
+
+    /// Parse a sysfs CPU list such as "0-3,8,10-11".
+    static std::vector<int> parseCpuList(const std::string &list);
+
 private:
     HardwareDetector();
     ~HardwareDetector();
@@ -98,6 +112,7 @@ private:
     void detectSystemRam();
     void detectCpuInfo();
     void detectCpuUtilization();
+    void detectNumaNodes();
     void detectNvmlGpus();
     void detectVulkanGpus();
     void detectUnifiedMemory();
@@ -0,0 +1,216 @@
+#include "arbiterAI/mappedFile.h"
+
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <vector>
+#include <cstring>
+#include <cerrno>
+
+#ifdef __linux__
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace arbiterAI
+{
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+bool MappedFile::open(const std::string &path, bool lock)
+{
+    close();
+
+#ifdef __linux__
+    int fd=::open(path.c_str(), O_RDONLY|O_CLOEXEC);
+    if(fd<0)
+    {
+        spdlog::warn("Failed to open '{}' for mapping: {}", path, std::strerror(errno));
+        return false;
+    }
+
+    struct stat st;
+    if(fstat(fd, &st)!=0||st.st_size<=0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    void *data=mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+
+    if(data==MAP_FAILED)
+    {
+        spdlog::warn("Failed to map '{}': {}", path, std::strerror(errno));
+        return false;
+    }
+
+    m_path=path;
+    m_data=data;
+    m_size=static_cast<int64_t>(st.st_size);
+
+    madvise(m_data, static_cast<size_t>(m_size), MADV_WILLNEED);
+
+    if(lock)
+    {
+        if(mlock(m_data, static_cast<size_t>(m_size))==0)
+        {
+            m_locked=true;
+        }
+        else
+        {
+            spdlog::warn("Failed to mlock '{}' ({} MB): {} — keeping unlocked mapping",
+                path, m_size/(1024*1024), std::strerror(errno));
+        }
+    }
+    return true;
+#else
+    (void)path;
+    (void)lock;
+    return false;
+#endif
+}
+
+void MappedFile::close()
+{
+#ifdef __linux__
+    if(m_data)
+    {
+        if(m_locked)
+        {
+            munlock(m_data, static_cast<size_t>(m_size));
+        }
+        munmap(m_data, static_cast<size_t>(m_size));
+    }
+#endif
+    m_data=nullptr;
+    m_size=0;
+    m_locked=false;
+    m_path.clear();
+}
+
+int64_t MappedFile::residentBytes() const
+{
+    return countResident(m_data, m_size);
+}
+
+void MappedFile::prefetch()
+{
+#ifdef __linux__
+    if(m_data)
+    {
+        madvise(m_data, static_cast<size_t>(m_size), MADV_WILLNEED);
+    }
+#endif
+}
+
+bool MappedFile::lock()
+{
+#ifdef __linux__
+    if(!m_data||m_locked)
+    {
+        return m_locked;
+    }
+    if(mlock(m_data, static_cast<size_t>(m_size))==0)
+    {
+        m_locked=true;
+    }
+    else
+    {
+        spdlog::warn("Failed to mlock '{}' ({} MB): {}", m_path, m_size/(1024*1024), std::strerror(errno));
+    }
+#endif
+    return m_locked;
+}
+
+void MappedFile::unlock()
+{
+#ifdef __linux__
+    if(m_data&&m_locked)
+    {
+        munlock(m_data, static_cast<size_t>(m_size));
+    }
+#endif
+    m_locked=false;
+}
+
+int64_t MappedFile::measureResident(const std::string &path, int64_t *sizeBytes)
+{
+    if(sizeBytes)
+    {
+        *sizeBytes=0;
+    }
+#ifdef __linux__
+    int fd=::open(path.c_str(), O_RDONLY|O_CLOEXEC);
+    if(fd<0)
+    {
+        return 0;
+    }
+
+    struct stat st;
+    if(fstat(fd, &st)!=0||st.st_size<=0)
+    {
+        ::close(fd);
+        return 0;
+    }
+    int64_t size=static_cast<int64_t>(st.st_size);
+    if(sizeBytes)
+    {
+        *sizeBytes=size;
+    }
+
+    // No MADV_WILLNEED: measuring must not pull the file in
+    void *data=mmap(nullptr, static_cast<size_t>(size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if(data==MAP_FAILED)
+    {
+        return 0;
+    }
+
+    int64_t resident=countResident(data, size);
+    munmap(data, static_cast<size_t>(size));
+    return resident;
+#else
+    (void)path;
+    return 0;
+#endif
+}
+
+int64_t MappedFile::countResident(void *data, int64_t size)
+{
+#ifdef __linux__
+    if(!data)
+    {
+        return 0;
+    }
+
+    long pageSize=sysconf(_SC_PAGESIZE);
+    size_t pages=(static_cast<size_t>(size)+pageSize-1)/pageSize;
+    std::vector<unsigned char> vec(pages);
+
+    if(mincore(data, static_cast<size_t>(size), vec.data())!=0)
+    {
+        return 0;
+    }
+
+    int64_t resident=0;
+    for(unsigned char v:vec)
+    {
+        if(v&1)
+        {
+            resident+=pageSize;
+        }
+    }
+    return std::min(resident, size);
+#else
+    (void)data;
+    (void)size;
+    return 0;
+#endif
+}
+
+} // namespace arbiterAI
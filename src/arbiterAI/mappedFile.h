@@ -0,0 +1,66 @@
+#ifndef _ARBITERAI_MAPPEDFILE_H_
+#define _ARBITERAI_MAPPEDFILE_H_
+
+#include <string>
+#include <cstdint>
+
+namespace arbiterAI
+{
+
+/// Read-only memory mapping of a file held resident in host RAM.
+/// Used to keep GGUF weights in the page cache while a model sits in the
+/// Ready tier, so re-promotion reads tensors from RAM instead of disk.
+class MappedFile {
+public:
+    MappedFile()=default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile &)=delete;
+    MappedFile &operator=(const MappedFile &)=delete;
+
+    /// Map the file read-only and ask the kernel to read it in.
+    /// @param path  File to map.
+    /// @param lock  Also mlock() the mapping. Failure to lock is logged and
+    ///              the mapping is kept unlocked.
+    /// @return true if the file was mapped.
+    bool open(const std::string &path, bool lock=false);
+
+    /// Unmap the file (and unlock it if locked).
+    void close();
+
+    bool isOpen() const { return m_data!=nullptr; }
+    bool isLocked() const { return m_locked; }
+    const std::string &path() const { return m_path; }
+    int64_t size() const { return m_size; }
+
+    /// Bytes of the mapping currently resident in RAM, measured with mincore().
+    int64_t residentBytes() const;
+
+    /// Ask the kernel to read the file in again (after pages were reclaimed).
+    void prefetch();
+
+    /// mlock() an open, unlocked mapping.  Failure is logged.
+    /// @return true if the mapping is locked.
+    bool lock();
+
+    /// munlock() the mapping, keeping it mapped.
+    void unlock();
+
+    /// Bytes of a file currently in the page cache, without reading it in:
+    /// maps it briefly and checks with mincore().  0 if it cannot be mapped.
+    /// @param sizeBytes  [out] optional, set to the file size.
+    static int64_t measureResident(const std::string &path, int64_t *sizeBytes=nullptr);
+
+private:
+    /// Resident bytes of a mapping via mincore().
+    static int64_t countResident(void *data, int64_t size);
+
+    std::string m_path;
+    void *m_data=nullptr;
+    int64_t m_size=0;
+    bool m_locked=false;
+};
+
+} // namespace arbiterAI
+
+#endif//_ARBITERAI_MAPPEDFILE_H_
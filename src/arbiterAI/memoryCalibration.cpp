@@ -0,0 +1,170 @@
+#include "arbiterAI/memoryCalibration.h"
+
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <fstream>
+
+namespace arbiterAI
+{
+
+MemoryCalibration &MemoryCalibration::instance()
+{
+    static MemoryCalibration calibration;
+    return calibration;
+}
+
+void MemoryCalibration::reset()
+{
+    MemoryCalibration &cal=instance();
+    std::lock_guard<std::mutex> lock(cal.m_mutex);
+    cal.m_entries.clear();
+    cal.m_path.clear();
+}
+
+std::string MemoryCalibration::key(const std::string &model, const std::string &variant)
+{
+    return model+"/"+variant;
+}
+
+void MemoryCalibration::load(const std::filesystem::path &path)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_path=path;
+    m_entries.clear();
+
+    if(!std::filesystem::exists(path))
+    {
+        return;
+    }
+
+    try
+    {
+        std::ifstream file(path);
+        nlohmann::json data;
+        file>>data;
+
+        if(data.contains("models")&&data["models"].is_object())
+        {
+            for(auto it=data["models"].begin(); it!=data["models"].end(); ++it)
+            {
+                const nlohmann::json &m=it.value();
+
+                MemoryCalibrationEntry entry;
+                entry.weightFactor=m.value("weight_factor", 1.0);
+                entry.kvFactor=m.value("kv_factor", 1.0);
+                entry.computeBufferMb=m.value("compute_buffer_mb", 0);
+                entry.samples=m.value("samples", 0);
+                entry.updatedAt=std::chrono::system_clock::time_point(
+                    std::chrono::seconds(m.value("updated_at", int64_t(0))));
+                m_entries[it.key()]=entry;
+            }
+        }
+
+        spdlog::info("Loaded memory calibration for {} model variants from {}", m_entries.size(), path.string());
+    }
+    catch(const std::exception &e)
+    {
+        spdlog::warn("Failed to load memory calibration from {}: {}", path.string(), e.what());
+    }
+}
+
+void MemoryCalibration::record(const std::string &model, const std::string &variant,
+    int64_t estimatedWeightBytes, int measuredWeightMb,
+    int64_t estimatedKvBytes, int measuredKvMb,
+    int measuredComputeMb)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    MemoryCalibrationEntry &entry=m_entries[key(model, variant)];
+    int weight=std::min(entry.samples, MAX_WEIGHTED_SAMPLES-1);
+    auto blend=[weight](double current, double sample)
+    {
+        return (current*weight+sample)/(weight+1);
+    };
+
+    constexpr double bytesPerMb=1024.0*1024.0;
+    if(estimatedWeightBytes>0&&measuredWeightMb>0)
+    {
+        entry.weightFactor=blend(entry.weightFactor, measuredWeightMb*bytesPerMb/estimatedWeightBytes);
+    }
+    if(estimatedKvBytes>0&&measuredKvMb>0)
+    {
+        entry.kvFactor=blend(entry.kvFactor, measuredKvMb*bytesPerMb/estimatedKvBytes);
+    }
+    if(measuredComputeMb>0)
+    {
+        entry.computeBufferMb=static_cast<int>(blend(entry.computeBufferMb, measuredComputeMb)+0.5);
+    }
+    entry.samples++;
+    entry.updatedAt=std::chrono::system_clock::now();
+
+    spdlog::info("Memory calibration for '{}' variant '{}': weights x{:.3f}, kv x{:.3f}, compute {}MB ({} samples)",
+        model, variant, entry.weightFactor, entry.kvFactor, entry.computeBufferMb, entry.samples);
+
+    save();
+}
+
+std::optional<MemoryCalibrationEntry> MemoryCalibration::get(const std::string &model, const std::string &variant) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it=m_entries.find(key(model, variant));
+    if(it==m_entries.end())
+    {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+std::map<std::string, MemoryCalibrationEntry> MemoryCalibration::getAll() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries;
+}
+
+void MemoryCalibration::save() const
+{
+    // NOTE: caller must hold m_mutex
+
+    if(m_path.empty())
+    {
+        return;
+    }
+
+    nlohmann::json models=nlohmann::json::object();
+    for(const auto &pair:m_entries)
+    {
+        models[pair.first]={
+            {"weight_factor", pair.second.weightFactor},
+            {"kv_factor", pair.second.kvFactor},
+            {"compute_buffer_mb", pair.second.computeBufferMb},
+            {"samples", pair.second.samples},
+            {"updated_at", std::chrono::duration_cast<std::chrono::seconds>(
+                pair.second.updatedAt.time_since_epoch()).count()}
+        };
+    }
+
+    nlohmann::json data;
+    data["version"]=1;
+    data["models"]=models;
+
+    // Write to a temp file and rename so a crash never leaves a torn file
+    std::filesystem::path tmpPath=m_path;
+    tmpPath+=".tmp";
+    try
+    {
+        {
+            std::ofstream file(tmpPath);
+            file<<data.dump(4);
+        }
+        std::filesystem::rename(tmpPath, m_path);
+    }
+    catch(const std::exception &e)
+    {
+        spdlog::error("Failed to save memory calibration to {}: {}", m_path.string(), e.what());
+    }
+}
+
+} // namespace arbiterAI
@@ -0,0 +1,68 @@
+#ifndef _ARBITERAI_MEMORYCALIBRATION_H_
+#define _ARBITERAI_MEMORYCALIBRATION_H_
+
+#include <string>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+
+namespace arbiterAI
+{
+
+/// Ratio between the buffers llama.cpp actually allocated and the GGUF-based
+/// estimate for one model variant.
+struct MemoryCalibrationEntry {
+    double weightFactor=1.0;    // measured model buffers / GGUF tensor bytes
+    double kvFactor=1.0;        // measured KV buffers / computed KV bytes
+    int computeBufferMb=0;      // measured GPU compute buffers
+    int samples=0;
+    std::chrono::system_clock::time_point updatedAt;
+};
+
+/// Calibration factors learned from real loads, persisted next to the models
+/// so the fit calculator's estimates improve across restarts.
+class MemoryCalibration {
+public:
+    static MemoryCalibration &instance();
+    static void reset(); // For testing
+
+    /// Load factors from a JSON file and persist future updates there.
+    void load(const std::filesystem::path &path);
+
+    /// Record a measured load.  Factors are a running average over the most
+    /// recent MAX_WEIGHTED_SAMPLES loads.
+    void record(const std::string &model, const std::string &variant,
+        int64_t estimatedWeightBytes, int measuredWeightMb,
+        int64_t estimatedKvBytes, int measuredKvMb,
+        int measuredComputeMb);
+
+    /// Get the factors for a model variant, if any load was measured.
+    std::optional<MemoryCalibrationEntry> get(const std::string &model, const std::string &variant) const;
+
+    /// Get all factors keyed by "model/variant".
+    std::map<std::string, MemoryCalibrationEntry> getAll() const;
+
+private:
+    MemoryCalibration()=default;
+
+    MemoryCalibration(const MemoryCalibration &)=delete;
+    MemoryCalibration &operator=(const MemoryCalibration &)=delete;
+
+    /// Write all factors to m_path (caller holds m_mutex).
+    void save() const;
+
+    static std::string key(const std::string &model, const std::string &variant);
+
+    static constexpr int MAX_WEIGHTED_SAMPLES=8;
+
+    mutable std::mutex m_mutex;
+    std::filesystem::path m_path;
+    std::map<std::string, MemoryCalibrationEntry> m_entries;
+};
+
+} // namespace arbiterAI
+
+#endif//_ARBITERAI_MEMORYCALIBRATION_H_
@@ -0,0 +1,239 @@
+#include "arbiterAI/memoryPressureMonitor.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace arbiterAI
+{
+
+namespace
+{
+
+bool readFile(const std::string &path, std::string &text)
+{
+    std::ifstream file(path);
+    if(!file.is_open())
+    {
+        return false;
+    }
+
+    std::stringstream buffer;
+    buffer<<file.rdbuf();
+    text=buffer.str();
+    return true;
+}
+
+/// Read a cgroup memory file: a byte count, or "max" (no limit -> -1).
+bool readCgroupBytes(const std::string &path, int64_t &bytes)
+{
+    std::string text;
+    if(!readFile(path, text))
+    {
+        return false;
+    }
+
+    std::istringstream stream(text);
+    std::string value;
+    stream>>value;
+    if(value.empty())
+    {
+        return false;
+    }
+    if(value=="max")
+    {
+        bytes=-1;
+        return true;
+    }
+
+    try
+    {
+        bytes=std::stoll(value);
+    }
+    catch(...)
+    {
+        return false;
+    }
+    return true;
+}
+
+/// Read one "key value" field of a cgroup memory.stat.
+bool readCgroupStat(const std::string &path, const std::string &key, int64_t &bytes)
+{
+    std::string text;
+    if(!readFile(path, text))
+    {
+        return false;
+    }
+
+    std::istringstream lines(text);
+    std::string line;
+    while(std::getline(lines, line))
+    {
+        std::istringstream fields(line);
+        std::string name;
+        int64_t value=0;
+        if(fields>>name>>value&&name==key)
+        {
+            bytes=value;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // anonymous namespace
+
+MemoryPressureMonitor::MemoryPressureMonitor(const std::string &procRoot, const std::string &cgroupRoot):
+    m_procRoot(procRoot),
+    m_cgroupRoot(cgroupRoot)
+{
+}
+
+void MemoryPressureMonitor::setThresholds(const MemoryPressureThresholds &thresholds)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_thresholds=thresholds;
+}
+
+MemoryPressureThresholds MemoryPressureMonitor::getThresholds() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_thresholds;
+}
+
+MemoryPressureSample MemoryPressureMonitor::sample() const
+{
+    MemoryPressureSample result;
+    std::string dir=cgroupDir();
+
+    // The cgroup's own PSI covers just this server's stalls; the system-wide
+    // file also counts every other workload on the host
+    std::string psi;
+    if((!dir.empty()&&readFile(dir+"/memory.pressure", psi))||readFile(m_procRoot+"/pressure/memory", psi))
+    {
+        result.psiAvailable=parsePsi(psi, result.someAvg10, result.fullAvg10);
+    }
+
+    if(!dir.empty())
+    {
+        int64_t current=0;
+        int64_t max=-1;
+        if(readCgroupBytes(dir+"/memory.current", current)&&readCgroupBytes(dir+"/memory.max", max)&&max>0)
+        {
+            // memory.current includes page cache the kernel drops before it
+            // stalls anyone (inactive_file); the mmapped weights alone would
+            // otherwise keep the cgroup near its limit
+            int64_t inactiveFile=0;
+            readCgroupStat(dir+"/memory.stat", "inactive_file", inactiveFile);
+
+            result.cgroupLimited=true;
+            result.cgroupCurrentBytes=current;
+            result.cgroupInactiveFileBytes=std::min(std::max<int64_t>(inactiveFile, 0), current);
+            result.cgroupMaxBytes=max;
+        }
+    }
+
+    result.level=classify(result, getThresholds());
+    return result;
+}
+
+bool MemoryPressureMonitor::parsePsi(const std::string &text, double &someAvg10, double &fullAvg10)
+{
+    // some avg10=1.23 avg60=0.50 avg300=0.10 total=123456
+    // full avg10=0.00 avg60=0.00 avg300=0.00 total=0
+    bool foundSome=false;
+    bool foundFull=false;
+
+    std::istringstream lines(text);
+    std::string line;
+    while(std::getline(lines, line))
+    {
+        std::istringstream fields(line);
+        std::string kind;
+        fields>>kind;
+
+        std::string field;
+        while(fields>>field)
+        {
+            if(field.rfind("avg10=", 0)!=0)
+            {
+                continue;
+            }
+
+            double value=0.0;
+            try
+            {
+                value=std::stod(field.substr(6));
+            }
+            catch(...)
+            {
+                break;
+            }
+
+            if(kind=="some")
+            {
+                someAvg10=value;
+                foundSome=true;
+            }
+            else if(kind=="full")
+            {
+                fullAvg10=value;
+                foundFull=true;
+            }
+            break;
+        }
+    }
+    return foundSome&&foundFull;
+}
+
+MemoryPressureLevel MemoryPressureMonitor::classify(const MemoryPressureSample &sample, const MemoryPressureThresholds &thresholds)
+{
+    double cgroupPercent=sample.cgroupUsagePercent();
+
+    if((sample.psiAvailable&&sample.fullAvg10>=thresholds.fullAvg10Critical)||
+        (sample.cgroupLimited&&cgroupPercent>=thresholds.cgroupCriticalPercent))
+    {
+        return MemoryPressureLevel::Critical;
+    }
+    if((sample.psiAvailable&&sample.someAvg10>=thresholds.someAvg10Moderate)||
+        (sample.cgroupLimited&&cgroupPercent>=thresholds.cgroupModeratePercent))
+    {
+        return MemoryPressureLevel::Moderate;
+    }
+    return MemoryPressureLevel::None;
+}
+
+std::string MemoryPressureMonitor::levelToString(MemoryPressureLevel level)
+{
+    switch(level)
+    {
+        case MemoryPressureLevel::Moderate: return "moderate";
+        case MemoryPressureLevel::Critical: return "critical";
+        default:                            return "none";
+    }
+}
+
+std::string MemoryPressureMonitor::cgroupDir() const
+{
+    // cgroup v2 lists a single "0::<path>" entry
+    std::string text;
+    if(!readFile(m_procRoot+"/self/cgroup", text))
+    {
+        return "";
+    }
+
+    std::istringstream lines(text);
+    std::string line;
+    while(std::getline(lines, line))
+    {
+        if(line.rfind("0::", 0)==0)
+        {
+            std::string path=line.substr(3);
+            return path=="/"?m_cgroupRoot:m_cgroupRoot+path;
+        }
+    }
+    return "";
+}
+
+} // namespace arbiterAI
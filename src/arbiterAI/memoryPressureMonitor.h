@@ -0,0 +1,89 @@
+#ifndef _ARBITERAI_MEMORYPRESSUREMONITOR_H_
+#define _ARBITERAI_MEMORYPRESSUREMONITOR_H_
+
+#include <string>
+#include <mutex>
+#include <cstdint>
+
+namespace arbiterAI
+{
+
+enum class MemoryPressureLevel {
+    None,
+    Moderate,   // shrink the Ready tier, reclaim idle contexts sooner, no speculative loads
+    Critical    // drop the Ready tier and every idle context
+};
+
+/// Pressure levels at which the runtime starts giving memory back.
+struct MemoryPressureThresholds {
+    double someAvg10Moderate=10.0;      // PSI "some" avg10: % of time at least one task stalled on memory
+    double fullAvg10Critical=5.0;       // PSI "full" avg10: % of time every task stalled on memory
+    double cgroupModeratePercent=85.0;  // cgroup working set (memory.current - inactive_file) as % of memory.max
+    double cgroupCriticalPercent=95.0;
+};
+
+/// One reading of the kernel's memory pressure indicators.
+struct MemoryPressureSample {
+    bool psiAvailable=false;        // the cgroup's memory.pressure or /proc/pressure/memory was readable
+    double someAvg10=0.0;
+    double fullAvg10=0.0;
+    bool cgroupLimited=false;       // the process's cgroup has a memory.max
+    int64_t cgroupCurrentBytes=0;
+    int64_t cgroupInactiveFileBytes=0;  // reclaimable page cache counted in memory.current
+    int64_t cgroupMaxBytes=0;
+    MemoryPressureLevel level=MemoryPressureLevel::None;
+
+    /// memory.current minus the inactive file cache.
+    int64_t cgroupWorkingSetBytes() const
+    {
+        return cgroupCurrentBytes-cgroupInactiveFileBytes;
+    }
+
+    double cgroupUsagePercent() const
+    {
+        return cgroupLimited&&cgroupMaxBytes>0?100.0*static_cast<double>(cgroupWorkingSetBytes())/static_cast<double>(cgroupMaxBytes):0.0;
+    }
+};
+
+/// Reads Linux pressure stall information (the cgroup's memory.pressure,
+/// else /proc/pressure/memory) and the cgroup v2 working set
+/// (memory.current less inactive_file from memory.stat) against memory.max
+/// of this process, and classifies them into a pressure level.  Either
+/// source may be missing (older kernels, cgroup v1, non-Linux); missing
+/// sources never raise the level.
+class MemoryPressureMonitor {
+public:
+    /// @param procRoot    Root of procfs (tests point this at a fake tree).
+    /// @param cgroupRoot  Mount point of the cgroup v2 hierarchy.
+    explicit MemoryPressureMonitor(const std::string &procRoot="/proc", const std::string &cgroupRoot="/sys/fs/cgroup");
+
+    void setThresholds(const MemoryPressureThresholds &thresholds);
+    MemoryPressureThresholds getThresholds() const;
+
+    /// Read the pressure sources and classify them.
+    MemoryPressureSample sample() const;
+
+    /// Parse the contents of a memory PSI file (/proc/pressure/memory or a
+    /// cgroup's memory.pressure).
+    /// @return true if both the "some" and "full" lines were found.
+    static bool parsePsi(const std::string &text, double &someAvg10, double &fullAvg10);
+
+    /// Pressure level of a sample under the given thresholds.
+    static MemoryPressureLevel classify(const MemoryPressureSample &sample, const MemoryPressureThresholds &thresholds);
+
+    static std::string levelToString(MemoryPressureLevel level);
+
+private:
+    /// cgroup v2 directory of this process ("0::/path" in /proc/self/cgroup),
+    /// empty when the process is not in a v2 hierarchy.
+    std::string cgroupDir() const;
+
+    std::string m_procRoot;
+    std::string m_cgroupRoot;
+    mutable std::mutex m_mutex;
+    MemoryPressureThresholds m_thresholds;
+};
+
+} // namespace arbiterAI
+
+#endif//_ARBITERAI_MEMORYPRESSUREMONITOR_H_
@@ -1,16 +1,646 @@
 #include "arbiterAI/modelDownloader.h"
 #include "arbiterAI/modelManager.h"
-#include <picosha2.h>
 #include <cpr/cpr.h>
 #include <fstream>
 #include <filesystem>
 #include <iostream>
 #include <spdlog/spdlog.h>
 #include <nlohmann/json.hpp>
+#include <thread>
+#include <condition_variable>
+#include <set>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
 
 namespace arbiterAI
 {
 
+namespace
+{
+
+/// Minimum spacing between speed samples and progress callbacks. Segmented
+/// downloads deliver small chunks from several threads at once; sampling
+/// every chunk would flood the speed window and the callback.
+constexpr std::chrono::milliseconds PROGRESS_INTERVAL(100);
+
+/// Record a progress sample and notify the caller. Safe to call from several
+/// segment threads; samples are serialized by speedMutex, but the callback
+/// runs outside it so it may take its own snapshots.
+void recordProgress(const std::shared_ptr<ActiveDownload> &downloadState,
+    const DownloadProgressCallback &progressCallback,
+    int64_t downloadNow,
+    int64_t downloadTotal)
+{
+    float percent=0.0f;
+    {
+        std::lock_guard<std::mutex> lock(downloadState->speedMutex);
+        std::chrono::steady_clock::time_point now=std::chrono::steady_clock::now();
+
+        if(!downloadState->speedSamples.empty()&&
+            now-downloadState->speedSamples.back().first<PROGRESS_INTERVAL&&
+            (downloadTotal<=0||downloadNow<downloadTotal))
+        {
+            return;
+        }
+
+        downloadState->bytesDownloaded=downloadNow;
+        downloadState->totalBytes=downloadTotal;
+
+        if(downloadTotal>0)
+        {
+            percent=(static_cast<float>(downloadNow)/downloadTotal)*100.0f;
+        }
+        downloadState->percentComplete=percent;
+
+        downloadState->speedSamples.push_back({now, downloadNow});
+
+        // Keep only last 10 seconds of samples
+        std::chrono::steady_clock::time_point cutoff=now-std::chrono::seconds(10);
+        while(!downloadState->speedSamples.empty()&&downloadState->speedSamples.front().first<cutoff)
+        {
+            downloadState->speedSamples.pop_front();
+        }
+    }
+
+    if(progressCallback)
+    {
+        progressCallback(downloadNow, downloadTotal, percent);
+    }
+}
+
+/// Stream the whole file over one connection into partialPath, feeding
+/// hasher (if any) as the bytes are written. The file is preallocated once
+/// its length is known, from expectedBytes or from the response.
+bool downloadSingleStream(const std::string &downloadUrl,
+    const std::string &partialPath,
+    int64_t expectedBytes,
+    const DownloadWriteConfig &writeConfig,
+    DownloadScheduler &scheduler,
+    int transferId,
+    Sha256Hasher *hasher,
+    const std::shared_ptr<ActiveDownload> &downloadState,
+    const DownloadProgressCallback &progressCallback)
+{
+    DownloadFile file;
+    if(!file.open(partialPath, expectedBytes, true, writeConfig))
+    {
+        spdlog::error("Failed to open partial file for writing: {}", file.error());
+        downloadState->error=file.error();
+        return false;
+    }
+    BufferedFileWriter writer(file, 0, writeConfig.bufferBytes);
+
+    bool writeError=false;
+
+    scheduler.acquire(downloadState->priority);
+    downloadState->connections=1;
+    cpr::Response r=cpr::Get(
+        cpr::Url{downloadUrl},
+        cpr::WriteCallback([&writer, &writeError, &scheduler, transferId, hasher](const std::string_view &data, intptr_t) -> bool
+        {
+            if(!writer.write(data.data(), data.size()))
+            {
+                writeError=true;
+                return false; // abort transfer
+            }
+            if(hasher)
+            {
+                hasher->update(data.data(), data.size());
+            }
+
+            // A single stream can't resume, so it is throttled but never paused
+            scheduler.throttle(transferId, data.size());
+            return true;
+        }),
+        cpr::ProgressCallback([&downloadState, &progressCallback, &file, &writeError](cpr::cpr_off_t downloadTotal,
+            cpr::cpr_off_t downloadNow,
+            cpr::cpr_off_t uploadTotal,
+            cpr::cpr_off_t uploadNow,
+            intptr_t userdata) -> bool
+        {
+            (void)uploadTotal;
+            (void)uploadNow;
+            (void)userdata;
+
+            // Runs on the transfer thread, so it can't race the first write
+            if(!file.preallocate(downloadTotal))
+            {
+                writeError=true;
+                return false;
+            }
+            recordProgress(downloadState, progressCallback, downloadNow, downloadTotal);
+            return true;
+        })
+    );
+    downloadState->connections=0;
+    scheduler.release();
+
+    if(!writer.flush())
+    {
+        writeError=true;
+    }
+
+    if(writeError)
+    {
+        spdlog::error("Write error during download to {}: {}", partialPath, file.error());
+        downloadState->error="Disk write error";
+        return false;
+    }
+
+    if(r.status_code!=200)
+    {
+        spdlog::error("Failed to download model. Status code: {}", r.status_code);
+        downloadState->error="HTTP error: "+std::to_string(r.status_code);
+        return false;
+    }
+
+    // Trim any preallocation the body fell short of, then sync once
+    if(!file.finish(writer.offset()))
+    {
+        spdlog::error("Write error during download to {}: {}", partialPath, file.error());
+        downloadState->error="Disk write error";
+        return false;
+    }
+    return true;
+}
+
+/// What a HEAD request tells us about the remote file.
+struct RemoteFileInfo
+{
+    int64_t contentLength=0;
+    std::string etag;
+    std::string lastModified;
+};
+
+/// Ask the server whether it serves byte ranges, how large the file is and
+/// which validators identify this version of it. Returns false when ranges or
+/// the size are unknown, so the caller uses a single stream.
+bool probeRangeSupport(const std::string &downloadUrl, RemoteFileInfo &remote)
+{
+    cpr::Response r=cpr::Head(cpr::Url{downloadUrl}, cpr::Timeout{30000});
+    if(r.status_code!=200)
+    {
+        return false;
+    }
+
+    // cpr::Header compares keys case-insensitively. The length is recorded
+    // even without range support so a single stream can preallocate.
+    cpr::Header::const_iterator length=r.header.find("Content-Length");
+    if(length==r.header.end())
+    {
+        return false;
+    }
+
+    try
+    {
+        remote.contentLength=std::stoll(length->second);
+    }
+    catch(...)
+    {
+        remote.contentLength=0;
+        return false;
+    }
+
+    cpr::Header::const_iterator acceptRanges=r.header.find("Accept-Ranges");
+    if(acceptRanges==r.header.end()||acceptRanges->second.find("bytes")==std::string::npos)
+    {
+        return false;
+    }
+
+    cpr::Header::const_iterator etag=r.header.find("ETag");
+    if(etag!=r.header.end())
+    {
+        remote.etag=etag->second;
+    }
+    cpr::Header::const_iterator lastModified=r.header.find("Last-Modified");
+    if(lastModified!=r.header.end())
+    {
+        remote.lastModified=lastModified->second;
+    }
+    return remote.contentLength>0;
+}
+
+/// A checkpoint may only be resumed against the same version of the same
+/// file. Without a validator there is no way to tell, so start over.
+bool checkpointMatches(const DownloadCheckpoint &checkpoint, const std::string &downloadUrl, const RemoteFileInfo &remote)
+{
+    if(checkpoint.url!=downloadUrl||checkpoint.totalBytes!=remote.contentLength||checkpoint.segments.empty())
+    {
+        return false;
+    }
+    if(!remote.etag.empty())
+    {
+        return checkpoint.etag==remote.etag;
+    }
+    if(!remote.lastModified.empty())
+    {
+        return checkpoint.lastModified==remote.lastModified;
+    }
+    return false;
+}
+
+/// Drops a transfer's bandwidth bucket when its download ends.
+struct TransferRegistration
+{
+    TransferRegistration(DownloadScheduler &scheduler, int id):
+        scheduler(scheduler),
+        id(id)
+    {
+    }
+
+    ~TransferRegistration()
+    {
+        scheduler.removeTransfer(id);
+    }
+
+    DownloadScheduler &scheduler;
+    int id;
+};
+
+enum class SegmentedResult
+{
+    Completed,
+    Failed,
+    RangesIgnored   // server answered a Range request with the whole body
+};
+
+/// How often a running segmented download saves its checkpoint.
+constexpr std::chrono::seconds CHECKPOINT_INTERVAL(5);
+
+/// Read size when the hasher catches up on bytes written by other segments.
+constexpr size_t HASH_READ_BYTES=4*1024*1024;
+
+/// How long a peer may take to say whether it has a file before it is
+/// skipped; peers are on the LAN, so a slow answer means a dead one.
+constexpr long PEER_PROBE_TIMEOUT_MS=3000;
+
+/// Fetch every unfinished segment of checkpoint on its own connection,
+/// writing each through its own buffered writer at its offset in a
+/// preallocated partialPath. A failed segment
+/// is retried from the last byte it wrote without disturbing the others. The
+/// checkpoint is saved beside filePath while running and when stopping, so a
+/// later call can pick up where this one left off.
+///
+/// SHA-256 is sequential but segments land out of order, so hasher (if any)
+/// runs on its own thread behind the contiguous written prefix of the file,
+/// reading those bytes back while they are still in the page cache. Data
+/// kept from an earlier attempt is hashed the same way. When every segment
+/// is done only the tail written last remains to be hashed.
+SegmentedResult downloadSegments(const std::string &downloadUrl,
+    const std::string &filePath,
+    const std::string &partialPath,
+    DownloadCheckpoint &checkpoint,
+    int segmentRetries,
+    const DownloadWriteConfig &writeConfig,
+    DownloadScheduler &scheduler,
+    int transferId,
+    Sha256Hasher *hasher,
+    const std::shared_ptr<ActiveDownload> &downloadState,
+    const DownloadProgressCallback &progressCallback)
+{
+#ifdef __linux__
+    int64_t totalBytes=checkpoint.totalBytes;
+
+    // Reserve the whole file up front; data kept from an earlier attempt stays
+    DownloadFile file;
+    if(!file.open(partialPath, totalBytes, false, writeConfig))
+    {
+        spdlog::error("Failed to open partial file for writing: {}", file.error());
+        downloadState->error=file.error();
+        return SegmentedResult::Failed;
+    }
+    int fd=file.fd();
+
+    // Next byte handed to the file per segment, published by its writer;
+    // read by the checkpoint and hash threads
+    std::vector<std::atomic<int64_t>> next(checkpoint.segments.size());
+    for(size_t i=0; i<checkpoint.segments.size(); ++i)
+    {
+        next[i]=checkpoint.segments[i].next;
+    }
+
+    std::atomic<int64_t> received{checkpoint.completedBytes()};
+    std::atomic<bool> abort{false};
+    std::atomic<bool> writeError{false};
+    std::atomic<bool> rangesIgnored{false};
+    std::mutex errorMutex;
+    std::string lastError;
+
+    // If-Range makes the server send the whole (new) file instead of a range
+    // of it when the file changed since the checkpoint was taken
+    std::string ifRange=!checkpoint.etag.empty()?checkpoint.etag:checkpoint.lastModified;
+
+    auto saveProgress=[&]()
+    {
+        // Only claim bytes that have reached the disk: take the positions
+        // before syncing so nothing written after the sync is counted
+        std::vector<int64_t> positions(checkpoint.segments.size());
+        for(size_t i=0; i<checkpoint.segments.size(); ++i)
+        {
+            positions[i]=next[i].load();
+        }
+        if(!file.datasync())
+        {
+            return;
+        }
+        for(size_t i=0; i<checkpoint.segments.size(); ++i)
+        {
+            checkpoint.segments[i].next=positions[i];
+        }
+        ModelDownloader::saveCheckpoint(filePath, checkpoint);
+    };
+
+    auto fetchSegment=[&](size_t index, BufferedFileWriter &writer)
+    {
+        int64_t first=checkpoint.segments[index].first;
+        int64_t last=checkpoint.segments[index].last;
+        int64_t offset=writer.offset();
+
+        int attempt=0;
+        bool yielded=false;
+        while(attempt<=segmentRetries&&!abort&&offset<=last)
+        {
+            if(attempt>0&&!yielded)
+            {
+                spdlog::warn("Retrying segment {}-{} of {} from byte {} (attempt {}/{})",
+                    first, last, downloadUrl, offset, attempt, segmentRetries);
+                std::this_thread::sleep_for(std::chrono::milliseconds(500<<(attempt-1)));
+            }
+
+            bool overrun=false;
+            yielded=false;
+
+            cpr::Header header{{"Range", fmt::format("bytes={}-{}", offset, last)}};
+            if(!ifRange.empty())
+            {
+                header["If-Range"]=ifRange;
+            }
+
+            // Wait for a connection from the pool shared with every other
+            // download; the transfer may have failed elsewhere meanwhile
+            scheduler.acquire(downloadState->priority);
+            if(abort)
+            {
+                scheduler.release();
+                return;
+            }
+
+            ++downloadState->connections;
+            cpr::Response r=cpr::Get(
+                cpr::Url{downloadUrl},
+                header,
+                cpr::WriteCallback([&](const std::string_view &data, intptr_t) -> bool
+                {
+                    if(abort)
+                    {
+                        return false;
+                    }
+                    if(offset+static_cast<int64_t>(data.size())>last+1)
+                    {
+                        overrun=true;
+                        return false;
+                    }
+                    if(!writer.write(data.data(), data.size()))
+                    {
+                        writeError=true;
+                        abort=true;
+                        return false;
+                    }
+                    offset+=static_cast<int64_t>(data.size());
+
+                    int64_t now=received.fetch_add(static_cast<int64_t>(data.size()))+static_cast<int64_t>(data.size());
+                    recordProgress(downloadState, progressCallback, now, totalBytes);
+                    scheduler.throttle(transferId, data.size());
+
+                    // Pause and hand the connection to a more urgent download
+                    if(offset<=last&&scheduler.shouldYield(downloadState->priority))
+                    {
+                        yielded=true;
+                        return false;
+                    }
+                    return true;
+                })
+            );
+            --downloadState->connections;
+            scheduler.release();
+
+            if(offset>last||writeError||abort)
+            {
+                return;
+            }
+            if(yielded)
+            {
+                // Not a failure; acquire() waits until the urgent work is
+                // served. Flush so a checkpoint taken meanwhile covers it.
+                if(!writer.flush())
+                {
+                    writeError=true;
+                    abort=true;
+                    return;
+                }
+                spdlog::debug("Segment {}-{} of {} paused at byte {} for a more urgent download",
+                    first, last, downloadUrl, offset);
+                continue;
+            }
+            if(overrun||r.status_code==200)
+            {
+                // The server ignored the Range header, or the file changed
+                rangesIgnored=true;
+                abort=true;
+                return;
+            }
+
+            std::string error=r.status_code==0?r.error.message:"HTTP error: "+std::to_string(r.status_code);
+            spdlog::warn("Segment {}-{} of {} stopped at byte {}: {}", first, last, downloadUrl, offset, error);
+
+            {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                lastError=error;
+            }
+            ++attempt;
+        }
+
+        if(!abort&&offset<=last)
+        {
+            spdlog::error("Segment {}-{} of {} failed after {} retries", first, last, downloadUrl, segmentRetries);
+            abort=true;
+        }
+    };
+
+    auto runSegment=[&](size_t index)
+    {
+        BufferedFileWriter writer(file, next[index].load(), writeConfig.bufferBytes, &next[index]);
+        fetchSegment(index, writer);
+
+        // Whatever was received is kept, even if the segment failed
+        if(!writer.flush())
+        {
+            writeError=true;
+            abort=true;
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(checkpoint.segments.size());
+    for(size_t i=0; i<checkpoint.segments.size(); ++i)
+    {
+        if(checkpoint.segments[i].next<=checkpoint.segments[i].last)
+        {
+            workers.emplace_back(runSegment, i);
+        }
+    }
+
+    std::mutex doneMutex;
+    std::condition_variable doneCv;
+    bool done=false;
+    std::thread checkpointer([&]()
+    {
+        std::unique_lock<std::mutex> lock(doneMutex);
+        while(!doneCv.wait_for(lock, CHECKPOINT_INTERVAL, [&]() { return done; }))
+        {
+            saveProgress();
+        }
+    });
+
+    std::thread hashFollower;
+    if(hasher)
+    {
+        hashFollower=std::thread([&]()
+        {
+            std::vector<char> buffer(HASH_READ_BYTES);
+            std::chrono::steady_clock::duration busy{0};
+            size_t segment=0;
+
+            while(true)
+            {
+                int64_t cursor=hasher->bytesHashed();
+                while(segment<checkpoint.segments.size()&&cursor>checkpoint.segments[segment].last)
+                {
+                    ++segment;
+                }
+                if(segment==checkpoint.segments.size())
+                {
+                    break;
+                }
+
+                // Read the flag before the frontier: once done is seen, next
+                // holds the final positions
+                bool finished;
+                {
+                    std::lock_guard<std::mutex> lock(doneMutex);
+                    finished=done;
+                }
+
+                int64_t frontier=std::min(next[segment].load(), checkpoint.segments[segment].last+1);
+                if(cursor<frontier)
+                {
+                    std::chrono::steady_clock::time_point start=std::chrono::steady_clock::now();
+                    size_t size=static_cast<size_t>(std::min<int64_t>(frontier-cursor, static_cast<int64_t>(buffer.size())));
+                    ssize_t bytesRead=::pread(fd, buffer.data(), size, static_cast<off_t>(cursor));
+                    if(bytesRead<=0)
+                    {
+                        if(bytesRead<0&&errno==EINTR)
+                        {
+                            continue;
+                        }
+                        spdlog::warn("Hashing {} while downloading stopped at byte {}; it will be verified from disk", partialPath, cursor);
+                        break;
+                    }
+                    hasher->update(buffer.data(), static_cast<size_t>(bytesRead));
+                    busy+=std::chrono::steady_clock::now()-start;
+                    continue;
+                }
+
+                if(finished)
+                {
+                    break;
+                }
+
+                std::unique_lock<std::mutex> lock(doneMutex);
+                doneCv.wait_for(lock, std::chrono::milliseconds(50), [&]() { return done; });
+            }
+
+            double seconds=std::chrono::duration<double>(busy).count();
+            double mb=static_cast<double>(hasher->bytesHashed())/(1024.0*1024.0);
+            spdlog::info("SHA-256 of {} computed while downloading: {:.0f} MB in {:.2f}s ({:.0f} MB/s)",
+                partialPath, mb, seconds, seconds>0.0?mb/seconds:0.0);
+        });
+    }
+
+    for(std::thread &worker:workers)
+    {
+        worker.join();
+    }
+    {
+        std::lock_guard<std::mutex> lock(doneMutex);
+        done=true;
+    }
+    doneCv.notify_all();
+    checkpointer.join();
+    if(hashFollower.joinable())
+    {
+        hashFollower.join();
+    }
+
+    bool complete=!rangesIgnored&&!writeError&&!abort&&received.load()==totalBytes;
+    bool closeFailed=false;
+    if(complete)
+    {
+        // The one full sync, before the caller renames the file into place
+        closeFailed=!file.finish(totalBytes);
+    }
+    else
+    {
+        if(!rangesIgnored)
+        {
+            saveProgress();
+        }
+        file.close();
+    }
+
+    if(rangesIgnored)
+    {
+        return SegmentedResult::RangesIgnored;
+    }
+    if(writeError||closeFailed)
+    {
+        spdlog::error("Write error during download to {}: {}", partialPath, file.error());
+        downloadState->error="Disk write error";
+        return SegmentedResult::Failed;
+    }
+    if(abort||received.load()!=totalBytes)
+    {
+        downloadState->error=lastError.empty()?"Segmented download incomplete":lastError;
+        return SegmentedResult::Failed;
+    }
+    return SegmentedResult::Completed;
+#else
+    // Positional writes need POSIX; use a single stream instead
+    (void)downloadUrl;
+    (void)filePath;
+    (void)partialPath;
+    (void)checkpoint;
+    (void)segmentRetries;
+    (void)writeConfig;
+    (void)scheduler;
+    (void)transferId;
+    (void)hasher;
+    (void)downloadState;
+    (void)progressCallback;
+    return SegmentedResult::RangesIgnored;
+#endif
+}
+
+} // anonymous namespace
+
+
 ModelDownloader::ModelDownloader(std::shared_ptr<IFileVerifier> fileVerifier) : m_fileVerifier(fileVerifier)
 {
     m_cacheDir=std::filesystem::temp_directory_path()/"arbiterAI_cache";
@@ -125,22 +755,27 @@ std::future<bool> ModelDownloader::downloadModelWithProgress(
     const std::optional<std::string> &fileHash,
     DownloadProgressCallback progressCallback,
     const std::string &modelName,
-    const std::string &variant)
+    const std::string &variant,
+    DownloadPriority priority)
 {
     // Create tracking state
     auto downloadState=std::make_shared<ActiveDownload>();
     downloadState->modelName=modelName.empty()?filePathStr:modelName;
     downloadState->variant=variant;
+    downloadState->filePath=filePathStr;
+    downloadState->priority=priority;
+    downloadState->transferId=m_scheduler.addTransfer(priority);
     downloadState->status=DownloadStatus::Pending;
     downloadState->startTime=std::chrono::steady_clock::now();
 
     {
         std::lock_guard<std::mutex> lock(m_downloadsMutex);
-        m_activeDownloads[downloadState->modelName]=downloadState;
+        m_activeDownloads[filePathStr]=downloadState;
     }
 
     return std::async(std::launch::async, [this, downloadUrl, filePathStr, fileHash, progressCallback, downloadState]()
     {
+        TransferRegistration transfer(m_scheduler, downloadState->transferId);
         downloadState->status=DownloadStatus::InProgress;
         std::filesystem::path filePath(filePathStr);
 
@@ -160,8 +795,6 @@ std::future<bool> ModelDownloader::downloadModelWithProgress(
             }
         }
 
-        spdlog::info("Downloading model from {} to {}", downloadUrl, filePath.string());
-
         try
         {
             std::filesystem::create_directories(filePath.parent_path());
@@ -174,143 +807,238 @@ std::future<bool> ModelDownloader::downloadModelWithProgress(
             return false;
         }
 
-        // Stream directly to a .partial file on disk to avoid buffering the
-        // entire response body in RAM.  A 20 GB model download would otherwise
-        // require 20+ GB of heap, which caused OOM / heap corruption (SEGV).
-        std::string partialPath=filePathStr+".partial";
 
-        // Remove stale partial file so we start fresh
+        // Peers that already hold a verified copy come before the origin;
+        // content is identified by its hash, so any source will do
+        std::vector<std::string> sources;
+        if(fileHash&&!fileHash->empty())
         {
-            std::error_code ec;
-            std::filesystem::remove(partialPath, ec);
+            for(const std::string &peer:getPeers())
+            {
+                sources.push_back(peerBlobUrl(peer, *fileHash));
+            }
         }
+        sources.push_back(downloadUrl);
 
-        std::ofstream outFile(partialPath, std::ios::binary|std::ios::trunc);
-        if(!outFile.is_open())
+        for(size_t i=0; i<sources.size(); ++i)
         {
-            spdlog::error("Failed to open partial file for writing: {}", partialPath);
-            downloadState->status=DownloadStatus::Failed;
-            downloadState->error="Failed to open "+partialPath;
-            return false;
-        }
-
-        bool writeError=false;
+            const std::string &source=sources[i];
+            bool fromPeer=i+1<sources.size();
 
-        cpr::Response r=cpr::Get(
-            cpr::Url{downloadUrl},
-            cpr::WriteCallback([&outFile, &writeError](const std::string_view &data, intptr_t) -> bool
+            if(fromPeer)
             {
-                outFile.write(data.data(), static_cast<std::streamsize>(data.size()));
-                if(!outFile.good())
+                cpr::Response probe=cpr::Head(cpr::Url{source}, cpr::Timeout{PEER_PROBE_TIMEOUT_MS});
+                if(probe.status_code!=200)
                 {
-                    writeError=true;
-                    return false; // abort transfer
+                    spdlog::debug("Peer {} does not have {}", source, filePath.filename().string());
+                    continue;
                 }
-                return true;
-            }),
-            cpr::ProgressCallback([&downloadState, &progressCallback](cpr::cpr_off_t downloadTotal,
-                cpr::cpr_off_t downloadNow,
-                cpr::cpr_off_t uploadTotal,
-                cpr::cpr_off_t uploadNow,
-                intptr_t userdata) -> bool
+            }
+
+            spdlog::info("Downloading model from {} to {}", source, filePath.string());
             {
-                (void)uploadTotal;
-                (void)uploadNow;
-                (void)userdata;
+                std::lock_guard<std::mutex> lock(downloadState->speedMutex);
+                downloadState->speedSamples.clear();
+            }
+            downloadState->bytesDownloaded=0;
+            downloadState->error.clear();
 
-                downloadState->bytesDownloaded=downloadNow;
-                downloadState->totalBytes=downloadTotal;
+            // A peer writes beside the origin's .partial and checkpoint
+            // rather than over them, so a half-finished origin download
+            // survives a peer that answers the probe and then fails
+            std::string target=fromPeer?filePathStr+".peer":filePathStr;
 
-                float percent=0.0f;
-                if(downloadTotal>0)
+            if(fetchFile(source, target, fileHash, transfer.id, downloadState, progressCallback))
+            {
+                if(fromPeer&&!adoptPeerFile(target, filePathStr))
                 {
-                    percent=(static_cast<float>(downloadNow)/downloadTotal)*100.0f;
+                    downloadState->error="Failed to move the peer copy into place";
+                    downloadState->status=DownloadStatus::Failed;
+                    return false;
                 }
-                downloadState->percentComplete=percent;
+                downloadState->status=DownloadStatus::Completed;
+                downloadState->percentComplete=100.0f;
+                return true;
+            }
+            if(!fromPeer)
+            {
+                break;
+            }
 
-                // Record speed sample
-                {
-                    std::lock_guard<std::mutex> lock(downloadState->speedMutex);
-                    std::chrono::steady_clock::time_point now=std::chrono::steady_clock::now();
+            // Leave nothing from the peer behind for the next source to trip over
+            spdlog::warn("Peer download of {} from {} failed ({}); trying the next source",
+                filePath.filename().string(), source, downloadState->error);
+            std::error_code ec;
+            std::filesystem::remove(target+".partial", ec);
+            std::filesystem::remove(checkpointPath(target), ec);
+            std::filesystem::remove(target, ec);
+        }
 
-                    downloadState->speedSamples.push_back({now, downloadNow});
+        downloadState->status=DownloadStatus::Failed;
+        return false;
+    });
+}
 
-                    // Keep only last 10 seconds of samples
-                    std::chrono::steady_clock::time_point cutoff=now-std::chrono::seconds(10);
-                    while(!downloadState->speedSamples.empty()&&downloadState->speedSamples.front().first<cutoff)
-                    {
-                        downloadState->speedSamples.pop_front();
-                    }
-                }
+bool ModelDownloader::fetchFile(const std::string &downloadUrl,
+    const std::string &filePathStr,
+    const std::optional<std::string> &fileHash,
+    int transferId,
+    const std::shared_ptr<ActiveDownload> &downloadState,
+    const DownloadProgressCallback &progressCallback)
+{
+    std::filesystem::path filePath(filePathStr);
 
-                if(progressCallback)
-                {
-                    progressCallback(downloadNow, downloadTotal, percent);
-                }
+    // Stream directly to a .partial file on disk to avoid buffering the
+    // entire response body in RAM.  A 20 GB model download would otherwise
+    // require 20+ GB of heap, which caused OOM / heap corruption (SEGV).
+    std::string partialPath=filePathStr+".partial";
 
-                return true;
-            })
-        );
+    SegmentedDownloadConfig segmentConfig=getSegmentConfig();
+    DownloadWriteConfig writeConfig=getWriteConfig();
+    bool downloaded=false;
+    bool segmented=false;
 
-        outFile.close();
+    // Hash while writing so verification is done when the last byte lands
+    std::unique_ptr<Sha256Hasher> hasher;
+    if(fileHash)
+    {
+        hasher=std::make_unique<Sha256Hasher>();
+    }
 
-        if(writeError)
+    RemoteFileInfo remote;
+    if(probeRangeSupport(downloadUrl, remote))
+    {
+        // Continue from the checkpoint left by an interrupted download of
+        // the same file version, otherwise plan fresh segments
+        DownloadCheckpoint checkpoint;
+        std::optional<DownloadCheckpoint> saved=loadCheckpoint(filePathStr);
+        std::error_code ec;
+        if(saved&&checkpointMatches(*saved, downloadUrl, remote)&&std::filesystem::exists(partialPath, ec))
         {
-            spdlog::error("Write error during download to {}", partialPath);
-            std::error_code ec;
+            checkpoint=*saved;
+            spdlog::info("Resuming download of {} at {} of {} MB",
+                filePath.filename().string(), checkpoint.completedBytes()/(1024*1024), checkpoint.totalBytes/(1024*1024));
+        }
+        else
+        {
+            if(saved)
+            {
+                spdlog::info("Discarding stale partial download of {}", filePath.filename().string());
+            }
             std::filesystem::remove(partialPath, ec);
-            downloadState->status=DownloadStatus::Failed;
-            downloadState->error="Disk write error";
-            return false;
+
+            checkpoint.url=downloadUrl;
+            checkpoint.etag=remote.etag;
+            checkpoint.lastModified=remote.lastModified;
+            checkpoint.totalBytes=remote.contentLength;
+            for(const std::pair<int64_t, int64_t> &range:planSegments(remote.contentLength, segmentConfig))
+            {
+                checkpoint.segments.push_back({range.first, range.second, range.first});
+            }
+            spdlog::info("Fetching {} in {} segment(s)", filePath.filename().string(), checkpoint.segments.size());
         }
 
-        if(r.status_code!=200)
+        SegmentedResult result=downloadSegments(downloadUrl, filePathStr, partialPath, checkpoint,
+            segmentConfig.segmentRetries, writeConfig, m_scheduler, transferId, hasher.get(), downloadState, progressCallback);
+
+        if(result==SegmentedResult::RangesIgnored)
+        {
+            spdlog::warn("Server ignored Range requests for {}; falling back to a single stream", downloadUrl);
+        }
+        else
+        {
+            segmented=true;
+            downloaded=result==SegmentedResult::Completed;
+        }
+    }
+
+    if(!segmented)
+    {
+        {
+            std::lock_guard<std::mutex> lock(downloadState->speedMutex);
+            downloadState->speedSamples.clear();
+        }
+        downloadState->bytesDownloaded=0;
+
+        // A single stream cannot be resumed; always start it over
+        std::error_code ec;
+        std::filesystem::remove(checkpointPath(filePathStr), ec);
+        if(hasher)
+        {
+            hasher->reset();
+        }
+        downloaded=downloadSingleStream(downloadUrl, partialPath, remote.contentLength, writeConfig, m_scheduler, transferId, hasher.get(), downloadState, progressCallback);
+    }
+
+    if(!downloaded)
+    {
+        // Keep a segmented .partial and its checkpoint for the next attempt
+        if(!segmented)
         {
-            spdlog::error("Failed to download model. Status code: {}", r.status_code);
             std::error_code ec;
             std::filesystem::remove(partialPath, ec);
-            downloadState->status=DownloadStatus::Failed;
-            downloadState->error="HTTP error: "+std::to_string(r.status_code);
-            return false;
         }
+        return false;
+    }
 
-        // Rename .partial -> final path atomically
+    {
+        std::error_code ec;
+        std::filesystem::remove(checkpointPath(filePathStr), ec);
+    }
+
+    // Verify before the rename, so a corrupt or tampered download never
+    // appears under the model's real filename
+    int64_t fileSize=0;
+    if(fileHash)
+    {
+        std::error_code ec;
+        fileSize=static_cast<int64_t>(std::filesystem::file_size(partialPath, ec));
+
+        bool verified;
+        if(!ec&&hasher->bytesHashed()==fileSize)
         {
-            std::error_code ec;
-            std::filesystem::rename(partialPath, filePath, ec);
-            if(ec)
-            {
-                spdlog::error("Failed to rename {} -> {}: {}", partialPath, filePath.string(), ec.message());
-                std::filesystem::remove(partialPath, ec);
-                downloadState->status=DownloadStatus::Failed;
-                downloadState->error="Failed to rename partial file";
-                return false;
-            }
+            verified=m_fileVerifier->verifyComputedHash(partialPath, hasher->finalizeHex(), *fileHash);
+        }
+        else
+        {
+            verified=m_fileVerifier->verifyFile(partialPath, *fileHash);
         }
 
-        if(fileHash)
+        if(!verified)
         {
-            if(m_fileVerifier->verifyFile(filePath.string(), *fileHash))
-            {
-                spdlog::info("Model downloaded and verified successfully: {}", filePath.string());
-                downloadState->status=DownloadStatus::Completed;
-                downloadState->percentComplete=100.0f;
-                return true;
-            }
-            else
-            {
-                spdlog::error("SHA256 verification failed for: {}", filePath.string());
-                downloadState->status=DownloadStatus::Failed;
-                downloadState->error="SHA256 verification failed";
-                return false;
-            }
+            spdlog::error("SHA256 verification failed for: {}", filePath.string());
+            std::filesystem::remove(partialPath, ec);
+            downloadState->error="SHA256 verification failed";
+            return false;
+        }
+    }
+
+    // Rename .partial -> final path atomically
+    {
+        std::error_code ec;
+        std::filesystem::rename(partialPath, filePath, ec);
+        if(ec)
+        {
+            spdlog::error("Failed to rename {} -> {}: {}", partialPath, filePath.string(), ec.message());
+            std::filesystem::remove(partialPath, ec);
+            downloadState->error="Failed to rename partial file";
+            return false;
         }
 
-        spdlog::info("Model downloaded successfully: {}", filePath.string());
-        downloadState->status=DownloadStatus::Completed;
-        downloadState->percentComplete=100.0f;
+        // Make the rename itself durable
+        DownloadFile::syncDirectory(filePath.has_parent_path()?filePath.parent_path().string():".");
+    }
+
+    if(fileHash)
+    {
+        spdlog::info("Model downloaded and verified successfully: {}", filePath.string());
+        downloadState->bytesDownloaded=fileSize;
+        downloadState->totalBytes=fileSize;
         return true;
-    });
+    }
+
+    spdlog::info("Model downloaded successfully: {}", filePath.string());
+    return true;
 }
 
 std::shared_ptr<ActiveDownload> ModelDownloader::getDownloadState(const std::string &modelName)
@@ -321,11 +1049,76 @@ std::shared_ptr<ActiveDownload> ModelDownloader::getDownloadState(const std::str
     {
         return it->second;
     }
-    return nullptr;
+
+    // Prefer a file still in flight, otherwise the most recently started
+    std::shared_ptr<ActiveDownload> latest;
+    for(const std::pair<const std::string, std::shared_ptr<ActiveDownload>> &entry:m_activeDownloads)
+    {
+        const std::shared_ptr<ActiveDownload> &download=entry.second;
+        if(download->modelName!=modelName)
+        {
+            continue;
+        }
+
+        DownloadStatus status=download->status.load();
+        if(status==DownloadStatus::InProgress||status==DownloadStatus::Pending)
+        {
+            return download;
+        }
+        if(!latest||download->startTime>latest->startTime)
+        {
+            latest=download;
+        }
+    }
+    return latest;
+}
+
+void ModelDownloader::setMaxConnections(int max)
+{
+    m_scheduler.setMaxConnections(max);
+}
+
+int ModelDownloader::getMaxConnections() const
+{
+    return m_scheduler.getMaxConnections();
+}
+
+void ModelDownloader::setBandwidthLimit(int64_t bytesPerSecond)
+{
+    m_scheduler.setBandwidthLimit(bytesPerSecond);
+}
+
+int64_t ModelDownloader::getBandwidthLimit() const
+{
+    return m_scheduler.getBandwidthLimit();
+}
+
+void ModelDownloader::setPriority(const std::string &modelName, DownloadPriority priority)
+{
+    std::lock_guard<std::mutex> lock(m_downloadsMutex);
+    for(const std::pair<const std::string, std::shared_ptr<ActiveDownload>> &entry:m_activeDownloads)
+    {
+        const std::shared_ptr<ActiveDownload> &download=entry.second;
+        DownloadStatus status=download->status.load();
+        if(download->modelName!=modelName||(status!=DownloadStatus::InProgress&&status!=DownloadStatus::Pending))
+        {
+            continue;
+        }
+
+        download->priority=priority;
+        m_scheduler.setTransferPriority(download->transferId, priority);
+    }
 }
 
 int64_t ModelDownloader::getPartialDownloadSize(const std::string &filePath)
 {
+    // A segmented .partial is preallocated to full size; the checkpoint
+    // knows how much of it is filled in
+    if(std::optional<DownloadCheckpoint> checkpoint=loadCheckpoint(filePath))
+    {
+        return checkpoint->completedBytes();
+    }
+
     std::string partialPath = filePath + ".partial";
     if (std::filesystem::exists(partialPath))
     {
@@ -334,6 +1127,221 @@ int64_t ModelDownloader::getPartialDownloadSize(const std::string &filePath)
     return 0;
 }
 
+int64_t DownloadCheckpoint::completedBytes() const
+{
+    int64_t completed=0;
+    for(const Segment &segment:segments)
+    {
+        completed+=std::min(segment.next, segment.last+1)-segment.first;
+    }
+    return completed;
+}
+
+bool ModelDownloader::adoptPeerFile(const std::string &peerPath, const std::string &filePath)
+{
+    std::error_code ec;
+    std::filesystem::rename(peerPath, filePath, ec);
+    if(ec)
+    {
+        spdlog::error("Failed to rename {} -> {}: {}", peerPath, filePath, ec.message());
+        std::filesystem::remove(peerPath, ec);
+        return false;
+    }
+
+    std::filesystem::path path(filePath);
+    DownloadFile::syncDirectory(path.has_parent_path()?path.parent_path().string():".");
+
+    // The origin's partial download is no longer needed
+    std::filesystem::remove(filePath+".partial", ec);
+    std::filesystem::remove(checkpointPath(filePath), ec);
+    return true;
+}
+
+std::string ModelDownloader::checkpointPath(const std::string &filePath)
+{
+    return filePath+".partial.json";
+}
+
+std::optional<DownloadCheckpoint> ModelDownloader::loadCheckpoint(const std::string &filePath)
+{
+    std::ifstream file(checkpointPath(filePath));
+    if(!file.is_open())
+    {
+        return std::nullopt;
+    }
+
+    try
+    {
+        nlohmann::json j;
+        file>>j;
+
+        DownloadCheckpoint checkpoint;
+        checkpoint.url=j.value("url", "");
+        checkpoint.etag=j.value("etag", "");
+        checkpoint.lastModified=j.value("last_modified", "");
+        checkpoint.totalBytes=j.value("total_bytes", static_cast<int64_t>(0));
+
+        int64_t expectedFirst=0;
+        for(const nlohmann::json &segmentJson:j.at("segments"))
+        {
+            DownloadCheckpoint::Segment segment;
+            segment.first=segmentJson.at("first").get<int64_t>();
+            segment.last=segmentJson.at("last").get<int64_t>();
+            segment.next=segmentJson.at("next").get<int64_t>();
+
+            // Segments must tile the file in order
+            if(segment.first!=expectedFirst||segment.last<segment.first||
+                segment.next<segment.first||segment.next>segment.last+1)
+            {
+                spdlog::warn("Ignoring inconsistent download checkpoint {}", checkpointPath(filePath));
+                return std::nullopt;
+            }
+            expectedFirst=segment.last+1;
+            checkpoint.segments.push_back(segment);
+        }
+
+        if(expectedFirst!=checkpoint.totalBytes)
+        {
+            spdlog::warn("Ignoring inconsistent download checkpoint {}", checkpointPath(filePath));
+            return std::nullopt;
+        }
+        return checkpoint;
+    }
+    catch(const std::exception &e)
+    {
+        spdlog::warn("Failed to read download checkpoint {}: {}", checkpointPath(filePath), e.what());
+        return std::nullopt;
+    }
+}
+
+bool ModelDownloader::saveCheckpoint(const std::string &filePath, const DownloadCheckpoint &checkpoint)
+{
+    nlohmann::json segments=nlohmann::json::array();
+    for(const DownloadCheckpoint::Segment &segment:checkpoint.segments)
+    {
+        segments.push_back({
+            {"first", segment.first},
+            {"last", segment.last},
+            {"next", segment.next}
+        });
+    }
+
+    nlohmann::json j={
+        {"url", checkpoint.url},
+        {"etag", checkpoint.etag},
+        {"last_modified", checkpoint.lastModified},
+        {"total_bytes", checkpoint.totalBytes},
+        {"segments", segments}
+    };
+
+    // Write then rename so a crash never leaves a torn checkpoint
+    std::string path=checkpointPath(filePath);
+    std::string tmpPath=path+".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::trunc);
+        if(!file.is_open())
+        {
+            return false;
+        }
+        file<<j.dump();
+        if(!file.good())
+        {
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, path, ec);
+    if(ec)
+    {
+        spdlog::warn("Failed to save download checkpoint {}: {}", path, ec.message());
+        return false;
+    }
+    return true;
+}
+
+void ModelDownloader::setSegmentConfig(const SegmentedDownloadConfig &config)
+{
+    std::lock_guard<std::mutex> lock(m_configMutex);
+    m_segmentConfig=config;
+    m_segmentConfig.maxSegments=std::max(1, config.maxSegments);
+    m_segmentConfig.minSegmentBytes=std::max<int64_t>(1, config.minSegmentBytes);
+    m_segmentConfig.segmentRetries=std::max(0, config.segmentRetries);
+}
+
+SegmentedDownloadConfig ModelDownloader::getSegmentConfig() const
+{
+    std::lock_guard<std::mutex> lock(m_configMutex);
+    return m_segmentConfig;
+}
+
+void ModelDownloader::setWriteConfig(const DownloadWriteConfig &config)
+{
+    std::lock_guard<std::mutex> lock(m_configMutex);
+    m_writeConfig=config;
+}
+
+DownloadWriteConfig ModelDownloader::getWriteConfig() const
+{
+    std::lock_guard<std::mutex> lock(m_configMutex);
+    return m_writeConfig;
+}
+
+void ModelDownloader::setPeers(const std::vector<std::string> &peers)
+{
+    std::lock_guard<std::mutex> lock(m_configMutex);
+    m_peers.clear();
+    for(const std::string &peer:peers)
+    {
+        if(!peer.empty())
+        {
+            m_peers.push_back(peer);
+        }
+    }
+}
+
+std::vector<std::string> ModelDownloader::getPeers() const
+{
+    std::lock_guard<std::mutex> lock(m_configMutex);
+    return m_peers;
+}
+
+std::string ModelDownloader::peerBlobUrl(const std::string &peer, const std::string &sha256)
+{
+    std::string base=peer;
+    while(!base.empty()&&base.back()=='/')
+    {
+        base.pop_back();
+    }
+
+    std::string hash=sha256;
+    std::transform(hash.begin(), hash.end(), hash.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return base+"/api/blobs/sha256/"+hash;
+}
+
+std::vector<std::pair<int64_t, int64_t>> ModelDownloader::planSegments(int64_t totalBytes, const SegmentedDownloadConfig &config)
+{
+    std::vector<std::pair<int64_t, int64_t>> segments;
+    if(totalBytes<=0)
+    {
+        return segments;
+    }
+
+    int64_t minSegmentBytes=std::max<int64_t>(1, config.minSegmentBytes);
+    int64_t count=std::max<int64_t>(1, std::min<int64_t>(config.maxSegments, totalBytes/minSegmentBytes));
+    int64_t segmentBytes=totalBytes/count;
+
+    int64_t first=0;
+    for(int64_t i=0; i<count; ++i)
+    {
+        // The last segment absorbs the remainder
+        int64_t last=(i==count-1)?totalBytes-1:first+segmentBytes-1;
+        segments.push_back({first, last});
+        first=last+1;
+    }
+    return segments;
+}
+
 DownloadProgressSnapshot ModelDownloader::buildSnapshot(const std::shared_ptr<ActiveDownload> &download)
 {
     DownloadProgressSnapshot snap;
@@ -341,6 +1349,7 @@ DownloadProgressSnapshot ModelDownloader::buildSnapshot(const std::shared_ptr<Ac
     snap.bytesDownloaded=download->bytesDownloaded.load();
     snap.totalBytes=download->totalBytes.load();
     snap.percentComplete=download->percentComplete.load();
+    snap.connections=download->connections.load();
     snap.modelName=download->modelName;
     snap.variant=download->variant;
 
@@ -374,40 +1383,89 @@ DownloadProgressSnapshot ModelDownloader::buildSnapshot(const std::shared_ptr<Ac
     return snap;
 }
 
-std::optional<DownloadProgressSnapshot> ModelDownloader::getProgressSnapshot(const std::string &modelName)
+DownloadProgressSnapshot ModelDownloader::buildVariantSnapshot(const std::string &modelName, const std::string &variant)
 {
-    std::lock_guard<std::mutex> lock(m_downloadsMutex);
+    DownloadProgressSnapshot snap;
+    snap.modelName=modelName;
+    snap.variant=variant;
+    snap.files=0;
+    snap.priority=DownloadPriority::Prefetch;
 
-    auto it=m_activeDownloads.find(modelName);
-    if(it==m_activeDownloads.end())
+    double bytesPerSec=0.0;
+    for(const std::pair<const std::string, std::shared_ptr<ActiveDownload>> &entry:m_activeDownloads)
     {
-        return std::nullopt;
+        const std::shared_ptr<ActiveDownload> &download=entry.second;
+        if(download->modelName!=modelName||download->variant!=variant)
+        {
+            continue;
+        }
+
+        DownloadProgressSnapshot file=buildSnapshot(download);
+        snap.bytesDownloaded+=file.bytesDownloaded;
+        snap.totalBytes+=file.totalBytes;
+        snap.connections+=file.connections;
+        snap.priority=std::min(snap.priority, download->priority.load());
+        ++snap.files;
+        if(download->status.load()==DownloadStatus::Completed)
+        {
+            ++snap.filesCompleted;
+        }
+        else
+        {
+            // Per-file rolling rates add up to the variant's rate
+            bytesPerSec+=file.speedMbps*1024.0*1024.0;
+        }
     }
 
-    DownloadStatus status=it->second->status.load();
-    if(status!=DownloadStatus::InProgress && status!=DownloadStatus::Pending)
+    snap.speedMbps=bytesPerSec/(1024.0*1024.0);
+    if(snap.totalBytes>0)
     {
-        return std::nullopt;
+        snap.percentComplete=(static_cast<float>(snap.bytesDownloaded)/snap.totalBytes)*100.0f;
     }
 
-    return buildSnapshot(it->second);
+    int64_t remaining=snap.totalBytes-snap.bytesDownloaded;
+    if(remaining>0&&bytesPerSec>0.0)
+    {
+        snap.etaSeconds=static_cast<int>(static_cast<double>(remaining)/bytesPerSec);
+    }
+    return snap;
 }
 
-std::vector<DownloadProgressSnapshot> ModelDownloader::getActiveSnapshots()
+std::optional<DownloadProgressSnapshot> ModelDownloader::getProgressSnapshot(const std::string &modelName)
 {
     std::lock_guard<std::mutex> lock(m_downloadsMutex);
 
-    std::vector<DownloadProgressSnapshot> result;
+    for(const std::pair<const std::string, std::shared_ptr<ActiveDownload>> &entry:m_activeDownloads)
+    {
+        DownloadStatus status=entry.second->status.load();
+        if(entry.second->modelName==modelName&&(status==DownloadStatus::InProgress || status==DownloadStatus::Pending))
+        {
+            return buildVariantSnapshot(modelName, entry.second->variant);
+        }
+    }
+    return std::nullopt;
+}
 
+std::vector<DownloadProgressSnapshot> ModelDownloader::getActiveSnapshots()
+{
+    std::lock_guard<std::mutex> lock(m_downloadsMutex);
+
+    // One snapshot per model/variant with at least one file still in flight
+    std::set<std::pair<std::string, std::string>> variants;
     for(const std::pair<const std::string, std::shared_ptr<ActiveDownload>> &entry:m_activeDownloads)
     {
         DownloadStatus status=entry.second->status.load();
         if(status==DownloadStatus::InProgress || status==DownloadStatus::Pending)
         {
-            result.push_back(buildSnapshot(entry.second));
+            variants.insert({entry.second->modelName, entry.second->variant});
         }
     }
 
+    std::vector<DownloadProgressSnapshot> result;
+    for(const std::pair<std::string, std::string> &variant:variants)
+    {
+        result.push_back(buildVariantSnapshot(variant.first, variant.second));
+    }
     return result;
 }
 
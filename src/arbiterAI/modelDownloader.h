@@ -4,6 +4,8 @@
 #include "arbiterAI/modelManager.h"
 #include "arbiterAI/arbiterAI.h"
 #include "arbiterAI/fileVerifier.h"
+#include "arbiterAI/downloadScheduler.h"
+#include "arbiterAI/downloadWriter.h"
 
 #include <string>
 #include <future>
@@ -15,12 +17,17 @@
 #include <chrono>
 #include <deque>
 #include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <utility>
 
 namespace arbiterAI
 {
 
 /**
  * @brief Progress callback for model downloads
+ *
+ * Segmented downloads call it from several threads at once.
  * @param bytesDownloaded Current bytes downloaded
  * @param totalBytes Total file size (0 if unknown)
  * @param percentComplete Percentage complete (0-100)
@@ -29,6 +36,37 @@ using DownloadProgressCallback = std::function<void(int64_t bytesDownloaded,
                                                       int64_t totalBytes, 
                                                       float percentComplete)>;
 
+/**
+ * @struct SegmentedDownloadConfig
+ * @brief How large files are split into concurrent HTTP Range requests
+ */
+struct SegmentedDownloadConfig {
+    int maxSegments=4;                          // connections per file (1 = single stream)
+    int64_t minSegmentBytes=32*1024*1024;       // never split below this size per segment
+    int segmentRetries=3;                       // retries per segment before the download fails
+};
+
+/**
+ * @struct DownloadCheckpoint
+ * @brief Resume state of a segmented download, saved beside its .partial file
+ */
+struct DownloadCheckpoint {
+    struct Segment {
+        int64_t first=0;
+        int64_t last=0;         // inclusive
+        int64_t next=0;         // first byte not yet written
+    };
+
+    std::string url;
+    std::string etag;           // validators the partial data was fetched against
+    std::string lastModified;
+    int64_t totalBytes=0;
+    std::vector<Segment> segments;
+
+    /// Bytes already written across all segments.
+    int64_t completedBytes() const;
+};
+
 /**
  * @struct ActiveDownload
  * @brief Tracks the state of an active download
@@ -38,9 +76,13 @@ struct ActiveDownload {
     std::atomic<int64_t> totalBytes{0};
     std::atomic<float> percentComplete{0.0f};
     std::atomic<DownloadStatus> status{DownloadStatus::NotStarted};
+    std::atomic<int> connections{0};
+    std::atomic<DownloadPriority> priority{DownloadPriority::Explicit};
+    std::atomic<int> transferId{0};     // bandwidth bucket in the scheduler
     std::string error;
     std::string modelName;
     std::string variant;
+    std::string filePath;
 
     // Speed tracking (guarded by speedMutex)
     mutable std::mutex speedMutex;
@@ -51,13 +93,21 @@ struct ActiveDownload {
 /**
  * @struct DownloadProgressSnapshot
  * @brief Point-in-time snapshot of a download's progress including speed and ETA
+ *
+ * Files downloaded under the same model and variant (the shards of a split
+ * GGUF) are summed into one snapshot.
  */
 struct DownloadProgressSnapshot {
     int64_t bytesDownloaded=0;
     int64_t totalBytes=0;
     float percentComplete=0.0f;
-    double speedMbps=0.0;       // rolling average MB/s
+    double speedMbps=0.0;       // rolling average MB/s, summed over all connections
     int etaSeconds=0;           // estimated time remaining
+    int connections=0;          // open HTTP connections (segments in flight)
+    int files=1;                // files in this download
+    int filesCompleted=0;       // files downloaded and verified
+    DownloadPriority priority=DownloadPriority::Explicit;
+    int queuePosition=0;        // 1-based position while waiting to start, 0 once running
     std::string modelName;
     std::string variant;
 };
@@ -68,9 +118,11 @@ struct DownloadProgressSnapshot {
  *
  * Features:
  * - Asynchronous downloading
+ * - Segmented downloads over concurrent HTTP Range requests
  * - Progress tracking via callbacks
  * - SHA256 verification
- * - Resume capability for interrupted downloads
+ * - Fetching files by sha256 from peer arbiterAI servers before the origin
+ * - Resume of interrupted segmented downloads from a saved checkpoint
  * - Caching of downloaded configs
  */
 class ModelDownloader
@@ -101,6 +153,7 @@ public:
      * @param progressCallback Callback for progress updates
      * @param modelName Name for tracking in active downloads
      * @param variant Quantization variant name for tracking
+     * @param priority Scheduling class for connections and bandwidth
      * @return Future that resolves to true on success
      */
     std::future<bool> downloadModelWithProgress(const std::string &downloadUrl,
@@ -108,12 +161,14 @@ public:
                                                   const std::optional<std::string> &fileHash,
                                                   DownloadProgressCallback progressCallback,
                                                   const std::string &modelName = "",
-                                                  const std::string &variant = "");
+                                                  const std::string &variant = "",
+                                                  DownloadPriority priority = DownloadPriority::Explicit);
 
     /**
      * @brief Get the current download state for a model
-     * @param modelName Name of the model
-     * @return Active download state, or nullptr if not downloading
+     * @param modelName Name of the model, or the file path of one of its files
+     * @return Download state (an in-progress file if the model has several),
+     *         or nullptr if never downloaded
      */
     std::shared_ptr<ActiveDownload> getDownloadState(const std::string &modelName);
 
@@ -132,11 +187,67 @@ public:
 
     /**
      * @brief Check if a download can be resumed
-     * @param filePath Path to the partial file
+     * @param filePath Path of the final model file
      * @return Number of bytes already downloaded, or 0 if no partial file
      */
     int64_t getPartialDownloadSize(const std::string &filePath);
 
+    /// Set the global limit on HTTP connections across all downloads.
+    void setMaxConnections(int max);
+
+    /// Get the global HTTP connection limit.
+    int getMaxConnections() const;
+
+    /// Set the total download bandwidth in bytes per second (0 = unlimited).
+    void setBandwidthLimit(int64_t bytesPerSecond);
+
+    /// Get the total download bandwidth limit.
+    int64_t getBandwidthLimit() const;
+
+    /// Change the priority of a model's in-flight files, e.g. when a load
+    /// starts waiting on a prefetch.
+    void setPriority(const std::string &modelName, DownloadPriority priority);
+
+    /// Set how files are split into concurrent Range requests.
+    void setSegmentConfig(const SegmentedDownloadConfig &config);
+
+    /// Get the current segmented download configuration.
+    SegmentedDownloadConfig getSegmentConfig() const;
+
+    /// Set how downloaded bytes are buffered and written to disk.
+    void setWriteConfig(const DownloadWriteConfig &config);
+
+    /// Get the current write configuration.
+    DownloadWriteConfig getWriteConfig() const;
+
+    /// Set other arbiterAI servers (e.g. "http://10.0.0.5:8080") to try
+    /// before the origin URL for files with a known sha256. A peer that
+    /// doesn't have the file, fails or serves bad data is skipped.
+    void setPeers(const std::vector<std::string> &peers);
+
+    /// Get the peer servers, in the order they are tried.
+    std::vector<std::string> getPeers() const;
+
+    /// URL under which a peer serves its stored copy of sha256.
+    static std::string peerBlobUrl(const std::string &peer, const std::string &sha256);
+
+    /**
+     * @brief Split a file into inclusive byte ranges for concurrent fetching
+     * @param totalBytes Size of the file
+     * @param config Segment count and minimum segment size
+     * @return One [first, last] range per segment, covering the whole file
+     */
+    static std::vector<std::pair<int64_t, int64_t>> planSegments(int64_t totalBytes, const SegmentedDownloadConfig &config);
+
+    /// Path of the checkpoint kept beside the .partial file for filePath.
+    static std::string checkpointPath(const std::string &filePath);
+
+    /// Read the checkpoint for filePath, or nullopt if missing or inconsistent.
+    static std::optional<DownloadCheckpoint> loadCheckpoint(const std::string &filePath);
+
+    /// Atomically replace the checkpoint for filePath.
+    static bool saveCheckpoint(const std::string &filePath, const DownloadCheckpoint &checkpoint);
+
     // GitHub API functions
     std::future<std::optional<nlohmann::json>> downloadConfigFromRepo(const std::string &repoOwner, 
                                                                         const std::string &repoName, 
@@ -150,12 +261,37 @@ private:
     void saveToCache(const std::string &key, const nlohmann::json &config);
     DownloadProgressSnapshot buildSnapshot(const std::shared_ptr<ActiveDownload> &download);
 
+    /// Fetch downloadUrl into filePath through a .partial file and verify
+    /// it against fileHash. Sets downloadState->error on failure; the
+    /// caller owns the download status.
+    bool fetchFile(const std::string &downloadUrl,
+        const std::string &filePath,
+        const std::optional<std::string> &fileHash,
+        int transferId,
+        const std::shared_ptr<ActiveDownload> &downloadState,
+        const DownloadProgressCallback &progressCallback);
+
+    /// Move a verified peer copy from peerPath to filePath and drop the
+    /// origin's .partial and checkpoint for filePath.
+    bool adoptPeerFile(const std::string &peerPath, const std::string &filePath);
+
+    /// Sum the snapshots of every file of modelName/variant into one.
+    /// NOTE: caller must hold m_downloadsMutex
+    DownloadProgressSnapshot buildVariantSnapshot(const std::string &modelName, const std::string &variant);
+
     std::filesystem::path m_cacheDir;
     std::shared_ptr<IFileVerifier> m_fileVerifier;
     
-    // Track active downloads
+    // Track active downloads, keyed by file path
     std::map<std::string, std::shared_ptr<ActiveDownload>> m_activeDownloads;
     std::mutex m_downloadsMutex;
+
+    SegmentedDownloadConfig m_segmentConfig;
+    DownloadWriteConfig m_writeConfig;
+    std::vector<std::string> m_peers;
+    mutable std::mutex m_configMutex;
+
+    DownloadScheduler m_scheduler;
 };
 
 } // namespace arbiterAI
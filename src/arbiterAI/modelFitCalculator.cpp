@@ -62,10 +62,38 @@ std::vector<int> ModelFitCalculator::allGpuIndices(const SystemInfo &hw)
     return indices;
 }
 
+double ModelFitCalculator::kvBytesPerElement(const std::string &kvCacheType)
+{
+    // Block-quantized types store 32 elements per block plus scale(s)
+    if(kvCacheType=="f32")    return 4.0;
+    if(kvCacheType=="f16")    return 2.0;
+    if(kvCacheType=="bf16")   return 2.0;
+    if(kvCacheType=="q8_0")   return 34.0/32.0;
+    if(kvCacheType=="q5_1")   return 24.0/32.0;
+    if(kvCacheType=="q5_0")   return 22.0/32.0;
+    if(kvCacheType=="q4_1")   return 20.0/32.0;
+    if(kvCacheType=="q4_0")   return 18.0/32.0;
+    if(kvCacheType=="iq4_nl") return 18.0/32.0;
+    return 0.0;
+}
+
+double ModelFitCalculator::kvBytesPerToken(const ContextScaling &scaling, const std::string &kvCacheType)
+{
+    double elementBytes=kvBytesPerElement(kvCacheType);
+    if(elementBytes<=0.0)
+    {
+        elementBytes=kvBytesPerElement("f16");
+    }
+
+    double f16BytesPerToken=static_cast<double>(scaling.vramPer1kContextMb)*1024.0*1024.0/1024.0;
+    return f16BytesPerToken*elementBytes/kvBytesPerElement("f16");
+}
+
 int ModelFitCalculator::estimateMaxContext(
     int availableVramMb,
     int variantMinVramMb,
-    const ContextScaling &scaling)
+    const ContextScaling &scaling,
+    const std::string &kvCacheType)
 {
     if(scaling.vramPer1kContextMb<=0)
     {
@@ -79,8 +107,10 @@ int ModelFitCalculator::estimateMaxContext(
         return scaling.baseContext;
     }
 
-    // Each 1K additional context tokens costs vramPer1kContextMb MB
-    int extraContextTokens=(extraVramMb/scaling.vramPer1kContextMb)*1024;
+    // Each 1K additional context tokens costs vramPer1kContextMb MB at f16,
+    // less with a quantized KV cache
+    double mbPer1k=kvBytesPerToken(scaling, kvCacheType)*1024.0/(1024.0*1024.0);
+    int extraContextTokens=static_cast<int>(extraVramMb/mbPer1k)*1024;
     int maxContext=scaling.baseContext+extraContextTokens;
 
     // Clamp to the model's maximum supported context
@@ -92,15 +122,125 @@ int ModelFitCalculator::estimateMaxContext(
     return maxContext;
 }
 
+int ModelFitCalculator::ExactEstimate::kvMb(int contextSize) const
+{
+    int64_t bytes=gguf.kvCacheBytes(contextSize, kvBytesPerElement);
+    return static_cast<int>(bytes*kvFactor/(1024.0*1024.0)+0.5);
+}
+
+std::optional<ModelFitCalculator::ExactEstimate> ModelFitCalculator::exactEstimate(
+    const ModelInfo &model,
+    const ModelVariant &variant,
+    const std::string &kvCacheType)
+{
+    std::optional<GgufModelInfo> gguf=GgufMetadataCache::instance().get(variant);
+    if(!gguf.has_value()||gguf->nLayer<=0||gguf->weightBytes<=0)
+    {
+        return std::nullopt;
+    }
+
+    ExactEstimate estimate;
+    estimate.gguf=std::move(gguf.value());
+    estimate.kvBytesPerElement=kvBytesPerElement(kvCacheType);
+    if(estimate.kvBytesPerElement<=0.0)
+    {
+        estimate.kvBytesPerElement=kvBytesPerElement("f16");
+    }
+
+    double weightFactor=1.0;
+    int computeMb=DEFAULT_COMPUTE_BUFFER_MB;
+
+    std::optional<MemoryCalibrationEntry> cal=MemoryCalibration::instance().get(model.model, variant.quantization);
+    if(cal.has_value())
+    {
+        weightFactor=cal->weightFactor;
+        estimate.kvFactor=cal->kvFactor;
+        if(cal->computeBufferMb>0)
+        {
+            computeMb=cal->computeBufferMb;
+        }
+    }
+
+    estimate.fixedMb=static_cast<int>(estimate.gguf.weightBytes*weightFactor/(1024.0*1024.0)+0.5)+computeMb;
+    return estimate;
+}
+
+int ModelFitCalculator::exactMaxContext(const ExactEstimate &estimate, int availableVramMb, int contextCap)
+{
+    constexpr int step=256;
+
+    if(contextCap<step||estimate.totalMb(step)>availableVramMb)
+    {
+        return 0;
+    }
+    if(estimate.totalMb(contextCap)<=availableVramMb)
+    {
+        return contextCap;
+    }
+
+    // KV size is monotonic in context — binary search over 256-token steps
+    int low=1;
+    int high=contextCap/step;
+    while(low<high)
+    {
+        int mid=(low+high+1)/2;
+        if(estimate.totalMb(mid*step)<=availableVramMb)
+        {
+            low=mid;
+        }
+        else
+        {
+            high=mid-1;
+        }
+    }
+    return low*step;
+}
+
 ModelFit ModelFitCalculator::calculateModelFit(
     const ModelInfo &model,
     const ModelVariant &variant,
-    const SystemInfo &hw)
+    const SystemInfo &hw,
+    const std::string &kvCacheType)
 {
     ModelFit fit;
     fit.model=model.model;
     fit.variant=variant.quantization;
     fit.canRun=false;
+    fit.kvCacheType=kvCacheType;
+
+    // Prefer exact sizes from the GGUF header once the variant is on disk
+    std::optional<ExactEstimate> exact=exactEstimate(model, variant, kvCacheType);
+
+    int contextCap=model.contextScaling.has_value()?model.contextScaling->maxContext:model.contextWindow;
+    int baseContext=model.contextScaling.has_value()?model.contextScaling->baseContext:model.contextWindow;
+    int minVramMb=variant.minVramMb;
+
+    // A variant that needs no VRAM, or a host without GPUs, runs from
+    // system RAM; the exact size is checked against that instead
+    bool hostMemory=variant.minVramMb==0||hw.gpus.empty();
+    if(exact.has_value())
+    {
+        if(exact->gguf.contextLength>0)
+        {
+            contextCap=contextCap>0?std::min(contextCap, exact->gguf.contextLength):exact->gguf.contextLength;
+        }
+        baseContext=std::min(baseContext>0?baseContext:4096, contextCap);
+        fit.estimateSource="gguf";
+
+        if(hostMemory)
+        {
+            if(hw.totalRamMb>0&&exact->totalMb(baseContext)>hw.totalRamMb)
+            {
+                fit.limitingFactor="ram";
+                return fit;
+            }
+            minVramMb=0;
+        }
+        else
+        {
+            minVramMb=exact->totalMb(baseContext);
+        }
+    }
 
     // Check system RAM requirement
     if(model.hardwareRequirements.has_value())
@@ -119,9 +259,9 @@ ModelFit ModelFitCalculator::calculateModelFit(
     int totalFreeVram=sumFreeVram(hw, gpuIndices);
 
     // Check minimum VRAM requirement
-    if(variant.minVramMb>0)
+    if(minVramMb>0)
     {
-        if(totalFreeVram<variant.minVramMb)
+        if(totalFreeVram<minVramMb)
         {
             // Can't run even with all GPUs — check if CPU-only fallback is possible
             if(model.hardwareRequirements.has_value()&&
@@ -183,7 +323,7 @@ ModelFit ModelFitCalculator::calculateModelFit(
                 accumulated+=gpu.vramFreeMb;
             }
 
-            if(accumulated>=variant.minVramMb)
+            if(accumulated>=minVramMb)
             {
                 break;
             }
@@ -195,10 +335,50 @@ ModelFit ModelFitCalculator::calculateModelFit(
 
     // Calculate max context size
     int availableVram=sumFreeVram(hw, selectedGpus);
+    int exactContext=0;
+    if(exact.has_value())
+    {
+        // Without GPUs the whole model lives in system RAM
+        int budgetMb=selectedGpus.empty()?hw.totalRamMb:availableVram;
+        exactContext=exactMaxContext(exact.value(), budgetMb, contextCap);
+    }
+    if(exactContext>0&&selectedGpus.empty())
+    {
+        fit.maxContextSize=exactContext;
+        fit.estimatedVramUsageMb=0;
+        return fit;
+    }
+    if(exactContext>0)
+    {
+        fit.maxContextSize=exactContext;
+        fit.estimatedVramUsageMb=exact->totalMb(fit.maxContextSize);
+
+        // llama.cpp splits layers by free memory; mirror that per device
+        int remaining=fit.estimatedVramUsageMb;
+        for(size_t i=0; i<selectedGpus.size(); ++i)
+        {
+            int share=remaining;
+            if(i+1<selectedGpus.size()&&availableVram>0)
+            {
+                share=static_cast<int>(static_cast<int64_t>(fit.estimatedVramUsageMb)*
+                    sumFreeVram(hw, {selectedGpus[i]})/availableVram);
+            }
+            fit.perGpuVramMb[selectedGpus[i]]=share;
+            remaining-=share;
+        }
+        return fit;
+    }
+    if(exact.has_value())
+    {
+        // Not even 256 tokens fit by the exact numbers (or the cap is below
+        // that); size the context from the config estimate instead
+        fit.estimateSource="config";
+    }
+
     if(model.contextScaling.has_value())
     {
         fit.maxContextSize=estimateMaxContext(
-            availableVram, variant.minVramMb, model.contextScaling.value());
+            availableVram, variant.minVramMb, model.contextScaling.value(), kvCacheType);
     }
     else
     {
@@ -212,13 +392,99 @@ ModelFit ModelFitCalculator::calculateModelFit(
         int extraContext=fit.maxContextSize-model.contextScaling->baseContext;
         if(extraContext>0)
         {
-            fit.estimatedVramUsageMb+=(extraContext/1024)*model.contextScaling->vramPer1kContextMb;
+            double kvBytes=kvBytesPerToken(model.contextScaling.value(), kvCacheType);
+            fit.estimatedVramUsageMb+=static_cast<int>((extraContext/1024)*1024*kvBytes/(1024.0*1024.0));
         }
     }
 
     return fit;
 }
 
+ModelFit ModelFitCalculator::selectBestFit(
+    const ModelInfo &model,
+    const SystemInfo &hw,
+    int requestedContext,
+    const std::string &variant,
+    const std::optional<std::string> &kvCacheType)
+{
+    int targetContext=requestedContext;
+    if(targetContext<=0)
+    {
+        targetContext=model.contextScaling.has_value()
+            ?model.contextScaling->maxContext
+            :model.contextWindow;
+    }
+
+    // Best quality first (same ranking as variant auto-selection)
+    std::vector<const ModelVariant *> variants;
+    for(const ModelVariant &v:model.variants)
+    {
+        if(variant.empty()||v.quantization==variant)
+        {
+            variants.push_back(&v);
+        }
+    }
+    std::stable_sort(variants.begin(), variants.end(),
+        [](const ModelVariant *a, const ModelVariant *b)
+        {
+            return a->recommendedVramMb>b->recommendedVramMb;
+        });
+
+    // q8_0 KV is near-lossless, so it is preferred over a smaller variant;
+    // q4_0 KV is only used once no variant reaches the context otherwise
+    std::vector<std::vector<std::string>> tiers;
+    if(kvCacheType.has_value())
+    {
+        tiers.push_back({kvCacheType.value()});
+    }
+    else
+    {
+        tiers.push_back({"f16", "q8_0"});
+        tiers.push_back({"q4_0"});
+    }
+
+    std::optional<ModelFit> largest;
+    for(const std::vector<std::string> &tier:tiers)
+    {
+        for(const ModelVariant *v:variants)
+        {
+            for(const std::string &kvType:tier)
+            {
+                ModelFit fit=calculateModelFit(model, *v, hw, kvType);
+                if(!fit.canRun)
+                {
+                    continue;
+                }
+                // A CPU fallback never counts as reaching the context
+                if(fit.maxContextSize>=targetContext&&fit.limitingFactor.empty())
+                {
+                    return fit;
+                }
+                if(!largest.has_value()||fit.maxContextSize>largest->maxContextSize)
+                {
+                    largest=fit;
+                }
+            }
+        }
+    }
+
+    if(largest.has_value())
+    {
+        return largest.value();
+    }
+
+    // Nothing runs — report why using the preferred candidate
+    if(!variants.empty())
+    {
+        return calculateModelFit(model, *variants.front(), hw, tiers.front().front());
+    }
+
+    ModelFit fit;
+    fit.model=model.model;
+    fit.variant=variant;
+    return fit;
+}
+
 std::vector<ModelFit> ModelFitCalculator::calculateFittableModels(
     const std::vector<ModelInfo> &models,
     const SystemInfo &hw)
@@ -3,9 +3,12 @@
 
 #include <string>
 #include <vector>
+#include <optional>
 
 #include "hardwareDetector.h"
 #include "modelManager.h"
+#include "ggufReader.h"
+#include "memoryCalibration.h"
 
 namespace arbiterAI
 {
@@ -18,15 +21,41 @@ struct ModelFit {
     std::string limitingFactor;
     int estimatedVramUsageMb=0;
     std::vector<int> gpuIndices;
+    std::string kvCacheType="f16"; // KV cache type the context estimate assumes
+    std::string estimateSource="config"; // "gguf" when sized from the GGUF header, else "config"
+    std::map<int, int> perGpuVramMb;     // gguf estimates: gpu index → share of estimatedVramUsageMb
 };
 
 class ModelFitCalculator {
 public:
     /// Calculate fit for a specific model variant against current hardware.
+    /// @param kvCacheType  KV cache type to size the context for ("f16", "q8_0", "q4_0", ...).
     static ModelFit calculateModelFit(
         const ModelInfo &model,
         const ModelVariant &variant,
-        const SystemInfo &hw);
+        const SystemInfo &hw,
+        const std::string &kvCacheType="f16");
+
+    /// Pick the variant and KV cache type that reach the requested context.
+    /// Candidates are tried best-quality first: each variant with f16 then
+    /// q8_0 KV, and only then q4_0 KV.  If none reaches the context, the
+    /// candidate with the largest context is returned.
+    /// @param requestedContext  Target context (0 = model's maximum context).
+    /// @param variant           Restrict to this variant (empty = any).
+    /// @param kvCacheType       Pinned KV cache type (nullopt = auto-select).
+    static ModelFit selectBestFit(
+        const ModelInfo &model,
+        const SystemInfo &hw,
+        int requestedContext,
+        const std::string &variant="",
+        const std::optional<std::string> &kvCacheType=std::nullopt);
+
+    /// Storage size of one KV cache element for a ggml type name (0 if unknown).
+    static double kvBytesPerElement(const std::string &kvCacheType);
+
+    /// KV cache bytes per context token for a KV cache type.  The model's
+    /// vram_per_1k_context_mb is taken as the f16 cost and scaled by element size.
+    static double kvBytesPerToken(const ContextScaling &scaling, const std::string &kvCacheType);
 
     /// Calculate fit for all variants of all provided models.
     static std::vector<ModelFit> calculateFittableModels(
@@ -42,6 +71,32 @@ public:
     static int sumTotalVram(const SystemInfo &hw, const std::vector<int> &gpuIndices);
 
 private:
+    /// Exact VRAM model from a GGUF header: weights and compute buffers are
+    /// fixed, KV grows with context.  Calibration factors from earlier loads
+    /// are applied when present.
+    struct ExactEstimate {
+        int fixedMb=0;              // weights + compute buffers
+        double kvBytesPerElement=2.0;
+        double kvFactor=1.0;
+        GgufModelInfo gguf;
+
+        int kvMb(int contextSize) const;
+        int totalMb(int contextSize) const { return fixedMb+kvMb(contextSize); }
+    };
+
+    static std::optional<ExactEstimate> exactEstimate(
+        const ModelInfo &model,
+        const ModelVariant &variant,
+        const std::string &kvCacheType);
+
+    /// Largest context (multiple of 256) whose total fits in availableVramMb.
+    /// 0 when not even 256 tokens fit or contextCap is below 256; callers
+    /// fall back to the config estimate then.
+    static int exactMaxContext(const ExactEstimate &estimate, int availableVramMb, int contextCap);
+
+    /// Compute buffer assumed before a load of the variant has been measured.
+    static constexpr int DEFAULT_COMPUTE_BUFFER_MB=512;
+
     /// Get all GPU indices from the system info.
     static std::vector<int> allGpuIndices(const SystemInfo &hw);
 
@@ -49,7 +104,8 @@ private:
     static int estimateMaxContext(
         int availableVramMb,
         int variantMinVramMb,
-        const ContextScaling &scaling);
+        const ContextScaling &scaling,
+        const std::string &kvCacheType="f16");
 };
 
 } // namespace arbiterAI
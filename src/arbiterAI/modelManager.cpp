@@ -73,6 +73,21 @@ void RuntimeOptions::mergeFrom(const RuntimeOptions &other)
     if(other.nGpuLayers.has_value()) nGpuLayers=other.nGpuLayers;
     if(other.overrideTensor.has_value()) overrideTensor=other.overrideTensor;
     if(other.vulkanNoHostVisibleVram.has_value()) vulkanNoHostVisibleVram=other.vulkanNoHostVisibleVram;
+    if(other.mlock.has_value()) mlock=other.mlock;
+    if(other.idleContextTimeoutSeconds.has_value()) idleContextTimeoutSeconds=other.idleContextTimeoutSeconds;
+    if(other.idleShrinkContext.has_value()) idleShrinkContext=other.idleShrinkContext;
+    if(other.dynamicContext.has_value()) dynamicContext=other.dynamicContext;
+    if(other.initialContextSize.has_value()) initialContextSize=other.initialContextSize;
+    if(other.kvOffload.has_value()) kvOffload=other.kvOffload;
+    if(other.autoPlacement.has_value()) autoPlacement=other.autoPlacement;
+    if(other.nThreads.has_value()) nThreads=other.nThreads;
+    if(other.nThreadsBatch.has_value()) nThreadsBatch=other.nThreadsBatch;
+    if(other.nBatch.has_value()) nBatch=other.nBatch;
+    if(other.nUbatch.has_value()) nUbatch=other.nUbatch;
+    if(other.autotune.has_value()) autotune=other.autotune;
+    if(other.numaPolicy.has_value()) numaPolicy=other.numaPolicy;
+    if(other.numaNode.has_value()) numaNode=other.numaNode;
+    if(other.warmup.has_value()) warmup=other.warmup;
 }
 
 ModelManager &ModelManager::instance()
@@ -386,6 +401,36 @@ bool ModelManager::parseModelInfo(const nlohmann::json &modelJson, ModelInfo &in
         }
     }
 
+    // LoRA adapters on a base model
+    if(modelJson.contains("lora")&&modelJson["lora"].is_object())
+    {
+        auto &loraJson=modelJson["lora"];
+        if(!loraJson.contains("base_model")||!loraJson["base_model"].is_string())
+        {
+            return false;
+        }
+
+        LoraConfig lora;
+        lora.baseModel=loraJson["base_model"].get<std::string>();
+        if(loraJson.contains("adapters")&&loraJson["adapters"].is_array())
+        {
+            for(const auto &adapterJson:loraJson["adapters"])
+            {
+                if(!adapterJson.contains("file")||!adapterJson["file"].is_string())
+                {
+                    continue;
+                }
+
+                LoraAdapter adapter;
+                adapter.file=adapterJson["file"].get<std::string>();
+                adapter.name=adapterJson.value("name", std::filesystem::path(adapter.file).stem().string());
+                adapter.scale=adapterJson.value("scale", 1.0f);
+                lora.adapters.push_back(adapter);
+            }
+        }
+        info.lora=lora;
+    }
+
     // Runtime options (llama.cpp model load/inference parameters)
     if(modelJson.contains("runtime_options")&&modelJson["runtime_options"].is_object())
     {
@@ -407,6 +452,36 @@ bool ModelManager::parseModelInfo(const nlohmann::json &modelJson, ModelInfo &in
             info.runtimeOptions.nGpuLayers=ro["n_gpu_layers"].get<int>();
         if(ro.contains("override_tensor")&&ro["override_tensor"].is_string())
             info.runtimeOptions.overrideTensor=ro["override_tensor"].get<std::string>();
+        if(ro.contains("mlock")&&ro["mlock"].is_boolean())
+            info.runtimeOptions.mlock=ro["mlock"].get<bool>();
+        if(ro.contains("idle_context_timeout_seconds")&&ro["idle_context_timeout_seconds"].is_number_integer())
+            info.runtimeOptions.idleContextTimeoutSeconds=ro["idle_context_timeout_seconds"].get<int>();
+        if(ro.contains("idle_shrink_context")&&ro["idle_shrink_context"].is_boolean())
+            info.runtimeOptions.idleShrinkContext=ro["idle_shrink_context"].get<bool>();
+        if(ro.contains("dynamic_context")&&ro["dynamic_context"].is_boolean())
+            info.runtimeOptions.dynamicContext=ro["dynamic_context"].get<bool>();
+        if(ro.contains("initial_context_size")&&ro["initial_context_size"].is_number_integer())
+            info.runtimeOptions.initialContextSize=ro["initial_context_size"].get<int>();
+        if(ro.contains("kv_offload")&&ro["kv_offload"].is_boolean())
+            info.runtimeOptions.kvOffload=ro["kv_offload"].get<bool>();
+        if(ro.contains("auto_placement")&&ro["auto_placement"].is_boolean())
+            info.runtimeOptions.autoPlacement=ro["auto_placement"].get<bool>();
+        if(ro.contains("n_threads")&&ro["n_threads"].is_number_integer())
+            info.runtimeOptions.nThreads=ro["n_threads"].get<int>();
+        if(ro.contains("n_threads_batch")&&ro["n_threads_batch"].is_number_integer())
+            info.runtimeOptions.nThreadsBatch=ro["n_threads_batch"].get<int>();
+        if(ro.contains("n_batch")&&ro["n_batch"].is_number_integer())
+            info.runtimeOptions.nBatch=ro["n_batch"].get<int>();
+        if(ro.contains("n_ubatch")&&ro["n_ubatch"].is_number_integer())
+            info.runtimeOptions.nUbatch=ro["n_ubatch"].get<int>();
+        if(ro.contains("autotune")&&ro["autotune"].is_boolean())
+            info.runtimeOptions.autotune=ro["autotune"].get<bool>();
+        if(ro.contains("numa_policy")&&ro["numa_policy"].is_string())
+            info.runtimeOptions.numaPolicy=ro["numa_policy"].get<std::string>();
+        if(ro.contains("numa_node")&&ro["numa_node"].is_number_integer())
+            info.runtimeOptions.numaNode=ro["numa_node"].get<int>();
+        if(ro.contains("warmup")&&ro["warmup"].is_boolean())
+            info.runtimeOptions.warmup=ro["warmup"].get<bool>();
     }
 
     // Backend priority (ordered preference for GPU compute backends)
@@ -662,6 +737,8 @@ void ModelManager::mergeModelInfo(ModelInfo &existing, const ModelInfo &source,
         existing.contextScaling=source.contextScaling;
     if(sourceJson.contains("variants"))
         existing.variants=source.variants;
+    if(sourceJson.contains("lora"))
+        existing.lora=source.lora;
     if(sourceJson.contains("download"))
         existing.download=source.download;
     if(sourceJson.contains("version"))
@@ -1006,6 +1083,23 @@ nlohmann::json ModelManager::modelInfoToJson(const ModelInfo &info)
         j["variants"]=variants;
     }
 
+    if(info.lora.has_value())
+    {
+        nlohmann::json adapters=nlohmann::json::array();
+        for(const LoraAdapter &adapter:info.lora->adapters)
+        {
+            adapters.push_back({
+                {"name", adapter.name},
+                {"file", adapter.file},
+                {"scale", adapter.scale}
+            });
+        }
+        j["lora"]={
+            {"base_model", info.lora->baseModel},
+            {"adapters", adapters}
+        };
+    }
+
     // Runtime options
     {
         nlohmann::json ro;
@@ -1025,6 +1119,36 @@ nlohmann::json ModelManager::modelInfoToJson(const ModelInfo &info)
             ro["n_gpu_layers"]=info.runtimeOptions.nGpuLayers.value();
         if(info.runtimeOptions.overrideTensor.has_value())
             ro["override_tensor"]=info.runtimeOptions.overrideTensor.value();
+        if(info.runtimeOptions.mlock.has_value())
+            ro["mlock"]=info.runtimeOptions.mlock.value();
+        if(info.runtimeOptions.idleContextTimeoutSeconds.has_value())
+            ro["idle_context_timeout_seconds"]=info.runtimeOptions.idleContextTimeoutSeconds.value();
+        if(info.runtimeOptions.idleShrinkContext.has_value())
+            ro["idle_shrink_context"]=info.runtimeOptions.idleShrinkContext.value();
+        if(info.runtimeOptions.dynamicContext.has_value())
+            ro["dynamic_context"]=info.runtimeOptions.dynamicContext.value();
+        if(info.runtimeOptions.initialContextSize.has_value())
+            ro["initial_context_size"]=info.runtimeOptions.initialContextSize.value();
+        if(info.runtimeOptions.kvOffload.has_value())
+            ro["kv_offload"]=info.runtimeOptions.kvOffload.value();
+        if(info.runtimeOptions.autoPlacement.has_value())
+            ro["auto_placement"]=info.runtimeOptions.autoPlacement.value();
+        if(info.runtimeOptions.nThreads.has_value())
+            ro["n_threads"]=info.runtimeOptions.nThreads.value();
+        if(info.runtimeOptions.nThreadsBatch.has_value())
+            ro["n_threads_batch"]=info.runtimeOptions.nThreadsBatch.value();
+        if(info.runtimeOptions.nBatch.has_value())
+            ro["n_batch"]=info.runtimeOptions.nBatch.value();
+        if(info.runtimeOptions.nUbatch.has_value())
+            ro["n_ubatch"]=info.runtimeOptions.nUbatch.value();
+        if(info.runtimeOptions.autotune.has_value())
+            ro["autotune"]=info.runtimeOptions.autotune.value();
+        if(info.runtimeOptions.numaPolicy.has_value())
+            ro["numa_policy"]=info.runtimeOptions.numaPolicy.value();
+        if(info.runtimeOptions.numaNode.has_value())
+            ro["numa_node"]=info.runtimeOptions.numaNode.value();
+        if(info.runtimeOptions.warmup.has_value())
+            ro["warmup"]=info.runtimeOptions.warmup.value();
         if(!ro.empty())
             j["runtime_options"]=ro;
     }
@@ -34,6 +34,19 @@ struct ContextScaling {
     int vramPer1kContextMb=0;
 };
 
+/// LoRA adapter applied on top of a base model's weights.
+struct LoraAdapter {
+    std::string name;       // id for per-request scale overrides (defaults to the file stem)
+    std::string file;       // adapter GGUF, relative to the models directory or absolute
+    float scale=1.0f;
+};
+
+/// A fine-tune served as LoRA adapters on another model, sharing its weights.
+struct LoraConfig {
+    std::string baseModel;
+    std::vector<LoraAdapter> adapters;
+};
+
 struct VariantDownload {
     std::string url;
     std::string sha256;
@@ -52,6 +65,21 @@ struct RuntimeOptions {
     std::optional<int> nGpuLayers;              // -ngl: number of GPU layers (99=all)
     std::optional<std::string> overrideTensor;  // -ot: tensor override pattern (e.g. "per_layer_token_embd.weight=CPU")
     std::optional<bool> vulkanNoHostVisibleVram; // GGML_VK_DISABLE_HOST_VISIBLE_VIDMEM: skip BAR-mapped heap, force device-local only
+    std::optional<bool> mlock;                  // --mlock: lock weights in RAM (also applies to Ready-tier mappings)
+    std::optional<int> idleContextTimeoutSeconds; // free the llama_context (KV + compute buffers) after this long idle (0=never)
+    std::optional<bool> idleShrinkContext;      // recreate a reclaimed context sized to recent requests instead of the load-time n_ctx
+    std::optional<bool> dynamicContext;         // start with a small context and grow it on demand up to the hardware-fit limit
+    std::optional<int> initialContextSize;      // starting n_ctx when dynamicContext is enabled
+    std::optional<bool> kvOffload;              // --no-kv-offload when false: keep the KV cache in host memory
+    std::optional<bool> autoPlacement;          // plan n_gpu_layers / override_tensor / kv_offload from GGUF tensor sizes (default true)
+    std::optional<int> nThreads;                // -t: max CPU threads for decode (the shared arbiter may grant fewer)
+    std::optional<int> nThreadsBatch;           // -tb: max CPU threads for prompt processing
+    std::optional<int> nBatch;                  // -b: logical batch size for prompt processing
+    std::optional<int> nUbatch;                 // -ub: physical (micro) batch size
+    std::optional<bool> autotune;               // apply options found by the autotuner for this hardware (default true)
+    std::optional<std::string> numaPolicy;      // "auto", "bind", "interleave" or "none": NUMA placement of host weights and threads
+    std::optional<int> numaNode;                // node to bind to (default: the node with the most free memory)
+    std::optional<bool> warmup;                 // run a tiny prefill+decode after loading so the first request starts warm (default true)
 
     /// Merge another set of options on top of this one (override only non-empty fields).
     void mergeFrom(const RuntimeOptions &other);
@@ -120,6 +148,7 @@ struct ModelInfo
     std::optional<HardwareRequirements> hardwareRequirements;
     std::optional<ContextScaling> contextScaling;
     std::vector<ModelVariant> variants;
+    std::optional<LoraConfig> lora;             // Adapter model: runs on lora->baseModel with adapters applied
     RuntimeOptions runtimeOptions;              // Per-model llama.cpp runtime options
     std::vector<std::string> backendPriority;   // Ordered preference: ["vulkan", "rocm", "cuda"]
     std::vector<std::string> disabledBackends;  // Backends to exclude (model-level override)
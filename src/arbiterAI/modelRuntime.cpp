@@ -3,16 +3,29 @@
 #include "arbiterAI/modelManager.h"
 #include "arbiterAI/telemetryCollector.h"
 #include "arbiterAI/storageManager.h"
+#include "arbiterAI/ggufReader.h"
+#include "arbiterAI/memoryCalibration.h"
 
 #include <llama.h>
 #include <ggml.h>
 #include <ggml-backend.h>
+#include <ggml-cpu.h>
 #include <spdlog/spdlog.h>
 #include <algorithm>
 #include <cstdlib>
 #include <filesystem>
+#include <fstream>
 #include <thread>
 #include <regex>
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+    #include <linux/mempolicy.h>
+    #include <sys/syscall.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
 
 namespace arbiterAI
 {
@@ -34,6 +47,285 @@ static ggml_type parseGgmlType(const std::string &name)
     return GGML_TYPE_COUNT;
 }
 
+/// Split a comma-separated override_tensor value into "pattern=BUFFER" entries.
+static std::vector<std::string> splitOverrideTensor(const std::string &value)
+{
+    std::vector<std::string> entries;
+    size_t start=0;
+    while(start<=value.size())
+    {
+        size_t comma=value.find(',', start);
+        if(comma==std::string::npos)
+        {
+            comma=value.size();
+        }
+        if(comma>start)
+        {
+            entries.push_back(value.substr(start, comma-start));
+        }
+        start=comma+1;
+    }
+    return entries;
+}
+
+/// Find the buffer type of a ggml device by name ("CPU", "CUDA0", "Vulkan1", ...).
+static ggml_backend_buffer_type_t findBufferType(const std::string &name)
+{
+    std::string wanted=name;
+    std::transform(wanted.begin(), wanted.end(), wanted.begin(), ::tolower);
+
+    for(size_t i=0; i<ggml_backend_dev_count(); ++i)
+    {
+        ggml_backend_dev_t dev=ggml_backend_dev_get(i);
+        std::string devName=ggml_backend_dev_name(dev);
+        std::transform(devName.begin(), devName.end(), devName.begin(), ::tolower);
+        if(devName==wanted)
+        {
+            return ggml_backend_dev_buffer_type(dev);
+        }
+    }
+
+    if(wanted=="cpu")
+    {
+        ggml_backend_dev_t cpu=ggml_backend_dev_by_type(GGML_BACKEND_DEVICE_TYPE_CPU);
+        return cpu?ggml_backend_dev_buffer_type(cpu):nullptr;
+    }
+    return nullptr;
+}
+
+/// Sets the calling thread's NUMA memory policy until destroyed, so pages
+/// faulted in meanwhile (weights read or prefetched by llama.cpp, KV cache
+/// buffers) come from the given nodes.  File pages already in the page cache
+/// stay where they are.
+///
+/// policy is a LoadedModel::numaPolicy: "bind" allocates only from the
+/// nodes (and fails once they are full), "preferred" tries the first node
+/// and falls back to the others, "interleave" spreads pages over them.
+class ScopedMemoryPolicy
+{
+public:
+    ScopedMemoryPolicy(const std::vector<int> &nodeIds, const std::string &policy)
+    {
+#ifdef __linux__
+        if(nodeIds.empty())
+        {
+            return;
+        }
+
+        unsigned long mask[4]={0, 0, 0, 0}; // up to 256 nodes
+        constexpr int bitsPerWord=static_cast<int>(sizeof(unsigned long)*8);
+        for(int id:nodeIds)
+        {
+            if(id>=0&&id<static_cast<int>(sizeof(mask)*8))
+            {
+                mask[id/bitsPerWord]|=1UL<<(id%bitsPerWord);
+            }
+        }
+
+        int mode=MPOL_PREFERRED;
+        if(policy=="bind")
+        {
+            mode=MPOL_BIND;
+        }
+        else if(policy=="interleave")
+        {
+            mode=MPOL_INTERLEAVE;
+        }
+
+        m_active=syscall(SYS_set_mempolicy, mode, mask, sizeof(mask)*8+1)==0;
+        if(!m_active)
+        {
+            spdlog::warn("Failed to set NUMA memory policy: {}", std::strerror(errno));
+        }
+#else
+        (void)nodeIds;
+        (void)policy;
+#endif
+    }
+
+    ~ScopedMemoryPolicy()
+    {
+#ifdef __linux__
+        if(m_active)
+        {
+            syscall(SYS_set_mempolicy, MPOL_DEFAULT, nullptr, 0);
+        }
+#endif
+    }
+
+    ScopedMemoryPolicy(const ScopedMemoryPolicy &)=delete;
+    ScopedMemoryPolicy &operator=(const ScopedMemoryPolicy &)=delete;
+
+private:
+    bool m_active=false;
+};
+
+/// Ask the kernel to read files into the page cache in the background.
+static void adviseWillNeed(const std::vector<std::string> &paths)
+{
+#ifdef __linux__
+    for(const std::string &path:paths)
+    {
+        int fd=::open(path.c_str(), O_RDONLY);
+        if(fd<0)
+        {
+            continue;
+        }
+        posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+        ::close(fd);
+    }
+#else
+    (void)paths;
+#endif
+}
+
+/// CPU lists of the NUMA nodes, in the order the thread arbiter indexes them.
+static std::vector<std::vector<int>> numaNodeCpus(const SystemInfo &hw)
+{
+    std::vector<std::vector<int>> nodeCpus;
+    for(const NumaNode &node:hw.numaNodes)
+    {
+        nodeCpus.push_back(node.cpus);
+    }
+    return nodeCpus;
+}
+
+/// Build llama.cpp context params for a model from its resolved runtime options.
+/// Shared by the initial load and by Ready→Loaded promotion so a rebuilt
+/// context matches the original one.
+static llama_context_params buildContextParams(const RuntimeOptions &options, int contextSize)
+{
+    llama_context_params cparams=llama_context_default_params();
+    cparams.n_ctx=static_cast<uint32_t>(contextSize);
+    // Starting counts; applyCpuThreads() narrows them to the model's share
+    int cores=static_cast<int>(std::thread::hardware_concurrency());
+    cparams.n_threads=options.nThreads.value_or(cores);
+    cparams.n_threads_batch=options.nThreadsBatch.value_or(cores);
+
+    if(options.flashAttn.has_value())
+    {
+        cparams.flash_attn_type=options.flashAttn.value()
+            ?LLAMA_FLASH_ATTN_TYPE_ENABLED
+            :LLAMA_FLASH_ATTN_TYPE_DISABLED;
+    }
+
+    if(options.kvCacheTypeK.has_value())
+    {
+        ggml_type kType=parseGgmlType(options.kvCacheTypeK.value());
+        if(kType!=GGML_TYPE_COUNT)
+        {
+            cparams.type_k=kType;
+        }
+    }
+
+    if(options.kvCacheTypeV.has_value())
+    {
+        ggml_type vType=parseGgmlType(options.kvCacheTypeV.value());
+        if(vType!=GGML_TYPE_COUNT)
+        {
+            cparams.type_v=vType;
+        }
+    }
+
+    if(options.swaFull.has_value())
+    {
+        cparams.swa_full=options.swaFull.value();
+    }
+
+    if(options.kvOffload.has_value())
+    {
+        cparams.offload_kqv=options.kvOffload.value();
+    }
+
+    if(options.nBatch.has_value())
+    {
+        cparams.n_batch=static_cast<uint32_t>(options.nBatch.value());
+    }
+
+    if(options.nUbatch.has_value())
+    {
+        cparams.n_ubatch=static_cast<uint32_t>(std::min(options.nUbatch.value(), static_cast<int>(cparams.n_batch)));
+    }
+
+    return cparams;
+}
+
+/// Create a context for a model from its runtime options.
+/// llama.cpp supports a quantized V cache only with flash attention, and
+/// with flash_attn left on "auto" some backends choose the path without
+/// it and refuse the context.  Unless flash attention was asked for
+/// explicitly, a refused quantized V cache is retried as f16; options is
+/// updated so later rebuilds of the context match.
+static llama_context *initContext(llama_model *model, RuntimeOptions &options, int contextSize, const std::string &name)
+{
+    llama_context *ctx=llama_init_from_model(model, buildContextParams(options, contextSize));
+    if(ctx||options.flashAttn.value_or(false)||!options.kvCacheTypeV.has_value())
+    {
+        return ctx;
+    }
+
+    ggml_type vType=parseGgmlType(options.kvCacheTypeV.value());
+    if(vType==GGML_TYPE_COUNT||!ggml_is_quantized(vType))
+    {
+        return ctx;
+    }
+
+    spdlog::warn("Context for '{}' with a {} V cache failed without explicit flash attention; retrying with an f16 V cache",
+        name, options.kvCacheTypeV.value());
+    options.kvCacheTypeV="f16";
+    return llama_init_from_model(model, buildContextParams(options, contextSize));
+}
+
+/// Resident set size of this process in MB, read from /proc/self/status.
+static int readProcessRssMb()
+{
+#ifdef __linux__
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while(std::getline(status, line))
+    {
+        if(line.compare(0, 6, "VmRSS:")==0)
+        {
+            long long kb=0;
+            std::istringstream iss(line.substr(6));
+            iss >> kb;
+            return static_cast<int>(kb/1024);
+        }
+    }
+#endif
+    return 0;
+}
+
+/// Context an instance likely has free once its requests in flight take their average size.
+static int estimatedFreeKvCells(const LoadedModel &entry, int queueDepth)
+{
+    if(queueDepth<=0||entry.recentContextTokens.empty())
+    {
+        return entry.contextSize;
+    }
+
+    int64_t total=0;
+    for(int tokens:entry.recentContextTokens)
+    {
+        total+=tokens;
+    }
+    int average=static_cast<int>(total/static_cast<int64_t>(entry.recentContextTokens.size()));
+    return std::max(0, entry.contextSize-average*queueDepth);
+}
+
+/// True if llama.cpp placed any model weights on a non-CPU device.
+static bool hasGpuWeights(const LoadedModel &entry)
+{
+    for(const auto &pair:entry.deviceAllocations)
+    {
+        if(pair.second.modelBufferMb>0&&pair.first.rfind("CPU", 0)!=0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 ModelRuntime &ModelRuntime::instance()
 {
     static ModelRuntime runtime;
@@ -44,6 +336,8 @@ void ModelRuntime::reset()
 {
     ModelRuntime &rt=instance();
 
+    rt.stopMaintenanceThread();
+
     // Signal all background download threads to stop waiting
     {
         std::lock_guard<std::mutex> lock(rt.m_mutex);
@@ -62,7 +356,7 @@ void ModelRuntime::reset()
     std::lock_guard<std::mutex> lock(rt.m_mutex);
 
     rt.m_downloadThreads.clear();
-    rt.m_activeDownloadCount=0;
+    rt.m_downloadQueue.clear();
     rt.m_maxConcurrentDownloads=2;
     rt.m_shuttingDown=false;
 
@@ -74,6 +368,17 @@ void ModelRuntime::reset()
 
     rt.m_models.clear();
     rt.m_activeInference.clear();
+    rt.m_defaultIdleContextTimeoutSec=0;
+    rt.m_cpuThreads=0;
+    rt.m_loraCacheBudgetMb=DEFAULT_LORA_CACHE_MB;
+    rt.m_threadArbiter.reset();
+    rt.m_replicaPolicies.clear();
+    rt.m_replicaRetryAt.clear();
+    rt.m_requestQueue.reset();
+    rt.m_pressure=MemoryPressureSample{};
+    rt.m_pressureLevel=MemoryPressureLevel::None;
+    rt.m_pressureMonitorEnabled=true;
+    rt.m_pressureMonitor.setThresholds(MemoryPressureThresholds{});
     while(!rt.m_pendingSwaps.empty())
     {
         rt.m_pendingSwaps.pop();
@@ -82,6 +387,10 @@ void ModelRuntime::reset()
     // Reset RAM budget to default (50% of system RAM)
     SystemInfo hw=HardwareDetector::instance().getSystemInfo();
     rt.m_readyRamBudgetMb=hw.totalRamMb/2;
+    if(hw.numaNodes.size()>1)
+    {
+        rt.m_threadArbiter.setNodes(numaNodeCpus(hw));
+    }
 }
 
 ModelRuntime::ModelRuntime()
@@ -89,6 +398,17 @@ ModelRuntime::ModelRuntime()
     // Default ready RAM budget: 50% of total system RAM
     SystemInfo hw=HardwareDetector::instance().getSystemInfo();
     m_readyRamBudgetMb=hw.totalRamMb/2;
+
+    // Threads of each model stay on one NUMA node where possible
+    if(hw.numaNodes.size()>1)
+    {
+        m_threadArbiter.setNodes(numaNodeCpus(hw));
+    }
+}
+
+ModelRuntime::~ModelRuntime()
+{
+    stopMaintenanceThread();
 }
 
 // ---- llama.cpp log capture ------------------------------------------------
@@ -346,6 +666,31 @@ int ModelRuntime::getMaxConcurrentDownloads() const
     return m_maxConcurrentDownloads;
 }
 
+void ModelRuntime::setDownloadSegmentConfig(const SegmentedDownloadConfig &config)
+{
+    m_downloader.setSegmentConfig(config);
+}
+
+void ModelRuntime::setMaxDownloadConnections(int max)
+{
+    m_downloader.setMaxConnections(max);
+}
+
+void ModelRuntime::setDownloadBandwidthLimit(int64_t bytesPerSecond)
+{
+    m_downloader.setBandwidthLimit(bytesPerSecond);
+}
+
+void ModelRuntime::setDownloadWriteConfig(const DownloadWriteConfig &config)
+{
+    m_downloader.setWriteConfig(config);
+}
+
+void ModelRuntime::setDownloadPeers(const std::vector<std::string> &peers)
+{
+    m_downloader.setPeers(peers);
+}
+
 void ModelRuntime::setModelsDir(const std::string &dir)
 {
     std::lock_guard<std::mutex> lock(m_mutex);
@@ -355,6 +700,11 @@ void ModelRuntime::setModelsDir(const std::string &dir)
     {
         m_modelsDir+='/';
     }
+
+    // Fit estimates read GGUF headers and learned calibration from here
+    GgufMetadataCache::instance().setModelsDir(m_modelsDir);
+    MemoryCalibration::instance().load(m_modelsDir+"memory_calibration.json");
+    AutotuneStore::instance().load(m_modelsDir+"autotune.json");
 }
 
 std::string ModelRuntime::getModelsDir() const
@@ -370,8 +720,17 @@ ErrorCode ModelRuntime::loadModel(
     const RuntimeOptions &optionsOverride,
     const std::vector<int> &targetDevices)
 {
+    // Adapter models run on their base model's weights
+    std::optional<ModelInfo> adapterInfo=ModelManager::instance().getModelInfo(model);
+    if(adapterInfo.has_value()&&adapterInfo->lora.has_value()&&adapterInfo->lora->baseModel!=model)
+    {
+        return loadModel(adapterInfo->lora->baseModel, variant, contextSize, optionsOverride, targetDevices);
+    }
+
     std::lock_guard<std::mutex> lock(m_mutex);
 
+    std::chrono::steady_clock::time_point loadStart=std::chrono::steady_clock::now();
+
     // Clear previous load error
     m_lastLoadError=LoadErrorDetail{};
 
@@ -381,34 +740,44 @@ ErrorCode ModelRuntime::loadModel(
     {
         if(it->second.state==ModelState::Loaded)
         {
+            if(it->second.contextReclaimed)
+            {
+                // Context was freed while idle — recreate it lazily
+                int restoreSize=reclaimedContextSize(it->second);
+                ErrorCode restoreResult=createContext(it->second, restoreSize);
+                if(restoreResult!=ErrorCode::Success)
+                {
+                    return restoreResult;
+                }
+                spdlog::info("Recreated idle-reclaimed context for '{}' (context={})",
+                    model, it->second.contextSize);
+            }
             it->second.lastUsed=std::chrono::steady_clock::now();
             return ErrorCode::Success;
         }
         if(it->second.state==ModelState::Downloading)
         {
+            // A load is now waiting on this download
+            promoteDownload(model, DownloadPriority::UserBlocking);
             return ErrorCode::ModelDownloading;
         }
         if(it->second.state==ModelState::Ready)
         {
-            // Promote from Ready to Loaded
-            // If llama model is in RAM but context was freed, recreate context
-            if(it->second.llamaModel&&!it->second.llamaCtx)
+            ErrorCode promoteResult=promoteReadyModel(it->second);
+            if(promoteResult!=ErrorCode::Success)
             {
-                llama_context_params cparams=llama_context_default_params();
-                cparams.n_ctx=it->second.contextSize;
-                cparams.n_threads=std::thread::hardware_concurrency();
-                cparams.n_threads_batch=std::thread::hardware_concurrency();
-
-                it->second.llamaCtx=llama_init_from_model(it->second.llamaModel, cparams);
-                if(!it->second.llamaCtx)
-                {
-                    spdlog::error("Failed to recreate llama context for model: {}", model);
-                    return ErrorCode::ModelLoadError;
-                }
+                return promoteResult;
             }
+
             it->second.state=ModelState::Loaded;
             it->second.lastUsed=std::chrono::steady_clock::now();
-            spdlog::info("Promoted model '{}' from Ready to Loaded", model);
+            it->second.loadedFrom="Ready";
+            it->second.loadTimeMs=std::chrono::duration<double, std::milli>(it->second.lastUsed-loadStart).count()-
+                it->second.warmupTimeMs;
+            spdlog::info("Promoted model '{}' from Ready to Loaded ({:.1f}ms, warm-up {:.1f}ms)",
+                model, it->second.loadTimeMs, it->second.warmupTimeMs);
+
+            evictReadyModels();
             return ErrorCode::Success;
         }
     }
@@ -421,13 +790,61 @@ ErrorCode ModelRuntime::loadModel(
         return ErrorCode::ModelNotFound;
     }
 
+    // Resolve runtime options: model config defaults + API override
+    RuntimeOptions resolvedOptions=modelInfo->runtimeOptions;
+    resolvedOptions.mergeFrom(optionsOverride);
+
+    // Pick the KV cache type together with the variant unless the user pinned
+    // one.  Autotune may still pin one for the chosen variant below.
+    std::optional<ModelFit> kvFit;
+    bool autoKvCache=modelInfo->provider=="llama"&&
+        autoSelectsKvCache(resolvedOptions)&&
+        targetDevices.empty();
+    if(autoKvCache&&!modelInfo->variants.empty())
+    {
+        ModelFit best=ModelFitCalculator::selectBestFit(modelInfo.value(),
+            HardwareDetector::instance().getSystemInfo(), contextSize, variant);
+        if(best.canRun)
+        {
+            kvFit=best;
+        }
+    }
+
     // Determine which variant to use
     std::string selectedVariant=variant;
+    if(selectedVariant.empty()&&kvFit.has_value())
+    {
+        selectedVariant=kvFit->variant;
+    }
     if(selectedVariant.empty()&&!modelInfo->variants.empty())
     {
         selectedVariant=selectBestVariant(modelInfo.value());
     }
 
+    // Options the autotuner measured for this variant on this machine fill
+    // in whatever the config and the request left unset
+    bool autotuned=false;
+    if(modelInfo->provider=="llama"&&resolvedOptions.autotune.value_or(true)&&!selectedVariant.empty())
+    {
+        std::optional<AutotuneResult> tuned=AutotuneStore::instance().get(model, selectedVariant,
+            Autotuner::hardwareFingerprint(HardwareDetector::instance().getSystemInfo()));
+        if(tuned.has_value())
+        {
+            RuntimeOptions tunedOptions=tuned->best;
+            tunedOptions.mergeFrom(resolvedOptions);
+            resolvedOptions=tunedOptions;
+            autotuned=true;
+            spdlog::info("Applying autotuned options for '{}' variant '{}'", model, selectedVariant);
+        }
+    }
+
+    // A KV cache type the autotuner measured for this variant wins over
+    // the one the fit picked; size the variant for the tuned type instead
+    if(kvFit.has_value()&&!autoSelectsKvCache(resolvedOptions))
+    {
+        kvFit.reset();
+    }
+
     // Determine context size
     // For llama provider models, contextSize=0 means "use model's native
     // training context from GGUF metadata" — resolved in loadLlamaModel after
@@ -458,7 +875,17 @@ ErrorCode ModelRuntime::loadModel(
 
         if(selectedVar)
         {
-            ModelFit fit=ModelFitCalculator::calculateModelFit(modelInfo.value(), *selectedVar, hw);
+            // A pinned K/V pair is sized as the wider of the two
+            std::string fitKvType=resolvedOptions.kvCacheTypeK.value_or("f16");
+            std::string fitKvTypeV=resolvedOptions.kvCacheTypeV.value_or("f16");
+            if(ModelFitCalculator::kvBytesPerElement(fitKvTypeV)>ModelFitCalculator::kvBytesPerElement(fitKvType))
+            {
+                fitKvType=fitKvTypeV;
+            }
+
+            ModelFit fit=(kvFit.has_value()&&kvFit->variant==selectedVariant)
+                ?kvFit.value()
+                :ModelFitCalculator::calculateModelFit(modelInfo.value(), *selectedVar, hw, fitKvType);
 
             // If caller specified target devices, override the auto-selected GPU indices
             if(!targetDevices.empty())
@@ -479,6 +906,52 @@ ErrorCode ModelRuntime::loadModel(
                 }
             }
 
+            // Plan partial offload from the GGUF tensor table.  When the
+            // model does not fit in VRAM whole, the plan sizes the load.
+            std::optional<PlacementPlan> placement;
+            if(modelInfo->provider=="llama")
+            {
+                std::vector<int> planGpus=targetDevices;
+                if(planGpus.empty())
+                {
+                    for(size_t i=0; i<hw.gpus.size(); ++i)
+                    {
+                        planGpus.push_back(static_cast<int>(i));
+                    }
+                }
+
+                placement=planPlacement(modelInfo.value(), *selectedVar, fit, resolvedOptions,
+                    resolvedContext, hw, planGpus);
+                if(placement.has_value()&&!placement->fits)
+                {
+                    placement.reset();
+                }
+
+                if(placement.has_value()&&placement->strategy!="full_gpu")
+                {
+                    fit.canRun=true;
+                    fit.limitingFactor.clear();
+                    fit.maxContextSize=placement->contextSize;
+                    fit.estimatedVramUsageMb=placement->strategy=="cpu_only"?0:placement->gpuMb;
+                    fit.gpuIndices.clear();
+                    fit.perGpuVramMb.clear();
+
+                    // llama.cpp splits offloaded layers by free memory
+                    int totalFree=ModelFitCalculator::sumFreeVram(hw, planGpus);
+                    int remaining=fit.estimatedVramUsageMb;
+                    for(size_t i=0; i<planGpus.size()&&fit.estimatedVramUsageMb>0&&totalFree>0; ++i)
+                    {
+                        int share=(i+1==planGpus.size())
+                            ?remaining
+                            :static_cast<int>(static_cast<int64_t>(fit.estimatedVramUsageMb)*
+                                ModelFitCalculator::sumFreeVram(hw, {planGpus[i]})/totalFree);
+                        fit.gpuIndices.push_back(planGpus[i]);
+                        fit.perGpuVramMb[planGpus[i]]=share;
+                        remaining-=share;
+                    }
+                }
+            }
+
             if(!fit.canRun)
             {
                 m_lastLoadError.reason=(fit.limitingFactor=="ram")
@@ -498,7 +971,10 @@ ErrorCode ModelRuntime::loadModel(
             // Evict if needed to make room on each assigned GPU
             for(int gpuIdx:fit.gpuIndices)
             {
-                int perGpuVram=selectedVar->minVramMb/static_cast<int>(fit.gpuIndices.size());
+                auto planned=fit.perGpuVramMb.find(gpuIdx);
+                int perGpuVram=planned!=fit.perGpuVramMb.end()
+                    ?planned->second
+                    :selectedVar->minVramMb/static_cast<int>(fit.gpuIndices.size());
                 evictIfNeeded(perGpuVram, gpuIdx);
             }
 
@@ -508,16 +984,7 @@ ErrorCode ModelRuntime::loadModel(
 
             if(!allFiles.empty())
             {
-                bool anyMissing=false;
-                for(const VariantDownload &file:allFiles)
-                {
-                    std::string filePath=m_modelsDir+file.filename;
-                    if(!std::filesystem::exists(filePath)&&!file.url.empty())
-                    {
-                        anyMissing=true;
-                        break;
-                    }
-                }
+                bool anyMissing=linkStoredFiles(model, *selectedVar);
 
                 if(anyMissing)
                 {
@@ -544,9 +1011,7 @@ ErrorCode ModelRuntime::loadModel(
                     spdlog::info("Model '{}' variant '{}' needs download — launching async download",
                         model, selectedVariant);
 
-                    m_downloadThreads.emplace_back(
-                        &ModelRuntime::runBackgroundDownload, this,
-                        model, selectedVariant, modelInfo.value());
+                    startBackgroundDownload(model, selectedVariant, modelInfo.value(), DownloadPriority::UserBlocking);
 
                     return ErrorCode::ModelDownloading;
                 }
@@ -561,9 +1026,19 @@ ErrorCode ModelRuntime::loadModel(
             entry.gpuIndices=fit.gpuIndices;
             entry.lastUsed=std::chrono::steady_clock::now();
 
+            entry.filePaths.clear();
+            for(const VariantDownload &file:allFiles)
+            {
+                entry.filePaths.push_back(m_modelsDir+file.filename);
+            }
+
             // Distribute estimated VRAM usage across assigned GPUs
             entry.perGpuVramMb.clear();
-            if(!fit.gpuIndices.empty())
+            if(!fit.perGpuVramMb.empty()&&(targetDevices.empty()||placement.has_value()))
+            {
+                entry.perGpuVramMb=fit.perGpuVramMb;
+            }
+            else if(!fit.gpuIndices.empty())
             {
                 int perGpu=fit.estimatedVramUsageMb/static_cast<int>(fit.gpuIndices.size());
                 int remainder=fit.estimatedVramUsageMb%static_cast<int>(fit.gpuIndices.size());
@@ -577,15 +1052,38 @@ ErrorCode ModelRuntime::loadModel(
             // Actually load llama.cpp model for local providers
             if(modelInfo->provider=="llama")
             {
-                // Resolve runtime options: model config defaults + API override
-                RuntimeOptions resolvedOptions=modelInfo->runtimeOptions;
-                resolvedOptions.mergeFrom(optionsOverride);
+                if(applyKvCacheFit(resolvedOptions, fit))
+                {
+                    spdlog::info("Using {} KV cache for '{}' variant '{}' to reach context {}",
+                        fit.kvCacheType, model, selectedVariant, fit.maxContextSize);
+                }
+
+                entry.placement=placement;
+                if(placement.has_value())
+                {
+                    resolvedOptions.nGpuLayers=placement->nGpuLayers;
+                    if(!placement->overrideTensor.empty())
+                    {
+                        resolvedOptions.overrideTensor=placement->overrideTensorString();
+                    }
+                    resolvedOptions.kvOffload=placement->kvOffload;
+                }
                 entry.activeOptions=resolvedOptions;
+                entry.autotuned=autotuned;
+
+                // Host-resident weights: the CPU share of a partial plan, or
+                // the whole file when no GPU is used
+                int hostMb=placement.has_value()
+                    ?placement->cpuMb
+                    :(fit.gpuIndices.empty()?selectedVar->fileSizeMb:0);
+                placeNuma(entry, resolvedOptions, hostMb);
 
                 // Resolve backend priority: model config > architecture rule > server default
                 std::vector<std::string> effectiveBackendPriority=resolveBackendPriority(*modelInfo);
+                entry.backendPriority=effectiveBackendPriority;
 
                 std::string filePath=m_modelsDir+primaryFilename;
+                entry.warmupTimeMs=0.0;
                 ErrorCode loadResult=loadLlamaModel(model, filePath, entry.contextSize, entry.gpuIndices,
                     fit.maxContextSize, resolvedOptions, effectiveBackendPriority);
                 if(loadResult!=ErrorCode::Success)
@@ -593,13 +1091,26 @@ ErrorCode ModelRuntime::loadModel(
                     m_models.erase(model);
                     return loadResult;
                 }
+
+                if(entry.contextLimit>0)
+                {
+                    // The fit estimate assumed the full context; charge only
+                    // the KV cache that was actually allocated
+                    chargeContextVram(entry, -static_cast<int>(entry.kvMbPerToken*(entry.contextLimit-entry.contextSize)));
+                }
             }
 
             entry.state=ModelState::Loaded;
+            entry.loadedFrom="Unloaded";
+            entry.loadTimeMs=std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now()-loadStart).count()-
+                entry.warmupTimeMs;
 
-            spdlog::info("Loaded model '{}' variant '{}' (context={}, vram={}MB, gpus={})",
+            spdlog::info("Loaded model '{}' variant '{}' (context={}, vram={}MB, gpus={}, {:.1f}ms, warm-up {:.1f}ms)",
                 model, selectedVariant, entry.contextSize, entry.estimatedVramUsageMb,
-                entry.gpuIndices.size());
+                entry.gpuIndices.size(), entry.loadTimeMs, entry.warmupTimeMs);
+
+            // Models demoted to make room may have pushed the Ready tier over budget
+            evictReadyModels();
         }
         else if(!selectedVariant.empty())
         {
@@ -622,6 +1133,8 @@ ErrorCode ModelRuntime::loadModel(
         entry.state=ModelState::Loaded;
         entry.contextSize=resolvedContext;
         entry.lastUsed=std::chrono::steady_clock::now();
+        entry.loadedFrom="Unloaded";
+        entry.loadTimeMs=std::chrono::duration<double, std::milli>(entry.lastUsed-loadStart).count();
     }
 
     return ErrorCode::Success;
@@ -629,7 +1142,8 @@ ErrorCode ModelRuntime::loadModel(
 
 ErrorCode ModelRuntime::downloadModel(
     const std::string &model,
-    const std::string &variant)
+    const std::string &variant,
+    DownloadPriority priority)
 {
     std::lock_guard<std::mutex> lock(m_mutex);
 
@@ -639,6 +1153,7 @@ ErrorCode ModelRuntime::downloadModel(
     {
         if(it->second.state==ModelState::Downloading)
         {
+            promoteDownload(model, priority);
             return ErrorCode::ModelDownloading;
         }
         if(it->second.state==ModelState::Loaded||it->second.state==ModelState::Ready)
@@ -685,18 +1200,8 @@ ErrorCode ModelRuntime::downloadModel(
         return ErrorCode::ModelNotFound;
     }
 
-    // Check if all files are already present
-    std::vector<VariantDownload> allFiles=selectedVar->getAllFiles();
-    bool anyMissing=false;
-    for(const VariantDownload &file:allFiles)
-    {
-        std::string filePath=m_modelsDir+file.filename;
-        if(!std::filesystem::exists(filePath)&&!file.url.empty())
-        {
-            anyMissing=true;
-            break;
-        }
-    }
+    // Check if all files are already present (or stored under another name)
+    bool anyMissing=linkStoredFiles(model, *selectedVar);
 
     if(!anyMissing)
     {
@@ -723,45 +1228,144 @@ ErrorCode ModelRuntime::downloadModel(
     dlEntry.state=ModelState::Downloading;
     dlEntry.lastUsed=std::chrono::steady_clock::now();
 
-    spdlog::info("downloadModel: launching async download for '{}' variant '{}'",
-        model, selectedVariant);
+    spdlog::info("downloadModel: launching async download for '{}' variant '{}' ({})",
+        model, selectedVariant, DownloadScheduler::priorityToString(priority));
 
-    m_downloadThreads.emplace_back(
-        &ModelRuntime::runBackgroundDownload, this,
-        model, selectedVariant, modelInfo.value());
+    startBackgroundDownload(model, selectedVariant, modelInfo.value(), priority);
 
     return ErrorCode::ModelDownloading;
 }
 
-void ModelRuntime::runBackgroundDownload(
-    const std::string &model,
-    const std::string &variant,
-    const ModelInfo &info)
+void ModelRuntime::startBackgroundDownload(const std::string &model, const std::string &variant,
+    const ModelInfo &info, DownloadPriority priority)
 {
-    // Wait for a download slot (respects concurrent download limit)
-    {
-        std::unique_lock<std::mutex> lock(m_mutex);
-        m_downloadCv.wait(lock, [this]()
-        {
-            return m_shuttingDown||m_activeDownloadCount<m_maxConcurrentDownloads;
-        });
+    DownloadTicket ticket;
+    ticket.id=m_nextDownloadTicket++;
+    ticket.model=model;
+    ticket.variant=variant;
+    ticket.priority=priority;
+    m_downloadQueue.push_back(ticket);
 
-        if(m_shuttingDown)
-        {
-            return;
-        }
+    m_downloadThreads.emplace_back(
+        &ModelRuntime::runBackgroundDownload, this,
+        ticket.id, model, variant, info);
+}
 
-        ++m_activeDownloadCount;
+bool ModelRuntime::canStartDownload(uint64_t ticket) const
+{
+    std::vector<DownloadTicket>::const_iterator self=std::find_if(m_downloadQueue.begin(), m_downloadQueue.end(),
+        [ticket](const DownloadTicket &t) { return t.id==ticket; });
+    if(self==m_downloadQueue.end())
+    {
+        return false;
     }
 
-    // Find the selected variant from the ModelInfo
-    const ModelVariant *selectedVar=nullptr;
-    for(const ModelVariant &v:info.variants)
+    // Lower priority values are more urgent
+    int runningAsUrgent=0;
+    for(const DownloadTicket &t:m_downloadQueue)
     {
-        if(v.quantization==variant)
+        if(t.running)
         {
-            selectedVar=&v;
-            break;
+            if(t.priority<=self->priority)
+            {
+                ++runningAsUrgent;
+            }
+        }
+        else if(t.priority<self->priority||(t.priority==self->priority&&t.id<self->id))
+        {
+            return false;
+        }
+    }
+    return runningAsUrgent<m_maxConcurrentDownloads;
+}
+
+void ModelRuntime::promoteDownload(const std::string &model, DownloadPriority priority)
+{
+    for(DownloadTicket &t:m_downloadQueue)
+    {
+        if(t.model==model&&priority<t.priority)
+        {
+            spdlog::info("Raising download priority of '{}' from {} to {}", model,
+                DownloadScheduler::priorityToString(t.priority), DownloadScheduler::priorityToString(priority));
+            t.priority=priority;
+            m_downloader.setPriority(model, priority);
+            m_downloadCv.notify_all();
+        }
+    }
+}
+
+std::vector<QueuedDownload> ModelRuntime::getDownloadQueue() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::vector<DownloadTicket> waiting;
+    std::vector<QueuedDownload> result;
+    for(const DownloadTicket &t:m_downloadQueue)
+    {
+        if(t.running)
+        {
+            result.push_back({t.model, t.variant, t.priority, 0});
+        }
+        else
+        {
+            waiting.push_back(t);
+        }
+    }
+
+    std::sort(waiting.begin(), waiting.end(), [](const DownloadTicket &a, const DownloadTicket &b)
+    {
+        return a.priority!=b.priority?a.priority<b.priority:a.id<b.id;
+    });
+    for(size_t i=0; i<waiting.size(); ++i)
+    {
+        result.push_back({waiting[i].model, waiting[i].variant, waiting[i].priority, static_cast<int>(i)+1});
+    }
+    return result;
+}
+
+void ModelRuntime::runBackgroundDownload(
+    uint64_t ticket,
+    const std::string &model,
+    const std::string &variant,
+    const ModelInfo &info)
+{
+    DownloadPriority priority;
+
+    // Wait for a download slot (respects concurrent download limit and priority)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_downloadCv.wait(lock, [this, ticket]()
+        {
+            return m_shuttingDown||canStartDownload(ticket);
+        });
+
+        std::vector<DownloadTicket>::iterator it=std::find_if(m_downloadQueue.begin(), m_downloadQueue.end(),
+            [ticket](const DownloadTicket &t) { return t.id==ticket; });
+        if(m_shuttingDown||it==m_downloadQueue.end())
+        {
+            return;
+        }
+
+        it->running=true;
+        priority=it->priority;
+    }
+
+    // Leave the queue however this download ends
+    auto finishDownload=[this, ticket]()
+    {
+        m_downloadQueue.erase(std::remove_if(m_downloadQueue.begin(), m_downloadQueue.end(),
+            [ticket](const DownloadTicket &t) { return t.id==ticket; }), m_downloadQueue.end());
+        m_downloadCv.notify_all();
+    };
+
+    // Find the selected variant from the ModelInfo
+    const ModelVariant *selectedVar=nullptr;
+    for(const ModelVariant &v:info.variants)
+    {
+        if(v.quantization==variant)
+        {
+            selectedVar=&v;
+            break;
         }
     }
 
@@ -770,20 +1374,20 @@ void ModelRuntime::runBackgroundDownload(
         spdlog::error("runBackgroundDownload: variant '{}' not found for model '{}'", variant, model);
         std::lock_guard<std::mutex> lock(m_mutex);
         m_models.erase(model);
-        --m_activeDownloadCount;
-        m_downloadCv.notify_one();
+        finishDownload();
         return;
     }
 
     std::vector<VariantDownload> allFiles=selectedVar->getAllFiles();
-    std::string primaryFilename=selectedVar->getPrimaryFilename();
 
-    // Collect files that need downloading
+    // Collect files that need downloading; content another download stored
+    // while this one was queued is linked instead
     std::vector<const VariantDownload *> missingFiles;
     for(const VariantDownload &file:allFiles)
     {
         std::string filePath=m_modelsDir+file.filename;
-        if(!std::filesystem::exists(filePath)&&!file.url.empty())
+        if(!std::filesystem::exists(filePath)&&!file.url.empty()&&
+            !StorageManager::instance().linkFromStore(file.sha256, filePath))
         {
             missingFiles.push_back(&file);
         }
@@ -799,32 +1403,13 @@ void ModelRuntime::runBackgroundDownload(
         spdlog::info("Downloading model '{}' variant '{}'", model, variant);
     }
 
-    // Download each missing file (no mutex held)
-    bool allDownloadsOk=true;
-    for(const VariantDownload *file:missingFiles)
-    {
-        std::string filePath=m_modelsDir+file->filename;
-        bool downloadOk=downloadModelFile(
-            file->url,
-            filePath,
-            file->sha256,
-            model,
-            variant);
-
-        if(!downloadOk)
-        {
-            allDownloadsOk=false;
-            spdlog::error("Failed to download shard '{}' for model '{}' variant '{}'",
-                file->filename, model, variant);
-            break;
-        }
-    }
+    // Download and verify the missing files (no mutex held)
+    bool allDownloadsOk=downloadVariantFiles(missingFiles, model, variant, priority);
 
     // Release the download slot
     {
         std::lock_guard<std::mutex> lock(m_mutex);
-        --m_activeDownloadCount;
-        m_downloadCv.notify_one();
+        finishDownload();
     }
 
     // Update model state under lock
@@ -838,25 +1423,7 @@ void ModelRuntime::runBackgroundDownload(
     }
 
     // Register all files with StorageManager
-    int64_t totalActualSize=0;
-    std::vector<std::string> extraFiles;
-    for(size_t i=0; i<allFiles.size(); ++i)
-    {
-        std::string filePath=m_modelsDir+allFiles[i].filename;
-        int64_t actualSize=0;
-        std::error_code ec;
-        if(std::filesystem::exists(filePath, ec))
-        {
-            actualSize=static_cast<int64_t>(std::filesystem::file_size(filePath, ec));
-        }
-        totalActualSize+=actualSize;
-        if(i>0)
-        {
-            extraFiles.push_back(allFiles[i].filename);
-        }
-    }
-    StorageManager::instance().registerDownload(
-        model, variant, primaryFilename, totalActualSize, extraFiles);
+    registerVariantFiles(model, *selectedVar);
 
     // Transition to Unloaded (downloaded, not yet loaded into VRAM)
     auto it=m_models.find(model);
@@ -886,30 +1453,32 @@ ErrorCode ModelRuntime::unloadModel(const std::string &model)
 
     if(entry.pinned)
     {
-        // Move pinned model to Ready (keep in RAM)
-        // Free context but keep model weights
-        if(entry.llamaCtx)
-        {
-            llama_free(entry.llamaCtx);
-            entry.llamaCtx=nullptr;
-        }
-        entry.state=ModelState::Ready;
-        entry.ramUsageMb=entry.estimatedVramUsageMb; // approximate
-        entry.vramUsageMb=0;
-        spdlog::info("Model '{}' moved to Ready (pinned)", model);
+        // Move pinned model to Ready (keep weights in host RAM)
+        demoteModel(entry, true);
+        spdlog::info("Model '{}' moved to Ready (pinned, {}MB resident)", model, entry.ramUsageMb);
 
         evictReadyModels();
     }
     else
     {
-        freeLlamaModel(entry);
-        entry.state=ModelState::Unloaded;
-        entry.vramUsageMb=0;
-        entry.ramUsageMb=0;
-        entry.perGpuVramMb.clear();
+        demoteModel(entry, false);
         spdlog::info("Model '{}' unloaded", model);
     }
 
+    // Replicas still running a request are dropped by scaleReplicas() once idle
+    std::vector<std::string> replicas;
+    for(const auto &pair:m_models)
+    {
+        if(pair.second.replicaOf==model&&!m_activeInference.count(pair.first))
+        {
+            replicas.push_back(pair.first);
+        }
+    }
+    for(const std::string &key:replicas)
+    {
+        removeReplica(key);
+    }
+
     return ErrorCode::Success;
 }
 
@@ -975,34 +1544,40 @@ ErrorCode ModelRuntime::swapModel(
         {
             if(pair.second.state==ModelState::Loaded)
             {
-                if(fromModel.empty())
+                if(fromModel.empty()&&pair.second.replicaOf.empty())
                 {
                     fromModel=pair.first;
                 }
 
-                if(pair.second.pinned)
-                {
-                    pair.second.state=ModelState::Ready;
-                    pair.second.ramUsageMb=pair.second.estimatedVramUsageMb;
-                    pair.second.vramUsageMb=0;
-                }
-                else
-                {
-                    pair.second.state=ModelState::Unloaded;
-                    pair.second.vramUsageMb=0;
-                    pair.second.ramUsageMb=0;
-                    pair.second.perGpuVramMb.clear();
-                }
+                // Pinned models always stay Ready; other local models stay
+                // Ready while the RAM budget allows it
+                bool keepReady=pair.second.pinned||
+                    ((pair.second.llamaModel||!pair.second.filePaths.empty())&&effectiveReadyRamBudgetMb()>0);
+                demoteModel(pair.second, keepReady);
             }
         }
+        evictReadyModels();
     }
 
     ErrorCode result=loadModel(newModel, variant, contextSize, optionsOverride);
 
-    // Record swap telemetry
+    // Record swap telemetry, separating Ready→Loaded from Unloaded→Loaded loads
     std::chrono::steady_clock::time_point swapEnd=std::chrono::steady_clock::now();
     double swapTimeMs=std::chrono::duration<double, std::milli>(swapEnd-swapStart).count();
-    TelemetryCollector::instance().recordModelSwap(fromModel, newModel, swapTimeMs);
+
+    std::string loadedFrom;
+    double loadTimeMs=0.0;
+    if(result==ErrorCode::Success)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it=m_models.find(newModel);
+        if(it!=m_models.end())
+        {
+            loadedFrom=it->second.loadedFrom;
+            loadTimeMs=it->second.loadTimeMs;
+        }
+    }
+    TelemetryCollector::instance().recordModelSwap(fromModel, newModel, swapTimeMs, loadedFrom, loadTimeMs);
 
     return result;
 }
@@ -1015,7 +1590,15 @@ std::vector<LoadedModel> ModelRuntime::getModelStates() const
     result.reserve(m_models.size());
     for(const auto &pair:m_models)
     {
+        if(!pair.second.replicaOf.empty())
+        {
+            continue;
+        }
         result.push_back(pair.second);
+        if(pair.second.state==ModelState::Ready)
+        {
+            result.back().ramUsageMb=measureReadyRamMb(pair.second);
+        }
     }
     return result;
 }
@@ -1197,7 +1780,7 @@ std::vector<std::string> ModelRuntime::resolveBackendPriority(const ModelInfo &m
     return priority;
 }
 
-void ModelRuntime::evictIfNeeded(int requiredVramMb, int gpuIndex)
+void ModelRuntime::evictIfNeeded(int requiredVramMb, int gpuIndex, const std::string &keepModel)
 {
     if(gpuIndex>=0)
     {
@@ -1212,10 +1795,18 @@ void ModelRuntime::evictIfNeeded(int requiredVramMb, int gpuIndex)
 
         int needToFree=requiredVramMb-estimatedFree;
 
+        // Give back grown dynamic contexts before evicting whole models
+        needToFree-=shrinkDynamicContexts(gpuIndex, needToFree, keepModel);
+        if(needToFree<=0)
+        {
+            return;
+        }
+
         struct EvictCandidate {
             std::string model;
             int vramOnGpu;
             std::chrono::steady_clock::time_point lastUsed;
+            bool replica;
         };
 
         std::vector<EvictCandidate> candidates;
@@ -1223,19 +1814,25 @@ void ModelRuntime::evictIfNeeded(int requiredVramMb, int gpuIndex)
         {
             if(pair.second.state==ModelState::Loaded&&
                 !pair.second.pinned&&
-                !m_activeInference.count(pair.first))
+                !m_activeInference.count(pair.first)&&
+                pair.first!=keepModel)
             {
                 auto gpuIt=pair.second.perGpuVramMb.find(gpuIndex);
                 if(gpuIt!=pair.second.perGpuVramMb.end()&&gpuIt->second>0)
                 {
-                    candidates.push_back({pair.first, gpuIt->second, pair.second.lastUsed});
+                    candidates.push_back({pair.first, gpuIt->second, pair.second.lastUsed, !pair.second.replicaOf.empty()});
                 }
             }
         }
 
+        // Replicas go first: their model stays available on another instance
         std::sort(candidates.begin(), candidates.end(),
             [](const EvictCandidate &a, const EvictCandidate &b)
             {
+                if(a.replica!=b.replica)
+                {
+                    return a.replica;
+                }
                 return a.lastUsed<b.lastUsed;
             });
 
@@ -1250,11 +1847,9 @@ void ModelRuntime::evictIfNeeded(int requiredVramMb, int gpuIndex)
             auto it=m_models.find(candidate.model);
             if(it!=m_models.end())
             {
-                freeLlamaModel(it->second);
-                it->second.state=ModelState::Unloaded;
-                it->second.vramUsageMb=0;
-                it->second.ramUsageMb=0;
-                it->second.perGpuVramMb.clear();
+                // Keep the evicted model's weights in the Ready tier; the
+                // caller trims the tier back to budget once its load is done
+                demoteModel(it->second, effectiveReadyRamBudgetMb()>0&&!it->second.filePaths.empty());
                 freed+=candidate.vramOnGpu;
                 spdlog::info("Evicted model '{}' to free {}MB VRAM on GPU {}", candidate.model, candidate.vramOnGpu, gpuIndex);
             }
@@ -1287,6 +1882,7 @@ void ModelRuntime::evictIfNeeded(int requiredVramMb, int gpuIndex)
         std::string model;
         int vramMb;
         std::chrono::steady_clock::time_point lastUsed;
+        bool replica;
     };
 
     std::vector<EvictCandidate> candidates;
@@ -1294,16 +1890,21 @@ void ModelRuntime::evictIfNeeded(int requiredVramMb, int gpuIndex)
     {
         if(pair.second.state==ModelState::Loaded&&
             !pair.second.pinned&&
-            !m_activeInference.count(pair.first))
+            !m_activeInference.count(pair.first)&&
+            pair.first!=keepModel)
         {
-            candidates.push_back({pair.first, pair.second.estimatedVramUsageMb, pair.second.lastUsed});
+            candidates.push_back({pair.first, pair.second.estimatedVramUsageMb, pair.second.lastUsed, !pair.second.replicaOf.empty()});
         }
     }
 
-    // Sort by LRU (oldest first)
+    // Sort replicas first, then by LRU (oldest first)
     std::sort(candidates.begin(), candidates.end(),
         [](const EvictCandidate &a, const EvictCandidate &b)
         {
+            if(a.replica!=b.replica)
+            {
+                return a.replica;
+            }
             return a.lastUsed<b.lastUsed;
         });
 
@@ -1318,11 +1919,7 @@ void ModelRuntime::evictIfNeeded(int requiredVramMb, int gpuIndex)
         auto it=m_models.find(candidate.model);
         if(it!=m_models.end())
         {
-            freeLlamaModel(it->second);
-            it->second.state=ModelState::Unloaded;
-            it->second.vramUsageMb=0;
-            it->second.ramUsageMb=0;
-            it->second.perGpuVramMb.clear();
+            demoteModel(it->second, effectiveReadyRamBudgetMb()>0&&!it->second.filePaths.empty());
             freed+=candidate.vramMb;
             spdlog::info("Evicted model '{}' to free {}MB VRAM", candidate.model, candidate.vramMb);
         }
@@ -1331,218 +1928,1563 @@ void ModelRuntime::evictIfNeeded(int requiredVramMb, int gpuIndex)
 
 void ModelRuntime::beginInference(const std::string &model)
 {
-    m_activeInference.insert(model);
-
     std::lock_guard<std::mutex> lock(m_mutex);
-    auto it=m_models.find(model);
+    startInference(model);
+}
+
+void ModelRuntime::startInference(const std::string &instance)
+{
+    // NOTE: caller must hold m_mutex
+
+    m_activeInference.insert(instance);
+    m_threadArbiter.begin(instance);
+
+    auto it=m_models.find(instance);
     if(it!=m_models.end())
     {
         it->second.lastUsed=std::chrono::steady_clock::now();
+        bindCpuThreads(it->second);
     }
 }
 
-void ModelRuntime::endInference(const std::string &model)
+std::string ModelRuntime::acquireInstance(const std::string &model)
 {
-    // Record usage for storage tracking
-    if(!model.empty())
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::string best=model;
+    auto primary=m_models.find(model);
+    if(primary!=m_models.end())
     {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        auto it=m_models.find(model);
-        if(it!=m_models.end())
+        int bestDepth=m_threadArbiter.queueDepth(model);
+        int bestFree=estimatedFreeKvCells(primary->second, bestDepth);
+        std::chrono::steady_clock::time_point bestLastUsed=primary->second.lastUsed;
+
+        for(const auto &pair:m_models)
         {
-            StorageManager::instance().recordUsage(model, it->second.variant);
+            const LoadedModel &entry=pair.second;
+            if(entry.replicaOf!=model||entry.state!=ModelState::Loaded||!entry.llamaModel)
+            {
+                continue;
+            }
+
+            int depth=m_threadArbiter.queueDepth(pair.first);
+            int freeCells=estimatedFreeKvCells(entry, depth);
+            if(depth<bestDepth||
+                (depth==bestDepth&&(freeCells>bestFree||(freeCells==bestFree&&entry.lastUsed<bestLastUsed))))
+            {
+                best=pair.first;
+                bestDepth=depth;
+                bestFree=freeCells;
+                bestLastUsed=entry.lastUsed;
+            }
         }
     }
 
-    m_activeInference.erase(model);
+    // The chosen instance's context may have been freed while the request
+    // waited for admission (idle reclaim, memory pressure, a benchmark);
+    // rebuild it before handing the instance out
+    auto restoreContext=[this](const std::string &instance)
+    {
+        auto it=m_models.find(instance);
+        if(it==m_models.end()||it->second.state!=ModelState::Loaded||!it->second.llamaModel||it->second.llamaCtx)
+        {
+            return true;
+        }
+        return createContext(it->second, reclaimedContextSize(it->second))==ErrorCode::Success;
+    };
 
-    if(m_activeInference.empty())
+    if(best!=model&&!restoreContext(best))
     {
-        drainPendingSwaps();
+        best=model;
+    }
+    if(!restoreContext(best))
+    {
+        // getLlamaContext() returns null and the caller fails the request
+        spdlog::error("Could not recreate the context of '{}' for a request", best);
     }
-}
 
-bool ModelRuntime::isInferenceActive() const
-{
-    return !m_activeInference.empty();
+    startInference(best);
+    return best;
 }
 
-bool ModelRuntime::isInferenceActive(const std::string &model) const
+void ModelRuntime::setReplicaPolicy(const std::string &model, const ReplicaPolicy &policy)
 {
-    return m_activeInference.count(model)>0;
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    ReplicaPolicy clamped=policy;
+    clamped.minReplicas=std::max(1, clamped.minReplicas);
+    clamped.maxReplicas=std::max(clamped.minReplicas, clamped.maxReplicas);
+    clamped.scaleUpQueueDepth=std::max(1, clamped.scaleUpQueueDepth);
+    clamped.scaleDownIdleSeconds=std::max(0, clamped.scaleDownIdleSeconds);
+    m_replicaPolicies[model]=clamped;
+    m_replicaRetryAt.erase(model);
 }
 
-int ModelRuntime::getActiveInferenceCount() const
+std::optional<ReplicaPolicy> ModelRuntime::getReplicaPolicy(const std::string &model) const
 {
-    return static_cast<int>(m_activeInference.size());
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it=m_replicaPolicies.find(model);
+    if(it==m_replicaPolicies.end())
+    {
+        return std::nullopt;
+    }
+    return it->second;
 }
 
-int ModelRuntime::getCommittedVramMb(int gpuIndex) const
+std::vector<LoadedModel> ModelRuntime::getReplicaStates(const std::string &model) const
 {
-    int committed=0;
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::vector<LoadedModel> result;
     for(const auto &pair:m_models)
     {
-        if(pair.second.state!=ModelState::Loaded)
-        {
-            continue;
-        }
-
-        auto gpuIt=pair.second.perGpuVramMb.find(gpuIndex);
-        if(gpuIt!=pair.second.perGpuVramMb.end())
+        if(pair.second.replicaOf==model)
         {
-            committed+=gpuIt->second;
+            result.push_back(pair.second);
         }
     }
-    return committed;
+    std::sort(result.begin(), result.end(),
+        [](const LoadedModel &a, const LoadedModel &b)
+        {
+            return a.replicaIndex<b.replicaIndex;
+        });
+    return result;
 }
 
-int ModelRuntime::getEstimatedFreeVramMb(int gpuIndex) const
+int ModelRuntime::getInFlightRequests(const std::string &instance) const
 {
-    SystemInfo hw=HardwareDetector::instance().getSystemInfo();
+    return m_threadArbiter.queueDepth(instance);
+}
 
-    if(gpuIndex<0||gpuIndex>=static_cast<int>(hw.gpus.size()))
-    {
-        return 0;
-    }
+int ModelRuntime::scaleReplicas()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
 
-    const GpuInfo &gpu=hw.gpus[gpuIndex];
-    int totalVram=gpu.unifiedMemory&&gpu.gpuAccessibleRamMb>0
-        ?gpu.gpuAccessibleRamMb:gpu.vramTotalMb;
-    int committed=getCommittedVramMb(gpuIndex);
+    int change=0;
+    auto now=std::chrono::steady_clock::now();
 
-    return std::max(0, totalVram-committed);
-}
+    // Drop replicas whose primary went away or that were demoted
+    std::vector<std::string> stale;
+    for(const auto &pair:m_models)
+    {
+        const LoadedModel &entry=pair.second;
+        if(entry.replicaOf.empty()||m_threadArbiter.queueDepth(pair.first)>0)
+        {
+            continue;
+        }
 
-std::string ModelRuntime::selectBestVariant(const ModelInfo &model) const
-{
-    if(model.variants.empty())
+        auto primary=m_models.find(entry.replicaOf);
+        if(entry.state!=ModelState::Loaded||primary==m_models.end()||primary->second.state!=ModelState::Loaded)
+        {
+            stale.push_back(pair.first);
+        }
+    }
+    for(const std::string &key:stale)
     {
-        return "";
+        removeReplica(key);
+        --change;
     }
 
-    SystemInfo hw=HardwareDetector::instance().getSystemInfo();
+    for(const auto &policyPair:m_replicaPolicies)
+    {
+        const std::string &model=policyPair.first;
+        const ReplicaPolicy &policy=policyPair.second;
 
-    // Prefer the highest-quality variant that fits
-    // Variants are typically ordered by quality (lower quant = smaller file = lower quality)
-    // So iterate in reverse to find the best that fits
-    std::string bestVariant;
-    int bestVram=0;
+        auto primary=m_models.find(model);
+        if(primary==m_models.end()||primary->second.state!=ModelState::Loaded||!primary->second.llamaModel)
+        {
+            continue;
+        }
 
-    for(const ModelVariant &v:model.variants)
-    {
-        ModelFit fit=ModelFitCalculator::calculateModelFit(model, v, hw);
-        if(fit.canRun&&v.recommendedVramMb>bestVram)
+        std::vector<std::string> instances={model};
+        for(const auto &pair:m_models)
         {
-            bestVariant=v.quantization;
-            bestVram=v.recommendedVramMb;
+            if(pair.second.replicaOf==model)
+            {
+                instances.push_back(pair.first);
+            }
         }
-    }
+        int count=static_cast<int>(instances.size());
 
-    // If no variant fits at recommended, try minimum
-    if(bestVariant.empty())
-    {
-        for(const ModelVariant &v:model.variants)
+        // Busy when every instance has scaleUpQueueDepth requests in flight
+        // or that many are waiting in the admission queue
+        bool saturated=true;
+        for(const std::string &instance:instances)
         {
-            ModelFit fit=ModelFitCalculator::calculateModelFit(model, v, hw);
-            if(fit.canRun)
+            if(m_threadArbiter.queueDepth(instance)<policy.scaleUpQueueDepth)
             {
-                bestVariant=v.quantization;
+                saturated=false;
                 break;
             }
         }
-    }
-
-    // Fallback to first variant
-    if(bestVariant.empty())
-    {
-        bestVariant=model.variants[0].quantization;
-    }
+        if(!saturated&&m_requestQueue.stats(model).waiting>=policy.scaleUpQueueDepth)
+        {
+            saturated=true;
+        }
 
-    return bestVariant;
-}
+        if(count<policy.minReplicas||(saturated&&count<policy.maxReplicas))
+        {
+            auto retry=m_replicaRetryAt.find(model);
+            if(retry!=m_replicaRetryAt.end()&&now<retry->second)
+            {
+                continue;
+            }
 
-void ModelRuntime::drainPendingSwaps()
+            // A replica is speculative capacity; none are added under memory pressure
+            if(m_pressure.level!=MemoryPressureLevel::None)
+            {
+                m_replicaRetryAt[model]=now+std::chrono::seconds(REPLICA_RETRY_SECONDS);
+                recordPressureEvent("refuse_replica", model, 0);
+                continue;
+            }
+
+            if(addReplica(model)==ErrorCode::Success)
+            {
+                m_replicaRetryAt.erase(model);
+                ++change;
+            }
+            else
+            {
+                m_replicaRetryAt[model]=now+std::chrono::seconds(REPLICA_RETRY_SECONDS);
+            }
+            continue;
+        }
+
+        if(count<=policy.minReplicas)
+        {
+            continue;
+        }
+
+        // Retire the newest idle replica; above maxReplicas (policy lowered)
+        // it goes as soon as it is idle
+        std::string victim;
+        int victimIndex=0;
+        for(const std::string &instance:instances)
+        {
+            const LoadedModel &entry=m_models[instance];
+            if(entry.replicaOf.empty()||m_threadArbiter.queueDepth(instance)>0||m_activeInference.count(instance))
+            {
+                continue;
+            }
+
+            int idleSeconds=static_cast<int>(std::chrono::duration_cast<std::chrono::seconds>(now-entry.lastUsed).count());
+            if((count>policy.maxReplicas||idleSeconds>=policy.scaleDownIdleSeconds)&&entry.replicaIndex>victimIndex)
+            {
+                victim=instance;
+                victimIndex=entry.replicaIndex;
+            }
+        }
+        if(!victim.empty())
+        {
+            spdlog::info("Removing idle replica '{}' of '{}' ({} instances)", victim, model, count-1);
+            removeReplica(victim);
+            --change;
+        }
+    }
+
+    // Queued requests start on new replicas right away
+    for(const auto &policyPair:m_replicaPolicies)
+    {
+        m_requestQueue.setInstances(policyPair.first, instanceCount(policyPair.first));
+    }
+
+    return change;
+}
+
+ErrorCode ModelRuntime::addReplica(const std::string &model)
 {
-    std::lock_guard<std::mutex> lock(m_mutex);
+    // NOTE: caller must hold m_mutex
 
-    if(m_pendingSwaps.empty())
+    const LoadedModel primary=m_models[model];
+
+    int index=1;
+    while(m_models.count(replicaKey(model, index)))
+    {
+        ++index;
+    }
+    std::string key=replicaKey(model, index);
+
+    SystemInfo hw=HardwareDetector::instance().getSystemInfo();
+    RuntimeOptions options=primary.activeOptions;
+
+    int contextMb=0;
+    for(const auto &pair:primary.deviceAllocations)
+    {
+        contextMb+=pair.second.kvCacheBufferMb+pair.second.computeBufferMb;
+    }
+
+    std::vector<int> gpus;
+    std::map<int, int> perGpuVramMb;
+    int hostMb=0;
+    if(!primary.perGpuVramMb.empty())
+    {
+        // Same number of GPUs as the primary, each with room for the largest
+        // remaining share; GPUs no instance uses yet are preferred
+        std::vector<int> shares;
+        for(const auto &pair:primary.perGpuVramMb)
+        {
+            shares.push_back(pair.second);
+        }
+        std::sort(shares.rbegin(), shares.rend());
+
+        std::set<int> used;
+        for(const auto &pair:m_models)
+        {
+            if(pair.first==model||pair.second.replicaOf==model)
+            {
+                for(const auto &gpu:pair.second.perGpuVramMb)
+                {
+                    used.insert(gpu.first);
+                }
+            }
+        }
+
+        std::vector<std::pair<int, int>> candidates;  // (free MB, gpu index)
+        for(int i=0; i<static_cast<int>(hw.gpus.size()); ++i)
+        {
+            candidates.emplace_back(getEstimatedFreeVramMb(i), i);
+        }
+        std::sort(candidates.begin(), candidates.end(),
+            [&used](const std::pair<int, int> &a, const std::pair<int, int> &b)
+            {
+                bool aUsed=used.count(a.second)>0;
+                bool bUsed=used.count(b.second)>0;
+                if(aUsed!=bUsed)
+                {
+                    return !aUsed;
+                }
+                return a.first>b.first;
+            });
+
+        for(int share:shares)
+        {
+            auto it=std::find_if(candidates.begin(), candidates.end(),
+                [share](const std::pair<int, int> &candidate)
+                {
+                    return candidate.first>=share;
+                });
+            if(it==candidates.end())
+            {
+                spdlog::debug("No GPU has {}MB free for a replica of '{}'", share, model);
+                return ErrorCode::ModelLoadError;
+            }
+            gpus.push_back(it->second);
+            perGpuVramMb[it->second]=share;
+            candidates.erase(it);
+        }
+    }
+    else if(hw.numaNodes.size()>1)
+    {
+        // Host model: a replica on another node gets a node-local copy of
+        // the weights so its threads never read across the interconnect
+        int fileMb=0;
+        for(const std::string &path:primary.filePaths)
+        {
+            std::error_code ec;
+            uintmax_t size=std::filesystem::file_size(path, ec);
+            if(!ec)
+            {
+                fileMb+=static_cast<int>(size/(1024*1024));
+            }
+        }
+
+        std::set<int> usedNodes;
+        for(const auto &pair:m_models)
+        {
+            if((pair.first==model||pair.second.replicaOf==model)&&pair.second.numaNode>=0)
+            {
+                usedNodes.insert(pair.second.numaNode);
+            }
+        }
+
+        int node=-1;
+        for(int i=0; i<static_cast<int>(hw.numaNodes.size()); ++i)
+        {
+            if(!usedNodes.count(i)&&hw.numaNodes[i].freeRamMb>=fileMb+contextMb&&
+                (node<0||hw.numaNodes[i].freeRamMb>hw.numaNodes[node].freeRamMb))
+            {
+                node=i;
+            }
+        }
+        if(node<0)
+        {
+            spdlog::debug("No NUMA node has {}MB free for a replica of '{}'", fileMb+contextMb, model);
+            return ErrorCode::ModelLoadError;
+        }
+
+        options.numaPolicy="auto";
+        options.numaNode=node;
+        options.noMmap=true;
+        hostMb=fileMb;
+    }
+    else if(hw.freeRamMb<contextMb)
+    {
+        // Same node: the mapped weights are shared, only the context is new
+        spdlog::debug("Not enough free RAM ({}MB) for a {}MB replica context of '{}'", hw.freeRamMb, contextMb, model);
+        return ErrorCode::ModelLoadError;
+    }
+
+    LoadedModel &entry=m_models[key];
+    entry.modelName=key;
+    entry.replicaOf=model;
+    entry.replicaIndex=index;
+    entry.variant=primary.variant;
+    entry.contextSize=primary.contextSize;
+    entry.estimatedVramUsageMb=primary.estimatedVramUsageMb;
+    entry.gpuIndices=gpus;
+    entry.perGpuVramMb=perGpuVramMb;
+    entry.filePaths=primary.filePaths;
+    entry.backendPriority=primary.backendPriority;
+    entry.activeOptions=options;
+    entry.placement=primary.placement;
+    entry.autotuned=primary.autotuned;
+    entry.lastUsed=std::chrono::steady_clock::now();
+    placeNuma(entry, options, hostMb);
+
+    auto loadStart=std::chrono::steady_clock::now();
+    ErrorCode result=loadLlamaModel(key, primary.filePaths.front(), primary.contextSize, gpus,
+        primary.contextLimit>0?primary.contextLimit:primary.loadedContextSize, options, primary.backendPriority);
+    if(result!=ErrorCode::Success)
+    {
+        spdlog::warn("Failed to load replica '{}' of '{}'", key, model);
+        m_models.erase(key);
+        m_threadArbiter.remove(key);
+        return result;
+    }
+
+    if(entry.contextLimit>0)
+    {
+        chargeContextVram(entry, -static_cast<int>(entry.kvMbPerToken*(entry.contextLimit-entry.contextSize)));
+    }
+    entry.state=ModelState::Loaded;
+    entry.loadedFrom="Unloaded";
+    entry.loadTimeMs=std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now()-loadStart).count()-
+        entry.warmupTimeMs;
+
+    spdlog::info("Loaded replica '{}' of '{}' (context={}, gpus={}, numa={}, {:.1f}ms)",
+        key, model, entry.contextSize, entry.gpuIndices.size(),
+        entry.numaPolicy.empty()?"none":entry.numaPolicy, entry.loadTimeMs);
+    return ErrorCode::Success;
+}
+
+void ModelRuntime::removeReplica(const std::string &key)
+{
+    // NOTE: caller must hold m_mutex
+
+    auto it=m_models.find(key);
+    if(it==m_models.end()||it->second.replicaOf.empty())
     {
         return;
     }
 
-    // Only execute the most recent swap, discard stale ones
-    SwapRequest latest=m_pendingSwaps.back();
-    while(!m_pendingSwaps.empty())
+    demoteModel(it->second, false);
+    m_models.erase(it);
+}
+
+bool ModelRuntime::autoSelectsKvCache(const RuntimeOptions &options)
+{
+    return !options.kvCacheTypeK.has_value()&&
+        !options.kvCacheTypeV.has_value()&&
+        options.flashAttn.value_or(true);
+}
+
+bool ModelRuntime::applyKvCacheFit(RuntimeOptions &options, const ModelFit &fit)
+{
+    if(fit.kvCacheType.empty()||fit.kvCacheType=="f16"||
+        options.kvCacheTypeK.has_value()||options.kvCacheTypeV.has_value())
     {
-        m_pendingSwaps.pop();
+        return false;
     }
+    options.kvCacheTypeK=fit.kvCacheType;
+    options.kvCacheTypeV=fit.kvCacheType;
+    return true;
+}
 
-    // Release lock before calling swapModel (it acquires its own lock)
-    m_mutex.unlock();
-    swapModel(latest.model, latest.variant, latest.contextSize, latest.optionsOverride);
-    m_mutex.lock();
+std::string ModelRuntime::replicaKey(const std::string &model, int index)
+{
+    return model+"#"+std::to_string(index);
 }
 
-int ModelRuntime::calculateReadyRamUsage() const
+int ModelRuntime::instanceCount(const std::string &model) const
 {
-    int total=0;
+    // NOTE: caller must hold m_mutex
+
+    int count=1;
     for(const auto &pair:m_models)
     {
-        if(pair.second.state==ModelState::Ready)
+        if(pair.second.replicaOf==model&&pair.second.state==ModelState::Loaded)
         {
-            total+=pair.second.ramUsageMb;
+            ++count;
         }
     }
-    return total;
+    return count;
 }
 
-void ModelRuntime::evictReadyModels()
+ErrorCode ModelRuntime::admitRequest(const std::string &model, const std::string &tenant, RequestPriority priority,
+    const std::function<void(int)> &onPosition)
 {
-    int currentUsage=calculateReadyRamUsage();
-    if(currentUsage<=m_readyRamBudgetMb)
     {
-        return;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_requestQueue.setInstances(model, instanceCount(model));
     }
 
-    // Collect non-pinned Ready models, sort by LRU
-    struct ReadyCandidate {
-        std::string model;
-        int ramMb;
-        std::chrono::steady_clock::time_point lastUsed;
-    };
+    // Waits without m_mutex; scaleReplicas() and releaseRequest() wake it
+    ErrorCode result=m_requestQueue.acquire(model, tenant, priority, onPosition);
+    if(result!=ErrorCode::Success)
+    {
+        spdlog::warn("Rejected request for '{}' from tenant '{}': {}", model, tenant,
+            result==ErrorCode::QueueFull?"queue full":"too many queued requests");
+    }
+    return result;
+}
 
-    std::vector<ReadyCandidate> candidates;
-    for(const auto &pair:m_models)
+void ModelRuntime::releaseRequest(const std::string &model)
+{
+    m_requestQueue.release(model);
+}
+
+ErrorCode ModelRuntime::checkAdmission(const std::string &model, const std::string &tenant) const
+{
+    return m_requestQueue.checkAdmission(model, tenant);
+}
+
+void ModelRuntime::setRequestQueueConfig(const RequestQueueConfig &config)
+{
+    // Every request on an instance decodes on sequence 0 of its one
+    // llama_context, so two at once would corrupt each other's KV cache
+    RequestQueueConfig clamped=config;
+    if(clamped.slotsPerInstance>1)
     {
-        if(pair.second.state==ModelState::Ready&&!pair.second.pinned)
+        spdlog::warn("Request queue: {} slots per instance requested; local models run one request per instance",
+            clamped.slotsPerInstance);
+        clamped.slotsPerInstance=1;
+    }
+    m_requestQueue.setConfig(clamped);
+}
+
+RequestQueueConfig ModelRuntime::getRequestQueueConfig() const
+{
+    return m_requestQueue.getConfig();
+}
+
+RequestQueueStats ModelRuntime::getRequestQueueStats(const std::string &model) const
+{
+    return m_requestQueue.stats(model);
+}
+
+void ModelRuntime::endInference(const std::string &model)
+{
+    bool idle=false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_threadArbiter.end(model);
+
+        auto it=m_models.find(model);
+        if(it!=m_models.end())
         {
-            candidates.push_back({pair.first, pair.second.ramUsageMb, pair.second.lastUsed});
+            // Idle time counts from the end of the request, not its start
+            it->second.lastUsed=std::chrono::steady_clock::now();
+
+            // Record usage for storage tracking
+            StorageManager::instance().recordUsage(it->second.replicaOf.empty()?model:it->second.replicaOf,
+                it->second.variant);
+
+            // Idle pools stop polling so they do not steal cores from active models
+            if(m_threadArbiter.queueDepth(model)==0&&it->second.cpuThreads&&it->second.cpuThreads->threadpool)
+            {
+                ggml_threadpool_pause(it->second.cpuThreads->threadpool);
+            }
         }
+
+        m_activeInference.erase(model);
+        idle=m_activeInference.empty();
     }
 
-    std::sort(candidates.begin(), candidates.end(),
-        [](const ReadyCandidate &a, const ReadyCandidate &b)
-        {
-            return a.lastUsed<b.lastUsed;
-        });
+    if(idle)
+    {
+        drainPendingSwaps();
+    }
+}
 
-    for(const ReadyCandidate &candidate:candidates)
+bool ModelRuntime::isInferenceActive() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return !m_activeInference.empty();
+}
+
+bool ModelRuntime::isInferenceActive(const std::string &model) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_activeInference.count(model)>0;
+}
+
+int ModelRuntime::getActiveInferenceCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return static_cast<int>(m_activeInference.size());
+}
+
+int ModelRuntime::getCommittedVramMb(int gpuIndex) const
+{
+    int committed=0;
+    for(const auto &pair:m_models)
     {
-        if(currentUsage<=m_readyRamBudgetMb)
+        if(pair.second.state!=ModelState::Loaded)
         {
-            break;
+            continue;
         }
 
-        auto it=m_models.find(candidate.model);
-        if(it!=m_models.end())
+        auto gpuIt=pair.second.perGpuVramMb.find(gpuIndex);
+        if(gpuIt!=pair.second.perGpuVramMb.end())
         {
-            freeLlamaModel(it->second);
-            it->second.state=ModelState::Unloaded;
-            it->second.ramUsageMb=0;
-            currentUsage-=candidate.ramMb;
-            spdlog::info("Evicted Ready model '{}' to free {}MB RAM", candidate.model, candidate.ramMb);
+            committed+=gpuIt->second;
+        }
+
+        // A reclaimed context no longer holds its KV cache / compute buffers
+        if(pair.second.contextReclaimed)
+        {
+            auto ctxIt=pair.second.perGpuContextVramMb.find(gpuIndex);
+            if(ctxIt!=pair.second.perGpuContextVramMb.end())
+            {
+                committed-=ctxIt->second;
+            }
         }
     }
+    return std::max(0, committed);
+}
+
+int ModelRuntime::getEstimatedFreeVramMb(int gpuIndex) const
+{
+    SystemInfo hw=HardwareDetector::instance().getSystemInfo();
+
+    if(gpuIndex<0||gpuIndex>=static_cast<int>(hw.gpus.size()))
+    {
+        return 0;
+    }
+
+    const GpuInfo &gpu=hw.gpus[gpuIndex];
+    int totalVram=gpu.unifiedMemory&&gpu.gpuAccessibleRamMb>0
+        ?gpu.gpuAccessibleRamMb:gpu.vramTotalMb;
+    int committed=getCommittedVramMb(gpuIndex);
+
+    return std::max(0, totalVram-committed);
+}
+
+std::string ModelRuntime::selectBestVariant(const ModelInfo &model) const
+{
+    if(model.variants.empty())
+    {
+        return "";
+    }
+
+    SystemInfo hw=HardwareDetector::instance().getSystemInfo();
+
+    // Prefer the highest-quality variant that fits
+    // Variants are typically ordered by quality (lower quant = smaller file = lower quality)
+    // So iterate in reverse to find the best that fits
+    std::string bestVariant;
+    int bestVram=0;
+
+    for(const ModelVariant &v:model.variants)
+    {
+        ModelFit fit=ModelFitCalculator::calculateModelFit(model, v, hw);
+        if(fit.canRun&&v.recommendedVramMb>bestVram)
+        {
+            bestVariant=v.quantization;
+            bestVram=v.recommendedVramMb;
+        }
+    }
+
+    // If no variant fits at recommended, try minimum
+    if(bestVariant.empty())
+    {
+        for(const ModelVariant &v:model.variants)
+        {
+            ModelFit fit=ModelFitCalculator::calculateModelFit(model, v, hw);
+            if(fit.canRun)
+            {
+                bestVariant=v.quantization;
+                break;
+            }
+        }
+    }
+
+    // Fallback to first variant
+    if(bestVariant.empty())
+    {
+        bestVariant=model.variants[0].quantization;
+    }
+
+    return bestVariant;
+}
+
+void ModelRuntime::drainPendingSwaps()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if(m_pendingSwaps.empty())
+    {
+        return;
+    }
+
+    // Only execute the most recent swap, discard stale ones
+    SwapRequest latest=m_pendingSwaps.back();
+    while(!m_pendingSwaps.empty())
+    {
+        m_pendingSwaps.pop();
+    }
+
+    // Release lock before calling swapModel (it acquires its own lock)
+    m_mutex.unlock();
+    swapModel(latest.model, latest.variant, latest.contextSize, latest.optionsOverride);
+    m_mutex.lock();
+}
+
+int ModelRuntime::calculateReadyRamUsage() const
+{
+    int total=0;
+    for(const auto &pair:m_models)
+    {
+        if(pair.second.state==ModelState::Ready)
+        {
+            total+=measureReadyRamMb(pair.second);
+        }
+    }
+    return total;
+}
+
+int ModelRuntime::measureReadyRamMb(const LoadedModel &entry) const
+{
+    if(!entry.residentWeights.empty())
+    {
+        int64_t residentBytes=0;
+        for(const std::shared_ptr<MappedFile> &file:entry.residentWeights)
+        {
+            residentBytes+=file->residentBytes();
+        }
+        return static_cast<int>(residentBytes/(1024*1024));
+    }
+    if(entry.llamaModel)
+    {
+        return entry.measuredRamMb;
+    }
+    return 0;
+}
+
+void ModelRuntime::evictReadyModels()
+{
+    // Refresh from measurement — page cache residency changes under us
+    for(auto &pair:m_models)
+    {
+        if(pair.second.state==ModelState::Ready)
+        {
+            pair.second.ramUsageMb=measureReadyRamMb(pair.second);
+        }
+    }
+
+    int budgetMb=effectiveReadyRamBudgetMb();
+    int currentUsage=calculateReadyRamUsage();
+    if(currentUsage<=budgetMb)
+    {
+        return;
+    }
+
+    // Collect non-pinned Ready models, sort by LRU
+    struct ReadyCandidate {
+        std::string model;
+        int ramMb;
+        std::chrono::steady_clock::time_point lastUsed;
+    };
+
+    std::vector<ReadyCandidate> candidates;
+    for(const auto &pair:m_models)
+    {
+        if(pair.second.state==ModelState::Ready&&!pair.second.pinned)
+        {
+            candidates.push_back({pair.first, pair.second.ramUsageMb, pair.second.lastUsed});
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end(),
+        [](const ReadyCandidate &a, const ReadyCandidate &b)
+        {
+            return a.lastUsed<b.lastUsed;
+        });
+
+    for(const ReadyCandidate &candidate:candidates)
+    {
+        if(currentUsage<=budgetMb)
+        {
+            break;
+        }
+
+        auto it=m_models.find(candidate.model);
+        if(it!=m_models.end())
+        {
+            freeLlamaModel(it->second);
+            it->second.state=ModelState::Unloaded;
+            it->second.ramUsageMb=0;
+            it->second.perGpuVramMb.clear();
+            currentUsage-=candidate.ramMb;
+            spdlog::info("Evicted Ready model '{}' to free {}MB RAM", candidate.model, candidate.ramMb);
+
+            if(m_pressure.level!=MemoryPressureLevel::None)
+            {
+                recordPressureEvent("evict_ready", candidate.model, candidate.ramMb);
+            }
+        }
+    }
+}
+
+void ModelRuntime::demoteModel(LoadedModel &entry, bool keepReady)
+{
+    entry.vramUsageMb=0;
+
+    // A replica is just extra capacity; its weights are the primary's
+    if(!entry.replicaOf.empty())
+    {
+        keepReady=false;
+    }
+
+    if(!keepReady)
+    {
+        freeLlamaModel(entry);
+        entry.state=ModelState::Unloaded;
+        entry.ramUsageMb=0;
+        entry.perGpuVramMb.clear();
+        return;
+    }
+
+    if(entry.llamaCtx)
+    {
+        llama_free(entry.llamaCtx);
+        entry.llamaCtx=nullptr;
+        detachCpuThreads(entry);
+    }
+    freeCpuThreadpool(entry);
+    entry.contextReclaimed=false;
+
+    if(entry.llamaModel&&hasGpuWeights(entry))
+    {
+        // Weights live in VRAM: release them, but map the GGUF files first so
+        // the pages llama.cpp just read stay in the page cache for re-upload.
+        bool lock=entry.activeOptions.mlock.value_or(false);
+
+        entry.residentWeights.clear();
+        for(const std::string &path:entry.filePaths)
+        {
+            std::shared_ptr<MappedFile> mapped=std::make_shared<MappedFile>();
+            if(mapped->open(path, lock))
+            {
+                entry.residentWeights.push_back(mapped);
+            }
+        }
+
+        forgetLoraAdapters(entry);
+        llama_model_free(entry.llamaModel);
+        entry.llamaModel=nullptr;
+    }
+
+    entry.state=ModelState::Ready;
+    entry.ramUsageMb=measureReadyRamMb(entry);
+}
+
+ErrorCode ModelRuntime::promoteReadyModel(LoadedModel &entry)
+{
+    entry.warmupTimeMs=0.0;
+
+    if(entry.llamaModel&&!entry.llamaCtx)
+    {
+        // Weights are still resident in host RAM — only rebuild the context
+        return createContext(entry, entry.contextSize);
+    }
+    else if(!entry.llamaModel&&!entry.filePaths.empty())
+    {
+        // Weights were released from VRAM but kept mapped in host RAM —
+        // re-upload them from the page cache instead of reading from disk.
+        entry.lastUsed=std::chrono::steady_clock::now();
+        for(const auto &pair:entry.perGpuVramMb)
+        {
+            evictIfNeeded(pair.second, pair.first);
+        }
+
+        // Dynamic contexts restart small; pass the limit so it is kept
+        int previousContext=entry.contextSize;
+        int requestedContext=entry.contextLimit>0?entry.contextLimit:entry.contextSize;
+
+        ErrorCode result=loadLlamaModel(entry.modelName, entry.filePaths.front(), requestedContext,
+            entry.gpuIndices, 0, entry.activeOptions, entry.backendPriority);
+        if(result!=ErrorCode::Success)
+        {
+            return result;
+        }
+        chargeContextVram(entry, static_cast<int>(entry.kvMbPerToken*(entry.contextSize-previousContext)));
+
+        // llama.cpp holds its own buffers/mapping now
+        entry.residentWeights.clear();
+    }
+    return ErrorCode::Success;
+}
+
+ErrorCode ModelRuntime::createContext(LoadedModel &entry, int contextSize)
+{
+    if(!entry.llamaModel)
+    {
+        return ErrorCode::ModelNotLoaded;
+    }
+
+    // Make room for the KV cache and compute buffers again, plus any growth
+    // over the previous context size
+    int growthMb=static_cast<int>(entry.kvMbPerToken*(contextSize-entry.contextSize));
+    int gpuCount=static_cast<int>(entry.gpuIndices.size());
+    for(int gpuIdx:entry.gpuIndices)
+    {
+        auto ctxIt=entry.perGpuContextVramMb.find(gpuIdx);
+        int needMb=(ctxIt!=entry.perGpuContextVramMb.end()?ctxIt->second:0)+growthMb/gpuCount;
+        evictIfNeeded(needMb, gpuIdx, entry.modelName);
+    }
+
+    // Host KV cache and compute buffers follow the model's NUMA placement
+    ScopedMemoryPolicy memoryPolicy(numaMemoryNodes(entry), entry.numaPolicy);
+
+    entry.llamaCtx=initContext(entry.llamaModel, entry.activeOptions, contextSize, entry.modelName);
+    if(!entry.llamaCtx)
+    {
+        spdlog::error("Failed to recreate llama context for model: {}", entry.modelName);
+        return ErrorCode::ModelLoadError;
+    }
+
+    int previousContext=entry.contextSize;
+    entry.contextSize=static_cast<int>(llama_n_ctx(entry.llamaCtx));
+    entry.contextReclaimed=false;
+    chargeContextVram(entry, static_cast<int>(entry.kvMbPerToken*(entry.contextSize-previousContext)));
+
+    // Adapters belong to the context; carry the active set over
+    for(const LoraSelection &selection:entry.appliedLoras)
+    {
+        auto cached=entry.loraAdapters.find(selection.path);
+        if(cached!=entry.loraAdapters.end())
+        {
+            llama_set_adapter_lora(entry.llamaCtx, cached->second.adapter, selection.scale);
+        }
+    }
+    return ErrorCode::Success;
+}
+
+ErrorCode ModelRuntime::resizeContext(LoadedModel &entry, int newSize, const std::string &reason)
+{
+    if(!entry.llamaModel||!entry.llamaCtx)
+    {
+        return ErrorCode::ModelNotLoaded;
+    }
+
+    std::chrono::steady_clock::time_point start=std::chrono::steady_clock::now();
+    int oldSize=entry.contextSize;
+
+    // Save sequence 0 so an in-flight conversation survives the rebuild.
+    // A shrink that would truncate it drops the state instead.
+    std::vector<uint8_t> seqState;
+    llama_pos lastPos=llama_memory_seq_pos_max(llama_get_memory(entry.llamaCtx), 0);
+    if(lastPos>=0&&lastPos<newSize)
+    {
+        seqState.resize(llama_state_seq_get_size(entry.llamaCtx, 0));
+        size_t written=llama_state_seq_get_data(entry.llamaCtx, seqState.data(), seqState.size(), 0);
+        seqState.resize(written);
+    }
+
+    // Build the new context next to the old one first, so a failed resize
+    // leaves the model decoding on the context it already has
+    llama_context *oldCtx=entry.llamaCtx;
+    ErrorCode result=createContext(entry, newSize);
+    if(result==ErrorCode::Success)
+    {
+        llama_free(oldCtx);
+    }
+    else
+    {
+        // Not enough room for both: free the old one and try again
+        entry.llamaCtx=nullptr;
+        llama_free(oldCtx);
+        entry.contextReclaimed=true;
+
+        result=createContext(entry, newSize);
+        if(result!=ErrorCode::Success)
+        {
+            spdlog::warn("Failed to resize context for '{}' from {} to {} — restoring previous size",
+                entry.modelName, oldSize, newSize);
+
+            // Leaves the context reclaimed (recreated on next load) if even this fails
+            result=createContext(entry, oldSize);
+            if(result!=ErrorCode::Success)
+            {
+                return result;
+            }
+        }
+    }
+    detachCpuThreads(entry);
+
+    bool carried=false;
+    if(!seqState.empty())
+    {
+        carried=llama_state_seq_set_data(entry.llamaCtx, seqState.data(), seqState.size(), 0)>0;
+    }
+
+    ContextResizeEvent event;
+    event.model=entry.modelName;
+    event.fromContext=oldSize;
+    event.toContext=entry.contextSize;
+    event.reason=reason;
+    event.stateCarried=carried;
+    event.timeMs=std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now()-start).count();
+    event.when=std::chrono::system_clock::now();
+    TelemetryCollector::instance().recordContextResize(event);
+
+    return result;
+}
+
+ErrorCode ModelRuntime::ensureContextCapacity(const std::string &model, int requiredTokens)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it=m_models.find(model);
+    if(it==m_models.end()||it->second.state!=ModelState::Loaded||!it->second.llamaModel)
+    {
+        return ErrorCode::ModelNotLoaded;
+    }
+
+    LoadedModel &entry=it->second;
+    if(entry.llamaCtx&&entry.contextSize>=requiredTokens)
+    {
+        return ErrorCode::Success;
+    }
+    if(entry.contextLimit<=0)
+    {
+        return ErrorCode::InvalidRequest; // fixed-size context
+    }
+    if(requiredTokens>entry.contextLimit)
+    {
+        spdlog::warn("Model '{}' needs {} context tokens, above its dynamic limit of {}",
+            model, requiredTokens, entry.contextLimit);
+        return ErrorCode::InvalidRequest;
+    }
+
+    int target=std::max(entry.contextSize, MIN_SHRUNK_CONTEXT);
+    while(target<requiredTokens)
+    {
+        target*=2;
+    }
+    target=std::min(target, entry.contextLimit);
+
+    ErrorCode result=entry.llamaCtx
+        ?resizeContext(entry, target, "grow")
+        :createContext(entry, target);
+    if(result!=ErrorCode::Success)
+    {
+        return result;
+    }
+
+    entry.lastUsed=std::chrono::steady_clock::now();
+    return entry.contextSize>=requiredTokens?ErrorCode::Success:ErrorCode::InvalidRequest;
+}
+
+ErrorCode ModelRuntime::runBenchmark(const std::string &model, const RuntimeOptions &options,
+    int promptTokens, int generateTokens, BenchmarkResult &result)
+{
+    llama_model *llamaModel=nullptr;
+    RuntimeOptions trialOptions;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto it=m_models.find(model);
+        if(it==m_models.end()||it->second.state!=ModelState::Loaded||!it->second.llamaModel)
+        {
+            return ErrorCode::ModelNotLoaded;
+        }
+        if(m_activeInference.count(model))
+        {
+            return ErrorCode::InvalidRequest;
+        }
+
+        LoadedModel &entry=it->second;
+        if(entry.llamaCtx)
+        {
+            // Give the trial contexts the serving context's memory; it is
+            // recreated on the next loadModel() like an idle-reclaimed one
+            llama_free(entry.llamaCtx);
+            entry.llamaCtx=nullptr;
+            detachCpuThreads(entry);
+            entry.contextReclaimed=true;
+        }
+
+        llamaModel=entry.llamaModel;
+        trialOptions=entry.activeOptions;
+        trialOptions.mergeFrom(options);
+
+        // Keeps the weights from being evicted while the lock is released
+        m_activeInference.insert(model);
+    }
+
+    ErrorCode status=ErrorCode::Success;
+    int contextSize=(promptTokens+generateTokens+255)/256*256;
+    llama_context_params cparams=buildContextParams(trialOptions, contextSize);
+    llama_context *ctx=llama_init_from_model(llamaModel, cparams);
+
+    if(!ctx)
+    {
+        status=ErrorCode::ModelLoadError;
+    }
+    else
+    {
+        // Synthetic prompt: a short sentence tokenized once and repeated
+        const llama_vocab *vocab=llama_model_get_vocab(llamaModel);
+        std::string text="The quick brown fox jumps over the lazy dog while the orchestra tunes its instruments. ";
+        std::vector<llama_token> sentence(text.size()+16);
+        int nSentence=llama_tokenize(vocab, text.c_str(), text.length(),
+            sentence.data(), static_cast<int32_t>(sentence.size()), false, false);
+
+        if(nSentence<=0)
+        {
+            status=ErrorCode::ModelLoadError;
+        }
+        else
+        {
+            std::vector<llama_token> tokens(promptTokens+generateTokens);
+            for(size_t i=0; i<tokens.size(); ++i)
+            {
+                tokens[i]=sentence[i%nSentence];
+            }
+
+            int nBatch=static_cast<int>(llama_n_batch(ctx));
+            std::chrono::steady_clock::time_point start=std::chrono::steady_clock::now();
+            for(int offset=0; offset<promptTokens&&status==ErrorCode::Success; offset+=nBatch)
+            {
+                int count=std::min(nBatch, promptTokens-offset);
+                if(llama_decode(ctx, llama_batch_get_one(tokens.data()+offset, count))!=0)
+                {
+                    status=ErrorCode::ModelLoadError;
+                }
+            }
+            llama_synchronize(ctx);
+            double promptSeconds=std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+
+            start=std::chrono::steady_clock::now();
+            for(int i=0; i<generateTokens&&status==ErrorCode::Success; ++i)
+            {
+                if(llama_decode(ctx, llama_batch_get_one(&tokens[promptTokens+i], 1))!=0)
+                {
+                    status=ErrorCode::ModelLoadError;
+                }
+            }
+            llama_synchronize(ctx);
+            double generateSeconds=std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+
+            result.promptTokens=promptTokens;
+            result.generatedTokens=generateTokens;
+            result.promptTokensPerSec=promptSeconds>0.0?promptTokens/promptSeconds:0.0;
+            result.generationTokensPerSec=generateSeconds>0.0?generateTokens/generateSeconds:0.0;
+        }
+
+        llama_free(ctx);
+    }
+
+    bool idle=false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto it=m_models.find(model);
+        if(it!=m_models.end())
+        {
+            it->second.lastUsed=std::chrono::steady_clock::now();
+        }
+        m_activeInference.erase(model);
+        idle=m_activeInference.empty();
+    }
+
+    if(idle)
+    {
+        drainPendingSwaps();
+    }
+    return status;
+}
+
+ErrorCode ModelRuntime::autotune(const std::string &model, const AutotuneConfig &config, AutotuneResult &result)
+{
+    std::string variant;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto it=m_models.find(model);
+        if(it==m_models.end()||it->second.state!=ModelState::Loaded||!it->second.llamaModel)
+        {
+            return ErrorCode::ModelNotLoaded;
+        }
+        variant=it->second.variant;
+    }
+
+    // Tune for the CPUs of the node the model runs on
+    CpuThreadShare share=m_threadArbiter.share(model);
+    int cores=static_cast<int>(m_threadArbiter.nodeCpus(share.node).size());
+
+    spdlog::info("Autotuning '{}' variant '{}' ({} prompt + {} generated tokens per trial, {} CPUs)",
+        model, variant, config.promptTokens, config.generateTokens, cores);
+
+    ErrorCode aborted=ErrorCode::Success;
+    result=Autotuner::sweep(cores, config, [&](const RuntimeOptions &options, BenchmarkResult &benchmark)
+    {
+        if(aborted!=ErrorCode::Success)
+        {
+            return false;
+        }
+
+        ErrorCode status=runBenchmark(model, options, config.promptTokens, config.generateTokens, benchmark);
+        if(status==ErrorCode::ModelNotLoaded||status==ErrorCode::InvalidRequest)
+        {
+            // Unloaded or picked up a request mid-sweep; the numbers would be meaningless
+            aborted=status;
+        }
+        return status==ErrorCode::Success;
+    });
+
+    if(aborted!=ErrorCode::Success)
+    {
+        spdlog::warn("Autotune of '{}' aborted: model unloaded or busy", model);
+        return aborted;
+    }
+    if(result.bestScore<=0.0)
+    {
+        spdlog::error("Autotune of '{}' failed: no configuration ran", model);
+        return ErrorCode::ModelLoadError;
+    }
+
+    result.model=model;
+    result.variant=variant;
+    result.hardwareFingerprint=Autotuner::hardwareFingerprint(HardwareDetector::instance().getSystemInfo());
+    AutotuneStore::instance().record(result);
+    return ErrorCode::Success;
+}
+
+int ModelRuntime::shrinkDynamicContexts(int gpuIndex, int needMb, const std::string &keepModel)
+{
+    std::vector<LoadedModel *> candidates;
+    for(auto &pair:m_models)
+    {
+        LoadedModel &entry=pair.second;
+
+        if(entry.state!=ModelState::Loaded||entry.contextLimit<=0||!entry.llamaCtx||
+            pair.first==keepModel||m_activeInference.count(pair.first)||
+            entry.contextSize<=entry.loadedContextSize||!entry.perGpuVramMb.count(gpuIndex))
+        {
+            continue;
+        }
+        candidates.push_back(&entry);
+    }
+
+    std::sort(candidates.begin(), candidates.end(),
+        [](const LoadedModel *a, const LoadedModel *b)
+        {
+            return a->lastUsed<b->lastUsed;
+        });
+
+    int released=0;
+    for(LoadedModel *entry:candidates)
+    {
+        if(released>=needMb)
+        {
+            break;
+        }
+
+        int before=entry->perGpuVramMb[gpuIndex];
+        if(resizeContext(*entry, entry->loadedContextSize, "shrink")==ErrorCode::Success)
+        {
+            released+=std::max(0, before-entry->perGpuVramMb[gpuIndex]);
+        }
+    }
+    return released;
+}
+
+int ModelRuntime::reclaimedContextSize(const LoadedModel &entry) const
+{
+    int fullSize=entry.loadedContextSize>0?entry.loadedContextSize:entry.contextSize;
+
+    if(!entry.activeOptions.idleShrinkContext.value_or(false)||entry.recentContextTokens.empty())
+    {
+        return fullSize;
+    }
+
+    // Largest recent request plus 25% headroom, rounded up to a 1k boundary
+    int largest=*std::max_element(entry.recentContextTokens.begin(), entry.recentContextTokens.end());
+    int target=(largest+largest/4+1023)/1024*1024;
+    target=std::max(target, MIN_SHRUNK_CONTEXT);
+
+    return std::min(target, fullSize);
+}
+
+void ModelRuntime::updateContextVram(LoadedModel &entry)
+{
+    entry.perGpuContextVramMb.clear();
+
+    if(entry.gpuIndices.empty())
+    {
+        return;
+    }
+
+    int contextMb=0;
+    for(const auto &pair:entry.deviceAllocations)
+    {
+        if(pair.first.rfind("CPU", 0)==0)
+        {
+            continue;
+        }
+        contextMb+=pair.second.kvCacheBufferMb+pair.second.computeBufferMb;
+    }
+
+    int gpuCount=static_cast<int>(entry.gpuIndices.size());
+    for(int i=0; i<gpuCount; ++i)
+    {
+        int gpuIdx=entry.gpuIndices[i];
+        int share=contextMb/gpuCount+(i<contextMb%gpuCount?1:0);
+
+        // Never release more than the model is charged for on that GPU
+        auto chargedIt=entry.perGpuVramMb.find(gpuIdx);
+        int charged=chargedIt!=entry.perGpuVramMb.end()?chargedIt->second:0;
+        entry.perGpuContextVramMb[gpuIdx]=std::min(share, charged);
+    }
+}
+
+void ModelRuntime::chargeContextVram(LoadedModel &entry, int deltaMb)
+{
+    if(deltaMb==0||entry.gpuIndices.empty())
+    {
+        return;
+    }
+
+    int gpuCount=static_cast<int>(entry.gpuIndices.size());
+    for(int i=0; i<gpuCount; ++i)
+    {
+        int gpuIdx=entry.gpuIndices[i];
+        int share=deltaMb/gpuCount+(i==0?deltaMb%gpuCount:0);
+
+        entry.perGpuVramMb[gpuIdx]=std::max(0, entry.perGpuVramMb[gpuIdx]+share);
+        entry.perGpuContextVramMb[gpuIdx]=std::max(0, entry.perGpuContextVramMb[gpuIdx]+share);
+    }
+    entry.estimatedVramUsageMb=std::max(0, entry.estimatedVramUsageMb+deltaMb);
+}
+
+void ModelRuntime::setDefaultIdleContextTimeout(int seconds)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_defaultIdleContextTimeoutSec=std::max(0, seconds);
+}
+
+int ModelRuntime::getDefaultIdleContextTimeout() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_defaultIdleContextTimeoutSec;
+}
+
+void ModelRuntime::recordContextUsage(const std::string &model, int tokens)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it=m_models.find(model);
+    if(it==m_models.end()||tokens<=0)
+    {
+        return;
+    }
+
+    std::deque<int> &recent=it->second.recentContextTokens;
+    recent.push_back(tokens);
+    while(recent.size()>MAX_RECENT_CONTEXT_SAMPLES)
+    {
+        recent.pop_front();
+    }
+}
+
+int ModelRuntime::reclaimIdleContexts()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::chrono::steady_clock::time_point now=std::chrono::steady_clock::now();
+    int reclaimed=0;
+
+    for(auto &pair:m_models)
+    {
+        LoadedModel &entry=pair.second;
+
+        if(entry.state!=ModelState::Loaded||!entry.llamaModel||!entry.llamaCtx)
+        {
+            continue;
+        }
+        if(m_activeInference.count(pair.first))
+        {
+            continue;
+        }
+
+        int timeout=entry.activeOptions.idleContextTimeoutSeconds.value_or(m_defaultIdleContextTimeoutSec);
+
+        // Under memory pressure idle contexts go sooner, even without a timeout
+        int pressureTimeout=0;
+        if(m_pressure.level==MemoryPressureLevel::Critical)
+        {
+            pressureTimeout=CRITICAL_IDLE_CONTEXT_SECONDS;
+        }
+        else if(m_pressure.level==MemoryPressureLevel::Moderate)
+        {
+            pressureTimeout=PRESSURE_IDLE_CONTEXT_SECONDS;
+        }
+
+        bool pressured=false;
+        if(pressureTimeout>0&&(timeout<=0||pressureTimeout<timeout))
+        {
+            timeout=pressureTimeout;
+            pressured=true;
+        }
+        if(timeout<=0)
+        {
+            continue;
+        }
+
+        double idleSeconds=std::chrono::duration<double>(now-entry.lastUsed).count();
+        if(idleSeconds<timeout)
+        {
+            continue;
+        }
+
+        llama_free(entry.llamaCtx);
+        entry.llamaCtx=nullptr;
+
+        detachCpuThreads(entry);
+        entry.contextReclaimed=true;
+        ++reclaimed;
+
+        int freedMb=0;
+        for(const auto &ctxPair:entry.perGpuContextVramMb)
+        {
+            freedMb+=ctxPair.second;
+        }
+        spdlog::info("Reclaimed idle context for '{}' after {:.0f}s (context={}, ~{}MB VRAM released)",
+            pair.first, idleSeconds, entry.contextSize, freedMb);
+
+        if(pressured)
+        {
+            recordPressureEvent("reclaim_context", pair.first, freedMb);
+        }
+    }
+
+    return reclaimed;
+}
+
+void ModelRuntime::applyMemoryPressure(const MemoryPressureSample &sample)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    MemoryPressureLevel previous=m_pressure.level;
+    m_pressure=sample;
+    m_pressureLevel=sample.level;
+
+    if(sample.level!=previous)
+    {
+        spdlog::log(sample.level==MemoryPressureLevel::None?spdlog::level::info:spdlog::level::warn,
+            "Memory pressure {} -> {} (PSI some={:.1f}% full={:.1f}%, cgroup {:.1f}%)",
+            MemoryPressureMonitor::levelToString(previous), MemoryPressureMonitor::levelToString(sample.level),
+            sample.someAvg10, sample.fullAvg10, sample.cgroupUsagePercent());
+        recordPressureEvent("level", "", 0);
+    }
+
+    // Give Ready-tier RAM back before the kernel starts reclaiming it for us
+    if(sample.level!=MemoryPressureLevel::None)
+    {
+        evictReadyModels();
+    }
+}
+
+MemoryPressureSample ModelRuntime::getMemoryPressure() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_pressure;
+}
+
+MemoryPressureLevel ModelRuntime::getMemoryPressureLevel() const
+{
+    return m_pressureLevel;
+}
+
+void ModelRuntime::setMemoryPressureThresholds(const MemoryPressureThresholds &thresholds)
+{
+    m_pressureMonitor.setThresholds(thresholds);
+}
+
+void ModelRuntime::setMemoryPressureMonitorEnabled(bool enabled)
+{
+    m_pressureMonitorEnabled=enabled;
+}
+
+int ModelRuntime::effectiveReadyRamBudgetMb() const
+{
+    // NOTE: caller must hold m_mutex
+
+    switch(m_pressure.level)
+    {
+        case MemoryPressureLevel::Moderate: return m_readyRamBudgetMb/2;
+        case MemoryPressureLevel::Critical: return 0;
+        default:                            return m_readyRamBudgetMb;
+    }
+}
+
+void ModelRuntime::recordPressureEvent(const std::string &action, const std::string &model, int freedMb)
+{
+    // NOTE: caller must hold m_mutex
+
+    MemoryPressureEvent event;
+    event.action=action;
+    event.level=MemoryPressureMonitor::levelToString(m_pressure.level);
+    event.model=model;
+    event.freedMb=freedMb;
+    event.someAvg10=m_pressure.someAvg10;
+    event.fullAvg10=m_pressure.fullAvg10;
+    event.cgroupUsagePercent=m_pressure.cgroupUsagePercent();
+    event.when=std::chrono::system_clock::now();
+    TelemetryCollector::instance().recordMemoryPressure(event);
+}
+
+void ModelRuntime::startMaintenanceThread()
+{
+    if(m_maintenanceRunning)
+    {
+        return;
+    }
+
+    m_maintenanceRunning=true;
+    m_maintenanceThread=std::thread([this]()
+    {
+        while(m_maintenanceRunning)
+        {
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+
+            if(!m_maintenanceRunning)
+            {
+                break;
+            }
+
+            if(m_pressureMonitorEnabled)
+            {
+                applyMemoryPressure(m_pressureMonitor.sample());
+            }
+            reclaimIdleContexts();
+            scaleReplicas();
+        }
+    });
+}
+
+void ModelRuntime::stopMaintenanceThread()
+{
+    m_maintenanceRunning=false;
+    if(m_maintenanceThread.joinable())
+    {
+        m_maintenanceThread.join();
+    }
 }
 
 void ModelRuntime::initLlamaBackend()
@@ -1599,6 +3541,18 @@ ErrorCode ModelRuntime::loadLlamaModel(
     }
 
     initLlamaBackend();
+    startMaintenanceThread();
+
+    // Weights llama.cpp reads or prefetches land on the model's NUMA node(s)
+    std::vector<int> memoryNodes;
+    std::string memoryPolicyName;
+    auto modelIt=m_models.find(model);
+    if(modelIt!=m_models.end())
+    {
+        memoryNodes=numaMemoryNodes(modelIt->second);
+        memoryPolicyName=modelIt->second.numaPolicy;
+    }
+    ScopedMemoryPolicy memoryPolicy(memoryNodes, memoryPolicyName);
 
     // Log available backend devices matching backendPriority for diagnostics.
     // NOTE: We intentionally do NOT set mparams.devices — llama.cpp's default
@@ -1702,11 +3656,49 @@ ErrorCode ModelRuntime::loadLlamaModel(
         llama_model_params mparams=llama_model_default_params();
         mparams.n_gpu_layers=options.nGpuLayers.value_or(99);
 
+        // -ot: route tensors matching each pattern to a named buffer type.
+        // The pattern strings must outlive the load call.
+        std::vector<std::string> overridePatterns;
+        std::vector<llama_model_tensor_buft_override> tensorOverrides;
+        if(options.overrideTensor.has_value())
+        {
+            std::vector<ggml_backend_buffer_type_t> overrideBufts;
+            for(const std::string &spec:splitOverrideTensor(options.overrideTensor.value()))
+            {
+                size_t eq=spec.rfind('=');
+                ggml_backend_buffer_type_t buft=eq!=std::string::npos
+                    ?findBufferType(spec.substr(eq+1))
+                    :nullptr;
+                if(!buft)
+                {
+                    spdlog::warn("Ignoring tensor override '{}' for model '{}': unknown buffer type", spec, model);
+                    continue;
+                }
+                overridePatterns.push_back(spec.substr(0, eq));
+                overrideBufts.push_back(buft);
+            }
+
+            for(size_t i=0; i<overridePatterns.size(); ++i)
+            {
+                tensorOverrides.push_back({overridePatterns[i].c_str(), overrideBufts[i]});
+            }
+            if(!tensorOverrides.empty())
+            {
+                tensorOverrides.push_back({nullptr, nullptr}); // NULL terminator
+                mparams.tensor_buft_overrides=tensorOverrides.data();
+            }
+        }
+
         if(options.noMmap.has_value()&&options.noMmap.value())
         {
             mparams.use_mmap=false;
         }
 
+        if(options.mlock.has_value())
+        {
+            mparams.use_mlock=options.mlock.value();
+        }
+
         // On UMA/iGPU systems (e.g. AMD APUs), mmap causes model tensors to be
         // imported as host-visible "CPU_Mapped" buffers via VK_EXT_external_memory_host
         // instead of being allocated as device-local memory. This bypasses the Vulkan
@@ -1918,6 +3910,18 @@ ErrorCode ModelRuntime::loadLlamaModel(
             }
         }
 
+        // Start reading the weights into the page cache while llama.cpp
+        // parses the file, so mmap faults during load and warm-up hit RAM
+        if(options.warmup.value_or(true))
+        {
+            auto modelIt=m_models.find(model);
+            adviseWillNeed(modelIt!=m_models.end()&&!modelIt->second.filePaths.empty()
+                ?modelIt->second.filePaths
+                :std::vector<std::string>{filePath});
+        }
+
+        int rssBeforeMb=readProcessRssMb();
+
         llama_model *llamaModel=llama_model_load_from_file(filePath.c_str(), mparams);
         if(!llamaModel)
         {
@@ -1960,135 +3964,742 @@ ErrorCode ModelRuntime::loadLlamaModel(
             }
             else
             {
-                actualContext=nativeContext;
+                actualContext=nativeContext;
+            }
+        }
+        if(maxHardwareContext>0&&actualContext>maxHardwareContext)
+        {
+            spdlog::info("Capping context from {} to {} (hardware limit) for model '{}'",
+                actualContext, maxHardwareContext, model);
+            actualContext=maxHardwareContext;
+        }
+
+        // dynamic_context: allocate a small context now and grow it on demand,
+        // never past the size resolved above
+        int contextLimit=0;
+        if(options.dynamicContext.value_or(false))
+        {
+            contextLimit=actualContext;
+            actualContext=std::min(actualContext,
+                std::max(256, options.initialContextSize.value_or(DEFAULT_INITIAL_CONTEXT)));
+        }
+
+        RuntimeOptions contextOptions=options;
+        llama_context *llamaCtx=initContext(llamaModel, contextOptions, actualContext, model);
+        if(!llamaCtx)
+        {
+            std::string captured=m_llamaLogCapture.str();
+            endLlamaLogCapture();
+
+            m_lastLoadError=classifyLoadFailure(captured, model, filePath, actualContext);
+
+            // If Vulkan device lost and we haven't retried yet, reinit and try again
+            if(m_lastLoadError.reason==LoadFailureReason::VulkanDeviceLost&&attempt+1<maxAttempts)
+            {
+                spdlog::warn("Vulkan device lost detected during context creation — "
+                    "reinitializing backend and retrying");
+                llama_model_free(llamaModel);
+                reinitLlamaBackend();
+                continue;
+            }
+
+            // If classification didn't catch a specific VRAM/context issue,
+            // context creation failure is almost always a memory issue
+            if(m_lastLoadError.reason==LoadFailureReason::Unknown||
+                m_lastLoadError.reason==LoadFailureReason::BackendError)
+            {
+                m_lastLoadError.reason=LoadFailureReason::InsufficientVram;
+                m_lastLoadError.summary="Failed to create context (size="+std::to_string(actualContext)+
+                    ") — likely insufficient GPU memory";
+                m_lastLoadError.suggestion="Try a smaller context size or use a smaller quantization variant. "
+                    "You can also unload other models to free VRAM.";
+                m_lastLoadError.action="reduce_context";
+                m_lastLoadError.recoverable=true;
+            }
+
+            spdlog::error("Failed to create llama context for model: {} — {}", model, m_lastLoadError.summary);
+            llama_model_free(llamaModel);
+            return ErrorCode::ModelLoadError;
+        }
+
+        std::string capturedLog=m_llamaLogCapture.str();
+        endLlamaLogCapture();
+
+        LoadedModel &entry=m_models[model];
+        entry.llamaModel=llamaModel;
+        entry.llamaCtx=llamaCtx;
+        entry.activeOptions.kvCacheTypeV=contextOptions.kvCacheTypeV;
+        entry.maxContextSize=nativeContext;
+        entry.contextSize=static_cast<int>(llama_n_ctx(llamaCtx));
+        entry.measuredRamMb=std::max(0, readProcessRssMb()-rssBeforeMb);
+
+        // Parse per-device buffer allocations from llama.cpp log output
+        parseDeviceAllocations(entry, capturedLog);
+        updateContextVram(entry);
+        calibrateMemoryEstimate(entry, filePath, options);
+        entry.loadedContextSize=entry.contextSize;
+        entry.contextReclaimed=false;
+        entry.contextLimit=contextLimit;
+
+        int gpuKvMb=0;
+        for(const auto &pair:entry.deviceAllocations)
+        {
+            if(pair.first.rfind("CPU", 0)!=0)
+            {
+                gpuKvMb+=pair.second.kvCacheBufferMb;
+            }
+        }
+        entry.kvMbPerToken=entry.contextSize>0?static_cast<double>(gpuKvMb)/entry.contextSize:0.0;
+
+        if(contextLimit>0)
+        {
+            spdlog::info("Dynamic context for '{}': starting at {} tokens, may grow to {} ({:.3f}MB KV per token)",
+                model, entry.contextSize, contextLimit, entry.kvMbPerToken);
+        }
+
+        spdlog::info("llama.cpp model loaded: {} (context={}, maxContext={}, ngl={}, flash_attn={}, mmap={}, mlock={}, host_ram={}MB, backend_filter={})",
+            model, entry.contextSize, entry.maxContextSize,
+            options.nGpuLayers.value_or(99),
+            options.flashAttn.has_value()?(options.flashAttn.value()?"enabled":"disabled"):"auto",
+            mparams.use_mmap?"on":"off",
+            mparams.use_mlock?"on":"off",
+            entry.measuredRamMb,
+            backendPriority.empty()?"all":[&]()
+            {
+                std::string s;
+                for(const std::string &p:backendPriority)
+                {
+                    if(!s.empty()) s+=",";
+                    s+=p;
+                }
+                return s;
+            }());
+
+        if(options.warmup.value_or(true))
+        {
+            warmupModel(entry);
+        }
+        return ErrorCode::Success;
+    }
+
+    // Should not reach here, but just in case
+    return ErrorCode::ModelLoadError;
+}
+
+void ModelRuntime::warmupModel(LoadedModel &entry)
+{
+    if(!entry.llamaModel||!entry.llamaCtx)
+    {
+        return;
+    }
+
+    std::chrono::steady_clock::time_point start=std::chrono::steady_clock::now();
+
+    // Same tokens llama.cpp's own warm-up uses; any valid ids will do
+    const llama_vocab *vocab=llama_model_get_vocab(entry.llamaModel);
+    std::vector<llama_token> tokens;
+    llama_token bos=llama_vocab_bos(vocab);
+    llama_token eos=llama_vocab_eos(vocab);
+    if(bos!=LLAMA_TOKEN_NULL)
+    {
+        tokens.push_back(bos);
+    }
+    if(eos!=LLAMA_TOKEN_NULL)
+    {
+        tokens.push_back(eos);
+    }
+    if(tokens.empty())
+    {
+        tokens.push_back(0);
+    }
+    llama_token next=tokens.back();
+
+    // A short prefill builds the batch graph and touches every weight; one
+    // more token builds the single-token decode graph
+    bool ok=llama_decode(entry.llamaCtx, llama_batch_get_one(tokens.data(), static_cast<int32_t>(tokens.size())))==0&&
+        llama_decode(entry.llamaCtx, llama_batch_get_one(&next, 1))==0;
+    llama_synchronize(entry.llamaCtx);
+
+    llama_memory_clear(llama_get_memory(entry.llamaCtx), true);
+    llama_perf_context_reset(entry.llamaCtx);
+
+    entry.warmupTimeMs=std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now()-start).count();
+    if(ok)
+    {
+        spdlog::info("Warmed up model '{}' in {:.1f}ms", entry.modelName, entry.warmupTimeMs);
+    }
+    else
+    {
+        spdlog::warn("Warm-up decode failed for model '{}' after {:.1f}ms", entry.modelName, entry.warmupTimeMs);
+    }
+}
+
+void ModelRuntime::freeLlamaModel(LoadedModel &entry)
+{
+    if(entry.llamaCtx)
+    {
+        llama_free(entry.llamaCtx);
+        entry.llamaCtx=nullptr;
+        detachCpuThreads(entry);
+    }
+    freeCpuThreadpool(entry);
+    m_threadArbiter.remove(entry.modelName);
+    forgetLoraAdapters(entry);
+    if(entry.llamaModel)
+    {
+        llama_model_free(entry.llamaModel);
+        entry.llamaModel=nullptr;
+    }
+    entry.residentWeights.clear();
+}
+
+void ModelRuntime::freeCpuThreadpool(LoadedModel &entry)
+{
+    if(entry.cpuThreads&&entry.cpuThreads->threadpool)
+    {
+        ggml_threadpool_free(entry.cpuThreads->threadpool);
+        entry.cpuThreads->threadpool=nullptr;
+    }
+    entry.cpuThreads.reset();
+}
+
+void ModelRuntime::setCpuThreads(int threads)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_cpuThreads=std::max(0, threads);
+    m_threadArbiter.setMaxThreads(m_cpuThreads);
+}
+
+int ModelRuntime::getCpuThreads() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_cpuThreads;
+}
+
+ErrorCode ModelRuntime::resolveLoraAdapters(const std::string &model, const std::map<std::string, double> &scales,
+    std::string &baseModel, std::vector<LoraSelection> &adapters) const
+{
+    baseModel=model;
+    adapters.clear();
+
+    std::optional<ModelInfo> info=ModelManager::instance().getModelInfo(model);
+    if(!info.has_value()||!info->lora.has_value())
+    {
+        if(!scales.empty())
+        {
+            spdlog::warn("Model '{}' has no LoRA adapters to scale", model);
+            return ErrorCode::InvalidRequest;
+        }
+        return ErrorCode::Success;
+    }
+
+    const LoraConfig &lora=info->lora.value();
+    for(const auto &pair:scales)
+    {
+        bool known=std::any_of(lora.adapters.begin(), lora.adapters.end(),
+            [&pair](const LoraAdapter &adapter)
+            {
+                return adapter.name==pair.first;
+            });
+        if(!known)
+        {
+            spdlog::warn("Model '{}' has no LoRA adapter named '{}'", model, pair.first);
+            return ErrorCode::InvalidRequest;
+        }
+    }
+
+    std::string modelsDir=getModelsDir();
+    baseModel=lora.baseModel;
+    for(const LoraAdapter &adapter:lora.adapters)
+    {
+        auto scale=scales.find(adapter.name);
+        LoraSelection selection;
+        selection.path=std::filesystem::path(adapter.file).is_absolute()?adapter.file:modelsDir+adapter.file;
+        selection.scale=scale!=scales.end()?static_cast<float>(scale->second):adapter.scale;
+        if(selection.scale!=0.0f)
+        {
+            adapters.push_back(selection);
+        }
+    }
+    return ErrorCode::Success;
+}
+
+ErrorCode ModelRuntime::applyLoraAdapters(const std::string &instance, const std::vector<LoraSelection> &adapters)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it=m_models.find(instance);
+    if(it==m_models.end()||!it->second.llamaModel||!it->second.llamaCtx)
+    {
+        return adapters.empty()?ErrorCode::Success:ErrorCode::ModelNotLoaded;
+    }
+
+    LoadedModel &entry=it->second;
+    std::chrono::steady_clock::time_point now=std::chrono::steady_clock::now();
+    for(const LoraSelection &selection:adapters)
+    {
+        auto cached=entry.loraAdapters.find(selection.path);
+        if(cached!=entry.loraAdapters.end())
+        {
+            cached->second.lastUsed=now;
+            continue;
+        }
+
+        std::error_code ec;
+        uintmax_t size=std::filesystem::file_size(selection.path, ec);
+        if(ec)
+        {
+            spdlog::error("LoRA adapter not found: {}", selection.path);
+            return ErrorCode::ModelNotFound;
+        }
+
+        int sizeMb=std::max(1, static_cast<int>(size/(1024*1024)));
+        evictLoraAdapters(sizeMb, entry, adapters);
+
+        llama_adapter_lora *adapter=llama_adapter_lora_init(entry.llamaModel, selection.path.c_str());
+        if(!adapter)
+        {
+            spdlog::error("Failed to load LoRA adapter {} for '{}'", selection.path, instance);
+            return ErrorCode::ModelLoadError;
+        }
+
+        LoadedLora loaded;
+        loaded.adapter=adapter;
+        loaded.sizeMb=sizeMb;
+        loaded.lastUsed=now;
+        entry.loraAdapters[selection.path]=loaded;
+        spdlog::info("Loaded LoRA adapter {} on '{}' ({}MB)", selection.path, instance, sizeMb);
+    }
+
+    if(entry.appliedLoras==adapters)
+    {
+        return ErrorCode::Success;
+    }
+
+    llama_clear_adapter_lora(entry.llamaCtx);
+    entry.appliedLoras.clear();
+    for(const LoraSelection &selection:adapters)
+    {
+        if(llama_set_adapter_lora(entry.llamaCtx, entry.loraAdapters[selection.path].adapter, selection.scale)!=0)
+        {
+            spdlog::error("Failed to apply LoRA adapter {} to '{}'", selection.path, instance);
+            llama_clear_adapter_lora(entry.llamaCtx);
+            entry.appliedLoras.clear();
+            return ErrorCode::ModelLoadError;
+        }
+        entry.appliedLoras.push_back(selection);
+    }
+    return ErrorCode::Success;
+}
+
+void ModelRuntime::setLoraCacheBudget(int mb)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_loraCacheBudgetMb=std::max(0, mb);
+}
+
+int ModelRuntime::getLoraCacheBudget() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_loraCacheBudgetMb;
+}
+
+int ModelRuntime::getLoraCacheUsage() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    int usedMb=0;
+    for(const auto &pair:m_models)
+    {
+        for(const auto &adapter:pair.second.loraAdapters)
+        {
+            usedMb+=adapter.second.sizeMb;
+        }
+    }
+    return usedMb;
+}
+
+void ModelRuntime::evictLoraAdapters(int requiredMb, const LoadedModel &target, const std::vector<LoraSelection> &keep)
+{
+    // NOTE: caller must hold m_mutex
+
+    if(m_loraCacheBudgetMb<=0)
+    {
+        return;
+    }
+
+    int usedMb=0;
+    for(const auto &pair:m_models)
+    {
+        for(const auto &adapter:pair.second.loraAdapters)
+        {
+            usedMb+=adapter.second.sizeMb;
+        }
+    }
+
+    auto contains=[](const std::vector<LoraSelection> &list, const std::string &path)
+    {
+        return std::any_of(list.begin(), list.end(),
+            [&path](const LoraSelection &selection)
+            {
+                return selection.path==path;
+            });
+    };
+
+    while(usedMb+requiredMb>m_loraCacheBudgetMb)
+    {
+        LoadedModel *owner=nullptr;
+        std::string victim;
+        std::chrono::steady_clock::time_point oldest=std::chrono::steady_clock::time_point::max();
+        for(auto &pair:m_models)
+        {
+            bool busy=m_threadArbiter.queueDepth(pair.first)>0;
+            for(const auto &adapter:pair.second.loraAdapters)
+            {
+                if(&pair.second==&target&&contains(keep, adapter.first))
+                {
+                    continue;
+                }
+                if(busy&&contains(pair.second.appliedLoras, adapter.first))
+                {
+                    continue;
+                }
+                if(adapter.second.lastUsed<oldest)
+                {
+                    owner=&pair.second;
+                    victim=adapter.first;
+                    oldest=adapter.second.lastUsed;
+                }
             }
         }
-        if(maxHardwareContext>0&&actualContext>maxHardwareContext)
-        {
-            spdlog::info("Capping context from {} to {} (hardware limit) for model '{}'",
-                actualContext, maxHardwareContext, model);
-            actualContext=maxHardwareContext;
-        }
 
-        llama_context_params cparams=llama_context_default_params();
-        cparams.n_ctx=static_cast<uint32_t>(actualContext);
-        cparams.n_threads=std::thread::hardware_concurrency();
-        cparams.n_threads_batch=std::thread::hardware_concurrency();
-
-        // Apply runtime options to context params
-        if(options.flashAttn.has_value())
+        if(!owner)
         {
-            cparams.flash_attn_type=options.flashAttn.value()
-                ?LLAMA_FLASH_ATTN_TYPE_ENABLED
-                :LLAMA_FLASH_ATTN_TYPE_DISABLED;
+            spdlog::debug("LoRA adapter cache over budget ({}MB + {}MB > {}MB), all adapters in use",
+                usedMb, requiredMb, m_loraCacheBudgetMb);
+            return;
         }
 
-        if(options.kvCacheTypeK.has_value())
+        LoadedLora &loaded=owner->loraAdapters[victim];
+        if(contains(owner->appliedLoras, victim))
         {
-            ggml_type kType=parseGgmlType(options.kvCacheTypeK.value());
-            if(kType!=GGML_TYPE_COUNT)
+            if(owner->llamaCtx)
             {
-                cparams.type_k=kType;
+                llama_rm_adapter_lora(owner->llamaCtx, loaded.adapter);
             }
+            owner->appliedLoras.erase(std::remove_if(owner->appliedLoras.begin(), owner->appliedLoras.end(),
+                [&victim](const LoraSelection &selection)
+                {
+                    return selection.path==victim;
+                }), owner->appliedLoras.end());
         }
 
-        if(options.kvCacheTypeV.has_value())
+        spdlog::info("Evicting LoRA adapter {} from '{}' ({}MB)", victim, owner->modelName, loaded.sizeMb);
+        usedMb-=loaded.sizeMb;
+        llama_adapter_lora_free(loaded.adapter);
+        owner->loraAdapters.erase(victim);
+    }
+}
+
+void ModelRuntime::forgetLoraAdapters(LoadedModel &entry)
+{
+    if(entry.llamaCtx&&!entry.appliedLoras.empty())
+    {
+        llama_clear_adapter_lora(entry.llamaCtx);
+    }
+    entry.loraAdapters.clear();
+    entry.appliedLoras.clear();
+}
+
+std::shared_ptr<CpuThreadBinding> ModelRuntime::getCpuThreads(const std::string &instance) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it=m_models.find(instance);
+    if(it==m_models.end()||!it->second.llamaCtx)
+    {
+        return nullptr;
+    }
+    return it->second.cpuThreads;
+}
+
+void ModelRuntime::bindCpuThreads(LoadedModel &entry)
+{
+    // NOTE: caller must hold m_mutex
+
+    if(!entry.llamaCtx)
+    {
+        return;
+    }
+
+    if(!entry.cpuThreads)
+    {
+        entry.cpuThreads=std::make_shared<CpuThreadBinding>();
+        entry.cpuThreads->model=entry.modelName;
+    }
+    CpuThreadBinding &threads=*entry.cpuThreads;
+    threads.maxThreads=entry.activeOptions.nThreads.value_or(0);
+    threads.maxBatchThreads=entry.activeOptions.nThreadsBatch.value_or(0);
+
+    if(!threads.threadpool)
+    {
+        // Sized to the whole node; the share limits how many threads run
+        CpuThreadShare share=m_threadArbiter.share(entry.modelName, threads.maxThreads, threads.maxBatchThreads);
+        std::vector<int> cpus=m_threadArbiter.nodeCpus(share.node);
+        ggml_threadpool_params params=ggml_threadpool_params_default(static_cast<int>(cpus.size()));
+        if(m_threadArbiter.nodeCount()>1)
         {
-            ggml_type vType=parseGgmlType(options.kvCacheTypeV.value());
-            if(vType!=GGML_TYPE_COUNT)
+            for(int cpu:cpus)
             {
-                cparams.type_v=vType;
+                if(cpu>=0&&cpu<GGML_MAX_N_THREADS)
+                {
+                    params.cpumask[cpu]=true;
+                }
             }
         }
 
-        if(options.swaFull.has_value())
+        threads.threadpool=ggml_threadpool_new(&params);
+        if(!threads.threadpool)
         {
-            cparams.swa_full=options.swaFull.value();
+            spdlog::warn("Failed to create CPU threadpool for model '{}'", entry.modelName);
+            return;
         }
+        spdlog::info("Created CPU threadpool for model '{}' ({} threads, node {})",
+            entry.modelName, cpus.size(), share.node);
+    }
+    else
+    {
+        ggml_threadpool_resume(threads.threadpool);
+    }
 
-        llama_context *llamaCtx=llama_init_from_model(llamaModel, cparams);
-        if(!llamaCtx)
+    // Options may have changed since the last request
+    threads.appliedGeneration=0;
+    applyCpuThreads(threads, entry.llamaCtx);
+}
+
+void ModelRuntime::detachCpuThreads(LoadedModel &entry)
+{
+    if(entry.cpuThreads)
+    {
+        entry.cpuThreads->attachedCtx=nullptr;
+    }
+}
+
+void ModelRuntime::applyCpuThreads(CpuThreadBinding &threads, llama_context *ctx)
+{
+    if(!ctx||!threads.threadpool)
+    {
+        return;
+    }
+
+    uint64_t generation=m_threadArbiter.generation();
+    bool attached=threads.attachedCtx.load()!=ctx;
+    if(!attached&&generation==threads.appliedGeneration)
+    {
+        return;
+    }
+
+    if(attached)
+    {
+        llama_attach_threadpool(ctx, threads.threadpool, threads.threadpool);
+        threads.attachedCtx=ctx;
+    }
+
+    CpuThreadShare share=m_threadArbiter.share(threads.model, threads.maxThreads, threads.maxBatchThreads);
+    if(attached||share!=threads.applied)
+    {
+        llama_set_n_threads(ctx, share.nThreads, share.nThreadsBatch);
+        spdlog::debug("CPU threads for '{}': decode={}, prefill={}, node={}",
+            threads.model, share.nThreads, share.nThreadsBatch, share.node);
+
+        std::lock_guard<std::mutex> lock(threads.mutex);
+        threads.applied=share;
+    }
+    threads.appliedGeneration=generation;
+}
+
+void ModelRuntime::calibrateMemoryEstimate(const LoadedModel &entry, const std::string &filePath,
+    const RuntimeOptions &options)
+{
+    std::optional<GgufModelInfo> gguf=GgufMetadataCache::instance().get(
+        entry.filePaths.empty()?std::vector<std::string>{filePath}:entry.filePaths);
+    if(!gguf.has_value()||gguf->nLayer<=0||entry.deviceAllocations.empty())
+    {
+        return;
+    }
+
+    int weightMb=entry.cpuMappedBufferMb;
+    int kvMb=0;
+    int computeMb=0;
+    for(const auto &pair:entry.deviceAllocations)
+    {
+        weightMb+=pair.second.modelBufferMb;
+        kvMb+=pair.second.kvCacheBufferMb;
+        if(pair.first.rfind("CPU", 0)!=0)
         {
-            std::string captured=m_llamaLogCapture.str();
-            endLlamaLogCapture();
+            computeMb+=pair.second.computeBufferMb;
+        }
+    }
 
-            m_lastLoadError=classifyLoadFailure(captured, model, filePath, actualContext);
+    double bytesK=ModelFitCalculator::kvBytesPerElement(options.kvCacheTypeK.value_or("f16"));
+    double bytesV=ModelFitCalculator::kvBytesPerElement(options.kvCacheTypeV.value_or("f16"));
+    double bytesPerElement=(bytesK>0.0&&bytesV>0.0)?(bytesK+bytesV)/2.0:2.0;
+    int64_t kvBytes=gguf->kvCacheBytes(entry.contextSize, bytesPerElement, options.swaFull.value_or(false));
 
-            // If Vulkan device lost and we haven't retried yet, reinit and try again
-            if(m_lastLoadError.reason==LoadFailureReason::VulkanDeviceLost&&attempt+1<maxAttempts)
-            {
-                spdlog::warn("Vulkan device lost detected during context creation — "
-                    "reinitializing backend and retrying");
-                llama_model_free(llamaModel);
-                reinitLlamaBackend();
-                continue;
-            }
+    MemoryCalibration::instance().record(entry.replicaOf.empty()?entry.modelName:entry.replicaOf, entry.variant,
+        gguf->weightBytes, weightMb, kvBytes, kvMb, computeMb);
+}
 
-            // If classification didn't catch a specific VRAM/context issue,
-            // context creation failure is almost always a memory issue
-            if(m_lastLoadError.reason==LoadFailureReason::Unknown||
-                m_lastLoadError.reason==LoadFailureReason::BackendError)
-            {
-                m_lastLoadError.reason=LoadFailureReason::InsufficientVram;
-                m_lastLoadError.summary="Failed to create context (size="+std::to_string(actualContext)+
-                    ") — likely insufficient GPU memory";
-                m_lastLoadError.suggestion="Try a smaller context size or use a smaller quantization variant. "
-                    "You can also unload other models to free VRAM.";
-                m_lastLoadError.action="reduce_context";
-                m_lastLoadError.recoverable=true;
-            }
+std::optional<PlacementPlan> ModelRuntime::planPlacement(const ModelInfo &model, const ModelVariant &variant,
+    const ModelFit &fit, const RuntimeOptions &options, int requestedContext,
+    const SystemInfo &hw, const std::vector<int> &gpuIndices) const
+{
+    if(!options.autoPlacement.value_or(true)||
+        options.nGpuLayers.has_value()||
+        options.overrideTensor.has_value())
+    {
+        return std::nullopt;
+    }
 
-            spdlog::error("Failed to create llama context for model: {} — {}", model, m_lastLoadError.summary);
-            llama_model_free(llamaModel);
-            return ErrorCode::ModelLoadError;
+    std::optional<GgufModelInfo> gguf=GgufMetadataCache::instance().get(variant);
+    if(!gguf.has_value()||gguf->nLayer<=0)
+    {
+        return std::nullopt;
+    }
+
+    // Size for the context the fit settled on; when nothing fit in VRAM,
+    // fall back to the model's base context
+    int contextSize=fit.canRun?fit.maxContextSize:0;
+    if(requestedContext>0)
+    {
+        contextSize=contextSize>0?std::min(requestedContext, contextSize):requestedContext;
+    }
+    if(contextSize<=0)
+    {
+        contextSize=model.contextScaling.has_value()?model.contextScaling->baseContext:DEFAULT_INITIAL_CONTEXT;
+    }
+    if(gguf->contextLength>0)
+    {
+        contextSize=std::min(contextSize, gguf->contextLength);
+    }
+
+    PlacementBudget budget;
+    budget.gpuVramMb=ModelFitCalculator::sumFreeVram(hw, gpuIndices);
+    budget.ramMb=hw.freeRamMb;
+    budget.kvOffload=options.kvOffload;
+
+    std::optional<MemoryCalibrationEntry> cal=MemoryCalibration::instance().get(model.model, variant.quantization);
+    if(cal.has_value())
+    {
+        budget.weightFactor=cal->weightFactor;
+        if(cal->computeBufferMb>0)
+        {
+            budget.computeBufferMb=cal->computeBufferMb;
         }
+    }
 
-        std::string capturedLog=m_llamaLogCapture.str();
-        endLlamaLogCapture();
+    // Unified-memory GPUs read weights at host RAM speed
+    bool allUnified=!gpuIndices.empty();
+    for(int idx:gpuIndices)
+    {
+        if(idx<0||idx>=static_cast<int>(hw.gpus.size())||!hw.gpus[idx].unifiedMemory)
+        {
+            allUnified=false;
+        }
+    }
+    if(allUnified)
+    {
+        budget.gpuBandwidthGbps=PlacementPlanner::DEFAULT_CPU_BANDWIDTH_GBPS;
+    }
 
-        LoadedModel &entry=m_models[model];
-        entry.llamaModel=llamaModel;
-        entry.llamaCtx=llamaCtx;
-        entry.maxContextSize=nativeContext;
-        entry.contextSize=static_cast<int>(llama_n_ctx(llamaCtx));
+    std::string kvType=options.kvCacheTypeK.value_or(fit.kvCacheType.empty()?"f16":fit.kvCacheType);
+    double bytesPerElement=ModelFitCalculator::kvBytesPerElement(kvType);
 
-        // Parse per-device buffer allocations from llama.cpp log output
-        parseDeviceAllocations(entry, capturedLog);
+    PlacementPlan plan=PlacementPlanner::plan(gguf.value(), contextSize,
+        bytesPerElement>0.0?bytesPerElement:2.0, budget);
+    spdlog::info("Placement plan for '{}' variant '{}': {} — {} (ngl={}, gpu={}MB, cpu={}MB, ~{:.1f} tok/s)",
+        model.model, variant.quantization, plan.strategy, plan.reason, plan.nGpuLayers,
+        plan.gpuMb, plan.cpuMb, plan.estimatedTokensPerSec);
+    return plan;
+}
 
-        spdlog::info("llama.cpp model loaded: {} (context={}, maxContext={}, ngl={}, flash_attn={}, mmap={}, backend_filter={})",
-            model, entry.contextSize, entry.maxContextSize,
-            options.nGpuLayers.value_or(99),
-            options.flashAttn.has_value()?(options.flashAttn.value()?"enabled":"disabled"):"auto",
-            mparams.use_mmap?"on":"off",
-            backendPriority.empty()?"all":[&]()
+void ModelRuntime::placeNuma(LoadedModel &entry, const RuntimeOptions &options, int hostMb)
+{
+    // NOTE: caller must hold m_mutex
+
+    entry.numaPolicy.clear();
+    entry.numaNode=-1;
+
+    std::vector<NumaNode> nodes=HardwareDetector::instance().getSystemInfo().numaNodes;
+    std::string policy=options.numaPolicy.value_or("auto");
+    if(nodes.size()<2||policy=="none")
+    {
+        return;
+    }
+    if(policy=="auto"&&hostMb<=0&&!options.numaNode.has_value())
+    {
+        // Everything lives in VRAM; leave the threads to the arbiter
+        return;
+    }
+
+    // Bind to the requested node, else the one with the most free memory.
+    // Free memory drops as each bound model faults its weights in, so
+    // successive models spread across the nodes.
+    int node=-1;
+    if(options.numaNode.has_value()&&options.numaNode.value()>=0&&
+        options.numaNode.value()<static_cast<int>(nodes.size()))
+    {
+        node=options.numaNode.value();
+    }
+    else
+    {
+        node=0;
+        for(int i=1; i<static_cast<int>(nodes.size()); ++i)
+        {
+            if(nodes[i].freeRamMb>nodes[node].freeRamMb)
             {
-                std::string s;
-                for(const std::string &p:backendPriority)
-                {
-                    if(!s.empty()) s+=",";
-                    s+=p;
-                }
-                return s;
-            }());
-        return ErrorCode::Success;
+                node=i;
+            }
+        }
     }
 
-    // Should not reach here, but just in case
-    return ErrorCode::ModelLoadError;
+    // Only an explicit "bind" makes the node a hard limit; "auto" prefers
+    // the node, so a load that outgrows it spills over instead of failing
+    bool bind=policy=="bind"||(policy=="auto"&&(options.numaNode.has_value()||nodes[node].freeRamMb>=hostMb));
+    if(bind)
+    {
+        entry.numaPolicy=policy=="bind"?"bind":"preferred";
+        entry.numaNode=node;
+        m_threadArbiter.setHomeNode(entry.modelName, node);
+        spdlog::info("NUMA: placing '{}' on node {} ({}, {}MB host memory, {}MB free on node)",
+            entry.modelName, nodes[node].id, entry.numaPolicy, hostMb, nodes[node].freeRamMb);
+    }
+    else
+    {
+        entry.numaPolicy="interleave";
+        m_threadArbiter.setHomeNode(entry.modelName, CpuThreadArbiter::ALL_NODES);
+        spdlog::info("NUMA: interleaving '{}' across {} nodes ({}MB host memory)",
+            entry.modelName, nodes.size(), hostMb);
+    }
 }
 
-void ModelRuntime::freeLlamaModel(LoadedModel &entry)
+std::vector<int> ModelRuntime::numaMemoryNodes(const LoadedModel &entry) const
 {
-    if(entry.llamaCtx)
+    std::vector<NumaNode> nodes=HardwareDetector::instance().getSystemInfo().numaNodes;
+    std::vector<int> ids;
+
+    if((entry.numaPolicy=="bind"||entry.numaPolicy=="preferred")&&entry.numaNode>=0&&entry.numaNode<static_cast<int>(nodes.size()))
     {
-        llama_free(entry.llamaCtx);
-        entry.llamaCtx=nullptr;
+        ids.push_back(nodes[entry.numaNode].id);
     }
-    if(entry.llamaModel)
+    else if(entry.numaPolicy=="interleave")
     {
-        llama_model_free(entry.llamaModel);
-        entry.llamaModel=nullptr;
+        for(const NumaNode &node:nodes)
+        {
+            ids.push_back(node.id);
+        }
     }
+    return ids;
 }
 
 void ModelRuntime::parseDeviceAllocations(LoadedModel &entry, const std::string &logOutput)
@@ -2198,55 +4809,130 @@ std::optional<ModelInfo> ModelRuntime::getLoadedModelInfo(const std::string &mod
     return ModelManager::instance().getModelInfo(model);
 }
 
-bool ModelRuntime::downloadModelFile(
-    const std::string &url,
-    const std::string &filePath,
-    const std::string &sha256,
-    const std::string &modelName,
-    const std::string &variant)
+bool ModelRuntime::linkStoredFiles(const std::string &model, const ModelVariant &variant)
+{
+    bool linked=false;
+    bool missing=false;
+    for(const VariantDownload &file:variant.getAllFiles())
+    {
+        std::string filePath=m_modelsDir+file.filename;
+        if(std::filesystem::exists(filePath))
+        {
+            continue;
+        }
+        if(StorageManager::instance().linkFromStore(file.sha256, filePath))
+        {
+            linked=true;
+        }
+        else if(!file.url.empty())
+        {
+            missing=true;
+        }
+    }
+
+    if(linked&&!missing)
+    {
+        spdlog::info("Model '{}' variant '{}' reuses stored files — no download needed", model, variant.quantization);
+        registerVariantFiles(model, variant);
+    }
+    return missing;
+}
+
+void ModelRuntime::registerVariantFiles(const std::string &model, const ModelVariant &variant)
 {
-    std::optional<std::string> hash=std::nullopt;
-    if(!sha256.empty())
+    std::vector<VariantDownload> allFiles=variant.getAllFiles();
+
+    int64_t totalActualSize=0;
+    std::vector<std::string> extraFiles;
+    std::vector<std::string> fileHashes;
+    for(size_t i=0; i<allFiles.size(); ++i)
     {
-        hash=sha256;
+        std::string filePath=m_modelsDir+allFiles[i].filename;
+        int64_t actualSize=0;
+        std::error_code ec;
+        if(std::filesystem::exists(filePath, ec))
+        {
+            actualSize=static_cast<int64_t>(std::filesystem::file_size(filePath, ec));
+        }
+        totalActualSize+=actualSize;
+        if(i>0)
+        {
+            extraFiles.push_back(allFiles[i].filename);
+        }
+        fileHashes.push_back(allFiles[i].sha256);
     }
+    StorageManager::instance().registerDownload(
+        model, variant.quantization, variant.getPrimaryFilename(), totalActualSize, extraFiles, fileHashes);
+}
 
-    spdlog::info("Starting synchronous download: {} -> {}", url, filePath);
+bool ModelRuntime::downloadVariantFiles(
+    const std::vector<const VariantDownload *> &files,
+    const std::string &modelName,
+    const std::string &variant,
+    DownloadPriority priority)
+{
+    spdlog::info("Starting download of {} file(s) for '{}'", files.size(), modelName);
 
+    std::mutex logMutex;
     auto lastLogTime=std::chrono::steady_clock::now();
 
-    std::future<bool> result=m_downloader.downloadModelWithProgress(
-        url, filePath, hash,
-        [&modelName, &lastLogTime](int64_t bytesDownloaded, int64_t totalBytes, float percent)
+    // Start every shard at once. The downloader's connection pool bounds how
+    // many byte streams actually run across all models, and each shard
+    // verifies its hash as soon as it lands while the others keep going.
+    std::vector<std::future<bool>> results;
+    for(const VariantDownload *file:files)
+    {
+        std::optional<std::string> hash=std::nullopt;
+        if(!file->sha256.empty())
         {
-            auto now=std::chrono::steady_clock::now();
-            double elapsed=std::chrono::duration<double>(now-lastLogTime).count();
-            if(elapsed>=5.0||percent>=100.0f)
+            hash=file->sha256;
+        }
+
+        results.push_back(m_downloader.downloadModelWithProgress(
+            file->url, m_modelsDir+file->filename, hash,
+            [this, &modelName, &logMutex, &lastLogTime](int64_t, int64_t, float)
             {
-                lastLogTime=now;
-                if(totalBytes>0)
+                std::lock_guard<std::mutex> lock(logMutex);
+                auto now=std::chrono::steady_clock::now();
+                double elapsed=std::chrono::duration<double>(now-lastLogTime).count();
+                if(elapsed<5.0)
                 {
-                    spdlog::info("Downloading '{}': {:.1f}% ({}/{} MB)",
-                        modelName, percent,
-                        bytesDownloaded/(1024*1024),
-                        totalBytes/(1024*1024));
+                    return;
                 }
-            }
-        },
-        modelName,
-        variant);
+                lastLogTime=now;
 
-    bool success=result.get();
+                std::optional<DownloadProgressSnapshot> snap=m_downloader.getProgressSnapshot(modelName);
+                if(snap&&snap->totalBytes>0)
+                {
+                    spdlog::info("Downloading '{}': {:.1f}% ({}/{} MB, {}/{} files, {:.1f} MB/s)",
+                        modelName, snap->percentComplete,
+                        snap->bytesDownloaded/(1024*1024),
+                        snap->totalBytes/(1024*1024),
+                        snap->filesCompleted, snap->files,
+                        snap->speedMbps);
+                }
+            },
+            modelName,
+            variant,
+            priority));
+    }
 
-    if(success)
+    // Wait for every shard so none is left writing after we return
+    bool success=true;
+    for(size_t i=0; i<results.size(); ++i)
     {
-        spdlog::info("Download complete: {}", filePath);
+        if(!results[i].get())
+        {
+            success=false;
+            spdlog::error("Failed to download shard '{}' for model '{}' variant '{}'",
+                files[i]->filename, modelName, variant);
+        }
     }
-    else
+
+    if(success)
     {
-        spdlog::error("Download failed: {}", filePath);
+        spdlog::info("Download complete and verified: '{}' variant '{}'", modelName, variant);
     }
-
     return success;
 }
 
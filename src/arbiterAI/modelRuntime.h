@@ -5,14 +5,22 @@
 #include "arbiterAI/modelManager.h"
 #include "arbiterAI/modelFitCalculator.h"
 #include "arbiterAI/modelDownloader.h"
+#include "arbiterAI/mappedFile.h"
+#include "arbiterAI/placementPlanner.h"
+#include "arbiterAI/cpuThreadArbiter.h"
+#include "arbiterAI/autotuner.h"
+#include "arbiterAI/requestQueue.h"
+#include "arbiterAI/memoryPressureMonitor.h"
 
 #include <string>
 #include <vector>
 #include <map>
 #include <set>
+#include <memory>
 #include <mutex>
 #include <atomic>
 #include <queue>
+#include <deque>
 #include <functional>
 #include <chrono>
 #include <sstream>
@@ -22,6 +30,8 @@
 // Forward declarations for llama.cpp types
 struct llama_model;
 struct llama_context;
+struct llama_adapter_lora;
+struct ggml_threadpool;
 
 namespace arbiterAI
 {
@@ -29,7 +39,7 @@ namespace arbiterAI
 enum class ModelState {
     Unloaded,
     Downloading,
-    Ready,      // in system RAM, quick to reload to VRAM
+    Ready,      // weights resident in system RAM, quick to reload to VRAM
     Loaded,     // fully loaded in VRAM, ready for inference
     Unloading
 };
@@ -68,6 +78,47 @@ struct DeviceAllocation {
     int totalMb=0;
 };
 
+/// A LoRA adapter to apply to a context, at a scale.
+struct LoraSelection {
+    std::string path;       // adapter GGUF on disk
+    float scale=1.0f;
+
+    bool operator==(const LoraSelection &other) const
+    {
+        return path==other.path&&scale==other.scale;
+    }
+    bool operator!=(const LoraSelection &other) const { return !(*this==other); }
+};
+
+/// A LoRA adapter loaded against a model (one entry of its adapter cache).
+struct LoadedLora {
+    llama_adapter_lora *adapter=nullptr;
+    int sizeMb=0;
+    std::chrono::steady_clock::time_point lastUsed;
+};
+
+/// A model's CPU threadpool and the thread counts applied to its context.
+/// Shared with the thread running the model's inference, which re-applies
+/// the counts itself when the arbiter's split changes, so decoding never
+/// waits on the runtime lock.
+struct CpuThreadBinding {
+    std::string model;
+    ggml_threadpool *threadpool=nullptr;    // pinned to the model's NUMA node
+    int maxThreads=0;                       // n_threads cap from the runtime options (0 = none)
+    int maxBatchThreads=0;                  // n_threads_batch cap (0 = none)
+    std::atomic<llama_context *> attachedCtx{nullptr}; // context the threadpool is attached to (reset when it is freed)
+    CpuThreadShare applied;                 // thread counts last applied to attachedCtx (guarded by mutex)
+    uint64_t appliedGeneration=0;           // CpuThreadArbiter::generation() when applied
+    mutable std::mutex mutex;               // lets other threads read applied
+
+    /// Thread counts the model last decoded with.
+    CpuThreadShare lastApplied() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return applied;
+    }
+};
+
 struct LoadedModel {
     std::string modelName;
     std::string variant;
@@ -87,6 +138,45 @@ struct LoadedModel {
     llama_model *llamaModel=nullptr;
     llama_context *llamaCtx=nullptr;
     RuntimeOptions activeOptions; // llama.cpp options active for this loaded model
+    std::vector<std::string> filePaths; // GGUF file(s) on disk, primary shard first
+    std::vector<std::string> backendPriority; // backend priority used for the load
+    std::vector<std::shared_ptr<MappedFile>> residentWeights; // Ready tier: GGUF files held in host RAM after VRAM release
+    int measuredRamMb=0;        // host RSS growth measured across the llama.cpp load
+    std::string loadedFrom;     // state the model was last promoted from ("Ready" or "Unloaded")
+    double loadTimeMs=0.0;      // duration of the last transition to Loaded, excluding warm-up
+    double warmupTimeMs=0.0;    // warm-up pass run after the last llama.cpp load (0 = none)
+    int loadedContextSize=0;    // n_ctx allocated at load; recreated contexts never exceed it
+    bool contextReclaimed=false; // llama_context freed after idling; recreated on next use
+    std::map<int, int> perGpuContextVramMb; // gpu index → KV + compute buffer share of perGpuVramMb
+    std::deque<int> recentContextTokens; // prompt+completion tokens of recent requests
+    int contextLimit=0;         // dynamic_context: largest n_ctx the context may grow to (hardware-fit limit)
+    double kvMbPerToken=0.0;    // GPU KV cache cost per context token, measured at load
+    std::optional<PlacementPlan> placement; // auto_placement plan applied at load (nullopt = manual placement)
+    std::shared_ptr<CpuThreadBinding> cpuThreads; // CPU threadpool and thread counts (null until first inference)
+    bool autotuned=false;       // activeOptions include a stored autotune result
+    std::string numaPolicy;     // "bind", "preferred" or "interleave" when host memory and threads are NUMA-placed, empty otherwise
+    int numaNode=-1;            // bound or preferred node (index into SystemInfo::numaNodes); -1 when interleaved or unplaced
+    std::string replicaOf;      // primary model of a data-parallel replica (entry key "<model>#<index>"); empty for the primary
+    int replicaIndex=0;         // 0 for the primary, 1.. for replicas
+    std::map<std::string, LoadedLora> loraAdapters; // adapter path → adapter loaded on llamaModel (LRU cache)
+    std::vector<LoraSelection> appliedLoras; // adapters set on llamaCtx; re-applied when the context is rebuilt
+};
+
+/// How many copies of a llama model to keep loaded.  Counts include the
+/// primary instance.
+struct ReplicaPolicy {
+    int minReplicas=1;
+    int maxReplicas=1;
+    int scaleUpQueueDepth=1;        // add a replica when every instance has this many requests in flight
+    int scaleDownIdleSeconds=120;   // remove a replica above minReplicas after this long without a request
+};
+
+/// A background model download waiting for, or holding, a download slot.
+struct QueuedDownload {
+    std::string model;
+    std::string variant;
+    DownloadPriority priority=DownloadPriority::Explicit;
+    int position=0;             // 1-based among waiting downloads, 0 once running
 };
 
 class ModelRuntime {
@@ -111,13 +201,26 @@ public:
         const RuntimeOptions &optionsOverride=RuntimeOptions{},
         const std::vector<int> &targetDevices={});
 
+    /// True when options leave the KV cache type to loadModel: neither K nor
+    /// V is set (by the config, the request or autotune) and flash
+    /// attention is not off, since a quantized V cache needs it.
+    static bool autoSelectsKvCache(const RuntimeOptions &options);
+
+    /// Apply the KV cache type a fit was sized for, unless options already
+    /// set one.
+    /// @return true if options changed.
+    static bool applyKvCacheFit(RuntimeOptions &options, const ModelFit &fit);
+
     /// Download model files without loading into VRAM.
     /// Launches an async background download that respects the concurrent
     /// download limit.  Returns ModelDownloading on success, Success if
-    /// files are already present, or an error code.
+    /// files are already present, or an error code.  Downloads that a load
+    /// triggers run as UserBlocking.  A more urgent request for a model
+    /// already downloading raises that download's priority.
     ErrorCode downloadModel(
         const std::string &model,
-        const std::string &variant="");
+        const std::string &variant="",
+        DownloadPriority priority=DownloadPriority::Explicit);
 
     /// Set the base directory for model files (default: "/models").
     void setModelsDir(const std::string &dir);
@@ -131,7 +234,29 @@ public:
     /// Get the current concurrent download limit.
     int getMaxConcurrentDownloads() const;
 
-    /// Unload a model. Pinned models move to Ready; others to Unloaded.
+    /// Set how many Range connections each model file is fetched over.
+    void setDownloadSegmentConfig(const SegmentedDownloadConfig &config);
+
+    /// Set the HTTP connection limit shared by all downloads, their shards
+    /// and segments (default: 8).
+    void setMaxDownloadConnections(int max);
+
+    /// Cap total download bandwidth in bytes per second (0 = unlimited).
+    void setDownloadBandwidthLimit(int64_t bytesPerSecond);
+
+    /// Set write buffering, preallocation and O_DIRECT for downloads.
+    void setDownloadWriteConfig(const DownloadWriteConfig &config);
+
+    /// Set peer arbiterAI servers to fetch files with a known sha256 from
+    /// before their origin URL.
+    void setDownloadPeers(const std::vector<std::string> &peers);
+
+    /// Background downloads in scheduling order: running ones first, then
+    /// waiting ones by priority and arrival.
+    std::vector<QueuedDownload> getDownloadQueue() const;
+
+    /// Unload a model. Pinned models move to Ready (weights stay in host RAM);
+    /// others to Unloaded.
     ErrorCode unloadModel(const std::string &model);
 
     /// Pin a model to keep it in RAM for quick reload after VRAM eviction.
@@ -149,7 +274,8 @@ public:
         int contextSize=0,
         const RuntimeOptions &optionsOverride=RuntimeOptions{});
 
-    /// Get the state of all tracked models.
+    /// Get the state of all tracked models (replicas are listed by
+    /// getReplicaStates()).
     std::vector<LoadedModel> getModelStates() const;
 
     /// Get the state of a specific model.
@@ -181,11 +307,84 @@ public:
 
     /// Evict least-recently-used non-pinned models to free VRAM.
     /// When gpuIndex >= 0, only considers models on that specific GPU.
-    void evictIfNeeded(int requiredVramMb, int gpuIndex=-1);
+    /// keepModel is never evicted (used when regrowing that model's own buffers).
+    void evictIfNeeded(int requiredVramMb, int gpuIndex=-1, const std::string &keepModel="");
 
     /// Mark inference as started on a model (blocks eviction of that model).
     void beginInference(const std::string &model);
 
+    /// Pick the instance of a model to run a request on (the model itself
+    /// or one of its replicas) and mark inference started on it.  The
+    /// instance with the fewest requests in flight wins, then the one with
+    /// the most free KV cells, then the least recently used.  A context
+    /// reclaimed while the request waited is recreated; if that fails,
+    /// getLlamaContext(instance) returns null.
+    /// @return Instance key for getLlamaModel/getLlamaContext/getCpuThreads;
+    ///         pair with endInference(instance).
+    std::string acquireInstance(const std::string &model);
+
+    /// Keep between minReplicas and maxReplicas copies of a llama model
+    /// loaded.  Replicas go on GPUs or NUMA nodes with room for a whole copy
+    /// and never evict other models.
+    void setReplicaPolicy(const std::string &model, const ReplicaPolicy &policy);
+
+    /// Get a model's replica policy (nullopt = single instance).
+    std::optional<ReplicaPolicy> getReplicaPolicy(const std::string &model) const;
+
+    /// Get the replicas of a model (the primary is not included).
+    std::vector<LoadedModel> getReplicaStates(const std::string &model) const;
+
+    /// Requests in flight on a model or replica instance.
+    int getInFlightRequests(const std::string &instance) const;
+
+    /// Add a replica to models whose instances are all busy or below
+    /// minReplicas, remove replicas idle past their timeout, and drop
+    /// replicas whose primary was unloaded.  Runs on the maintenance thread.
+    /// @return Change in the number of loaded replicas.
+    int scaleReplicas();
+
+    /// Wait for a slot on a model in its fair admission queue.  Each loaded
+    /// instance (primary or replica) runs one request at a time;
+    /// interactive requests go before batch ones and tenants share by weight.
+    /// onPosition receives the queue position while the request waits.
+    /// @return Success (pair with releaseRequest), QueueFull or TooManyRequests.
+    ErrorCode admitRequest(const std::string &model, const std::string &tenant, RequestPriority priority,
+        const std::function<void(int)> &onPosition=nullptr);
+
+    /// Free the queue slot taken by admitRequest().
+    void releaseRequest(const std::string &model);
+
+    /// Check whether admitRequest() would currently reject a request.
+    ErrorCode checkAdmission(const std::string &model, const std::string &tenant) const;
+
+    /// Set the admission limits.  slotsPerInstance is clamped to 1: an
+    /// instance's requests share one llama_context and its sequence 0.
+    void setRequestQueueConfig(const RequestQueueConfig &config);
+    RequestQueueConfig getRequestQueueConfig() const;
+
+    /// Waiting/running requests and slots of a model's admission queue.
+    RequestQueueStats getRequestQueueStats(const std::string &model) const;
+
+    /// React to a memory pressure reading (the maintenance thread samples
+    /// PSI and the cgroup limit every second).  Under Moderate pressure the
+    /// Ready tier shrinks to half its budget, idle contexts are reclaimed
+    /// after PRESSURE_IDLE_CONTEXT_SECONDS and no replicas are added; under
+    /// Critical pressure the Ready tier is emptied (pinned models excepted)
+    /// and idle contexts go after CRITICAL_IDLE_CONTEXT_SECONDS.  Each action
+    /// is recorded as a MemoryPressureEvent.
+    void applyMemoryPressure(const MemoryPressureSample &sample);
+
+    /// Last memory pressure reading.
+    MemoryPressureSample getMemoryPressure() const;
+
+    /// Current pressure level (lock-free, for other background threads).
+    MemoryPressureLevel getMemoryPressureLevel() const;
+
+    void setMemoryPressureThresholds(const MemoryPressureThresholds &thresholds);
+
+    /// Turn PSI/cgroup sampling on the maintenance thread on or off.
+    void setMemoryPressureMonitorEnabled(bool enabled);
+
     /// Mark inference as completed on a model and drain pending swaps.
     void endInference(const std::string &model);
 
@@ -223,6 +422,84 @@ public:
     /// Get the estimated free VRAM on a specific GPU accounting for loaded models (MB).
     int getEstimatedFreeVramMb(int gpuIndex) const;
 
+    /// Set the server-wide idle timeout after which a loaded model's
+    /// llama_context (KV cache + compute buffers) is freed.  Models override it
+    /// with the idle_context_timeout_seconds runtime option.  0 = never.
+    void setDefaultIdleContextTimeout(int seconds);
+
+    /// Get the server-wide idle context timeout (seconds).
+    int getDefaultIdleContextTimeout() const;
+
+    /// Limit the CPU threads shared by all models (0 = all cores).
+    void setCpuThreads(int threads);
+
+    /// Get the CPU thread limit (0 = all cores).
+    int getCpuThreads() const;
+
+    /// Resolve the model to run and the adapters to apply for a request.
+    /// Models with a "lora" config run on their base model with their
+    /// adapters; other models resolve to themselves with none.
+    /// @param scales  Per-request scale overrides by adapter name (0 = skip the adapter).
+    /// @return InvalidRequest when scales name an adapter the model does not have.
+    ErrorCode resolveLoraAdapters(const std::string &model, const std::map<std::string, double> &scales,
+        std::string &baseModel, std::vector<LoraSelection> &adapters) const;
+
+    /// Set the adapters on an instance's context, loading missing ones into
+    /// the adapter cache.  An empty set clears the context's adapters.
+    ErrorCode applyLoraAdapters(const std::string &instance, const std::vector<LoraSelection> &adapters);
+
+    /// Limit the memory of cached LoRA adapters across all models (0 = no
+    /// limit).  Least recently used adapters not in use are freed first.
+    void setLoraCacheBudget(int mb);
+    int getLoraCacheBudget() const;
+
+    /// MB of LoRA adapters currently loaded.
+    int getLoraCacheUsage() const;
+
+    /// CPU thread binding of a model instance acquired for inference, set up
+    /// by acquireInstance().  Null if the model has no context.
+    std::shared_ptr<CpuThreadBinding> getCpuThreads(const std::string &instance) const;
+
+    /// Attach the binding's threadpool to ctx and apply the thread counts the
+    /// arbiter currently grants the model.  Called before each llama_decode
+    /// so shares follow other models starting and finishing; costs one atomic
+    /// load unless the split changed, and never takes the runtime lock.
+    void applyCpuThreads(CpuThreadBinding &threads, llama_context *ctx);
+
+    /// Record the number of tokens (prompt + completion) a request used, for
+    /// sizing recreated contexts.
+    void recordContextUsage(const std::string &model, int tokens);
+
+    /// Free the contexts of Loaded models that have been idle past their
+    /// timeout.  Runs periodically on the maintenance thread; the model
+    /// weights stay loaded and the context is recreated on next loadModel().
+    /// @return Number of contexts reclaimed.
+    int reclaimIdleContexts();
+
+    /// Grow a dynamic_context model's context so it can hold requiredTokens.
+    /// The size doubles until it fits, capped at the hardware-fit limit; the
+    /// current sequence is copied into the new context.
+    /// @return Success if the context now holds requiredTokens, InvalidRequest
+    ///         if the model is not dynamic or the limit is too small,
+    ///         ModelNotLoaded / ModelLoadError otherwise.
+    ErrorCode ensureContextCapacity(const std::string &model, int requiredTokens);
+
+    /// Measure prompt and generation throughput of a Loaded model with the
+    /// given options layered over its active ones.  Runs a synthetic prompt
+    /// in a temporary context; the model's own context is freed first and
+    /// recreated on next use.
+    /// @return Success, ModelNotLoaded, InvalidRequest if the model is busy,
+    ///         or ModelLoadError if the context or a decode failed.
+    ErrorCode runBenchmark(const std::string &model, const RuntimeOptions &options,
+        int promptTokens, int generateTokens, BenchmarkResult &result);
+
+    /// Sweep batch sizes, thread counts, flash attention and KV cache type
+    /// for a Loaded model and store the winner for this hardware.  The
+    /// stored options are applied the next time the model is loaded.
+    ErrorCode autotune(const std::string &model, const AutotuneConfig &config, AutotuneResult &result);
+
+    ~ModelRuntime();
+
 private:
     ModelRuntime();
 
@@ -235,12 +512,88 @@ private:
     /// Execute a pending swap (called when inference completes).
     void drainPendingSwaps();
 
-    /// Calculate ready-tier RAM usage across all Ready models.
+    /// Mark inference started on an instance (caller holds m_mutex).
+    void startInference(const std::string &instance);
+
+    /// Load one more copy of a Loaded llama model on GPUs or a NUMA node
+    /// with room for it, without evicting anything (caller holds m_mutex).
+    ErrorCode addReplica(const std::string &model);
+
+    /// Unload a replica and forget it (caller holds m_mutex).
+    void removeReplica(const std::string &key);
+
+    /// Loaded instances of a model, primary plus Loaded replicas (caller
+    /// holds m_mutex).
+    int instanceCount(const std::string &model) const;
+
+    /// Entry key of a model's replica.
+    static std::string replicaKey(const std::string &model, int index);
+
+    /// Ready-tier budget after memory pressure cuts (caller holds m_mutex).
+    int effectiveReadyRamBudgetMb() const;
+
+    /// Record a pressure-triggered action in telemetry (caller holds m_mutex).
+    void recordPressureEvent(const std::string &action, const std::string &model, int freedMb);
+
+    /// Calculate ready-tier RAM usage across all Ready models (measured).
     int calculateReadyRamUsage() const;
 
+    /// Measure the host RAM a Ready model currently holds: resident pages of
+    /// its mapped GGUF files, or the RSS measured at load when the llama_model
+    /// itself was kept.
+    int measureReadyRamMb(const LoadedModel &entry) const;
+
     /// Evict LRU non-pinned Ready models to stay within RAM budget.
     void evictReadyModels();
 
+    /// Move a Loaded model out of VRAM.
+    /// @param keepReady  Move to Ready instead of Unloaded.  Host-only models
+    ///                   keep their llama_model and drop only the context; GPU
+    ///                   models release their weights from VRAM but keep the
+    ///                   GGUF files mapped in host RAM for a fast re-upload.
+    void demoteModel(LoadedModel &entry, bool keepReady);
+
+    /// Promote a Ready model back to Loaded, rebuilding only what was released.
+    ErrorCode promoteReadyModel(LoadedModel &entry);
+
+    /// Recreate a model's llama_context from its active options.
+    ErrorCode createContext(LoadedModel &entry, int contextSize);
+
+    /// Free least recently used LoRA adapters until requiredMb more fits in
+    /// the adapter budget.  Adapters in keep (on target) and adapters set on
+    /// a context with requests in flight are never freed.
+    void evictLoraAdapters(int requiredMb, const LoadedModel &target, const std::vector<LoraSelection> &keep);
+
+    /// Drop a model's adapter cache before its llama_model is freed (the
+    /// model frees its adapters).
+    void forgetLoraAdapters(LoadedModel &entry);
+
+    /// Context size to use when recreating a reclaimed context: the load-time
+    /// size, or a size fitted to recent requests when idle_shrink_context is set.
+    int reclaimedContextSize(const LoadedModel &entry) const;
+
+    /// Split the parsed KV + compute allocations across the model's GPUs.
+    void updateContextVram(LoadedModel &entry);
+
+    /// Adjust a model's VRAM charge by deltaMb of KV cache, split across its GPUs.
+    void chargeContextVram(LoadedModel &entry, int deltaMb);
+
+    /// Rebuild a model's context at newSize, carrying sequence 0 across when
+    /// it fits, and record the resize in telemetry. If newSize can't be
+    /// allocated the model keeps (or gets back) a context at its old size and
+    /// Success is returned; check contextSize. entry.llamaCtx changes on
+    /// success and is null only when no context could be rebuilt.
+    ErrorCode resizeContext(LoadedModel &entry, int newSize, const std::string &reason);
+
+    /// Shrink idle dynamic_context models on a GPU back to their initial
+    /// context to free VRAM before evicting whole models.
+    /// @return MB released.
+    int shrinkDynamicContexts(int gpuIndex, int needMb, const std::string &keepModel);
+
+    /// Start/stop the periodic maintenance thread (idle context reclamation).
+    void startMaintenanceThread();
+    void stopMaintenanceThread();
+
     /// Initialize the llama.cpp backend (called once on first local model load).
     void initLlamaBackend();
 
@@ -269,20 +622,70 @@ private:
         const RuntimeOptions &options=RuntimeOptions{},
         const std::vector<std::string> &backendPriority={});
 
-    /// Free llama.cpp resources for a model.
+    /// Free llama.cpp resources and Ready-tier weight mappings for a model.
     void freeLlamaModel(LoadedModel &entry);
 
+    /// Free the model's CPU threadpool (its context must already be freed).
+    void freeCpuThreadpool(LoadedModel &entry);
+
+    /// Create the model's CPU threadpool if needed and apply it and the
+    /// arbiter's thread counts to its context.  Once per request, from
+    /// startInference(); decodes re-apply through applyCpuThreads().
+    /// NOTE: caller must hold m_mutex
+    void bindCpuThreads(LoadedModel &entry);
+
+    /// Forget which context the threadpool is attached to, after freeing it.
+    void detachCpuThreads(LoadedModel &entry);
+
     /// Parse per-device buffer allocations from llama.cpp log output.
     void parseDeviceAllocations(LoadedModel &entry, const std::string &logOutput);
 
-    /// Download a model file synchronously.
-    /// @return true on success, false on failure.
-    bool downloadModelFile(
-        const std::string &url,
-        const std::string &filePath,
-        const std::string &sha256,
+    /// Compare the parsed allocations with the GGUF-based estimate and update
+    /// the persisted calibration factors for the model variant.
+    void calibrateMemoryEstimate(const LoadedModel &entry, const std::string &filePath,
+        const RuntimeOptions &options);
+
+    /// Plan GPU layers, tensor overrides and KV placement for a llama load
+    /// from the variant's GGUF tensor table and the free VRAM/RAM.
+    /// @return nullopt when placement is manual (n_gpu_layers/override_tensor
+    ///         set or auto_placement=false) or the files are not on disk.
+    std::optional<PlacementPlan> planPlacement(const ModelInfo &model, const ModelVariant &variant,
+        const ModelFit &fit, const RuntimeOptions &options, int requestedContext,
+        const SystemInfo &hw, const std::vector<int> &gpuIndices) const;
+
+    /// Run a tiny prefill and decode on a freshly loaded model so the first
+    /// request does not pay for page faults, lazy buffer allocation and graph
+    /// setup.  Clears the KV cache and perf counters afterwards and records
+    /// the time in warmupTimeMs.
+    void warmupModel(LoadedModel &entry);
+
+    /// Choose the NUMA placement for a model's host memory (hostMb) and CPU
+    /// threads from its numa_policy option and per-node free memory, record
+    /// it on the entry and home the model's threads accordingly.
+    void placeNuma(LoadedModel &entry, const RuntimeOptions &options, int hostMb);
+
+    /// Kernel node ids a model's host allocations are restricted to (empty =
+    /// no policy).
+    std::vector<int> numaMemoryNodes(const LoadedModel &entry) const;
+
+    /// Link files of a variant whose content is already stored under another
+    /// name, so a second registration of a known GGUF costs no download and
+    /// no disk.  Registers the variant once that makes it complete.
+    /// @return true if any file still needs downloading.
+    /// NOTE: caller must hold m_mutex
+    bool linkStoredFiles(const std::string &model, const ModelVariant &variant);
+
+    /// Register a variant's files (sizes and hashes) with StorageManager.
+    void registerVariantFiles(const std::string &model, const ModelVariant &variant);
+
+    /// Download and verify the given files of a variant in parallel, then
+    /// wait for all of them.
+    /// @return true only if every file downloaded and verified.
+    bool downloadVariantFiles(
+        const std::vector<const VariantDownload *> &files,
         const std::string &modelName,
-        const std::string &variant);
+        const std::string &variant,
+        DownloadPriority priority);
 
     std::map<std::string, LoadedModel> m_models;
     mutable std::mutex m_mutex;
@@ -291,6 +694,28 @@ private:
     std::vector<std::string> m_defaultBackendPriority;
     std::set<std::string> m_activeInference; // models currently running inference
     bool m_llamaInitialized=false;
+    int m_defaultIdleContextTimeoutSec=0;
+    int m_cpuThreads=0;
+    int m_loraCacheBudgetMb=DEFAULT_LORA_CACHE_MB;
+    CpuThreadArbiter m_threadArbiter;
+    std::map<std::string, ReplicaPolicy> m_replicaPolicies;
+    std::map<std::string, std::chrono::steady_clock::time_point> m_replicaRetryAt; // no replica load attempts before this
+    RequestQueue m_requestQueue;
+    MemoryPressureMonitor m_pressureMonitor;
+    MemoryPressureSample m_pressure;
+    std::atomic<MemoryPressureLevel> m_pressureLevel{MemoryPressureLevel::None};
+    std::atomic<bool> m_pressureMonitorEnabled{true};
+
+    static constexpr size_t MAX_RECENT_CONTEXT_SAMPLES=32;
+    static constexpr int REPLICA_RETRY_SECONDS=30;
+    static constexpr int MIN_SHRUNK_CONTEXT=2048;
+    static constexpr int DEFAULT_INITIAL_CONTEXT=4096;
+    static constexpr int DEFAULT_LORA_CACHE_MB=1024;
+    static constexpr int PRESSURE_IDLE_CONTEXT_SECONDS=60;
+    static constexpr int CRITICAL_IDLE_CONTEXT_SECONDS=5;
+
+    std::thread m_maintenanceThread;
+    std::atomic<bool> m_maintenanceRunning{false};
 
     struct SwapRequest {
         std::string model;
@@ -302,17 +727,42 @@ private:
 
     ModelDownloader m_downloader;
 
-    /// Background download concurrency management.
+    /// Background download concurrency management.  A download may start
+    /// while fewer than m_maxConcurrentDownloads downloads at least as
+    /// urgent are running and no more urgent (or earlier equal) download is
+    /// waiting.  Less urgent running downloads don't block it; they yield
+    /// their connections to it in the downloader instead.
+    struct DownloadTicket {
+        uint64_t id=0;
+        std::string model;
+        std::string variant;
+        DownloadPriority priority=DownloadPriority::Explicit;
+        bool running=false;
+    };
     int m_maxConcurrentDownloads=2;
-    int m_activeDownloadCount=0;
+    std::vector<DownloadTicket> m_downloadQueue;
+    uint64_t m_nextDownloadTicket=1;
     bool m_shuttingDown=false;
     std::condition_variable m_downloadCv;
     std::vector<std::thread> m_downloadThreads;
 
-    /// Internal: run a background download for a model.  Respects the
-    /// concurrent download semaphore and registers files with StorageManager
-    /// on success.  Called on a detached background thread.
+    /// Queue a background download and launch its thread.
+    /// NOTE: caller must hold m_mutex
+    void startBackgroundDownload(const std::string &model, const std::string &variant,
+        const ModelInfo &info, DownloadPriority priority);
+
+    /// NOTE: caller must hold m_mutex
+    bool canStartDownload(uint64_t ticket) const;
+
+    /// Raise the priority of a queued or running download of model.
+    /// NOTE: caller must hold m_mutex
+    void promoteDownload(const std::string &model, DownloadPriority priority);
+
+    /// Internal: run a background download for a model.  Waits for a
+    /// download slot and registers files with StorageManager on success.
+    /// Called on a background thread.
     void runBackgroundDownload(
+        uint64_t ticket,
         const std::string &model,
         const std::string &variant,
         const ModelInfo &info);
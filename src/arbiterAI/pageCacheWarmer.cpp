@@ -0,0 +1,320 @@
+#include "arbiterAI/pageCacheWarmer.h"
+
+#include <spdlog/spdlog.h>
+#include <algorithm>
+
+namespace arbiterAI
+{
+
+void PageCacheWarmer::setLockBudget(int64_t bytes)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_lockBudgetBytes=std::max<int64_t>(0, bytes);
+}
+
+int64_t PageCacheWarmer::getLockBudget() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_lockBudgetBytes;
+}
+
+void PageCacheWarmer::setRewarmThreshold(double percent)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_rewarmThresholdPercent=std::clamp(percent, 0.0, 100.0);
+}
+
+void PageCacheWarmer::hold(const std::string &key, const std::vector<std::string> &paths)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    HeldSet set;
+    for(const std::string &path:paths)
+    {
+        HeldFile file;
+        file.path=path;
+        set.files.push_back(file);
+    }
+    set.order=m_nextOrder++;
+    m_held[key]=std::move(set);
+}
+
+void PageCacheWarmer::release(const std::string &key)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_held.erase(key);
+}
+
+void PageCacheWarmer::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_held.clear();
+}
+
+bool PageCacheWarmer::hasPending() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for(const auto &pair:m_held)
+    {
+        if(!pair.second.mapped)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+int PageCacheWarmer::update()
+{
+    std::lock_guard<std::mutex> updateLock(m_updateMutex);
+
+    int warmed=0;
+
+    // Map newly held files.  Opening reads the file ahead; the mapping and
+    // any mlock run outside m_mutex so residency queries are not blocked
+    // behind disk reads.
+    std::vector<std::pair<std::string, HeldSet>> pending;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for(const auto &pair:m_held)
+        {
+            if(!pair.second.mapped)
+            {
+                pending.push_back(pair);
+            }
+        }
+    }
+
+    for(auto &pair:pending)
+    {
+        for(HeldFile &file:pair.second.files)
+        {
+            std::shared_ptr<MappedFile> mapping=std::make_shared<MappedFile>();
+            if(mapping->open(file.path))
+            {
+                file.mapping=mapping;
+                ++warmed;
+                spdlog::info("PageCacheWarmer: warming {} ({} MB)", file.path, mapping->size()/(1024*1024));
+            }
+            else
+            {
+                spdlog::warn("PageCacheWarmer: cannot map {}", file.path);
+            }
+        }
+    }
+
+    std::vector<std::shared_ptr<MappedFile>> mapped;
+    double threshold=0.0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for(auto &pair:pending)
+        {
+            auto it=m_held.find(pair.first);
+            if(it!=m_held.end()&&it->second.order==pair.second.order&&!it->second.mapped)
+            {
+                it->second.files=std::move(pair.second.files);
+                it->second.mapped=true;
+            }
+        }
+
+        for(const auto &pair:m_held)
+        {
+            for(const HeldFile &file:pair.second.files)
+            {
+                if(file.mapping)
+                {
+                    mapped.push_back(file.mapping);
+                }
+            }
+        }
+        threshold=m_rewarmThresholdPercent;
+    }
+
+    // Re-read files whose pages were reclaimed since the last pass
+    for(const std::shared_ptr<MappedFile> &mapping:mapped)
+    {
+        int64_t resident=mapping->residentBytes();
+        if(mapping->size()>0&&100.0*static_cast<double>(resident)<threshold*static_cast<double>(mapping->size()))
+        {
+            spdlog::info("PageCacheWarmer: re-warming {} ({:.1f}% resident)", mapping->path(),
+                100.0*static_cast<double>(resident)/static_cast<double>(mapping->size()));
+            mapping->prefetch();
+            ++warmed;
+        }
+    }
+
+    // Fit the locks to the budget: existing locks are kept oldest hold first,
+    // then unlocked files are added in the same order while they fit
+    struct LockChange {
+        std::string key;
+        uint64_t order=0;
+        size_t index=0;
+        std::shared_ptr<MappedFile> mapping;
+        bool lock=false;
+        bool locked=false;
+    };
+    std::vector<LockChange> changes;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        std::vector<std::pair<uint64_t, std::string>> byOrder;
+        for(const auto &pair:m_held)
+        {
+            byOrder.emplace_back(pair.second.order, pair.first);
+        }
+        std::sort(byOrder.begin(), byOrder.end());
+
+        int64_t used=0;
+        for(bool locking:{false, true})
+        {
+            for(const auto &entry:byOrder)
+            {
+                const HeldSet &set=m_held.at(entry.second);
+                for(size_t i=0; i<set.files.size(); ++i)
+                {
+                    const HeldFile &file=set.files[i];
+                    if(!file.mapping||file.locked==locking)
+                    {
+                        continue;
+                    }
+
+                    bool fits=used+file.mapping->size()<=m_lockBudgetBytes;
+                    if(!locking)
+                    {
+                        if(fits)
+                        {
+                            used+=file.mapping->size();
+                        }
+                        else
+                        {
+                            changes.push_back({entry.second, set.order, i, file.mapping, false, false});
+                        }
+                    }
+                    else if(fits&&!file.lockFailed)
+                    {
+                        used+=file.mapping->size();
+                        changes.push_back({entry.second, set.order, i, file.mapping, true, false});
+                    }
+                }
+            }
+        }
+    }
+
+    for(LockChange &change:changes)
+    {
+        if(change.lock)
+        {
+            change.locked=change.mapping->lock();
+        }
+        else
+        {
+            change.mapping->unlock();
+        }
+    }
+
+    if(!changes.empty())
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for(const LockChange &change:changes)
+        {
+            auto it=m_held.find(change.key);
+            if(it==m_held.end()||it->second.order!=change.order||change.index>=it->second.files.size())
+            {
+                continue;
+            }
+
+            HeldFile &file=it->second.files[change.index];
+            file.locked=change.locked;
+            if(change.lock&&!change.locked)
+            {
+                file.lockFailed=true;
+            }
+        }
+    }
+
+    return warmed;
+}
+
+FileResidency PageCacheWarmer::residency(const std::string &path) const
+{
+    FileResidency result;
+    result.path=path;
+
+    std::shared_ptr<MappedFile> mapping;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for(const auto &pair:m_held)
+        {
+            for(const HeldFile &file:pair.second.files)
+            {
+                if(file.path==path&&file.mapping)
+                {
+                    mapping=file.mapping;
+                    result.locked=file.locked;
+                }
+            }
+        }
+    }
+
+    if(mapping)
+    {
+        result.held=true;
+        result.sizeBytes=mapping->size();
+        result.residentBytes=mapping->residentBytes();
+    }
+    else
+    {
+        result.residentBytes=MappedFile::measureResident(path, &result.sizeBytes);
+    }
+    return result;
+}
+
+int64_t PageCacheWarmer::lockedBytes() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    int64_t bytes=0;
+    for(const auto &pair:m_held)
+    {
+        for(const HeldFile &file:pair.second.files)
+        {
+            if(file.locked&&file.mapping)
+            {
+                bytes+=file.mapping->size();
+            }
+        }
+    }
+    return bytes;
+}
+
+int64_t PageCacheWarmer::unlockAll()
+{
+    std::lock_guard<std::mutex> updateLock(m_updateMutex);
+
+    std::vector<std::shared_ptr<MappedFile>> locked;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for(auto &pair:m_held)
+        {
+            for(HeldFile &file:pair.second.files)
+            {
+                if(file.locked&&file.mapping)
+                {
+                    locked.push_back(file.mapping);
+                    file.locked=false;
+                }
+            }
+        }
+    }
+
+    int64_t bytes=0;
+    for(const std::shared_ptr<MappedFile> &mapping:locked)
+    {
+        mapping->unlock();
+        bytes+=mapping->size();
+    }
+    return bytes;
+}
+
+} // namespace arbiterAI
@@ -0,0 +1,104 @@
+#ifndef _ARBITERAI_PAGECACHEWARMER_H_
+#define _ARBITERAI_PAGECACHEWARMER_H_
+
+#include "arbiterAI/mappedFile.h"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+
+namespace arbiterAI
+{
+
+/// Page-cache residency of one file.
+struct FileResidency {
+    std::string path;
+    int64_t sizeBytes=0;
+    int64_t residentBytes=0;    // pages in the page cache (mincore)
+    bool locked=false;          // mlock()ed by the warmer
+    bool held=false;            // mapped and kept warm by the warmer
+
+    double residentPercent() const
+    {
+        return sizeBytes>0?100.0*static_cast<double>(residentBytes)/static_cast<double>(sizeBytes):0.0;
+    }
+};
+
+/// Keeps the GGUF files of hot-ready variants in the OS page cache so a later
+/// load reads them from RAM.  Each held file is mapped and read ahead; files
+/// are mlock()ed in the order they were held while the lock budget lasts.
+/// update() does the mapping work and re-reads files whose residency fell
+/// below the threshold (pages reclaimed under memory pressure), so callers
+/// run it from a background thread.
+class PageCacheWarmer {
+public:
+    PageCacheWarmer()=default;
+
+    PageCacheWarmer(const PageCacheWarmer &)=delete;
+    PageCacheWarmer &operator=(const PageCacheWarmer &)=delete;
+
+    /// Bytes that may be mlock()ed across all held files (0 = never lock).
+    void setLockBudget(int64_t bytes);
+    int64_t getLockBudget() const;
+
+    /// Residency percentage under which a held file is read ahead again.
+    void setRewarmThreshold(double percent);
+
+    /// Keep a set of files warm, replacing any earlier set held under key.
+    /// The files are mapped on the next update().
+    void hold(const std::string &key, const std::vector<std::string> &paths);
+
+    /// Stop keeping a key's files warm (unmaps and unlocks them).
+    void release(const std::string &key);
+
+    /// Release everything.
+    void clear();
+
+    /// True when held files are waiting to be mapped.
+    bool hasPending() const;
+
+    /// Map newly held files, fill the lock budget and re-read held files
+    /// that dropped below the threshold.
+    /// @return Number of files read ahead (newly mapped or re-warmed).
+    int update();
+
+    /// Residency of a file: measured on the held mapping, or with a
+    /// short-lived mapping that does not read the file in.
+    FileResidency residency(const std::string &path) const;
+
+    /// Bytes currently mlock()ed.
+    int64_t lockedBytes() const;
+
+    /// munlock() every held file so the kernel may reclaim it (memory
+    /// pressure).  The next update() locks them again within the budget.
+    /// @return Bytes unlocked.
+    int64_t unlockAll();
+
+private:
+    struct HeldFile {
+        std::string path;
+        std::shared_ptr<MappedFile> mapping;    // null until mapped
+        bool locked=false;
+        bool lockFailed=false;                  // mlock() refused (RLIMIT_MEMLOCK); not retried
+    };
+
+    struct HeldSet {
+        std::vector<HeldFile> files;
+        uint64_t order=0;       // hold order, for lock priority
+        bool mapped=false;
+    };
+
+    mutable std::mutex m_mutex;
+    std::mutex m_updateMutex;   // serializes update(); mapping work runs outside m_mutex
+    std::map<std::string, HeldSet> m_held;
+    uint64_t m_nextOrder=0;
+    int64_t m_lockBudgetBytes=0;
+    double m_rewarmThresholdPercent=90.0;
+};
+
+} // namespace arbiterAI
+
+#endif//_ARBITERAI_PAGECACHEWARMER_H_
@@ -0,0 +1,287 @@
+#include "arbiterAI/placementPlanner.h"
+
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cstdlib>
+
+namespace arbiterAI
+{
+
+namespace
+{
+
+constexpr double BYTES_PER_MB=1024.0*1024.0;
+
+/// Tensor bytes grouped the way llama.cpp places them.
+struct LayerSizes {
+    std::vector<int64_t> dense;     // per layer: attention, norms, shared FFN
+    std::vector<int64_t> experts;   // per layer: MoE expert FFNs (*_exps)
+    int64_t outputBytes=0;          // output head and final norm, offloaded only with every layer
+    int64_t inputBytes=0;           // token embeddings, always kept in host memory
+};
+
+/// Layer index of a "blk.<n>.*" tensor, or -1.
+int layerIndex(const std::string &name)
+{
+    if(name.compare(0, 4, "blk.")!=0)
+    {
+        return -1;
+    }
+
+    char *end=nullptr;
+    long index=std::strtol(name.c_str()+4, &end, 10);
+    if(end==name.c_str()+4||*end!='.')
+    {
+        return -1;
+    }
+    return static_cast<int>(index);
+}
+
+LayerSizes collectLayerSizes(const GgufModelInfo &gguf)
+{
+    LayerSizes sizes;
+    sizes.dense.assign(gguf.nLayer, 0);
+    sizes.experts.assign(gguf.nLayer, 0);
+
+    for(const GgufTensorInfo &tensor:gguf.tensors)
+    {
+        int layer=layerIndex(tensor.name);
+        if(layer>=0&&layer<gguf.nLayer)
+        {
+            if(tensor.name.find("_exps")!=std::string::npos)
+            {
+                sizes.experts[layer]+=tensor.sizeBytes;
+            }
+            else
+            {
+                sizes.dense[layer]+=tensor.sizeBytes;
+            }
+        }
+        else if(tensor.name.compare(0, 10, "token_embd")==0)
+        {
+            sizes.inputBytes+=tensor.sizeBytes;
+        }
+        else
+        {
+            sizes.outputBytes+=tensor.sizeBytes;
+        }
+    }
+    return sizes;
+}
+
+/// One way of splitting the model between GPU and host memory.
+struct Candidate {
+    std::string strategy;
+    int gpuLayers=0;        // the last gpuLayers layers are offloaded (llama.cpp -ngl order)
+    int expertCpuLayers=0;  // expert FFNs of the first expertCpuLayers layers stay on CPU
+    bool outputOnGpu=false;
+    bool kvOffload=true;
+};
+
+PlacementPlan evaluate(const Candidate &candidate, const GgufModelInfo &gguf, const LayerSizes &sizes,
+    const std::vector<int64_t> &layerKv, const PlacementBudget &budget)
+{
+    double activeExperts=(gguf.expertCount>0&&gguf.expertUsedCount>0)
+        ?static_cast<double>(gguf.expertUsedCount)/gguf.expertCount
+        :1.0;
+    double wf=budget.weightFactor>0.0?budget.weightFactor:1.0;
+
+    double gpuBytes=0.0;
+    double cpuBytes=sizes.inputBytes*wf;
+    double gpuRead=0.0;
+    double cpuRead=0.0;
+
+    int firstGpuLayer=gguf.nLayer-candidate.gpuLayers;
+    for(int il=0; il<gguf.nLayer; ++il)
+    {
+        bool onGpu=il>=firstGpuLayer;
+        bool expertsOnGpu=onGpu&&il>=candidate.expertCpuLayers;
+        bool kvOnGpu=onGpu&&candidate.kvOffload;
+        double dense=sizes.dense[il]*wf;
+        double experts=sizes.experts[il]*wf;
+        double kv=static_cast<double>(layerKv[il]);
+
+        (onGpu?gpuBytes:cpuBytes)+=dense;
+        (onGpu?gpuRead:cpuRead)+=dense;
+        (expertsOnGpu?gpuBytes:cpuBytes)+=experts;
+        (expertsOnGpu?gpuRead:cpuRead)+=experts*activeExperts;
+        (kvOnGpu?gpuBytes:cpuBytes)+=kv;
+        (kvOnGpu?gpuRead:cpuRead)+=kv;
+    }
+
+    (candidate.outputOnGpu?gpuBytes:cpuBytes)+=sizes.outputBytes*wf;
+    (candidate.outputOnGpu?gpuRead:cpuRead)+=sizes.outputBytes*wf;
+
+    double gpuBandwidth=budget.gpuBandwidthGbps>0.0?budget.gpuBandwidthGbps:PlacementPlanner::DEFAULT_GPU_BANDWIDTH_GBPS;
+    double cpuBandwidth=budget.cpuBandwidthGbps>0.0?budget.cpuBandwidthGbps:PlacementPlanner::DEFAULT_CPU_BANDWIDTH_GBPS;
+    double seconds=gpuRead/(gpuBandwidth*1e9)+cpuRead/(cpuBandwidth*1e9);
+
+    PlacementPlan plan;
+    plan.strategy=candidate.strategy;
+    plan.nGpuLayers=candidate.outputOnGpu?gguf.nLayer+1:candidate.gpuLayers;
+    plan.kvOffload=candidate.kvOffload;
+    plan.gpuMb=static_cast<int>(gpuBytes/BYTES_PER_MB+0.5)+(candidate.gpuLayers>0?budget.computeBufferMb:0);
+    plan.cpuMb=static_cast<int>(cpuBytes/BYTES_PER_MB+0.5);
+    plan.estimatedTokensPerSec=seconds>0.0?1.0/seconds:0.0;
+    plan.fits=plan.gpuMb<=budget.gpuVramMb&&(budget.ramMb<=0||plan.cpuMb<=budget.ramMb);
+
+    std::string total=std::to_string(gguf.nLayer);
+    if(candidate.strategy=="full_gpu")
+    {
+        plan.reason="all "+total+" layers fit in "+std::to_string(budget.gpuVramMb)+"MB of VRAM";
+    }
+    else if(candidate.strategy=="moe_experts_cpu")
+    {
+        plan.reason="experts of "+std::to_string(candidate.expertCpuLayers)+"/"+total+
+            " layers in host memory, attention on GPU";
+    }
+    else if(candidate.strategy=="partial_layers")
+    {
+        plan.reason=std::to_string(candidate.gpuLayers)+"/"+total+" layers on GPU";
+    }
+    if(candidate.gpuLayers>0&&!candidate.kvOffload)
+    {
+        plan.reason+=", KV cache in host memory";
+    }
+
+    if(candidate.expertCpuLayers>0)
+    {
+        std::vector<int> layers;
+        for(int il=0; il<candidate.expertCpuLayers; ++il)
+        {
+            layers.push_back(il);
+        }
+        plan.overrideTensor.push_back(PlacementPlanner::expertOverridePattern(layers)+"=CPU");
+    }
+    return plan;
+}
+
+} // namespace
+
+std::string PlacementPlan::overrideTensorString() const
+{
+    std::string joined;
+    for(const std::string &entry:overrideTensor)
+    {
+        if(!joined.empty())
+        {
+            joined+=",";
+        }
+        joined+=entry;
+    }
+    return joined;
+}
+
+std::string PlacementPlanner::expertOverridePattern(const std::vector<int> &layers)
+{
+    std::string pattern="blk\\.(";
+    for(size_t i=0; i<layers.size(); ++i)
+    {
+        if(i>0)
+        {
+            pattern+="|";
+        }
+        pattern+=std::to_string(layers[i]);
+    }
+    pattern+=")\\.ffn_.*_exps\\.";
+    return pattern;
+}
+
+PlacementPlan PlacementPlanner::plan(const GgufModelInfo &gguf, int contextSize,
+    double kvBytesPerElement, const PlacementBudget &budget)
+{
+    PlacementPlan best;
+    best.contextSize=contextSize;
+
+    if(gguf.nLayer<=0||gguf.tensors.empty())
+    {
+        best.reason="no tensor metadata";
+        return best;
+    }
+
+    LayerSizes sizes=collectLayerSizes(gguf);
+    std::vector<int64_t> layerKv(gguf.nLayer);
+    for(int il=0; il<gguf.nLayer; ++il)
+    {
+        layerKv[il]=gguf.layerKvCacheBytes(il, contextSize, kvBytesPerElement);
+    }
+    bool hasExperts=std::any_of(sizes.experts.begin(), sizes.experts.end(), [](int64_t b) { return b>0; });
+
+    auto fits=[&](const Candidate &c)
+    {
+        return evaluate(c, gguf, sizes, layerKv, budget).fits;
+    };
+
+    std::vector<Candidate> candidates;
+    if(budget.gpuVramMb>0)
+    {
+        std::vector<bool> kvOptions=budget.kvOffload.has_value()
+            ?std::vector<bool>{budget.kvOffload.value()}
+            :std::vector<bool>{true, false};
+
+        for(bool kvOffload:kvOptions)
+        {
+            candidates.push_back({"full_gpu", gguf.nLayer, 0, true, kvOffload});
+
+            // MoE: keep attention and shared weights on the GPU, move the
+            // fewest expert FFNs needed to host memory
+            if(hasExperts)
+            {
+                for(int k=1; k<=gguf.nLayer; ++k)
+                {
+                    Candidate c{"moe_experts_cpu", gguf.nLayer, k, true, kvOffload};
+                    if(fits(c))
+                    {
+                        candidates.push_back(c);
+                        break;
+                    }
+                }
+            }
+
+            // Dense: offload as many whole layers as fit
+            for(int layers=gguf.nLayer-1; layers>0; --layers)
+            {
+                Candidate c{"partial_layers", layers, 0, false, kvOffload};
+                if(fits(c))
+                {
+                    candidates.push_back(c);
+                    break;
+                }
+            }
+        }
+    }
+    candidates.push_back({"cpu_only", 0, 0, false, false});
+
+    bool found=false;
+    for(const Candidate &candidate:candidates)
+    {
+        PlacementPlan plan=evaluate(candidate, gguf, sizes, layerKv, budget);
+        if(!plan.fits)
+        {
+            continue;
+        }
+        if(!found||plan.estimatedTokensPerSec>best.estimatedTokensPerSec)
+        {
+            best=plan;
+            found=true;
+        }
+    }
+
+    if(!found)
+    {
+        best=evaluate(candidates.back(), gguf, sizes, layerKv, budget);
+        best.reason="needs "+std::to_string(best.cpuMb)+"MB of host RAM, "+
+            std::to_string(budget.ramMb)+"MB free";
+    }
+    else if(best.strategy=="cpu_only")
+    {
+        best.reason=budget.gpuVramMb>0?"no layer fits in VRAM":"no usable VRAM";
+    }
+    best.contextSize=contextSize;
+
+    spdlog::debug("Placement plan: {} (ngl={}, kv_offload={}, gpu={}MB, cpu={}MB, ~{:.1f} tok/s)",
+        best.reason, best.nGpuLayers, best.kvOffload, best.gpuMb, best.cpuMb, best.estimatedTokensPerSec);
+    return best;
+}
+
+} // namespace arbiterAI
@@ -0,0 +1,61 @@
+#ifndef _ARBITERAI_PLACEMENTPLANNER_H_
+#define _ARBITERAI_PLACEMENTPLANNER_H_
+
+#include "arbiterAI/ggufReader.h"
+
+#include <string>
+#include <vector>
+#include <optional>
+#include <cstdint>
+
+namespace arbiterAI
+{
+
+/// Memory and bandwidth available to a model load.
+struct PlacementBudget {
+    int gpuVramMb=0;                // free VRAM across the GPUs the model may use
+    int ramMb=0;                    // free host RAM (0 = unchecked)
+    int computeBufferMb=512;        // GPU compute buffers when any layer is offloaded
+    double weightFactor=1.0;        // calibrated buffer size / GGUF tensor bytes
+    double gpuBandwidthGbps=0.0;    // 0 = DEFAULT_GPU_BANDWIDTH_GBPS
+    double cpuBandwidthGbps=0.0;    // 0 = DEFAULT_CPU_BANDWIDTH_GBPS
+    std::optional<bool> kvOffload;  // pinned by the user; otherwise both are tried
+};
+
+/// Where a model's tensors and KV cache go, expressed as llama.cpp options.
+struct PlacementPlan {
+    std::string strategy;                   // "full_gpu", "moe_experts_cpu", "partial_layers", "cpu_only"
+    int nGpuLayers=0;                       // -ngl (nLayer+1 includes the output layer)
+    std::vector<std::string> overrideTensor; // -ot entries: "pattern=BUFFER"
+    bool kvOffload=true;                    // KV cache of offloaded layers lives on the GPU
+    int contextSize=0;                      // context the plan was sized for
+    int gpuMb=0;                            // weights + KV + compute buffers on the GPUs
+    int cpuMb=0;                            // weights + KV in host memory
+    double estimatedTokensPerSec=0.0;       // bandwidth-bound decode estimate
+    bool fits=false;                        // false when even the best plan exceeds the budget
+    std::string reason;
+
+    /// overrideTensor joined into the comma-separated RuntimeOptions form.
+    std::string overrideTensorString() const;
+};
+
+/// Chooses GPU layer count, tensor overrides and KV placement from GGUF tensor
+/// sizes.  Decode is modelled as memory-bandwidth bound: each token reads every
+/// dense weight, the active share of MoE expert weights and the KV cache, from
+/// whichever memory holds them.  The candidate with the highest estimated
+/// tokens/sec that fits the budget wins.
+class PlacementPlanner {
+public:
+    static PlacementPlan plan(const GgufModelInfo &gguf, int contextSize,
+        double kvBytesPerElement, const PlacementBudget &budget);
+
+    /// -ot pattern moving the expert FFN tensors of the given layers to CPU.
+    static std::string expertOverridePattern(const std::vector<int> &layers);
+
+    static constexpr double DEFAULT_GPU_BANDWIDTH_GBPS=400.0;
+    static constexpr double DEFAULT_CPU_BANDWIDTH_GBPS=50.0;
+};
+
+} // namespace arbiterAI
+
+#endif//_ARBITERAI_PLACEMENTPLANNER_H_
@@ -28,23 +28,53 @@ ErrorCode Llama::completion(const CompletionRequest &request,
 {
     ModelRuntime &runtime=ModelRuntime::instance();
 
+    // Adapter models run on their base model
+    std::string baseModel;
+    std::vector<LoraSelection> loras;
+    ErrorCode loraResult=runtime.resolveLoraAdapters(request.model, request.lora.value_or(std::map<std::string, double>{}),
+        baseModel, loras);
+    if(loraResult!=ErrorCode::Success)
+    {
+        return loraResult;
+    }
+
     // Ensure model is loaded
-    ErrorCode loadResult=runtime.loadModel(request.model);
+    ErrorCode loadResult=runtime.loadModel(baseModel);
     if(loadResult!=ErrorCode::Success)
     {
         return loadResult;
     }
 
-    llama_model *llamaModel=runtime.getLlamaModel(request.model);
-    llama_context *llamaCtx=runtime.getLlamaContext(request.model);
+    // Wait for a slot in the model's admission queue
+    std::chrono::steady_clock::time_point queuedAt=std::chrono::steady_clock::now();
+    ErrorCode admitResult=runtime.admitRequest(baseModel, request.tenant.value_or(""),
+        request.priority.value_or(RequestPriority::Interactive), request.onQueuePosition);
+    if(admitResult!=ErrorCode::Success)
+    {
+        return admitResult;
+    }
+    double queueWaitMs=std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now()-queuedAt).count();
+
+    // Dispatch to the least-loaded replica of the model
+    std::string instance=runtime.acquireInstance(baseModel);
+    llama_model *llamaModel=runtime.getLlamaModel(instance);
+    llama_context *llamaCtx=runtime.getLlamaContext(instance);
 
     if(!llamaModel||!llamaCtx)
     {
         spdlog::error("Llama model handles not available for: {}", request.model);
+        runtime.endInference(instance);
+        runtime.releaseRequest(baseModel);
         return ErrorCode::ModelNotLoaded;
     }
 
-    runtime.beginInference(request.model);
+    ErrorCode applyResult=runtime.applyLoraAdapters(instance, loras);
+    if(applyResult!=ErrorCode::Success)
+    {
+        runtime.endInference(instance);
+        runtime.releaseRequest(baseModel);
+        return applyResult;
+    }
 
     std::chrono::steady_clock::time_point startTime=std::chrono::steady_clock::now();
 
@@ -54,13 +84,15 @@ ErrorCode Llama::completion(const CompletionRequest &request,
     double promptTimeMs=0.0;
     double generationTimeMs=0.0;
 
-    ErrorCode code=runInference(llamaModel, llamaCtx, request, model,
+    ErrorCode code=runInference(llamaModel, llamaCtx, instance, request, model,
         resultText, promptTokens, completionTokens, promptTimeMs, generationTimeMs, nullptr);
 
     std::chrono::steady_clock::time_point endTime=std::chrono::steady_clock::now();
     double totalTimeMs=std::chrono::duration<double, std::milli>(endTime-startTime).count();
 
-    runtime.endInference(request.model);
+    runtime.recordContextUsage(instance, promptTokens+completionTokens);
+    runtime.endInference(instance);
+    runtime.releaseRequest(baseModel);
 
     if(code==ErrorCode::Success)
     {
@@ -73,7 +105,7 @@ ErrorCode Llama::completion(const CompletionRequest &request,
         response.finishReason="stop";
 
         // Record telemetry
-        std::optional<LoadedModel> state=runtime.getModelState(request.model);
+        std::optional<LoadedModel> state=runtime.getModelState(baseModel);
 
         InferenceStats stats;
         stats.model=request.model;
@@ -83,6 +115,7 @@ ErrorCode Llama::completion(const CompletionRequest &request,
         stats.totalTimeMs=totalTimeMs;
         stats.promptTimeMs=promptTimeMs;
         stats.generationTimeMs=generationTimeMs;
+        stats.queueWaitMs=queueWaitMs;
         stats.tokensPerSecond=totalTimeMs>0.0?(completionTokens/(totalTimeMs/1000.0)):0.0;
         stats.promptTokensPerSecond=promptTimeMs>0.0?(promptTokens/(promptTimeMs/1000.0)):0.0;
         stats.generationTokensPerSecond=generationTimeMs>0.0?(completionTokens/(generationTimeMs/1000.0)):0.0;
@@ -98,29 +131,59 @@ ErrorCode Llama::streamingCompletion(const CompletionRequest &request,
 {
     ModelRuntime &runtime=ModelRuntime::instance();
 
-    ErrorCode loadResult=runtime.loadModel(request.model);
+    // Adapter models run on their base model
+    std::string baseModel;
+    std::vector<LoraSelection> loras;
+    ErrorCode loraResult=runtime.resolveLoraAdapters(request.model, request.lora.value_or(std::map<std::string, double>{}),
+        baseModel, loras);
+    if(loraResult!=ErrorCode::Success)
+    {
+        return loraResult;
+    }
+
+    ErrorCode loadResult=runtime.loadModel(baseModel);
     if(loadResult!=ErrorCode::Success)
     {
         return loadResult;
     }
 
-    llama_model *llamaModel=runtime.getLlamaModel(request.model);
-    llama_context *llamaCtx=runtime.getLlamaContext(request.model);
+    std::optional<ModelInfo> modelInfo=runtime.getLoadedModelInfo(baseModel);
+    if(!modelInfo)
+    {
+        return ErrorCode::ModelNotFound;
+    }
+
+    // Wait for a slot in the model's admission queue
+    std::chrono::steady_clock::time_point queuedAt=std::chrono::steady_clock::now();
+    ErrorCode admitResult=runtime.admitRequest(baseModel, request.tenant.value_or(""),
+        request.priority.value_or(RequestPriority::Interactive), request.onQueuePosition);
+    if(admitResult!=ErrorCode::Success)
+    {
+        return admitResult;
+    }
+    double queueWaitMs=std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now()-queuedAt).count();
+
+    // Dispatch to the least-loaded replica of the model
+    std::string instance=runtime.acquireInstance(baseModel);
+    llama_model *llamaModel=runtime.getLlamaModel(instance);
+    llama_context *llamaCtx=runtime.getLlamaContext(instance);
 
     if(!llamaModel||!llamaCtx)
     {
         spdlog::error("Llama model handles not available for: {}", request.model);
+        runtime.endInference(instance);
+        runtime.releaseRequest(baseModel);
         return ErrorCode::ModelNotLoaded;
     }
 
-    std::optional<ModelInfo> modelInfo=runtime.getLoadedModelInfo(request.model);
-    if(!modelInfo)
+    ErrorCode applyResult=runtime.applyLoraAdapters(instance, loras);
+    if(applyResult!=ErrorCode::Success)
     {
-        return ErrorCode::ModelNotFound;
+        runtime.endInference(instance);
+        runtime.releaseRequest(baseModel);
+        return applyResult;
     }
 
-    runtime.beginInference(request.model);
-
     std::chrono::steady_clock::time_point startTime=std::chrono::steady_clock::now();
 
     std::string resultText;
@@ -129,17 +192,19 @@ ErrorCode Llama::streamingCompletion(const CompletionRequest &request,
     double promptTimeMs=0.0;
     double generationTimeMs=0.0;
 
-    ErrorCode code=runInference(llamaModel, llamaCtx, request, *modelInfo,
+    ErrorCode code=runInference(llamaModel, llamaCtx, instance, request, *modelInfo,
         resultText, promptTokens, completionTokens, promptTimeMs, generationTimeMs, callback);
 
     std::chrono::steady_clock::time_point endTime=std::chrono::steady_clock::now();
     double totalTimeMs=std::chrono::duration<double, std::milli>(endTime-startTime).count();
 
-    runtime.endInference(request.model);
+    runtime.recordContextUsage(instance, promptTokens+completionTokens);
+    runtime.endInference(instance);
+    runtime.releaseRequest(baseModel);
 
     if(code==ErrorCode::Success)
     {
-        std::optional<LoadedModel> state=runtime.getModelState(request.model);
+        std::optional<LoadedModel> state=runtime.getModelState(baseModel);
 
         InferenceStats stats;
         stats.model=request.model;
@@ -149,6 +214,7 @@ ErrorCode Llama::streamingCompletion(const CompletionRequest &request,
         stats.totalTimeMs=totalTimeMs;
         stats.promptTimeMs=promptTimeMs;
         stats.generationTimeMs=generationTimeMs;
+        stats.queueWaitMs=queueWaitMs;
         stats.tokensPerSecond=totalTimeMs>0.0?(completionTokens/(totalTimeMs/1000.0)):0.0;
         stats.promptTokensPerSecond=promptTimeMs>0.0?(promptTokens/(promptTimeMs/1000.0)):0.0;
         stats.generationTokensPerSecond=generationTimeMs>0.0?(completionTokens/(generationTimeMs/1000.0)):0.0;
@@ -164,20 +230,45 @@ ErrorCode Llama::getEmbeddings(const EmbeddingRequest &request,
 {
     ModelRuntime &runtime=ModelRuntime::instance();
 
-    ErrorCode loadResult=runtime.loadModel(request.model);
+    std::string baseModel;
+    std::vector<LoraSelection> loras;
+    ErrorCode loraResult=runtime.resolveLoraAdapters(request.model, {}, baseModel, loras);
+    if(loraResult!=ErrorCode::Success)
+    {
+        return loraResult;
+    }
+
+    ErrorCode loadResult=runtime.loadModel(baseModel);
     if(loadResult!=ErrorCode::Success)
     {
         return loadResult;
     }
 
-    llama_model *llamaModel=runtime.getLlamaModel(request.model);
-    llama_context *llamaCtx=runtime.getLlamaContext(request.model);
+    ErrorCode admitResult=runtime.admitRequest(baseModel, "", RequestPriority::Interactive);
+    if(admitResult!=ErrorCode::Success)
+    {
+        return admitResult;
+    }
+
+    std::string instance=runtime.acquireInstance(baseModel);
+    llama_model *llamaModel=runtime.getLlamaModel(instance);
+    llama_context *llamaCtx=runtime.getLlamaContext(instance);
 
     if(!llamaModel||!llamaCtx)
     {
+        runtime.endInference(instance);
+        runtime.releaseRequest(baseModel);
         return ErrorCode::ModelNotLoaded;
     }
 
+    ErrorCode applyResult=runtime.applyLoraAdapters(instance, loras);
+    if(applyResult!=ErrorCode::Success)
+    {
+        runtime.endInference(instance);
+        runtime.releaseRequest(baseModel);
+        return applyResult;
+    }
+
     // Combine input text
     std::string inputText;
     std::visit([&inputText](auto &&arg)
@@ -205,12 +296,15 @@ ErrorCode Llama::getEmbeddings(const EmbeddingRequest &request,
     if(nTokens<0)
     {
         spdlog::error("Failed to tokenize embedding input");
+        runtime.endInference(instance);
+        runtime.releaseRequest(baseModel);
         return ErrorCode::GenerationError;
     }
     tokens.resize(nTokens);
 
     int nBatch=static_cast<int>(llama_n_batch(llamaCtx));
     llama_batch batch=llama_batch_init(std::max(nBatch, 512), 0, 1);
+    std::shared_ptr<CpuThreadBinding> cpuThreads=runtime.getCpuThreads(instance);
 
     for(int start=0; start<nTokens; start+=nBatch)
     {
@@ -231,10 +325,16 @@ ErrorCode Llama::getEmbeddings(const EmbeddingRequest &request,
             batch.logits[chunkSize-1]=1;
         }
 
+        if(cpuThreads)
+        {
+            runtime.applyCpuThreads(*cpuThreads, llamaCtx);
+        }
         if(llama_decode(llamaCtx, batch)!=0)
         {
             spdlog::error("llama_decode failed for embeddings (chunk at offset {})", start);
             llama_batch_free(batch);
+            runtime.endInference(instance);
+            runtime.releaseRequest(baseModel);
             return ErrorCode::GenerationError;
         }
     }
@@ -244,6 +344,8 @@ ErrorCode Llama::getEmbeddings(const EmbeddingRequest &request,
     {
         spdlog::error("llama_get_embeddings returned null");
         llama_batch_free(batch);
+        runtime.endInference(instance);
+        runtime.releaseRequest(baseModel);
         return ErrorCode::GenerationError;
     }
 
@@ -258,6 +360,8 @@ ErrorCode Llama::getEmbeddings(const EmbeddingRequest &request,
     response.data.push_back(emb);
 
     llama_batch_free(batch);
+    runtime.endInference(instance);
+    runtime.releaseRequest(baseModel);
     return ErrorCode::Success;
 }
 
@@ -350,7 +454,7 @@ std::string Llama::applyTemplate(llama_model *model,
     return result;
 }
 
-ErrorCode Llama::runInference(llama_model *model, llama_context *ctx,
+ErrorCode Llama::runInference(llama_model *model, llama_context *ctx, const std::string &instance,
     const CompletionRequest &request, const ModelInfo &modelInfo,
     std::string &result, int &promptTokens, int &completionTokens,
     double &promptTimeMs, double &generationTimeMs,
@@ -380,11 +484,26 @@ ErrorCode Llama::runInference(llama_model *model, llama_context *ctx,
     tokensList.resize(nTokens);
     promptTokens=nTokens;
 
+    // Dynamic contexts start small — grow to hold the prompt before decoding.
+    // A failed grow may still rebuild the context, so always re-fetch it
+    ModelRuntime &runtime=ModelRuntime::instance();
+    if(nTokens+1>static_cast<int>(llama_n_ctx(ctx)))
+    {
+        runtime.ensureContextCapacity(instance, nTokens+1);
+        ctx=runtime.getLlamaContext(instance);
+        if(!ctx)
+        {
+            spdlog::error("Context for '{}' was lost while growing it", instance);
+            return ErrorCode::ModelNotLoaded;
+        }
+    }
+
     // Clear KV cache for fresh inference
     llama_memory_clear(llama_get_memory(ctx), true);
 
     int nBatch=static_cast<int>(llama_n_batch(ctx));
     llama_batch batch=llama_batch_init(std::max(nBatch, 512), 0, 1);
+    std::shared_ptr<CpuThreadBinding> cpuThreads=runtime.getCpuThreads(instance);
 
     // Process prompt (timed) — chunk into n_batch-sized pieces
     std::chrono::steady_clock::time_point promptStart=std::chrono::steady_clock::now();
@@ -409,6 +528,10 @@ ErrorCode Llama::runInference(llama_model *model, llama_context *ctx,
             batch.logits[chunkSize-1]=1;
         }
 
+        if(cpuThreads)
+        {
+            runtime.applyCpuThreads(*cpuThreads, ctx);
+        }
         if(llama_decode(ctx, batch)!=0)
         {
             spdlog::error("llama_decode failed during prompt processing (chunk at offset {})", start);
@@ -500,6 +623,21 @@ ErrorCode Llama::runInference(llama_model *model, llama_context *ctx,
             }
         }
 
+        // Grow a dynamic context when generation reaches its end; the
+        // sequence so far is carried into the larger context
+        if(nCur>=static_cast<int>(llama_n_ctx(ctx)))
+        {
+            runtime.ensureContextCapacity(instance, nCur+1);
+            ctx=runtime.getLlamaContext(instance);
+            if(!ctx)
+            {
+                spdlog::error("Context for '{}' was lost while growing it", instance);
+                llama_sampler_free(samplerChain);
+                llama_batch_free(batch);
+                return ErrorCode::ModelNotLoaded;
+            }
+        }
+
         // Prepare next batch
         batch.n_tokens=1;
         batch.token[0]=nextToken;
@@ -509,6 +647,10 @@ ErrorCode Llama::runInference(llama_model *model, llama_context *ctx,
         batch.logits[0]=1;
         nCur++;
 
+        if(cpuThreads)
+        {
+            runtime.applyCpuThreads(*cpuThreads, ctx);
+        }
         if(llama_decode(ctx, batch)!=0)
         {
             spdlog::error("llama_decode failed during generation");
@@ -40,7 +40,8 @@ private:
         const std::vector<Message> &messages) const;
 
     /// Run the inference loop (shared by completion and streaming).
-    ErrorCode runInference(llama_model *model, llama_context *ctx,
+    /// instance is the runtime entry (model or replica) that owns ctx.
+    ErrorCode runInference(llama_model *model, llama_context *ctx, const std::string &instance,
         const CompletionRequest &request, const ModelInfo &modelInfo,
         std::string &result, int &promptTokens, int &completionTokens,
         double &promptTimeMs, double &generationTimeMs,
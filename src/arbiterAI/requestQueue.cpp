@@ -0,0 +1,231 @@
+#include "arbiterAI/requestQueue.h"
+
+#include <algorithm>
+#include <tuple>
+
+namespace arbiterAI
+{
+
+void RequestQueue::reset()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_config=RequestQueueConfig{};
+    m_queues.clear();
+    m_changed.notify_all();
+}
+
+void RequestQueue::setConfig(const RequestQueueConfig &config)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_config=config;
+    m_config.slotsPerInstance=std::max(1, m_config.slotsPerInstance);
+    m_config.maxDepth=std::max(0, m_config.maxDepth);
+    m_config.maxPerTenant=std::max(0, m_config.maxPerTenant);
+    m_changed.notify_all();
+}
+
+RequestQueueConfig RequestQueue::getConfig() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_config;
+}
+
+void RequestQueue::setInstances(const std::string &model, int instances)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    ModelQueue &queue=m_queues[model];
+    if(queue.instances!=instances)
+    {
+        queue.instances=std::max(1, instances);
+        m_changed.notify_all();
+    }
+}
+
+ErrorCode RequestQueue::checkAdmission(const std::string &model, const std::string &tenant) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it=m_queues.find(model);
+    if(it==m_queues.end())
+    {
+        return ErrorCode::Success;
+    }
+
+    const ModelQueue &queue=it->second;
+    if(queue.waiting.empty()&&queue.running<slots(queue))
+    {
+        return ErrorCode::Success;
+    }
+    if(m_config.maxDepth>0&&static_cast<int>(queue.waiting.size())>=m_config.maxDepth)
+    {
+        return ErrorCode::QueueFull;
+    }
+
+    int tenantWaiting=static_cast<int>(std::count_if(queue.waiting.begin(), queue.waiting.end(),
+        [&tenant](const Waiter &waiter)
+        {
+            return waiter.tenant==tenant;
+        }));
+    if(m_config.maxPerTenant>0&&tenantWaiting>=m_config.maxPerTenant)
+    {
+        return ErrorCode::TooManyRequests;
+    }
+    return ErrorCode::Success;
+}
+
+ErrorCode RequestQueue::acquire(const std::string &model, const std::string &tenant, RequestPriority priority,
+    const std::function<void(int)> &onPosition)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    {
+        ModelQueue &queue=m_queues[model];
+        if(queue.waiting.empty()&&queue.running<slots(queue))
+        {
+            queue.running++;
+            charge(queue, tenant);
+            return ErrorCode::Success;
+        }
+    }
+
+    lock.unlock();
+    ErrorCode admission=checkAdmission(model, tenant);
+    lock.lock();
+    if(admission!=ErrorCode::Success)
+    {
+        return admission;
+    }
+
+    Waiter waiter;
+    waiter.id=m_nextId++;
+    waiter.tenant=tenant;
+    waiter.priority=priority;
+    m_queues[model].waiting.push_back(waiter);
+
+    int reported=0;
+    while(true)
+    {
+        ModelQueue &queue=m_queues[model];
+        std::vector<uint64_t> order=admissionOrder(queue);
+        auto it=std::find(order.begin(), order.end(), waiter.id);
+        if(it==order.end())
+        {
+            // Dropped by reset()
+            queue.running++;
+            return ErrorCode::Success;
+        }
+
+        int position=static_cast<int>(it-order.begin())+1;
+        if(position<=slots(queue)-queue.running)
+        {
+            queue.waiting.erase(std::remove_if(queue.waiting.begin(), queue.waiting.end(),
+                [&waiter](const Waiter &entry)
+                {
+                    return entry.id==waiter.id;
+                }), queue.waiting.end());
+            queue.running++;
+            charge(queue, tenant);
+
+            // The next waiter's position moved up
+            m_changed.notify_all();
+            return ErrorCode::Success;
+        }
+
+        if(onPosition&&position!=reported)
+        {
+            reported=position;
+            lock.unlock();
+            onPosition(position);
+            lock.lock();
+            continue;
+        }
+        m_changed.wait(lock);
+    }
+}
+
+void RequestQueue::release(const std::string &model)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it=m_queues.find(model);
+    if(it!=m_queues.end()&&it->second.running>0)
+    {
+        it->second.running--;
+        m_changed.notify_all();
+    }
+}
+
+RequestQueueStats RequestQueue::stats(const std::string &model) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    RequestQueueStats result;
+    auto it=m_queues.find(model);
+    if(it==m_queues.end())
+    {
+        result.slots=m_config.slotsPerInstance;
+        return result;
+    }
+    result.waiting=static_cast<int>(it->second.waiting.size());
+    result.running=it->second.running;
+    result.slots=slots(it->second);
+    return result;
+}
+
+std::vector<uint64_t> RequestQueue::admissionOrder(const ModelQueue &queue) const
+{
+    // NOTE: caller must hold m_mutex
+
+    // A tenant's n-th waiting request starts n/weight after its last
+    // admission (or the current virtual clock, if the tenant was idle)
+    std::map<std::string, double> nextStart;
+    std::vector<std::tuple<int, double, uint64_t>> keys;
+    keys.reserve(queue.waiting.size());
+    for(const Waiter &waiter:queue.waiting)
+    {
+        auto next=nextStart.find(waiter.tenant);
+        if(next==nextStart.end())
+        {
+            auto finish=queue.tenantFinish.find(waiter.tenant);
+            double start=std::max(queue.virtualClock, finish!=queue.tenantFinish.end()?finish->second:0.0);
+            next=nextStart.emplace(waiter.tenant, start).first;
+        }
+
+        keys.emplace_back(static_cast<int>(waiter.priority), next->second, waiter.id);
+        next->second+=1.0/weight(waiter.tenant);
+    }
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<uint64_t> order;
+    order.reserve(keys.size());
+    for(const auto &key:keys)
+    {
+        order.push_back(std::get<2>(key));
+    }
+    return order;
+}
+
+void RequestQueue::charge(ModelQueue &queue, const std::string &tenant)
+{
+    // NOTE: caller must hold m_mutex
+
+    double &finish=queue.tenantFinish[tenant];
+    double start=std::max(queue.virtualClock, finish);
+    queue.virtualClock=start;
+    finish=start+1.0/weight(tenant);
+}
+
+double RequestQueue::weight(const std::string &tenant) const
+{
+    auto it=m_config.tenantWeights.find(tenant);
+    return it!=m_config.tenantWeights.end()&&it->second>0.0?it->second:1.0;
+}
+
+int RequestQueue::slots(const ModelQueue &queue) const
+{
+    return queue.instances*m_config.slotsPerInstance;
+}
+
+} // namespace arbiterAI
@@ -0,0 +1,107 @@
+#ifndef _ARBITERAI_REQUESTQUEUE_H_
+#define _ARBITERAI_REQUESTQUEUE_H_
+
+#include "arbiterAI/arbiterAI.h"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <cstdint>
+
+namespace arbiterAI
+{
+
+/// Admission limits shared by every model's queue.
+struct RequestQueueConfig {
+    int slotsPerInstance=1;     // requests one loaded instance (model or replica) runs at a time
+    int maxDepth=64;            // waiting requests per model before QueueFull (0 = no limit)
+    int maxPerTenant=0;         // waiting requests per tenant per model before TooManyRequests (0 = no limit)
+    std::map<std::string, double> tenantWeights; // fair-share weight by tenant (default 1)
+};
+
+/// Waiting and running requests of one model.
+struct RequestQueueStats {
+    int waiting=0;
+    int running=0;
+    int slots=0;
+};
+
+/// Admission queue in front of local models.  Each model runs at most
+/// slotsPerInstance requests per loaded instance; further requests wait.
+/// Interactive requests are always admitted before batch requests.  Within
+/// a priority, tenants (API keys) share the model by weight: each admission
+/// advances the tenant's virtual time by 1/weight and the waiting request
+/// with the lowest virtual start time goes next (start-time fair queuing).
+class RequestQueue {
+public:
+    RequestQueue()=default;
+
+    RequestQueue(const RequestQueue &)=delete;
+    RequestQueue &operator=(const RequestQueue &)=delete;
+
+    /// Forget every queue and restore the default config.  Must not be
+    /// called while requests are waiting.
+    void reset();
+
+    void setConfig(const RequestQueueConfig &config);
+    RequestQueueConfig getConfig() const;
+
+    /// Set how many instances of a model are loaded (slots = instances x
+    /// slotsPerInstance).  Waiters are re-checked when it grows.
+    void setInstances(const std::string &model, int instances);
+
+    /// Check whether a new request would be accepted right now.
+    /// @return Success, QueueFull or TooManyRequests.
+    ErrorCode checkAdmission(const std::string &model, const std::string &tenant) const;
+
+    /// Wait until the request may run.  onPosition is called (without the
+    /// queue lock) with the 1-based queue position each time it changes
+    /// while waiting; it is not called for requests admitted immediately.
+    /// @return Success once admitted (pair with release()), QueueFull when
+    ///         maxDepth requests are waiting, TooManyRequests when the tenant
+    ///         has maxPerTenant requests waiting.
+    ErrorCode acquire(const std::string &model, const std::string &tenant, RequestPriority priority,
+        const std::function<void(int)> &onPosition=nullptr);
+
+    /// An admitted request finished.
+    void release(const std::string &model);
+
+    RequestQueueStats stats(const std::string &model) const;
+
+private:
+    struct Waiter {
+        uint64_t id=0;
+        std::string tenant;
+        RequestPriority priority=RequestPriority::Interactive;
+    };
+
+    struct ModelQueue {
+        std::vector<Waiter> waiting;                // arrival order
+        int running=0;
+        int instances=1;
+        double virtualClock=0.0;                    // virtual start time of the last admission
+        std::map<std::string, double> tenantFinish; // virtual finish time of each tenant's last admission
+    };
+
+    /// Waiter ids in admission order (caller holds m_mutex).
+    std::vector<uint64_t> admissionOrder(const ModelQueue &queue) const;
+
+    /// Charge an admission to a tenant's virtual time (caller holds m_mutex).
+    void charge(ModelQueue &queue, const std::string &tenant);
+
+    double weight(const std::string &tenant) const;
+    int slots(const ModelQueue &queue) const;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_changed;
+    RequestQueueConfig m_config;
+    std::map<std::string, ModelQueue> m_queues;
+    uint64_t m_nextId=1;
+};
+
+} // namespace arbiterAI
+
+#endif//_ARBITERAI_REQUESTQUEUE_H_
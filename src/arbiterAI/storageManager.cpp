@@ -1,10 +1,14 @@
 #include "arbiterAI/storageManager.h"
 #include "arbiterAI/modelRuntime.h"
+#include "arbiterAI/telemetryCollector.h"
 
 #include <spdlog/spdlog.h>
 #include <nlohmann/json.hpp>
 #include <fstream>
 #include <algorithm>
+#include <map>
+#include <set>
+#include <cctype>
 
 namespace arbiterAI
 {
@@ -45,6 +49,43 @@ std::string formatBytes(int64_t bytes)
     return std::to_string(bytes)+" B";
 }
 
+bool isGgufName(const std::string &filename)
+{
+    return filename.size()>5&&filename.compare(filename.size()-5, 5, ".gguf")==0;
+}
+
+/// Split "<base>-00001-of-00003.gguf" into its base, shard number and count.
+bool parseShardName(const std::string &filename, std::string &base, int &index, int &count)
+{
+    // "-00001-of-00003.gguf"
+    constexpr size_t suffixLength=20;
+    if(filename.size()<=suffixLength||!isGgufName(filename))
+    {
+        return false;
+    }
+
+    std::string suffix=filename.substr(filename.size()-suffixLength);
+    if(suffix[0]!='-'||suffix.compare(6, 4, "-of-")!=0)
+    {
+        return false;
+    }
+    for(size_t i:{1, 2, 3, 4, 5, 10, 11, 12, 13, 14})
+    {
+        if(!std::isdigit(static_cast<unsigned char>(suffix[i])))
+        {
+            return false;
+        }
+    }
+
+    index=std::stoi(suffix.substr(1, 5));
+    count=std::stoi(suffix.substr(10, 5));
+    base=filename.substr(0, filename.size()-suffixLength);
+    return index>=1&&index<=count;
+}
+
+// Journal records folded in before the journal is compacted early
+constexpr size_t journalCompactRecords=4096;
+
 } // anonymous namespace
 
 StorageManager &StorageManager::instance()
@@ -58,10 +99,17 @@ void StorageManager::reset()
     StorageManager &mgr=instance();
 
     mgr.shutdown();
+    mgr.m_warmer.clear();
+    mgr.m_warmer.setLockBudget(0);
+    mgr.m_rewarmIntervalSeconds=30;
 
     std::lock_guard<std::mutex> lock(mgr.m_mutex);
     mgr.m_entries.clear();
     mgr.m_modelsDir.clear();
+    mgr.m_blobs.setRoot({});
+    mgr.m_index.clear();
+    mgr.m_usageCounters.clear();
+    mgr.m_journal.close();
     mgr.m_storageLimitBytes=0;
     mgr.m_initialized=false;
     mgr.m_dirty=false;
@@ -75,10 +123,14 @@ StorageManager::~StorageManager()
 
 void StorageManager::initialize(const std::filesystem::path &modelsDir)
 {
+    // The watcher's callback takes m_mutex, so stop it before locking
+    m_watcher.stop();
+
     std::lock_guard<std::mutex> lock(m_mutex);
 
     // Clear any existing state from a previous initialize() call
     m_entries.clear();
+    m_warmer.clear();
     m_dirty=false;
 
     m_modelsDir=modelsDir;
@@ -88,17 +140,42 @@ void StorageManager::initialize(const std::filesystem::path &modelsDir)
         std::filesystem::create_directories(m_modelsDir);
     }
 
-    loadUsageData();
+    m_blobs.setRoot(m_modelsDir/"blobs");
+
+    uint64_t snapshotSequence=loadUsageData();
+    replayUsageJournal(snapshotSequence);
+    m_index.load(m_modelsDir/"models_index.json");
     scanModelsDirectory();
+    for(ModelFileEntry &entry:m_entries)
+    {
+        dropStaleHashes(entry);
+        adoptEntryFiles(entry);
+        indexEntryFiles(entry);
+        holdIfHotReady(entry);
+    }
+
+    // Blobs whose model files were all deleted outside the server
+    int64_t orphaned=m_blobs.collectGarbage();
+    if(orphaned>0)
+    {
+        spdlog::info("StorageManager: removed {} of unreferenced blobs", formatBytes(orphaned));
+    }
     m_initialized=true;
 
     spdlog::info("StorageManager initialized: modelsDir={}", m_modelsDir.string());
 
+    m_watcher.start(m_modelsDir, [this](const std::vector<DirectoryChange> &changes, bool overflowed)
+    {
+        onDirectoryChanged(changes, overflowed);
+    });
+
     startBackgroundTimer();
 }
 
 void StorageManager::shutdown()
 {
+    m_watcher.stop();
+
     m_timerRunning=false;
     if(m_timerThread.joinable())
     {
@@ -106,6 +183,9 @@ void StorageManager::shutdown()
     }
 
     flush();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_journal.close();
 }
 
 void StorageManager::setStorageLimit(int64_t limitBytes)
@@ -143,13 +223,28 @@ StorageInfo StorageManager::getStorageInfo() const
         }
     }
 
-    // Sum model file sizes
+    // Sum model file sizes, counting content shared between entries once
     int64_t usedBytes=0;
     for(const ModelFileEntry &entry:m_entries)
     {
         usedBytes+=entry.fileSizeBytes;
     }
+    info.deduplicatedBytes=sharedBytes();
+    usedBytes-=info.deduplicatedBytes;
     info.usedByModelsBytes=usedBytes;
+
+    std::set<std::string> blobs;
+    for(const ModelFileEntry &entry:m_entries)
+    {
+        for(const std::string &hash:entry.fileHashes)
+        {
+            if(m_blobs.contains(hash))
+            {
+                blobs.insert(hash);
+            }
+        }
+    }
+    info.blobCount=static_cast<int>(blobs.size());
     info.modelCount=static_cast<int>(m_entries.size());
 
     // Calculate available space
@@ -192,27 +287,51 @@ void StorageManager::registerDownload(const std::string &modelName,
     const std::string &variant,
     const std::string &filename,
     int64_t fileSizeBytes,
-    const std::vector<std::string> &additionalFiles)
+    const std::vector<std::string> &additionalFiles,
+    const std::vector<std::string> &fileHashes)
 {
     std::lock_guard<std::mutex> lock(m_mutex);
 
+    // A taken-over entry carries its usage, including what isn't folded yet
+    foldUsage();
+
     // Check if entry already exists
     ModelFileEntry *existing=findEntry(modelName, variant);
     if(existing)
     {
         existing->filename=filename;
         existing->additionalFiles=additionalFiles;
+        existing->fileHashes=fileHashes;
         existing->fileSizeBytes=fileSizeBytes;
         existing->downloadedAt=std::chrono::system_clock::now();
+        adoptEntryFiles(*existing);
+        indexEntryFiles(*existing);
+        holdIfHotReady(*existing);
         m_dirty=true;
         return;
     }
 
+    // The directory watcher may have seen the file land first and filed it
+    // under a name guessed from the filename; the download's name wins
+    ModelFileEntry discovered;
+    bool takeOver=false;
+    for(auto it=m_entries.begin(); it!=m_entries.end(); ++it)
+    {
+        if(it->filename==filename)
+        {
+            discovered=*it;
+            takeOver=true;
+            m_entries.erase(it);
+            break;
+        }
+    }
+
     ModelFileEntry entry;
     entry.modelName=modelName;
     entry.variant=variant;
     entry.filename=filename;
     entry.additionalFiles=additionalFiles;
+    entry.fileHashes=fileHashes;
     entry.fileSizeBytes=fileSizeBytes;
     entry.downloadedAt=std::chrono::system_clock::now();
     entry.lastUsedAt=std::chrono::system_clock::now();
@@ -220,6 +339,19 @@ void StorageManager::registerDownload(const std::string &modelName,
     entry.hotReady=false;
     entry.isProtected=false;
 
+    if(takeOver)
+    {
+        spdlog::info("StorageManager: {} (found as {} variant {}) is {} variant {}",
+            filename, discovered.modelName, discovered.variant, modelName, variant);
+        entry.lastUsedAt=discovered.lastUsedAt;
+        entry.usageCount=discovered.usageCount;
+        entry.hotReady=discovered.hotReady;
+        entry.isProtected=discovered.isProtected;
+    }
+
+    adoptEntryFiles(entry);
+    indexEntryFiles(entry);
+    holdIfHotReady(entry);
     m_entries.push_back(entry);
     m_dirty=true;
 
@@ -235,8 +367,39 @@ void StorageManager::registerDownload(const std::string &modelName,
     }
 }
 
+bool StorageManager::linkFromStore(const std::string &sha256, const std::filesystem::path &path)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if(!m_blobs.link(sha256, path))
+    {
+        return false;
+    }
+    spdlog::info("StorageManager: linked {} to stored blob {}; no download needed",
+        path.filename().string(), sha256.substr(0, 12));
+    return true;
+}
+
+std::optional<std::filesystem::path> StorageManager::getBlobPath(const std::string &sha256) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if(!m_blobs.contains(sha256))
+    {
+        return std::nullopt;
+    }
+    return m_blobs.blobPath(sha256);
+}
+
 void StorageManager::recordUsage(const std::string &modelName, const std::string &variant)
 {
+    // Called for every inference: count without taking m_mutex
+    if(m_usageCounters.record(UsageCounters::keyFor(modelName, variant), std::chrono::system_clock::now()))
+    {
+        return;
+    }
+
+    // Counter table full (more variants than slots): record directly
     std::lock_guard<std::mutex> lock(m_mutex);
 
     ModelFileEntry *entry=findEntry(modelName, variant);
@@ -253,7 +416,11 @@ bool StorageManager::deleteModelFile(const std::string &modelName, const std::st
 {
     std::lock_guard<std::mutex> lock(m_mutex);
 
+    // Settle pending usage so it can't land on a variant downloaded again
+    foldUsage();
+
     freedBytes=0;
+    bool deleted=false;
 
     if(variant.empty())
     {
@@ -284,35 +451,11 @@ bool StorageManager::deleteModelFile(const std::string &modelName, const std::st
         {
             ModelFileEntry &entry=m_entries[*it];
 
-            // Delete primary file
-            std::filesystem::path filePath=m_modelsDir/entry.filename;
-
-            std::error_code ec;
-            if(std::filesystem::exists(filePath, ec))
-            {
-                std::filesystem::remove(filePath, ec);
-                if(ec)
-                {
-                    spdlog::error("StorageManager: failed to delete file {}: {}", filePath.string(), ec.message());
-                    return false;
-                }
-            }
-
-            // Delete additional shard files
-            for(const std::string &extraFile:entry.additionalFiles)
+            if(!removeEntryFiles(entry, freedBytes))
             {
-                std::filesystem::path extraPath=m_modelsDir/extraFile;
-                if(std::filesystem::exists(extraPath, ec))
-                {
-                    std::filesystem::remove(extraPath, ec);
-                    if(ec)
-                    {
-                        spdlog::warn("StorageManager: failed to delete shard {}: {}", extraPath.string(), ec.message());
-                    }
-                }
+                return false;
             }
-
-            freedBytes+=entry.fileSizeBytes;
+            deleted=true;
             spdlog::info("StorageManager: deleted {} variant {} ({})",
                 entry.modelName, entry.variant, formatBytes(entry.fileSizeBytes));
             m_entries.erase(m_entries.begin()+static_cast<ptrdiff_t>(*it));
@@ -331,35 +474,11 @@ bool StorageManager::deleteModelFile(const std::string &modelName, const std::st
                     return false;
                 }
 
-                // Delete primary file
-                std::filesystem::path filePath=m_modelsDir/it->filename;
-
-                std::error_code ec;
-                if(std::filesystem::exists(filePath, ec))
+                if(!removeEntryFiles(*it, freedBytes))
                 {
-                    std::filesystem::remove(filePath, ec);
-                    if(ec)
-                    {
-                        spdlog::error("StorageManager: failed to delete file {}: {}", filePath.string(), ec.message());
-                        return false;
-                    }
-                }
-
-                // Delete additional shard files
-                for(const std::string &extraFile:it->additionalFiles)
-                {
-                    std::filesystem::path extraPath=m_modelsDir/extraFile;
-                    if(std::filesystem::exists(extraPath, ec))
-                    {
-                        std::filesystem::remove(extraPath, ec);
-                        if(ec)
-                        {
-                            spdlog::warn("StorageManager: failed to delete shard {}: {}", extraPath.string(), ec.message());
-                        }
-                    }
+                    return false;
                 }
-
-                freedBytes=it->fileSizeBytes;
+                deleted=true;
                 spdlog::info("StorageManager: deleted {} variant {} ({})",
                     modelName, variant, formatBytes(it->fileSizeBytes));
                 m_entries.erase(it);
@@ -368,13 +487,12 @@ bool StorageManager::deleteModelFile(const std::string &modelName, const std::st
         }
     }
 
-    if(freedBytes>0)
+    if(deleted)
     {
-        m_dirty=true;
-        saveUsageData();
+        compactUsage();
     }
 
-    return freedBytes>0;
+    return deleted;
 }
 
 bool StorageManager::setHotReady(const std::string &modelName, const std::string &variant, bool enabled)
@@ -388,10 +506,44 @@ bool StorageManager::setHotReady(const std::string &modelName, const std::string
     }
 
     entry->hotReady=enabled;
+    if(enabled)
+    {
+        holdIfHotReady(*entry);
+    }
+    else
+    {
+        m_warmer.release(entry->filename);
+    }
     m_dirty=true;
     return true;
 }
 
+void StorageManager::setHotReadyLockBudget(int64_t bytes)
+{
+    m_warmer.setLockBudget(bytes);
+}
+
+int64_t StorageManager::getHotReadyLockBudget() const
+{
+    return m_warmer.getLockBudget();
+}
+
+void StorageManager::setHotReadyRewarmInterval(int seconds)
+{
+    m_rewarmIntervalSeconds=std::max(0, seconds);
+}
+
+std::vector<FileResidency> StorageManager::getResidency(const DownloadedModelFile &file) const
+{
+    std::vector<FileResidency> result;
+    result.push_back(m_warmer.residency(file.filePath.string()));
+    for(const std::string &extraFile:file.additionalFiles)
+    {
+        result.push_back(m_warmer.residency((file.filePath.parent_path()/extraFile).string()));
+    }
+    return result;
+}
+
 bool StorageManager::setProtected(const std::string &modelName, const std::string &variant, bool enabled)
 {
     std::lock_guard<std::mutex> lock(m_mutex);
@@ -451,13 +603,20 @@ void StorageManager::flush()
 {
     std::lock_guard<std::mutex> lock(m_mutex);
 
-    if(!m_initialized||!m_dirty)
+    if(!m_initialized)
     {
         return;
     }
 
-    saveUsageData();
-    m_dirty=false;
+    foldUsage();
+    if(m_dirty||m_journal.recordCount()>0)
+    {
+        compactUsage();
+    }
+    if(m_index.isDirty())
+    {
+        m_index.save(m_modelsDir/"models_index.json");
+    }
 }
 
 void StorageManager::scanModelsDirectory()
@@ -469,87 +628,142 @@ void StorageManager::scanModelsDirectory()
         return;
     }
 
-    std::error_code ec;
+    if(!m_index.refresh(m_modelsDir, [this](const std::string &filename) { return isIndexedName(filename); }))
+    {
+        return;
+    }
+
+    removeMissingEntries();
+    registerUntrackedFiles();
+}
 
-    for(const std::filesystem::directory_entry &dirEntry:std::filesystem::directory_iterator(m_modelsDir, ec))
+void StorageManager::onDirectoryChanged(const std::vector<DirectoryChange> &changes, bool overflowed)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if(!m_initialized)
     {
-        if(!dirEntry.is_regular_file())
+        return;
+    }
+
+    if(overflowed)
+    {
+        scanModelsDirectory();
+        return;
+    }
+
+    bool relevant=false;
+    std::set<std::string> gone;
+    for(const DirectoryChange &change:changes)
+    {
+        if(!isIndexedName(change.filename))
         {
             continue;
         }
+        relevant=true;
 
-        std::string filename=dirEntry.path().filename().string();
-
-        // Only track GGUF files
-        if(filename.size()<5||filename.substr(filename.size()-5)!=".gguf")
+        std::optional<IndexedFile> before;
+        if(const IndexedFile *known=m_index.find(change.filename))
+        {
+            before=*known;
+        }
+        std::optional<IndexedFile> now=m_index.update(m_modelsDir, change.filename);
+        if(!now)
+        {
+            gone.insert(change.filename);
+            continue;
+        }
+        if(before&&before->sameVersion(*now))
         {
             continue;
         }
 
-        // Check if already tracked (as primary or additional file)
-        bool found=false;
-        for(const ModelFileEntry &entry:m_entries)
+        // A tracked file rewritten or replaced: take its new size, and stop
+        // vouching for its hash unless it is now a link to the stored blob
+        for(ModelFileEntry &entry:m_entries)
         {
-            if(entry.filename==filename)
+            std::vector<std::string> names{entry.filename};
+            names.insert(names.end(), entry.additionalFiles.begin(), entry.additionalFiles.end());
+            std::vector<std::string>::iterator name=std::find(names.begin(), names.end(), change.filename);
+            if(name==names.end())
             {
-                found=true;
-                break;
+                continue;
             }
-            for(const std::string &extra:entry.additionalFiles)
+
+            size_t fileIndex=static_cast<size_t>(name-names.begin());
+            if(fileIndex<entry.fileHashes.size()&&!entry.fileHashes[fileIndex].empty())
             {
-                if(extra==filename)
+                std::string &hash=entry.fileHashes[fileIndex];
+                if(m_blobs.isLinked(hash, m_modelsDir/change.filename))
                 {
-                    found=true;
-                    break;
+                    m_index.setHash(change.filename, hash);
+                }
+                else
+                {
+                    spdlog::warn("StorageManager: {} changed on disk; its sha256 is no longer trusted", change.filename);
+                    hash.clear();
+                    m_dirty=true;
                 }
             }
-            if(found) break;
-        }
-
-        if(!found)
-        {
-            // New file discovered on disk — add with unknown model/variant
-            ModelFileEntry entry;
-            entry.filename=filename;
-            entry.fileSizeBytes=static_cast<int64_t>(dirEntry.file_size(ec));
-            entry.downloadedAt=std::chrono::system_clock::now();
-            entry.lastUsedAt=std::chrono::system_clock::now();
 
-            // Try to infer model name and variant from filename
-            // Typical pattern: ModelName-VariantName.gguf
-            std::string stem=filename.substr(0, filename.size()-5);
-            size_t lastDash=stem.rfind('-');
-            if(lastDash!=std::string::npos&&lastDash>0)
+            int64_t total=0;
+            for(const std::string &file:names)
             {
-                entry.modelName=stem.substr(0, lastDash);
-                entry.variant=stem.substr(lastDash+1);
+                const IndexedFile *record=m_index.find(file);
+                total+=record?record->sizeBytes:0;
             }
-            else
+            if(total!=entry.fileSizeBytes)
             {
-                entry.modelName=stem;
-                entry.variant="default";
+                spdlog::info("StorageManager: {} variant {} is now {} on disk",
+                    entry.modelName, entry.variant, formatBytes(total));
+                entry.fileSizeBytes=total;
+                m_dirty=true;
             }
+        }
+    }
 
-            m_entries.push_back(entry);
-            m_dirty=true;
-
-            spdlog::info("StorageManager: discovered untracked GGUF file: {} ({})",
-                filename, formatBytes(entry.fileSizeBytes));
+    if(relevant)
+    {
+        if(!gone.empty())
+        {
+            removeMissingEntries(gone);
         }
+        registerUntrackedFiles();
     }
+}
+
+void StorageManager::removeMissingEntries(const std::set<std::string> &candidates)
+{
+    // NOTE: caller must hold m_mutex
+
+    foldUsage();
 
-    // Remove entries for files that no longer exist on disk
     auto removeIt=std::remove_if(m_entries.begin(), m_entries.end(),
-        [this](const ModelFileEntry &entry)
+        [this, &candidates](const ModelFileEntry &entry)
         {
-            std::filesystem::path filePath=m_modelsDir/entry.filename;
-            std::error_code ec;
-            bool exists=std::filesystem::exists(filePath, ec);
-            if(!exists)
+            std::vector<std::string> names{entry.filename};
+            names.insert(names.end(), entry.additionalFiles.begin(), entry.additionalFiles.end());
+
+            std::string missing;
+            for(const std::string &name:names)
+            {
+                if(candidates.empty()||candidates.count(name)>0)
+                {
+                    if(!m_index.find(name))
+                    {
+                        missing=name;
+                        break;
+                    }
+                }
+            }
+            if(missing.empty())
             {
-                spdlog::info("StorageManager: removing entry for missing file: {}", entry.filename);
+                return false;
             }
-            return !exists;
+
+            spdlog::info("StorageManager: removing entry for missing file: {}", missing);
+            m_warmer.release(entry.filename);
+            return true;
         });
 
     if(removeIt!=m_entries.end())
@@ -559,6 +773,178 @@ void StorageManager::scanModelsDirectory()
     }
 }
 
+void StorageManager::registerUntrackedFiles()
+{
+    // NOTE: caller must hold m_mutex
+
+    std::set<std::string> tracked;
+    for(const ModelFileEntry &entry:m_entries)
+    {
+        tracked.insert(entry.filename);
+        tracked.insert(entry.additionalFiles.begin(), entry.additionalFiles.end());
+    }
+
+    // Shards of a split GGUF are one entry, registered once all are present
+    struct ShardSet {
+        int count=0;
+        std::map<int, std::string> shards;
+    };
+    std::map<std::string, ShardSet> shardSets;
+
+    auto addEntry=[this](const std::string &stem, const std::string &filename, const std::vector<std::string> &additionalFiles)
+    {
+        ModelFileEntry entry;
+        entry.filename=filename;
+        entry.additionalFiles=additionalFiles;
+        entry.downloadedAt=std::chrono::system_clock::now();
+        entry.lastUsedAt=std::chrono::system_clock::now();
+
+        std::vector<std::string> names{filename};
+        names.insert(names.end(), additionalFiles.begin(), additionalFiles.end());
+        for(const std::string &name:names)
+        {
+            const IndexedFile *record=m_index.find(name);
+            entry.fileSizeBytes+=record?record->sizeBytes:0;
+        }
+
+        // Try to infer model name and variant from filename
+        // Typical pattern: ModelName-VariantName.gguf
+        size_t lastDash=stem.rfind('-');
+        if(lastDash!=std::string::npos&&lastDash>0)
+        {
+            entry.modelName=stem.substr(0, lastDash);
+            entry.variant=stem.substr(lastDash+1);
+        }
+        else
+        {
+            entry.modelName=stem;
+            entry.variant="default";
+        }
+
+        m_entries.push_back(entry);
+        m_dirty=true;
+
+        if(additionalFiles.empty())
+        {
+            spdlog::info("StorageManager: discovered untracked GGUF file: {} ({})",
+                filename, formatBytes(entry.fileSizeBytes));
+        }
+        else
+        {
+            spdlog::info("StorageManager: discovered untracked split GGUF: {} ({}, {} files)",
+                filename, formatBytes(entry.fileSizeBytes), names.size());
+        }
+    };
+
+    for(const std::string &filename:m_index.filenames())
+    {
+        if(tracked.count(filename)>0||!isGgufName(filename))
+        {
+            continue;
+        }
+
+        std::string base;
+        int index=0;
+        int count=0;
+        if(parseShardName(filename, base, index, count)&&count>1)
+        {
+            ShardSet &set=shardSets[base+"/"+std::to_string(count)];
+            set.count=count;
+            set.shards[index]=filename;
+            continue;
+        }
+
+        addEntry(filename.substr(0, filename.size()-5), filename, {});
+    }
+
+    for(auto it=shardSets.begin(); it!=shardSets.end(); ++it)
+    {
+        const ShardSet &set=it->second;
+        if(static_cast<int>(set.shards.size())!=set.count)
+        {
+            continue;   // still being copied in, or incomplete
+        }
+
+        std::vector<std::string> additionalFiles;
+        for(auto shard=std::next(set.shards.begin()); shard!=set.shards.end(); ++shard)
+        {
+            additionalFiles.push_back(shard->second);
+        }
+        addEntry(it->first.substr(0, it->first.rfind('/')), set.shards.begin()->second, additionalFiles);
+    }
+}
+
+void StorageManager::indexEntryFiles(const ModelFileEntry &entry)
+{
+    // NOTE: caller must hold m_mutex
+
+    // Unhashed files are indexed by the scan and the watcher; hashed ones
+    // are re-stat()ed here since adopting them may have relinked them
+    std::vector<std::string> names{entry.filename};
+    names.insert(names.end(), entry.additionalFiles.begin(), entry.additionalFiles.end());
+    for(size_t i=0; i<names.size()&&i<entry.fileHashes.size(); ++i)
+    {
+        if(BlobStore::isValidHash(entry.fileHashes[i])&&m_index.update(m_modelsDir, names[i]))
+        {
+            m_index.setHash(names[i], entry.fileHashes[i]);
+        }
+    }
+}
+
+void StorageManager::dropStaleHashes(ModelFileEntry &entry)
+{
+    // NOTE: caller must hold m_mutex
+
+    std::vector<std::string> names{entry.filename};
+    names.insert(names.end(), entry.additionalFiles.begin(), entry.additionalFiles.end());
+    for(size_t i=0; i<names.size()&&i<entry.fileHashes.size(); ++i)
+    {
+        std::string &hash=entry.fileHashes[i];
+        if(hash.empty())
+        {
+            continue;
+        }
+
+        // Unchanged since verified, or it is the stored blob itself
+        const IndexedFile *record=m_index.find(names[i]);
+        if(record&&record->sha256==hash&&m_index.isCurrent(m_modelsDir, names[i]))
+        {
+            continue;
+        }
+        if(m_blobs.isLinked(hash, m_modelsDir/names[i]))
+        {
+            continue;
+        }
+        if(record&&record->sha256.empty()&&m_index.isCurrent(m_modelsDir, names[i]))
+        {
+            continue;   // indexed before its hash was recorded
+        }
+
+        spdlog::warn("StorageManager: {} changed since it was verified; its sha256 is no longer trusted", names[i]);
+        hash.clear();
+        m_dirty=true;
+    }
+}
+
+bool StorageManager::isIndexedName(const std::string &filename) const
+{
+    // NOTE: caller must hold m_mutex
+
+    if(isGgufName(filename))
+    {
+        return true;
+    }
+    for(const ModelFileEntry &entry:m_entries)
+    {
+        if(entry.filename==filename||
+            std::find(entry.additionalFiles.begin(), entry.additionalFiles.end(), filename)!=entry.additionalFiles.end())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 // ========== Cleanup ==========
 
 void StorageManager::setCleanupPolicy(const CleanupPolicy &policy)
@@ -588,6 +974,7 @@ int64_t StorageManager::runCleanup()
         return 0;
     }
 
+    foldUsage();
     std::vector<CleanupCandidate> candidates=collectCleanupCandidates();
 
     if(candidates.empty())
@@ -597,40 +984,32 @@ int64_t StorageManager::runCleanup()
 
     int64_t totalFreed=0;
 
+    bool removedAny=false;
     for(const CleanupCandidate &candidate:candidates)
     {
-        // Delete the file
-        std::filesystem::path filePath=m_modelsDir/candidate.filename;
-
-        std::error_code ec;
-        if(std::filesystem::exists(filePath, ec))
-        {
-            std::filesystem::remove(filePath, ec);
-            if(ec)
-            {
-                spdlog::error("StorageManager cleanup: failed to delete {}: {}", filePath.string(), ec.message());
-                continue;
-            }
-        }
-
-        // Remove from entries
         for(auto it=m_entries.begin(); it!=m_entries.end(); ++it)
         {
             if(it->modelName==candidate.modelName&&it->variant==candidate.variant)
             {
-                totalFreed+=it->fileSizeBytes;
-                spdlog::info("StorageManager cleanup: deleted {} variant {} ({})",
-                    it->modelName, it->variant, formatBytes(it->fileSizeBytes));
+                // Blobs shared with entries that stay are kept
+                int64_t freed=0;
+                if(!removeEntryFiles(*it, freed))
+                {
+                    break;
+                }
+                totalFreed+=freed;
+                removedAny=true;
+                spdlog::info("StorageManager cleanup: deleted {} variant {} ({} freed)",
+                    it->modelName, it->variant, formatBytes(freed));
                 m_entries.erase(it);
                 break;
             }
         }
     }
 
-    if(totalFreed>0)
+    if(removedAny)
     {
-        m_dirty=true;
-        saveUsageData();
+        compactUsage();
     }
 
     spdlog::info("StorageManager cleanup: freed {}", formatBytes(totalFreed));
@@ -665,7 +1044,7 @@ const StorageManager::ModelFileEntry *StorageManager::findEntry(
     return nullptr;
 }
 
-void StorageManager::loadUsageData()
+uint64_t StorageManager::loadUsageData()
 {
     // NOTE: caller must hold m_mutex
 
@@ -673,20 +1052,24 @@ void StorageManager::loadUsageData()
 
     if(!std::filesystem::exists(usagePath))
     {
-        return;
+        return 0;
     }
 
+    uint64_t journalSequence=0;
+
     try
     {
         std::ifstream file(usagePath);
         if(!file.is_open())
         {
-            return;
+            return 0;
         }
 
         nlohmann::json data;
         file>>data;
 
+        journalSequence=data.value("journal_sequence", uint64_t(0));
+
         if(data.contains("storage_limit_bytes"))
         {
             m_storageLimitBytes=data["storage_limit_bytes"].get<int64_t>();
@@ -713,6 +1096,10 @@ void StorageManager::loadUsageData()
                 {
                     entry.additionalFiles=m["additional_files"].get<std::vector<std::string>>();
                 }
+                if(m.contains("sha256")&&m["sha256"].is_array())
+                {
+                    entry.fileHashes=m["sha256"].get<std::vector<std::string>>();
+                }
                 entry.fileSizeBytes=m.value("file_size_bytes", int64_t(0));
                 entry.downloadedAt=isoToTimePoint(m.value("downloaded_at", ""));
                 entry.lastUsedAt=isoToTimePoint(m.value("last_used_at", ""));
@@ -752,21 +1139,23 @@ void StorageManager::loadUsageData()
     {
         spdlog::warn("StorageManager: failed to load usage data: {}", e.what());
     }
+    return journalSequence;
 }
 
-void StorageManager::saveUsageData() const
+bool StorageManager::saveUsageData() const
 {
     // NOTE: caller must hold m_mutex
 
     if(m_modelsDir.empty())
     {
-        return;
+        return false;
     }
 
     std::filesystem::path usagePath=m_modelsDir/"model_usage.json";
 
     nlohmann::json data;
     data["version"]=1;
+    data["journal_sequence"]=m_journal.lastSequence();
     data["storage_limit_bytes"]=m_storageLimitBytes;
 
     nlohmann::json cleanupJson;
@@ -787,6 +1176,10 @@ void StorageManager::saveUsageData() const
         {
             m["additional_files"]=entry.additionalFiles;
         }
+        if(!entry.fileHashes.empty())
+        {
+            m["sha256"]=entry.fileHashes;
+        }
         m["file_size_bytes"]=entry.fileSizeBytes;
         m["downloaded_at"]=timePointToIso(entry.downloadedAt);
         m["last_used_at"]=timePointToIso(entry.lastUsedAt);
@@ -797,18 +1190,141 @@ void StorageManager::saveUsageData() const
     }
     data["models"]=models;
 
+    // Written aside and renamed over the old snapshot, so a crash leaves
+    // either the old or the new one
+    std::filesystem::path tmpPath=usagePath;
+    tmpPath+=".tmp";
     try
     {
-        std::ofstream file(usagePath);
+        std::ofstream file(tmpPath, std::ios::trunc);
         file<<data.dump(4);
         file.close();
+        if(file.fail())
+        {
+            spdlog::error("StorageManager: failed to write {}", tmpPath.string());
+            return false;
+        }
+        std::filesystem::rename(tmpPath, usagePath);
     }
     catch(const std::exception &e)
     {
         spdlog::error("StorageManager: failed to save usage data: {}", e.what());
+        std::error_code ec;
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+    return true;
+}
+
+void StorageManager::replayUsageJournal(uint64_t snapshotSequence)
+{
+    // NOTE: caller must hold m_mutex
+
+    std::filesystem::path journalPath=m_modelsDir/"model_usage.journal";
+    std::vector<UsageRecord> records=UsageJournal::read(journalPath, snapshotSequence);
+
+    uint64_t lastSequence=snapshotSequence;
+    for(const UsageRecord &record:records)
+    {
+        lastSequence=std::max(lastSequence, record.sequence);
+
+        ModelFileEntry *entry=findEntry(record.modelName, record.variant);
+        if(entry)
+        {
+            entry->usageCount+=record.count;
+            entry->lastUsedAt=std::max(entry->lastUsedAt, record.lastUsedAt);
+        }
+    }
+
+    if(!records.empty())
+    {
+        spdlog::info("StorageManager: replayed {} usage record(s) from {}", records.size(), journalPath.string());
+        // Compact on the next flush
+        m_dirty=true;
+    }
+
+    m_journal.open(journalPath, lastSequence);
+}
+
+void StorageManager::foldUsage()
+{
+    // NOTE: caller must hold m_mutex
+
+    std::vector<UsageTally> tallies=m_usageCounters.drain();
+    if(tallies.empty())
+    {
+        return;
+    }
+
+    std::map<uint64_t, ModelFileEntry *> entriesByKey;
+    for(ModelFileEntry &entry:m_entries)
+    {
+        entriesByKey[UsageCounters::keyFor(entry.modelName, entry.variant)]=&entry;
+    }
+
+    std::vector<UsageRecord> records;
+    for(const UsageTally &tally:tallies)
+    {
+        std::map<uint64_t, ModelFileEntry *>::iterator it=entriesByKey.find(tally.key);
+        if(it==entriesByKey.end())
+        {
+            // Unknown variant: nothing to record
+            continue;
+        }
+
+        ModelFileEntry &entry=*it->second;
+        entry.usageCount+=tally.count;
+        entry.lastUsedAt=std::max(entry.lastUsedAt, tally.lastUsedAt);
+
+        UsageRecord record;
+        record.modelName=entry.modelName;
+        record.variant=entry.variant;
+        record.count=tally.count;
+        record.lastUsedAt=entry.lastUsedAt;
+        records.push_back(record);
+    }
+
+    if(records.empty())
+    {
+        return;
+    }
+
+    if(!m_journal.append(records))
+    {
+        // Not journaled: the next snapshot has to carry it
+        m_dirty=true;
+        return;
+    }
+
+    if(m_journal.recordCount()>=journalCompactRecords)
+    {
+        compactUsage();
     }
 }
 
+void StorageManager::compactUsage()
+{
+    // NOTE: caller must hold m_mutex
+
+    // The snapshot notes the journal's last sequence, so if truncating
+    // fails the records are skipped on replay rather than counted twice
+    if(saveUsageData())
+    {
+        m_journal.truncate();
+        m_dirty=false;
+    }
+}
+
+UsageTally StorageManager::currentUsage(const ModelFileEntry &entry) const
+{
+    // NOTE: caller must hold m_mutex
+
+    UsageTally usage=m_usageCounters.pending(UsageCounters::keyFor(entry.modelName, entry.variant));
+    usage.count+=entry.usageCount;
+    usage.lastUsedAt=std::max(usage.lastUsedAt, entry.lastUsedAt);
+    return usage;
+}
+
 std::vector<CleanupCandidate> StorageManager::collectCleanupCandidates() const
 {
     // NOTE: caller must hold m_mutex
@@ -836,7 +1352,8 @@ std::vector<CleanupCandidate> StorageManager::collectCleanupCandidates() const
         }
 
         // Check staleness
-        auto age=std::chrono::duration_cast<std::chrono::hours>(now-entry.lastUsedAt);
+        UsageTally usage=currentUsage(entry);
+        auto age=std::chrono::duration_cast<std::chrono::hours>(now-usage.lastUsedAt);
         if(age<m_cleanupPolicy.maxAge)
         {
             continue;
@@ -847,8 +1364,8 @@ std::vector<CleanupCandidate> StorageManager::collectCleanupCandidates() const
         candidate.variant=entry.variant;
         candidate.filename=entry.filename;
         candidate.fileSizeBytes=entry.fileSizeBytes;
-        candidate.lastUsedAt=entry.lastUsedAt;
-        candidate.usageCount=entry.usageCount;
+        candidate.lastUsedAt=usage.lastUsedAt;
+        candidate.usageCount=usage.count;
         candidates.push_back(candidate);
     }
 
@@ -869,11 +1386,13 @@ DownloadedModelFile StorageManager::entryToPublic(const ModelFileEntry &entry) c
     f.variant=entry.variant;
     f.filename=entry.filename;
     f.additionalFiles=entry.additionalFiles;
+    f.fileHashes=entry.fileHashes;
     f.filePath=m_modelsDir/entry.filename;
     f.fileSizeBytes=entry.fileSizeBytes;
     f.downloadedAt=entry.downloadedAt;
-    f.lastUsedAt=entry.lastUsedAt;
-    f.usageCount=entry.usageCount;
+    UsageTally usage=currentUsage(entry);
+    f.lastUsedAt=usage.lastUsedAt;
+    f.usageCount=usage.count;
     f.hotReady=entry.hotReady;
     f.isProtected=entry.isProtected;
 
@@ -898,6 +1417,99 @@ DownloadedModelFile StorageManager::entryToPublic(const ModelFileEntry &entry) c
     return f;
 }
 
+std::vector<std::string> StorageManager::entryPaths(const ModelFileEntry &entry) const
+{
+    std::vector<std::string> paths;
+    paths.push_back((m_modelsDir/entry.filename).string());
+    for(const std::string &extraFile:entry.additionalFiles)
+    {
+        paths.push_back((m_modelsDir/extraFile).string());
+    }
+    return paths;
+}
+
+void StorageManager::holdIfHotReady(const ModelFileEntry &entry)
+{
+    // NOTE: caller must hold m_mutex
+
+    if(entry.hotReady&&!entry.filename.empty())
+    {
+        m_warmer.hold(entry.filename, entryPaths(entry));
+    }
+}
+
+void StorageManager::adoptEntryFiles(const ModelFileEntry &entry)
+{
+    // NOTE: caller must hold m_mutex
+
+    std::vector<std::string> paths=entryPaths(entry);
+    for(size_t i=0; i<paths.size()&&i<entry.fileHashes.size(); ++i)
+    {
+        int64_t duplicateBytes=0;
+        if(m_blobs.adopt(entry.fileHashes[i], paths[i], &duplicateBytes)&&duplicateBytes>0)
+        {
+            spdlog::info("StorageManager: {} variant {} shares stored content; saved {}",
+                entry.modelName, entry.variant, formatBytes(duplicateBytes));
+        }
+    }
+}
+
+bool StorageManager::removeEntryFiles(const ModelFileEntry &entry, int64_t &freedBytes)
+{
+    // NOTE: caller must hold m_mutex
+
+    m_warmer.release(entry.filename);
+
+    std::vector<std::string> paths=entryPaths(entry);
+    for(size_t i=0; i<paths.size(); ++i)
+    {
+        std::string hash=i<entry.fileHashes.size()?entry.fileHashes[i]:std::string();
+        freedBytes+=m_blobs.release(hash, paths[i]);
+        m_index.remove(std::filesystem::path(paths[i]).filename().string());
+
+        std::error_code ec;
+        if(std::filesystem::exists(paths[i], ec))
+        {
+            if(i==0)
+            {
+                spdlog::error("StorageManager: failed to delete file {}", paths[i]);
+                return false;
+            }
+            spdlog::warn("StorageManager: failed to delete shard {}", paths[i]);
+        }
+    }
+    return true;
+}
+
+int64_t StorageManager::sharedBytes() const
+{
+    // NOTE: caller must hold m_mutex
+
+    std::map<std::string, int> uses;
+    for(const ModelFileEntry &entry:m_entries)
+    {
+        for(const std::string &hash:entry.fileHashes)
+        {
+            if(BlobStore::isValidHash(hash))
+            {
+                ++uses[hash];
+            }
+        }
+    }
+
+    // Only paths actually linked to the blob share its space
+    int64_t shared=0;
+    for(auto it=uses.begin(); it!=uses.end(); ++it)
+    {
+        int copies=std::min(it->second, m_blobs.refCount(it->first));
+        if(copies>1)
+        {
+            shared+=static_cast<int64_t>(copies-1)*m_blobs.blobSize(it->first);
+        }
+    }
+    return shared;
+}
+
 void StorageManager::startBackgroundTimer()
 {
     if(m_timerRunning)
@@ -908,9 +1520,11 @@ void StorageManager::startBackgroundTimer()
     m_timerRunning=true;
     m_timerThread=std::thread([this]()
     {
-        // Flush every 5 minutes, cleanup on the cleanup interval
+        // Fold usage every second, flush every 5 minutes, keep hot-ready
+        // files warm, cleanup on the cleanup interval
         constexpr int flushIntervalSeconds=300; // 5 minutes
         int elapsedSeconds=0;
+        bool warmingPaused=false;
 
         while(m_timerRunning)
         {
@@ -922,11 +1536,49 @@ void StorageManager::startBackgroundTimer()
                 break;
             }
 
-            // Periodic flush
+            // Fold usage counted since the last tick into the journal;
+            // the periodic flush compacts it into the snapshot
             if(elapsedSeconds%flushIntervalSeconds==0)
             {
                 flush();
             }
+            else
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if(m_initialized)
+                {
+                    foldUsage();
+                }
+            }
+
+            // Map newly hot-ready files right away; re-warm on the interval.
+            // Warming is speculative: it pauses under memory pressure, and
+            // critical pressure also gives the locked pages back
+            MemoryPressureLevel pressure=ModelRuntime::instance().getMemoryPressureLevel();
+            if(pressure!=MemoryPressureLevel::None)
+            {
+                int64_t unlocked=pressure==MemoryPressureLevel::Critical?m_warmer.unlockAll():0;
+                if(!warmingPaused||unlocked>0)
+                {
+                    MemoryPressureEvent event;
+                    event.action="pause_warming";
+                    event.level=MemoryPressureMonitor::levelToString(pressure);
+                    event.freedMb=static_cast<int>(unlocked/(1024*1024));
+                    event.when=std::chrono::system_clock::now();
+                    TelemetryCollector::instance().recordMemoryPressure(event);
+                    warmingPaused=true;
+                }
+            }
+            else
+            {
+                warmingPaused=false;
+
+                int rewarmIntervalSeconds=m_rewarmIntervalSeconds;
+                if(m_warmer.hasPending()||(rewarmIntervalSeconds>0&&elapsedSeconds%rewarmIntervalSeconds==0))
+                {
+                    m_warmer.update();
+                }
+            }
 
             // Periodic cleanup
             int cleanupIntervalSeconds=0;
@@ -1,8 +1,16 @@
 #ifndef _ARBITERAI_STORAGEMANAGER_H_
 #define _ARBITERAI_STORAGEMANAGER_H_
 
+#include "arbiterAI/pageCacheWarmer.h"
+#include "arbiterAI/blobStore.h"
+#include "arbiterAI/directoryIndex.h"
+#include "arbiterAI/directoryWatcher.h"
+#include "arbiterAI/usageCounters.h"
+#include "arbiterAI/usageJournal.h"
+
 #include <string>
 #include <vector>
+#include <set>
 #include <optional>
 #include <filesystem>
 #include <mutex>
@@ -17,7 +25,9 @@ struct StorageInfo {
     std::filesystem::path modelsDirectory;
     int64_t totalDiskBytes=0;           // partition total
     int64_t freeDiskBytes=0;            // partition free
-    int64_t usedByModelsBytes=0;        // sum of all tracked model files
+    int64_t usedByModelsBytes=0;        // sum of all tracked model files, shared blobs counted once
+    int64_t deduplicatedBytes=0;        // bytes saved by variants sharing blobs
+    int blobCount=0;                    // distinct blobs in the content store
     int64_t storageLimitBytes=0;        // configured limit (0 = use all free)
     int64_t availableForModelsBytes=0;  // min(freeDisk, limit - usedByModels)
     int modelCount=0;
@@ -29,12 +39,13 @@ struct DownloadedModelFile {
     std::string variant;             // quantization (e.g., "Q4_K_M")
     std::string filename;            // primary filename (first shard / single file)
     std::vector<std::string> additionalFiles; // extra shard filenames for split GGUF models
+    std::vector<std::string> fileHashes; // sha256 per file, primary first ("" = unknown)
     std::filesystem::path filePath;
     int64_t fileSizeBytes=0;
     std::chrono::system_clock::time_point downloadedAt;
     std::chrono::system_clock::time_point lastUsedAt;
     int usageCount=0;                // number of inference requests served
-    bool hotReady=false;             // keep weights in RAM for quick VRAM reload
+    bool hotReady=false;             // keep weights in the page cache for quick (re)load
     bool isProtected=false;          // protected from deletion (manual and automated)
     std::string runtimeState;        // cross-referenced from ModelRuntime
 };
@@ -63,9 +74,11 @@ public:
     static void reset(); // For testing
 
     /// Initialize with the models directory path.
+    /// The directory is then watched, so GGUF files and complete shard sets
+    /// copied in or removed by hand are picked up as they change.
     void initialize(const std::filesystem::path &modelsDir);
 
-    /// Shut down the background flush/cleanup timers.
+    /// Shut down the background flush/cleanup timers and the directory watch.
     void shutdown();
 
     /// Set the storage limit in bytes. 0 = use all free disk space.
@@ -85,29 +98,60 @@ public:
     std::vector<DownloadedModelFile> getDownloadedModels() const;
 
     /// Register a completed download (updates inventory).
+    /// Files with a known sha256 are moved into the content store, so a
+    /// second copy of the same content becomes a link to the first.
     /// @param additionalFiles Extra shard filenames for split GGUF models (empty for single-file).
+    /// @param fileHashes sha256 per file, primary first (empty or "" = unknown).
     void registerDownload(const std::string &modelName,
         const std::string &variant,
         const std::string &filename,
         int64_t fileSizeBytes,
-        const std::vector<std::string> &additionalFiles={});
+        const std::vector<std::string> &additionalFiles={},
+        const std::vector<std::string> &fileHashes={});
+
+    /// Create path as a link to stored content with this sha256, so a file
+    /// already downloaded under another name needs no download or space.
+    /// @return false if the content isn't stored or linking failed.
+    bool linkFromStore(const std::string &sha256, const std::filesystem::path &path);
 
-    /// Record a model usage event (inference served).
+    /// Path of the stored content with this sha256, for serving it to peer
+    /// servers. Only verified downloads are stored.
+    /// @return nullopt if the content isn't stored.
+    std::optional<std::filesystem::path> getBlobPath(const std::string &sha256) const;
+
+    /// Record a model usage event (inference served). Lock-free: the count
+    /// is folded into the usage journal by the background timer.
     void recordUsage(const std::string &modelName, const std::string &variant);
 
     /// Delete a downloaded model file from disk.
     /// Fails if the variant is hot ready or protected (must clear flags first).
+    /// Stored content shared with other variants stays until its last user
+    /// is deleted.
     /// @param modelName Model name.
     /// @param variant Specific variant to delete. If empty, deletes all variants of the model.
-    /// @param freedBytes [out] Total bytes freed.
+    /// @param freedBytes [out] Total bytes freed on disk.
     /// @return true if deleted, false if file not found, deletion failed, or guarded.
     bool deleteModelFile(const std::string &modelName, const std::string &variant,
         int64_t &freedBytes);
 
     /// Set/clear hot ready on a variant (keep weights in RAM for quick VRAM reload).
+    /// Hot-ready files are read into the page cache in the background, kept
+    /// there and mlock()ed within the hot-ready lock budget.
     /// @return true if the variant was found, false otherwise.
     bool setHotReady(const std::string &modelName, const std::string &variant, bool enabled);
 
+    /// Bytes of hot-ready files that may be mlock()ed (0 = readahead only).
+    void setHotReadyLockBudget(int64_t bytes);
+    int64_t getHotReadyLockBudget() const;
+
+    /// Seconds between checks that re-read hot-ready files whose pages the
+    /// kernel reclaimed (0 = warm once, never re-warm).
+    void setHotReadyRewarmInterval(int seconds);
+
+    /// Page-cache residency of each file of a downloaded variant (primary
+    /// file first), measured with mincore().
+    std::vector<FileResidency> getResidency(const DownloadedModelFile &file) const;
+
     /// Set/clear protected on a variant (prevent deletion, manual or automated).
     /// @return true if the variant was found, false otherwise.
     bool setProtected(const std::string &modelName, const std::string &variant, bool enabled);
@@ -123,10 +167,14 @@ public:
     /// @return true if either flag is set, false otherwise.
     bool isGuarded(const std::string &modelName, const std::string &variant) const;
 
-    /// Flush usage stats to disk (called periodically and on shutdown).
+    /// Fold pending usage into the journal and compact the journal into
+    /// model_usage.json (called periodically and on shutdown).
     void flush();
 
-    /// Scan the models directory for GGUF files not yet in the inventory.
+    /// Scan the models directory for GGUF files not yet in the inventory
+    /// and drop entries whose files are gone. Incremental: only names the
+    /// directory index hasn't seen are stat()ed.
+    /// NOTE: caller must hold m_mutex
     void scanModelsDirectory();
 
     // ========== Cleanup ==========
@@ -156,6 +204,7 @@ private:
         std::string variant;
         std::string filename;
         std::vector<std::string> additionalFiles; // extra shard filenames for split GGUF
+        std::vector<std::string> fileHashes;      // sha256 per file, primary first
         int64_t fileSizeBytes=0;
         std::chrono::system_clock::time_point downloadedAt;
         std::chrono::system_clock::time_point lastUsedAt;
@@ -168,8 +217,32 @@ private:
     ModelFileEntry *findEntry(const std::string &modelName, const std::string &variant);
     const ModelFileEntry *findEntry(const std::string &modelName, const std::string &variant) const;
 
-    void loadUsageData();
-    void saveUsageData() const;
+    /// Load the model_usage.json snapshot.
+    /// @return Last journal sequence the snapshot contains.
+    /// NOTE: caller must hold m_mutex
+    uint64_t loadUsageData();
+
+    /// Write the model_usage.json snapshot through a temporary file and rename.
+    /// NOTE: caller must hold m_mutex
+    bool saveUsageData() const;
+
+    /// Apply journal records newer than the snapshot and open the journal
+    /// for appending.
+    /// NOTE: caller must hold m_mutex
+    void replayUsageJournal(uint64_t snapshotSequence);
+
+    /// Move counts from the lock-free usage counters into the entries and
+    /// append them to the journal.
+    /// NOTE: caller must hold m_mutex
+    void foldUsage();
+
+    /// Write a snapshot and empty the journal.
+    /// NOTE: caller must hold m_mutex
+    void compactUsage();
+
+    /// An entry's usage including counts not yet folded in.
+    /// NOTE: caller must hold m_mutex
+    UsageTally currentUsage(const ModelFileEntry &entry) const;
 
     /// Collect cleanup candidates (caller holds m_mutex).
     std::vector<CleanupCandidate> collectCleanupCandidates() const;
@@ -180,16 +253,76 @@ private:
     /// Start the background flush/cleanup timer.
     void startBackgroundTimer();
 
+    /// Full paths of an entry's files, primary first.
+    std::vector<std::string> entryPaths(const ModelFileEntry &entry) const;
+
+    /// Keep an entry's files warm if it is hot ready (caller holds m_mutex).
+    void holdIfHotReady(const ModelFileEntry &entry);
+
+    /// Move an entry's hashed files into the content store.
+    /// NOTE: caller must hold m_mutex
+    void adoptEntryFiles(const ModelFileEntry &entry);
+
+    /// Delete an entry's files, dropping blobs no other entry links to.
+    /// @return false if the primary file could not be deleted.
+    /// NOTE: caller must hold m_mutex
+    bool removeEntryFiles(const ModelFileEntry &entry, int64_t &freedBytes);
+
+    /// Bytes counted more than once when summing entries that share blobs.
+    /// NOTE: caller must hold m_mutex
+    int64_t sharedBytes() const;
+
+    /// Apply a batch of changes reported by the directory watcher.
+    void onDirectoryChanged(const std::vector<DirectoryChange> &changes, bool overflowed);
+
+    /// Drop entries with a file missing from the directory index. With
+    /// candidates, only those files are checked.
+    /// NOTE: caller must hold m_mutex
+    void removeMissingEntries(const std::set<std::string> &candidates={});
+
+    /// Add entries for indexed GGUF files and complete shard sets that no
+    /// entry owns yet.
+    /// NOTE: caller must hold m_mutex
+    void registerUntrackedFiles();
+
+    /// Record an entry's files (and their verified hashes) in the index.
+    /// NOTE: caller must hold m_mutex
+    void indexEntryFiles(const ModelFileEntry &entry);
+
+    /// Forget hashes of files that changed on disk since they were verified.
+    /// NOTE: caller must hold m_mutex
+    void dropStaleHashes(ModelFileEntry &entry);
+
+    /// True if filename belongs in the directory index.
+    /// NOTE: caller must hold m_mutex
+    bool isIndexedName(const std::string &filename) const;
+
     std::filesystem::path m_modelsDir;
     int64_t m_storageLimitBytes=0;
 
+    // Content-addressed store under <modelsDir>/blobs
+    BlobStore m_blobs;
+
+    // Files in the models directory, persisted to <modelsDir>/models_index.json
+    DirectoryIndex m_index;
+    DirectoryWatcher m_watcher;
+
     std::vector<ModelFileEntry> m_entries;
     mutable std::mutex m_mutex;
     bool m_initialized=false;
-    bool m_dirty=false; // has unsaved changes
+    bool m_dirty=false; // has changes the journal doesn't hold
+
+    // Usage counted lock-free by recordUsage() and folded into m_entries
+    // and <modelsDir>/model_usage.journal by the background timer
+    UsageCounters m_usageCounters;
+    UsageJournal m_journal;
 
     CleanupPolicy m_cleanupPolicy;
 
+    // Hot-ready page-cache warming, keyed by primary filename
+    PageCacheWarmer m_warmer;
+    std::atomic<int> m_rewarmIntervalSeconds{30};
+
     // Background timer
     std::thread m_timerThread;
     std::atomic<bool> m_timerRunning{false};
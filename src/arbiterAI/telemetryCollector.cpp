@@ -19,6 +19,8 @@ void TelemetryCollector::reset()
     std::lock_guard<std::mutex> lock(tc.m_mutex);
     tc.m_inferenceHistory.clear();
     tc.m_swapHistory.clear();
+    tc.m_resizeHistory.clear();
+    tc.m_pressureHistory.clear();
 }
 
 void TelemetryCollector::recordInference(const InferenceStats &stats)
@@ -39,7 +41,8 @@ void TelemetryCollector::recordInference(const InferenceStats &stats)
         stats.latencyMs, stats.totalTimeMs);
 }
 
-void TelemetryCollector::recordModelSwap(const std::string &from, const std::string &to, double swapTimeMs)
+void TelemetryCollector::recordModelSwap(const std::string &from, const std::string &to, double swapTimeMs,
+    const std::string &loadedFrom, double loadTimeMs)
 {
     std::lock_guard<std::mutex> lock(m_mutex);
 
@@ -47,6 +50,8 @@ void TelemetryCollector::recordModelSwap(const std::string &from, const std::str
     event.from=from;
     event.to=to;
     event.timeMs=swapTimeMs;
+    event.loadedFrom=loadedFrom;
+    event.loadTimeMs=loadTimeMs;
     event.when=std::chrono::system_clock::now();
 
     m_swapHistory.push_back(event);
@@ -57,19 +62,67 @@ void TelemetryCollector::recordModelSwap(const std::string &from, const std::str
         m_swapHistory.pop_front();
     }
 
-    spdlog::info("Model swap: '{}' -> '{}' ({:.1f}ms)", from, to, swapTimeMs);
+    if(loadedFrom.empty())
+    {
+        spdlog::info("Model swap: '{}' -> '{}' ({:.1f}ms)", from, to, swapTimeMs);
+    }
+    else
+    {
+        spdlog::info("Model swap: '{}' -> '{}' ({:.1f}ms, {}->Loaded in {:.1f}ms)",
+            from, to, swapTimeMs, loadedFrom, loadTimeMs);
+    }
 }
 
-SystemSnapshot TelemetryCollector::getSnapshot() const
+void TelemetryCollector::recordContextResize(const ContextResizeEvent &event)
 {
     std::lock_guard<std::mutex> lock(m_mutex);
 
+    m_resizeHistory.push_back(event);
+
+    while(m_resizeHistory.size()>MAX_RESIZE_HISTORY)
+    {
+        m_resizeHistory.pop_front();
+    }
+
+    spdlog::info("Context resize ({}): '{}' {} -> {} ({:.1f}ms, state {})",
+        event.reason, event.model, event.fromContext, event.toContext, event.timeMs,
+        event.stateCarried?"carried":"dropped");
+}
+
+void TelemetryCollector::recordMemoryPressure(const MemoryPressureEvent &event)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_pressureHistory.push_back(event);
+
+    while(m_pressureHistory.size()>MAX_PRESSURE_HISTORY)
+    {
+        m_pressureHistory.pop_front();
+    }
+
+    if(event.model.empty())
+    {
+        spdlog::info("Memory pressure ({}): {}", event.level, event.action);
+    }
+    else
+    {
+        spdlog::info("Memory pressure ({}): {} '{}' ({}MB)", event.level, event.action, event.model, event.freedMb);
+    }
+}
+
+SystemSnapshot TelemetryCollector::getSnapshot() const
+{
+    // Query the runtime before taking our own lock: the runtime records
+    // telemetry while holding its lock, so the reverse order would deadlock.
     SystemSnapshot snapshot;
     snapshot.hardware=HardwareDetector::instance().getSystemInfo();
     snapshot.models=ModelRuntime::instance().getModelStates();
-    snapshot.avgTokensPerSecond=getAvgTokensPerSecond();
     snapshot.activeRequests=ModelRuntime::instance().getActiveInferenceCount();
 
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    snapshot.avgTokensPerSecond=getAvgTokensPerSecond();
+
     // Calculate average prompt/generation speeds over last 5 minutes
     std::chrono::system_clock::time_point cutoff=
         std::chrono::system_clock::now()-std::chrono::minutes(5);
@@ -126,6 +179,20 @@ std::vector<SwapEvent> TelemetryCollector::getSwapHistory() const
     return std::vector<SwapEvent>(m_swapHistory.begin(), m_swapHistory.end());
 }
 
+std::vector<ContextResizeEvent> TelemetryCollector::getContextResizeHistory() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return std::vector<ContextResizeEvent>(m_resizeHistory.begin(), m_resizeHistory.end());
+}
+
+std::vector<MemoryPressureEvent> TelemetryCollector::getMemoryPressureHistory() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return std::vector<MemoryPressureEvent>(m_pressureHistory.begin(), m_pressureHistory.end());
+}
+
 double TelemetryCollector::getAvgTokensPerSecond() const
 {
     // Calculate rolling average over recent entries (last 5 minutes)
@@ -25,6 +25,7 @@ struct InferenceStats {
     double totalTimeMs=0.0;    // total request time
     double promptTimeMs=0.0;   // time spent processing prompt
     double generationTimeMs=0.0; // time spent generating tokens
+    double queueWaitMs=0.0;    // time spent in the model's admission queue
     std::chrono::system_clock::time_point timestamp;
 };
 
@@ -32,6 +33,29 @@ struct SwapEvent {
     std::string from;
     std::string to;
     double timeMs=0.0;
+    std::string loadedFrom; // state the target was promoted from ("Ready" or "Unloaded"), empty if the load did not complete
+    double loadTimeMs=0.0;  // portion of timeMs spent bringing the target to Loaded
+    std::chrono::system_clock::time_point when;
+};
+
+struct ContextResizeEvent {
+    std::string model;
+    int fromContext=0;
+    int toContext=0;
+    std::string reason;        // "grow" (request needed more tokens) or "shrink" (VRAM pressure)
+    bool stateCarried=false;   // sequence state was copied into the new context
+    double timeMs=0.0;         // time to rebuild the context, including state copy
+    std::chrono::system_clock::time_point when;
+};
+
+struct MemoryPressureEvent {
+    std::string action;        // "level" (level changed), "evict_ready", "reclaim_context", "refuse_replica" or "pause_warming"
+    std::string level;         // pressure level when the action was taken
+    std::string model;         // model acted on (empty for "level" and "pause_warming")
+    int freedMb=0;             // memory released by the action
+    double someAvg10=0.0;      // PSI readings that triggered it
+    double fullAvg10=0.0;
+    double cgroupUsagePercent=0.0;
     std::chrono::system_clock::time_point when;
 };
 
@@ -53,7 +77,16 @@ public:
     void recordInference(const InferenceStats &stats);
 
     /// Record a model swap event
-    void recordModelSwap(const std::string &from, const std::string &to, double swapTimeMs);
+    /// @param loadedFrom  State the target model was promoted from ("Ready" or "Unloaded").
+    /// @param loadTimeMs  Time spent bringing the target model to Loaded.
+    void recordModelSwap(const std::string &from, const std::string &to, double swapTimeMs,
+        const std::string &loadedFrom="", double loadTimeMs=0.0);
+
+    /// Record a dynamic context resize
+    void recordContextResize(const ContextResizeEvent &event);
+
+    /// Record an action taken because of memory pressure
+    void recordMemoryPressure(const MemoryPressureEvent &event);
 
     /// Get current system snapshot
     SystemSnapshot getSnapshot() const;
@@ -64,6 +97,12 @@ public:
     /// Get all recorded swap events
     std::vector<SwapEvent> getSwapHistory() const;
 
+    /// Get all recorded context resize events
+    std::vector<ContextResizeEvent> getContextResizeHistory() const;
+
+    /// Get all recorded memory pressure events
+    std::vector<MemoryPressureEvent> getMemoryPressureHistory() const;
+
     /// Get the rolling average tokens/sec across recent inferences
     double getAvgTokensPerSecond() const;
 
@@ -84,11 +123,15 @@ private:
 
     static constexpr int MAX_INFERENCE_HISTORY=10000;
     static constexpr int MAX_SWAP_HISTORY=1000;
+    static constexpr int MAX_RESIZE_HISTORY=1000;
+    static constexpr int MAX_PRESSURE_HISTORY=1000;
     static constexpr std::chrono::minutes MAX_RETENTION{60};
 
     mutable std::mutex m_mutex;
     mutable std::deque<InferenceStats> m_inferenceHistory;
     std::deque<SwapEvent> m_swapHistory;
+    std::deque<ContextResizeEvent> m_resizeHistory;
+    std::deque<MemoryPressureEvent> m_pressureHistory;
 };
 
 } // namespace arbiterAI
@@ -0,0 +1,149 @@
+#include "arbiterAI/usageCounters.h"
+
+namespace arbiterAI
+{
+
+namespace
+{
+
+int64_t toNs(std::chrono::system_clock::time_point when)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(when.time_since_epoch()).count();
+}
+
+std::chrono::system_clock::time_point fromNs(int64_t ns)
+{
+    return std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(ns)));
+}
+
+} // namespace
+
+uint64_t UsageCounters::keyFor(const std::string &modelName, const std::string &variant)
+{
+    // FNV-1a over "model\0variant"
+    uint64_t hash=14695981039346656037ULL;
+    auto mix=[&hash](unsigned char c)
+    {
+        hash^=c;
+        hash*=1099511628211ULL;
+    };
+
+    for(char c:modelName)
+    {
+        mix(static_cast<unsigned char>(c));
+    }
+    mix(0);
+    for(char c:variant)
+    {
+        mix(static_cast<unsigned char>(c));
+    }
+    return hash==0?1:hash;
+}
+
+bool UsageCounters::record(uint64_t key, std::chrono::system_clock::time_point when)
+{
+    size_t start=static_cast<size_t>(key%Capacity);
+
+    for(size_t probe=0; probe<Capacity; ++probe)
+    {
+        Slot &slot=m_slots[(start+probe)%Capacity];
+
+        uint64_t current=slot.key.load(std::memory_order_acquire);
+        if(current==0)
+        {
+            // Claim the empty slot; losing the race to the same key is fine
+            if(!slot.key.compare_exchange_strong(current, key, std::memory_order_acq_rel)&&current!=key)
+            {
+                continue;
+            }
+        }
+        else if(current!=key)
+        {
+            continue;
+        }
+
+        // Time first, so a drain that sees the count also sees a time at
+        // least this recent
+        int64_t ns=toNs(when);
+        int64_t last=slot.lastUsedNs.load(std::memory_order_relaxed);
+        while(last<ns&&!slot.lastUsedNs.compare_exchange_weak(last, ns, std::memory_order_relaxed))
+        {
+        }
+        slot.count.fetch_add(1, std::memory_order_release);
+        return true;
+    }
+    return false;
+}
+
+UsageTally UsageCounters::pending(uint64_t key) const
+{
+    UsageTally tally;
+    tally.key=key;
+
+    const Slot *slot=findSlot(key);
+    if(slot)
+    {
+        tally.count=slot->count.load(std::memory_order_acquire);
+        tally.lastUsedAt=fromNs(slot->lastUsedNs.load(std::memory_order_relaxed));
+    }
+    return tally;
+}
+
+std::vector<UsageTally> UsageCounters::drain()
+{
+    std::vector<UsageTally> tallies;
+
+    for(Slot &slot:m_slots)
+    {
+        uint64_t key=slot.key.load(std::memory_order_acquire);
+        if(key==0)
+        {
+            continue;
+        }
+
+        int count=slot.count.exchange(0, std::memory_order_acq_rel);
+        if(count>0)
+        {
+            UsageTally tally;
+            tally.key=key;
+            tally.count=count;
+            tally.lastUsedAt=fromNs(slot.lastUsedNs.load(std::memory_order_relaxed));
+            tallies.push_back(tally);
+        }
+    }
+    return tallies;
+}
+
+void UsageCounters::clear()
+{
+    for(Slot &slot:m_slots)
+    {
+        slot.count.store(0, std::memory_order_relaxed);
+        slot.lastUsedNs.store(0, std::memory_order_relaxed);
+        slot.key.store(0, std::memory_order_release);
+    }
+}
+
+const UsageCounters::Slot *UsageCounters::findSlot(uint64_t key) const
+{
+    size_t start=static_cast<size_t>(key%Capacity);
+
+    for(size_t probe=0; probe<Capacity; ++probe)
+    {
+        const Slot &slot=m_slots[(start+probe)%Capacity];
+
+        uint64_t current=slot.key.load(std::memory_order_acquire);
+        if(current==key)
+        {
+            return &slot;
+        }
+        if(current==0)
+        {
+            return nullptr;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace arbiterAI
@@ -0,0 +1,62 @@
+#ifndef _ARBITERAI_USAGECOUNTERS_H_
+#define _ARBITERAI_USAGECOUNTERS_H_
+
+#include <string>
+#include <vector>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace arbiterAI
+{
+
+/// Usage counted since the last drain for one model variant.
+struct UsageTally {
+    uint64_t key=0;             // UsageCounters::keyFor(model, variant)
+    int count=0;
+    std::chrono::system_clock::time_point lastUsedAt;
+};
+
+/// Lock-free per-variant usage counters.
+///
+/// Recording a use is an atomic increment in a fixed open-addressed table
+/// keyed by a 64-bit hash of the model and variant names, so the inference
+/// path never waits on the storage manager's lock. A slot is claimed the
+/// first time a variant is used and kept until clear(); the owner drains
+/// the counts periodically and matches keys back to its entries.
+class UsageCounters {
+public:
+    static constexpr size_t Capacity=1024;
+
+    /// Key for a model variant (never 0).
+    static uint64_t keyFor(const std::string &modelName, const std::string &variant);
+
+    /// Count one use. Safe from any thread.
+    /// @return false if the table is full; the caller must record it another way.
+    bool record(uint64_t key, std::chrono::system_clock::time_point when);
+
+    /// Counts recorded for key since the last drain, without resetting them.
+    UsageTally pending(uint64_t key) const;
+
+    /// Take and reset every non-zero count.
+    std::vector<UsageTally> drain();
+
+    /// Release all slots. Not safe while other threads record.
+    void clear();
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> key{0};
+        std::atomic<int> count{0};
+        std::atomic<int64_t> lastUsedNs{0};
+    };
+
+    const Slot *findSlot(uint64_t key) const;
+
+    std::array<Slot, Capacity> m_slots;
+};
+
+} // namespace arbiterAI
+
+#endif//_ARBITERAI_USAGECOUNTERS_H_
@@ -0,0 +1,141 @@
+#include "arbiterAI/usageJournal.h"
+
+#include <spdlog/spdlog.h>
+#include <nlohmann/json.hpp>
+
+namespace arbiterAI
+{
+
+UsageJournal::~UsageJournal()
+{
+    close();
+}
+
+std::vector<UsageRecord> UsageJournal::read(const std::filesystem::path &path, uint64_t after)
+{
+    std::vector<UsageRecord> records;
+
+    std::ifstream file(path);
+    if(!file.is_open())
+    {
+        return records;
+    }
+
+    std::string line;
+    int lineNumber=0;
+    while(std::getline(file, line))
+    {
+        ++lineNumber;
+        if(line.empty())
+        {
+            continue;
+        }
+
+        try
+        {
+            nlohmann::json j=nlohmann::json::parse(line);
+
+            UsageRecord record;
+            record.sequence=j.at("seq").get<uint64_t>();
+            record.modelName=j.at("model").get<std::string>();
+            record.variant=j.at("variant").get<std::string>();
+            record.count=j.value("count", 0);
+            record.lastUsedAt=std::chrono::system_clock::time_point(
+                std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                    std::chrono::milliseconds(j.value("last_used_ms", int64_t(0)))));
+
+            if(record.sequence>after)
+            {
+                records.push_back(record);
+            }
+        }
+        catch(const std::exception &e)
+        {
+            // Only the last line can be torn; anything after it is unreliable
+            spdlog::warn("UsageJournal: ignoring {} from line {}: {}", path.string(), lineNumber, e.what());
+            break;
+        }
+    }
+    return records;
+}
+
+bool UsageJournal::open(const std::filesystem::path &path, uint64_t lastSequence)
+{
+    close();
+
+    m_path=path;
+    m_lastSequence=lastSequence;
+    m_recordCount=0;
+
+    m_file.open(path, std::ios::app);
+    if(!m_file.is_open())
+    {
+        spdlog::error("UsageJournal: cannot open {}", path.string());
+        return false;
+    }
+    return true;
+}
+
+void UsageJournal::close()
+{
+    if(m_file.is_open())
+    {
+        m_file.close();
+    }
+}
+
+bool UsageJournal::append(std::vector<UsageRecord> &records)
+{
+    if(!m_file.is_open())
+    {
+        return false;
+    }
+
+    std::string lines;
+    for(UsageRecord &record:records)
+    {
+        record.sequence=++m_lastSequence;
+
+        nlohmann::json j;
+        j["seq"]=record.sequence;
+        j["model"]=record.modelName;
+        j["variant"]=record.variant;
+        j["count"]=record.count;
+        j["last_used_ms"]=std::chrono::duration_cast<std::chrono::milliseconds>(
+            record.lastUsedAt.time_since_epoch()).count();
+        lines+=j.dump();
+        lines+='\n';
+    }
+
+    // One write per batch, so a crash tears at most the last line
+    m_file.write(lines.data(), static_cast<std::streamsize>(lines.size()));
+    m_file.flush();
+    if(!m_file.good())
+    {
+        spdlog::error("UsageJournal: write to {} failed", m_path.string());
+        m_file.clear();
+        return false;
+    }
+    m_recordCount+=records.size();
+    return true;
+}
+
+bool UsageJournal::truncate()
+{
+    if(m_path.empty())
+    {
+        return false;
+    }
+
+    close();
+    m_file.open(m_path, std::ios::trunc);
+    m_recordCount=0;
+    if(!m_file.is_open())
+    {
+        spdlog::error("UsageJournal: cannot truncate {}", m_path.string());
+        return false;
+    }
+    return true;
+}
+
+} // namespace arbiterAI
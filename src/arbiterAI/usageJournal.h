@@ -0,0 +1,66 @@
+#ifndef _ARBITERAI_USAGEJOURNAL_H_
+#define _ARBITERAI_USAGEJOURNAL_H_
+
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <fstream>
+#include <chrono>
+#include <cstdint>
+
+namespace arbiterAI
+{
+
+/// One journaled batch of uses of a model variant.
+struct UsageRecord {
+    uint64_t sequence=0;        // assigned by append(), increasing
+    std::string modelName;
+    std::string variant;
+    int count=0;
+    std::chrono::system_clock::time_point lastUsedAt;
+};
+
+/// Append-only JSONL journal of usage, one record per line.
+///
+/// Usage is appended here instead of rewriting the snapshot on every
+/// change; the owner periodically compacts by writing a snapshot that
+/// notes the last sequence it contains and then truncating the journal.
+/// Replay skips records the snapshot already holds, so a crash between
+/// the two steps doesn't count anything twice, and a torn last line from
+/// a crash mid-append is dropped.
+///
+/// Not thread safe; the owner serializes access.
+class UsageJournal {
+public:
+    ~UsageJournal();
+
+    /// Read the records in path with a sequence above after.
+    static std::vector<UsageRecord> read(const std::filesystem::path &path, uint64_t after);
+
+    /// Open path for appending. Sequences continue from lastSequence.
+    bool open(const std::filesystem::path &path, uint64_t lastSequence);
+    void close();
+    bool isOpen() const { return m_file.is_open(); }
+
+    /// Append records, assigning their sequence numbers.
+    bool append(std::vector<UsageRecord> &records);
+
+    /// Empty the journal once a snapshot holds everything in it.
+    bool truncate();
+
+    /// Sequence of the last record appended (or replayed).
+    uint64_t lastSequence() const { return m_lastSequence; }
+
+    /// Records appended since the journal was opened or truncated.
+    size_t recordCount() const { return m_recordCount; }
+
+private:
+    std::filesystem::path m_path;
+    std::ofstream m_file;
+    uint64_t m_lastSequence=0;
+    size_t m_recordCount=0;
+};
+
+} // namespace arbiterAI
+
+#endif//_ARBITERAI_USAGEJOURNAL_H_
@@ -6,6 +6,7 @@
 #include "arbiterAI/modelManager.h"
 #include "arbiterAI/modelRuntime.h"
 #include "arbiterAI/storageManager.h"
+#include "arbiterAI/autotuner.h"
 
 #include <httplib.h>
 #include <nlohmann/json.hpp>
@@ -14,6 +15,7 @@
 #include <spdlog/sinks/daily_file_sink.h>
 
 #include <iostream>
+#include <iomanip>
 #include <fstream>
 #include <string>
 #include <thread>
@@ -61,6 +63,36 @@ arbiterAI::RuntimeOptions parseStartupRuntimeOptions(const nlohmann::json &j)
         opts.overrideTensor=j["override_tensor"].get<std::string>();
     if(j.contains("vulkan_no_host_visible_vram")&&j["vulkan_no_host_visible_vram"].is_boolean())
         opts.vulkanNoHostVisibleVram=j["vulkan_no_host_visible_vram"].get<bool>();
+    if(j.contains("mlock")&&j["mlock"].is_boolean())
+        opts.mlock=j["mlock"].get<bool>();
+    if(j.contains("idle_context_timeout_seconds")&&j["idle_context_timeout_seconds"].is_number_integer())
+        opts.idleContextTimeoutSeconds=j["idle_context_timeout_seconds"].get<int>();
+    if(j.contains("idle_shrink_context")&&j["idle_shrink_context"].is_boolean())
+        opts.idleShrinkContext=j["idle_shrink_context"].get<bool>();
+    if(j.contains("dynamic_context")&&j["dynamic_context"].is_boolean())
+        opts.dynamicContext=j["dynamic_context"].get<bool>();
+    if(j.contains("initial_context_size")&&j["initial_context_size"].is_number_integer())
+        opts.initialContextSize=j["initial_context_size"].get<int>();
+    if(j.contains("kv_offload")&&j["kv_offload"].is_boolean())
+        opts.kvOffload=j["kv_offload"].get<bool>();
+    if(j.contains("auto_placement")&&j["auto_placement"].is_boolean())
+        opts.autoPlacement=j["auto_placement"].get<bool>();
+    if(j.contains("n_threads")&&j["n_threads"].is_number_integer())
+        opts.nThreads=j["n_threads"].get<int>();
+    if(j.contains("n_threads_batch")&&j["n_threads_batch"].is_number_integer())
+        opts.nThreadsBatch=j["n_threads_batch"].get<int>();
+    if(j.contains("n_batch")&&j["n_batch"].is_number_integer())
+        opts.nBatch=j["n_batch"].get<int>();
+    if(j.contains("n_ubatch")&&j["n_ubatch"].is_number_integer())
+        opts.nUbatch=j["n_ubatch"].get<int>();
+    if(j.contains("autotune")&&j["autotune"].is_boolean())
+        opts.autotune=j["autotune"].get<bool>();
+    if(j.contains("numa_policy")&&j["numa_policy"].is_string())
+        opts.numaPolicy=j["numa_policy"].get<std::string>();
+    if(j.contains("numa_node")&&j["numa_node"].is_number_integer())
+        opts.numaNode=j["numa_node"].get<int>();
+    if(j.contains("warmup")&&j["warmup"].is_boolean())
+        opts.warmup=j["warmup"].get<bool>();
     return opts;
 }
 
@@ -417,12 +449,84 @@ int64_t parseStorageLimit(const std::string &str)
     return std::stoll(str);
 }
 
+/// --autotune mode: load one model, sweep its runtime options, print the
+/// measurements and exit.  The model's startup_models entry (variant,
+/// context, devices, runtime options) is used when it has one.
+int runAutotune(const std::string &model, const std::vector<StartupModelEntry> &startupModels)
+{
+    StartupModelEntry entry;
+    entry.model=model;
+    for(const StartupModelEntry &candidate:startupModels)
+    {
+        if(candidate.model==model)
+        {
+            entry=candidate;
+            break;
+        }
+    }
+
+    arbiterAI::RuntimeOptions opts=entry.runtimeOptions;
+    arbiterAI::ErrorCode err=arbiterAI::ArbiterAI::instance().loadModel(
+        entry.model, entry.variant, entry.contextSize, &opts, entry.devices);
+
+    for(int attempt=0; attempt<300&&err==arbiterAI::ErrorCode::ModelDownloading; ++attempt)
+    {
+        std::this_thread::sleep_for(std::chrono::seconds(2));
+
+        std::optional<arbiterAI::LoadedModel> state=arbiterAI::ModelRuntime::instance().getModelState(model);
+        if(state.has_value()&&state->state==arbiterAI::ModelState::Downloading)
+            continue;
+
+        err=arbiterAI::ArbiterAI::instance().loadModel(
+            entry.model, entry.variant, entry.contextSize, &opts, entry.devices);
+    }
+
+    if(err!=arbiterAI::ErrorCode::Success)
+    {
+        std::cerr<<"Error: failed to load model '"<<model<<"' for autotuning (error="<<static_cast<int>(err)<<")\n";
+        return 1;
+    }
+
+    arbiterAI::AutotuneResult result;
+    err=arbiterAI::ModelRuntime::instance().autotune(model, arbiterAI::AutotuneConfig{}, result);
+    if(err!=arbiterAI::ErrorCode::Success)
+    {
+        std::cerr<<"Error: autotune of '"<<model<<"' failed (error="<<static_cast<int>(err)<<")\n";
+        return 1;
+    }
+
+    auto describe=[](const arbiterAI::RuntimeOptions &o)
+    {
+        return "fa="+std::string(o.flashAttn.value_or(false)?"on":"off")+
+            " kv="+o.kvCacheTypeK.value_or("f16")+
+            " b="+std::to_string(o.nBatch.value_or(0))+
+            " ub="+std::to_string(o.nUbatch.value_or(0))+
+            " t="+std::to_string(o.nThreads.value_or(0))+
+            " tb="+std::to_string(o.nThreadsBatch.value_or(0));
+    };
+
+    std::cout<<"Autotune results for "<<result.model<<" ("<<result.variant<<") on "<<result.hardwareFingerprint<<"\n\n";
+    std::cout<<std::left<<std::setw(48)<<"configuration"<<std::right<<std::setw(12)<<"pp tok/s"<<std::setw(12)<<"tg tok/s"<<"\n";
+    for(const arbiterAI::AutotuneTrial &trial:result.trials)
+    {
+        std::cout<<std::left<<std::setw(48)<<describe(trial.options)<<std::right<<std::fixed<<std::setprecision(1);
+        if(trial.ok)
+            std::cout<<std::setw(12)<<trial.result.promptTokensPerSec<<std::setw(12)<<trial.result.generationTokensPerSec<<"\n";
+        else
+            std::cout<<std::setw(24)<<"failed"<<"\n";
+    }
+    std::cout<<"\nBest: "<<describe(result.best)<<"\n"
+        "Stored in "<<arbiterAI::ModelRuntime::instance().getModelsDir()<<"autotune.json; applied on the next load of this variant.\n";
+    return 0;
+}
+
 void printUsage()
 {
     std::cout<<"Usage: arbiterAI-server [options]\n"
         "\n"
         "Options:\n"
         "  -c, --config <path>   Path to server configuration JSON file (required)\n"
+        "  --autotune <model>    Benchmark runtime options for a model, store the best and exit\n"
         "  -h, --help            Print this help message\n"
         "\n"
         "See examples/server_config.json for the configuration file format.\n";
@@ -432,8 +536,9 @@ void printUsage()
 
 int main(int argc, char *argv[])
 {
-    // ── Parse CLI — only --config and --help ──────────────────────
+    // ── Parse CLI — --config, --autotune and --help ───────────────
     std::string configPath;
+    std::string autotuneModel;
 
     for(int i=1; i<argc; ++i)
     {
@@ -452,6 +557,14 @@ int main(int argc, char *argv[])
         {
             configPath=arg.substr(9);
         }
+        else if(arg=="--autotune"&&i+1<argc)
+        {
+            autotuneModel=argv[++i];
+        }
+        else if(arg.rfind("--autotune=", 0)==0)
+        {
+            autotuneModel=arg.substr(11);
+        }
         else
         {
             std::cerr<<"Unknown argument: "<<arg<<"\n";
@@ -513,6 +626,9 @@ int main(int argc, char *argv[])
     std::string injectedConfigDir=cfg.value("injected_config_dir", "");
     int ramBudget=cfg.value("ram_budget_mb", 0);
     int maxDownloads=cfg.value("max_concurrent_downloads", 2);
+    int idleContextTimeout=cfg.value("idle_context_timeout_seconds", 0);
+    int cpuThreads=cfg.value("cpu_threads", 0);
+    int loraCacheMb=cfg.value("lora_cache_mb", -1);
 
     // Storage
     nlohmann::json storageCfg=cfg.value("storage", nlohmann::json::object());
@@ -520,6 +636,8 @@ int main(int argc, char *argv[])
     bool cleanupEnabled=storageCfg.value("cleanup_enabled", true);
     int cleanupMaxAgeDays=storageCfg.value("cleanup_max_age_days", 30);
     int cleanupIntervalHours=storageCfg.value("cleanup_interval_hours", 24);
+    std::string hotReadyLockBudgetStr=storageCfg.value("hot_ready_lock_budget", "0");
+    int hotReadyRewarmSeconds=storageCfg.value("hot_ready_rewarm_interval_seconds", 30);
 
     // Hardware
     nlohmann::json hwCfg=cfg.value("hardware", nlohmann::json::object());
@@ -649,6 +767,12 @@ int main(int argc, char *argv[])
     spdlog::info("Cleanup policy: enabled={}, maxAge={}d, interval={}h",
         cleanupEnabled, cleanupMaxAgeDays, cleanupIntervalHours);
 
+    int64_t hotReadyLockBudget=parseStorageLimit(hotReadyLockBudgetStr);
+    storage.setHotReadyLockBudget(hotReadyLockBudget);
+    storage.setHotReadyRewarmInterval(hotReadyRewarmSeconds);
+    spdlog::info("Hot-ready page cache: lock budget={} bytes, rewarm interval={}s",
+        hotReadyLockBudget, hotReadyRewarmSeconds);
+
     // ── RAM budget ───────────────────────────────────────────────
     if(ramBudget>0)
     {
@@ -669,6 +793,149 @@ int main(int argc, char *argv[])
         spdlog::info("Max concurrent downloads set to {}", maxDownloads);
     }
 
+    if(cfg.contains("downloads")&&cfg["downloads"].is_object())
+    {
+        const nlohmann::json &downloadsJson=cfg["downloads"];
+        arbiterAI::SegmentedDownloadConfig segmentConfig;
+        segmentConfig.maxSegments=downloadsJson.value("segments", segmentConfig.maxSegments);
+        segmentConfig.minSegmentBytes=downloadsJson.value("min_segment_mb", segmentConfig.minSegmentBytes/(1024*1024))*1024*1024;
+        segmentConfig.segmentRetries=downloadsJson.value("segment_retries", segmentConfig.segmentRetries);
+        int maxConnections=downloadsJson.value("max_connections", 8);
+
+        arbiterAI::ModelRuntime::instance().setDownloadSegmentConfig(segmentConfig);
+        arbiterAI::ModelRuntime::instance().setMaxDownloadConnections(maxConnections);
+        spdlog::info("Downloads: up to {} segment(s) per file, {} MB minimum, {} retries per segment, {} connections in total",
+            segmentConfig.maxSegments, segmentConfig.minSegmentBytes/(1024*1024), segmentConfig.segmentRetries, maxConnections);
+
+        double maxBandwidthMbps=downloadsJson.value("max_bandwidth_mbps", 0.0);
+        if(maxBandwidthMbps>0.0)
+        {
+            arbiterAI::ModelRuntime::instance().setDownloadBandwidthLimit(static_cast<int64_t>(maxBandwidthMbps*1024.0*1024.0));
+            spdlog::info("Download bandwidth capped at {:.1f} MB/s", maxBandwidthMbps);
+        }
+
+        arbiterAI::DownloadWriteConfig writeConfig;
+        writeConfig.bufferBytes=static_cast<size_t>(std::max(0, downloadsJson.value("write_buffer_mb", 4)))*1024*1024;
+        writeConfig.preallocate=downloadsJson.value("preallocate", writeConfig.preallocate);
+        writeConfig.directIo=downloadsJson.value("direct_io", writeConfig.directIo);
+        arbiterAI::ModelRuntime::instance().setDownloadWriteConfig(writeConfig);
+        spdlog::info("Download writes: {} MB buffers, preallocate {}, O_DIRECT {}",
+            writeConfig.bufferBytes/(1024*1024), writeConfig.preallocate?"on":"off", writeConfig.directIo?"on":"off");
+
+        std::vector<std::string> peers;
+        if(downloadsJson.contains("peers")&&downloadsJson["peers"].is_array())
+        {
+            for(const nlohmann::json &peer:downloadsJson["peers"])
+            {
+                peers.push_back(peer.get<std::string>());
+            }
+        }
+        if(!peers.empty())
+        {
+            arbiterAI::ModelRuntime::instance().setDownloadPeers(peers);
+            spdlog::info("Downloads: {} peer server(s) tried before the origin", peers.size());
+        }
+
+        bool servePeers=downloadsJson.value("serve_peers", true);
+        arbiterAI::server::setPeerServing(servePeers);
+        if(!servePeers)
+        {
+            spdlog::info("Serving stored models to peer servers is disabled");
+        }
+    }
+
+    if(idleContextTimeout>0)
+    {
+        arbiterAI::ModelRuntime::instance().setDefaultIdleContextTimeout(idleContextTimeout);
+        spdlog::info("Idle context timeout set to {}s", idleContextTimeout);
+    }
+
+    if(cpuThreads>0)
+    {
+        arbiterAI::ModelRuntime::instance().setCpuThreads(cpuThreads);
+        spdlog::info("CPU threads shared by models limited to {}", cpuThreads);
+    }
+
+    if(loraCacheMb>=0)
+    {
+        arbiterAI::ModelRuntime::instance().setLoraCacheBudget(loraCacheMb);
+        spdlog::info("LoRA adapter cache limited to {} MB", loraCacheMb);
+    }
+
+    // ── Data-parallel replicas ──────────────────────────────────
+    if(cfg.contains("replicas")&&cfg["replicas"].is_object())
+    {
+        const nlohmann::json &replicasJson=cfg["replicas"];
+        for(auto it=replicasJson.begin(); it!=replicasJson.end(); ++it)
+        {
+            const std::string &model=it.key();
+            const nlohmann::json &value=it.value();
+            arbiterAI::ReplicaPolicy policy;
+            if(value.is_number_integer())
+            {
+                policy.minReplicas=value.get<int>();
+                policy.maxReplicas=policy.minReplicas;
+            }
+            else if(value.is_object())
+            {
+                policy.minReplicas=value.value("min", 1);
+                policy.maxReplicas=value.value("max", policy.minReplicas);
+                policy.scaleUpQueueDepth=value.value("scale_up_queue_depth", policy.scaleUpQueueDepth);
+                policy.scaleDownIdleSeconds=value.value("scale_down_idle_seconds", policy.scaleDownIdleSeconds);
+            }
+            else
+            {
+                spdlog::warn("Ignoring replicas entry for '{}': expected a count or an object", model);
+                continue;
+            }
+
+            arbiterAI::ModelRuntime::instance().setReplicaPolicy(model, policy);
+            spdlog::info("Replicas for '{}': min={}, max={}", model, policy.minReplicas, policy.maxReplicas);
+        }
+    }
+
+    // ── Request admission queue ─────────────────────────────────
+    if(cfg.contains("request_queue")&&cfg["request_queue"].is_object())
+    {
+        const nlohmann::json &queueJson=cfg["request_queue"];
+        arbiterAI::RequestQueueConfig queueConfig;
+        queueConfig.maxDepth=queueJson.value("max_depth", queueConfig.maxDepth);
+        queueConfig.maxPerTenant=queueJson.value("max_per_tenant", queueConfig.maxPerTenant);
+        if(queueJson.contains("tenant_weights")&&queueJson["tenant_weights"].is_object())
+        {
+            const nlohmann::json &weightsJson=queueJson["tenant_weights"];
+            for(auto it=weightsJson.begin(); it!=weightsJson.end(); ++it)
+            {
+                queueConfig.tenantWeights[it.key()]=it.value().get<double>();
+            }
+        }
+
+        arbiterAI::ModelRuntime::instance().setRequestQueueConfig(queueConfig);
+        spdlog::info("Request queue: max depth {}, max per tenant {}",
+            queueConfig.maxDepth, queueConfig.maxPerTenant);
+    }
+
+    // ── Memory pressure ─────────────────────────────────────────
+    if(cfg.contains("memory_pressure")&&cfg["memory_pressure"].is_object())
+    {
+        const nlohmann::json &pressureJson=cfg["memory_pressure"];
+        arbiterAI::MemoryPressureThresholds thresholds;
+        thresholds.someAvg10Moderate=pressureJson.value("psi_some_avg10_moderate", thresholds.someAvg10Moderate);
+        thresholds.fullAvg10Critical=pressureJson.value("psi_full_avg10_critical", thresholds.fullAvg10Critical);
+        thresholds.cgroupModeratePercent=pressureJson.value("cgroup_moderate_percent", thresholds.cgroupModeratePercent);
+        thresholds.cgroupCriticalPercent=pressureJson.value("cgroup_critical_percent", thresholds.cgroupCriticalPercent);
+
+        bool enabled=pressureJson.value("enabled", true);
+
+        arbiterAI::ModelRuntime &runtime=arbiterAI::ModelRuntime::instance();
+        runtime.setMemoryPressureThresholds(thresholds);
+        runtime.setMemoryPressureMonitorEnabled(enabled);
+        if(!enabled)
+        {
+            spdlog::info("Memory pressure monitoring disabled");
+        }
+    }
+
     // ── Load startup models ─────────────────────────────────────
     arbiterAI::HardwareDetector::instance().refresh();
     arbiterAI::SystemInfo startupHardware=arbiterAI::HardwareDetector::instance().getSystemInfo();
@@ -676,6 +943,12 @@ int main(int argc, char *argv[])
     // New format: startup_models array (preferred)
     std::vector<StartupModelEntry> startupModels=parseStartupModels(cfg);
 
+    if(!autotuneModel.empty())
+    {
+        // Tune one model with the machine to itself, then exit
+        return runAutotune(autotuneModel, startupModels);
+    }
+
     if(!startupModels.empty())
     {
         for(const StartupModelEntry &entry:startupModels)
@@ -786,6 +1059,8 @@ int main(int argc, char *argv[])
     spdlog::info("  POST /api/models/:name/unload - Unload a model");
     spdlog::info("  POST /api/models/:name/pin     - Pin a model");
     spdlog::info("  POST /api/models/:name/unpin   - Unpin a model");
+    spdlog::info("  POST /api/models/:name/autotune - Benchmark and store runtime options");
+    spdlog::info("  GET  /api/models/:name/autotune - Stored autotune results");
     spdlog::info("  POST /api/models/config        - Add model config(s)");
     spdlog::info("  PUT  /api/models/config        - Add/update model config(s)");
     spdlog::info("  GET  /api/models/config/:name  - Get model config");
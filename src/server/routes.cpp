@@ -10,16 +10,22 @@
 #include "arbiterAI/hardwareDetector.h"
 #include "arbiterAI/telemetryCollector.h"
 #include "arbiterAI/storageManager.h"
+#include "arbiterAI/autotuner.h"
+#include "arbiterAI/downloadScheduler.h"
 
 #include <nlohmann/json.hpp>
 #include <spdlog/spdlog.h>
 #include <algorithm>
+#include <cmath>
 #include <ctime>
+#include <filesystem>
 #include <fstream>
 #include <random>
 #include <sstream>
 #include <iomanip>
 #include <mutex>
+#include <atomic>
+#include <memory>
 
 namespace arbiterAI
 {
@@ -32,6 +38,7 @@ namespace
 std::string g_overridePath;
 std::string g_serverConfigPath;
 std::mutex g_serverConfigMutex;
+std::atomic<bool> g_peerServing{true};
 constexpr const char *STARTUP_ACCELERATOR_CPU="cpu";
 constexpr const char *STARTUP_ACCELERATOR_CUDA="cuda";
 constexpr const char *STARTUP_ACCELERATOR_VULKAN="vulkan";
@@ -771,12 +778,24 @@ nlohmann::json systemInfoToJson(const SystemInfo &hw)
         gpus.push_back(gpuJson);
     }
 
+    nlohmann::json numaNodes=nlohmann::json::array();
+    for(const NumaNode &node:hw.numaNodes)
+    {
+        numaNodes.push_back({
+            {"id", node.id},
+            {"cpus", node.cpus},
+            {"total_ram_mb", node.totalRamMb},
+            {"free_ram_mb", node.freeRamMb}
+        });
+    }
+
     return {
         {"total_ram_mb", hw.totalRamMb},
         {"free_ram_mb", hw.freeRamMb},
         {"cpu_cores", hw.cpuCores},
         {"cpu_utilization_percent", hw.cpuUtilizationPercent},
-        {"gpus", gpus}
+        {"gpus", gpus},
+        {"numa_nodes", numaNodes}
     };
 }
 
@@ -815,6 +834,36 @@ nlohmann::json runtimeOptionsToJson(const RuntimeOptions &opts)
         j["override_tensor"]=opts.overrideTensor.value();
     if(opts.vulkanNoHostVisibleVram.has_value())
         j["vulkan_no_host_visible_vram"]=opts.vulkanNoHostVisibleVram.value();
+    if(opts.mlock.has_value())
+        j["mlock"]=opts.mlock.value();
+    if(opts.idleContextTimeoutSeconds.has_value())
+        j["idle_context_timeout_seconds"]=opts.idleContextTimeoutSeconds.value();
+    if(opts.idleShrinkContext.has_value())
+        j["idle_shrink_context"]=opts.idleShrinkContext.value();
+    if(opts.dynamicContext.has_value())
+        j["dynamic_context"]=opts.dynamicContext.value();
+    if(opts.initialContextSize.has_value())
+        j["initial_context_size"]=opts.initialContextSize.value();
+    if(opts.kvOffload.has_value())
+        j["kv_offload"]=opts.kvOffload.value();
+    if(opts.autoPlacement.has_value())
+        j["auto_placement"]=opts.autoPlacement.value();
+    if(opts.nThreads.has_value())
+        j["n_threads"]=opts.nThreads.value();
+    if(opts.nThreadsBatch.has_value())
+        j["n_threads_batch"]=opts.nThreadsBatch.value();
+    if(opts.nBatch.has_value())
+        j["n_batch"]=opts.nBatch.value();
+    if(opts.nUbatch.has_value())
+        j["n_ubatch"]=opts.nUbatch.value();
+    if(opts.autotune.has_value())
+        j["autotune"]=opts.autotune.value();
+    if(opts.numaPolicy.has_value())
+        j["numa_policy"]=opts.numaPolicy.value();
+    if(opts.numaNode.has_value())
+        j["numa_node"]=opts.numaNode.value();
+    if(opts.warmup.has_value())
+        j["warmup"]=opts.warmup.value();
 
     return j;
 }
@@ -841,6 +890,36 @@ RuntimeOptions parseRuntimeOptions(const nlohmann::json &j)
         opts.overrideTensor=j["override_tensor"].get<std::string>();
     if(j.contains("vulkan_no_host_visible_vram")&&j["vulkan_no_host_visible_vram"].is_boolean())
         opts.vulkanNoHostVisibleVram=j["vulkan_no_host_visible_vram"].get<bool>();
+    if(j.contains("mlock")&&j["mlock"].is_boolean())
+        opts.mlock=j["mlock"].get<bool>();
+    if(j.contains("idle_context_timeout_seconds")&&j["idle_context_timeout_seconds"].is_number_integer())
+        opts.idleContextTimeoutSeconds=j["idle_context_timeout_seconds"].get<int>();
+    if(j.contains("idle_shrink_context")&&j["idle_shrink_context"].is_boolean())
+        opts.idleShrinkContext=j["idle_shrink_context"].get<bool>();
+    if(j.contains("dynamic_context")&&j["dynamic_context"].is_boolean())
+        opts.dynamicContext=j["dynamic_context"].get<bool>();
+    if(j.contains("initial_context_size")&&j["initial_context_size"].is_number_integer())
+        opts.initialContextSize=j["initial_context_size"].get<int>();
+    if(j.contains("kv_offload")&&j["kv_offload"].is_boolean())
+        opts.kvOffload=j["kv_offload"].get<bool>();
+    if(j.contains("auto_placement")&&j["auto_placement"].is_boolean())
+        opts.autoPlacement=j["auto_placement"].get<bool>();
+    if(j.contains("n_threads")&&j["n_threads"].is_number_integer())
+        opts.nThreads=j["n_threads"].get<int>();
+    if(j.contains("n_threads_batch")&&j["n_threads_batch"].is_number_integer())
+        opts.nThreadsBatch=j["n_threads_batch"].get<int>();
+    if(j.contains("n_batch")&&j["n_batch"].is_number_integer())
+        opts.nBatch=j["n_batch"].get<int>();
+    if(j.contains("n_ubatch")&&j["n_ubatch"].is_number_integer())
+        opts.nUbatch=j["n_ubatch"].get<int>();
+    if(j.contains("autotune")&&j["autotune"].is_boolean())
+        opts.autotune=j["autotune"].get<bool>();
+    if(j.contains("numa_policy")&&j["numa_policy"].is_string())
+        opts.numaPolicy=j["numa_policy"].get<std::string>();
+    if(j.contains("numa_node")&&j["numa_node"].is_number_integer())
+        opts.numaNode=j["numa_node"].get<int>();
+    if(j.contains("warmup")&&j["warmup"].is_boolean())
+        opts.warmup=j["warmup"].get<bool>();
 
     return opts;
 }
@@ -865,7 +944,14 @@ nlohmann::json loadedModelToJson(const LoadedModel &m)
         {"gpu_indices", gpuIndices},
         {"pinned", m.pinned},
         {"graph_splits", m.graphSplits},
-        {"cpu_mapped_buffer_mb", m.cpuMappedBufferMb}
+        {"cpu_mapped_buffer_mb", m.cpuMappedBufferMb},
+        {"measured_ram_mb", m.measuredRamMb},
+        {"weights_resident", m.llamaModel!=nullptr||!m.residentWeights.empty()},
+        {"loaded_from", m.loadedFrom},
+        {"load_time_ms", m.loadTimeMs},
+        {"warmup_time_ms", m.warmupTimeMs},
+        {"context_reclaimed", m.contextReclaimed},
+        {"context_limit", m.contextLimit}
     };
 
     if(!m.perGpuVramMb.empty())
@@ -894,12 +980,119 @@ nlohmann::json loadedModelToJson(const LoadedModel &m)
         j["device_allocations"]=allocations;
     }
 
+    if(m.placement.has_value())
+    {
+        const PlacementPlan &plan=m.placement.value();
+        j["placement"]={
+            {"strategy", plan.strategy},
+            {"n_gpu_layers", plan.nGpuLayers},
+            {"override_tensor", plan.overrideTensor},
+            {"kv_offload", plan.kvOffload},
+            {"context_size", plan.contextSize},
+            {"gpu_mb", plan.gpuMb},
+            {"cpu_mb", plan.cpuMb},
+            {"estimated_tokens_per_second", plan.estimatedTokensPerSec},
+            {"reason", plan.reason}
+        };
+    }
+
+    if(m.autotuned)
+    {
+        j["autotuned"]=true;
+    }
+
+    if(!m.numaPolicy.empty())
+    {
+        j["numa"]={
+            {"policy", m.numaPolicy},
+            {"node", m.numaNode}
+        };
+    }
+
+    CpuThreadShare cpuThreads=m.cpuThreads?m.cpuThreads->lastApplied():CpuThreadShare{};
+    if(cpuThreads.nThreads>0)
+    {
+        j["cpu_threads"]={
+            {"decode", cpuThreads.nThreads},
+            {"prefill", cpuThreads.nThreadsBatch},
+            {"numa_node", cpuThreads.node}
+        };
+    }
+
     nlohmann::json activeOpts=runtimeOptionsToJson(m.activeOptions);
     if(!activeOpts.empty())
     {
         j["runtime_options"]=activeOpts;
     }
 
+    if(!m.loraAdapters.empty())
+    {
+        nlohmann::json adapters=nlohmann::json::array();
+        for(const auto &pair:m.loraAdapters)
+        {
+            auto applied=std::find_if(m.appliedLoras.begin(), m.appliedLoras.end(),
+                [&pair](const LoraSelection &selection)
+                {
+                    return selection.path==pair.first;
+                });
+
+            nlohmann::json adapterJson={
+                {"path", pair.first},
+                {"size_mb", pair.second.sizeMb},
+                {"applied", applied!=m.appliedLoras.end()}
+            };
+            if(applied!=m.appliedLoras.end())
+            {
+                adapterJson["scale"]=applied->scale;
+            }
+            adapters.push_back(adapterJson);
+        }
+        j["lora_adapters"]=adapters;
+    }
+
+    if(m.replicaOf.empty())
+    {
+        ModelRuntime &runtime=ModelRuntime::instance();
+
+        if(m.state==ModelState::Loaded)
+        {
+            RequestQueueStats queue=runtime.getRequestQueueStats(m.modelName);
+            j["queue"]={
+                {"waiting", queue.waiting},
+                {"running", queue.running},
+                {"slots", queue.slots}
+            };
+        }
+
+        std::vector<LoadedModel> replicas=runtime.getReplicaStates(m.modelName);
+        if(!replicas.empty())
+        {
+            j["in_flight"]=runtime.getInFlightRequests(m.modelName);
+
+            nlohmann::json replicasJson=nlohmann::json::array();
+            for(const LoadedModel &replica:replicas)
+            {
+                nlohmann::json replicaJson={
+                    {"index", replica.replicaIndex},
+                    {"state", modelStateToString(replica.state)},
+                    {"gpu_indices", replica.gpuIndices},
+                    {"context_size", replica.contextSize},
+                    {"context_reclaimed", replica.contextReclaimed},
+                    {"in_flight", runtime.getInFlightRequests(replica.modelName)}
+                };
+                if(!replica.numaPolicy.empty())
+                {
+                    replicaJson["numa"]={
+                        {"policy", replica.numaPolicy},
+                        {"node", replica.numaNode}
+                    };
+                }
+                replicasJson.push_back(replicaJson);
+            }
+            j["replicas"]=replicasJson;
+        }
+    }
+
     return j;
 }
 
@@ -916,7 +1109,8 @@ nlohmann::json inferenceStatsToJson(const InferenceStats &s)
         {"latency_ms", s.latencyMs},
         {"total_time_ms", s.totalTimeMs},
         {"prompt_time_ms", s.promptTimeMs},
-        {"generation_time_ms", s.generationTimeMs}
+        {"generation_time_ms", s.generationTimeMs},
+        {"queue_wait_ms", s.queueWaitMs}
     };
 }
 
@@ -925,10 +1119,86 @@ nlohmann::json swapEventToJson(const SwapEvent &e)
     return {
         {"from", e.from},
         {"to", e.to},
+        {"time_ms", e.timeMs},
+        {"loaded_from", e.loadedFrom},
+        {"load_time_ms", e.loadTimeMs}
+    };
+}
+
+nlohmann::json contextResizeEventToJson(const ContextResizeEvent &e)
+{
+    return {
+        {"model", e.model},
+        {"from_context", e.fromContext},
+        {"to_context", e.toContext},
+        {"reason", e.reason},
+        {"state_carried", e.stateCarried},
         {"time_ms", e.timeMs}
     };
 }
 
+nlohmann::json memoryPressureEventToJson(const MemoryPressureEvent &e)
+{
+    return {
+        {"action", e.action},
+        {"level", e.level},
+        {"model", e.model},
+        {"freed_mb", e.freedMb},
+        {"psi_some_avg10", e.someAvg10},
+        {"psi_full_avg10", e.fullAvg10},
+        {"cgroup_usage_percent", e.cgroupUsagePercent}
+    };
+}
+
+nlohmann::json memoryPressureToJson(const MemoryPressureSample &s)
+{
+    nlohmann::json j={
+        {"level", MemoryPressureMonitor::levelToString(s.level)},
+        {"psi_available", s.psiAvailable},
+        {"psi_some_avg10", s.someAvg10},
+        {"psi_full_avg10", s.fullAvg10},
+        {"cgroup_limited", s.cgroupLimited}
+    };
+    if(s.cgroupLimited)
+    {
+        j["cgroup_current_bytes"]=s.cgroupCurrentBytes;
+        j["cgroup_inactive_file_bytes"]=s.cgroupInactiveFileBytes;
+        j["cgroup_max_bytes"]=s.cgroupMaxBytes;
+        j["cgroup_usage_percent"]=s.cgroupUsagePercent();
+    }
+    return j;
+}
+
+nlohmann::json autotuneResultToJson(const AutotuneResult &r)
+{
+    nlohmann::json trials=nlohmann::json::array();
+    for(const AutotuneTrial &trial:r.trials)
+    {
+        trials.push_back({
+            {"options", runtimeOptionsToJson(trial.options)},
+            {"ok", trial.ok},
+            {"prompt_tokens_per_sec", trial.result.promptTokensPerSec},
+            {"generation_tokens_per_sec", trial.result.generationTokensPerSec},
+            {"score", trial.score}
+        });
+    }
+
+    return {
+        {"model", r.model},
+        {"variant", r.variant},
+        {"hardware_fingerprint", r.hardwareFingerprint},
+        {"best", {
+            {"options", runtimeOptionsToJson(r.best)},
+            {"prompt_tokens_per_sec", r.bestResult.promptTokensPerSec},
+            {"generation_tokens_per_sec", r.bestResult.generationTokensPerSec},
+            {"score", r.bestScore}
+        }},
+        {"trials", trials},
+        {"updated_at", std::chrono::duration_cast<std::chrono::seconds>(
+            r.updatedAt.time_since_epoch()).count()}
+    };
+}
+
 nlohmann::json modelFitToJson(const ModelFit &f)
 {
     nlohmann::json gpuIndices=nlohmann::json::array();
@@ -944,7 +1214,9 @@ nlohmann::json modelFitToJson(const ModelFit &f)
         {"max_context_size", f.maxContextSize},
         {"limiting_factor", f.limitingFactor},
         {"estimated_vram_mb", f.estimatedVramUsageMb},
-        {"gpu_indices", gpuIndices}
+        {"gpu_indices", gpuIndices},
+        {"kv_cache_type", f.kvCacheType},
+        {"estimate_source", f.estimateSource}
     };
 }
 
@@ -967,6 +1239,8 @@ std::string errorCodeToString(ErrorCode code)
         case ErrorCode::NotImplemented:      return "not_implemented";
         case ErrorCode::GenerationError:     return "generation_error";
         case ErrorCode::ApiKeyNotFound:      return "api_key_not_found";
+        case ErrorCode::QueueFull:           return "queue_full";
+        case ErrorCode::TooManyRequests:     return "too_many_requests";
         default:                             return "unknown_error";
     }
 }
@@ -998,6 +1272,39 @@ std::pair<std::string, std::string> parseModelVariant(const std::string &modelId
     return {modelId, ""};
 }
 
+/// Tenant a request is queued under: the bearer API key, else the OpenAI
+/// "user" field, else the shared anonymous tenant.
+std::string requestTenant(const httplib::Request &req, const nlohmann::json &body)
+{
+    std::string auth=req.get_header_value("Authorization");
+    if(auth.rfind("Bearer ", 0)==0&&auth.size()>7)
+    {
+        return auth.substr(7);
+    }
+    if(body.contains("user")&&body.at("user").is_string())
+    {
+        return body.at("user").get<std::string>();
+    }
+    return "";
+}
+
+/// Reject a request the admission queue turned away (503 when the model's
+/// queue is full, 429 when the tenant has too many requests waiting).
+bool sendQueueRejection(ErrorCode err, httplib::Response &res)
+{
+    if(err!=ErrorCode::QueueFull&&err!=ErrorCode::TooManyRequests)
+    {
+        return false;
+    }
+
+    std::string errCode=errorCodeToString(err);
+    res.status=err==ErrorCode::QueueFull?503:429;
+    res.set_header("Retry-After", "1");
+    res.set_content(errorJson(err==ErrorCode::QueueFull?"Model request queue is full":"Too many queued requests for this API key",
+        err==ErrorCode::QueueFull?"server_error":"rate_limit_error", "", errCode).dump(), "application/json");
+    return true;
+}
+
 } // anonymous namespace
 
 // ========== Override Path ==========
@@ -1013,6 +1320,11 @@ void setOverridePath(const std::string &path)
     g_overridePath=path;
 }
 
+void setPeerServing(bool enabled)
+{
+    g_peerServing=enabled;
+}
+
 // ========== Route Registration ==========
 
 void registerRoutes(httplib::Server &server)
@@ -1035,7 +1347,7 @@ void registerRoutes(httplib::Server &server)
     {
         res.set_header("Access-Control-Allow-Origin", "*");
         res.set_header("Access-Control-Allow-Methods", "GET, POST, PUT, OPTIONS, DELETE");
-        res.set_header("Access-Control-Allow-Headers", "Content-Type, Authorization");
+        res.set_header("Access-Control-Allow-Headers", "Content-Type, Authorization, X-Priority");
         res.set_header("Access-Control-Max-Age", "86400");
         res.status=204;
     });
@@ -1045,7 +1357,8 @@ void registerRoutes(httplib::Server &server)
     {
         res.set_header("Access-Control-Allow-Origin", "*");
         res.set_header("Access-Control-Allow-Methods", "GET, POST, OPTIONS, DELETE");
-        res.set_header("Access-Control-Allow-Headers", "Content-Type, Authorization");
+        res.set_header("Access-Control-Allow-Headers", "Content-Type, Authorization, X-Priority");
+        res.set_header("Access-Control-Expose-Headers", "X-Queue-Position, Retry-After");
     });
 
     // Health check
@@ -1077,6 +1390,8 @@ void registerRoutes(httplib::Server &server)
     server.Post(R"(/api/models/([^/]+)/unpin)", handleUnpinModel);
     server.Post(R"(/api/models/([^/]+)/download)", handleDownloadModel);
     server.Get(R"(/api/models/([^/]+)/download)", handleGetDownloadStatus);
+    server.Post(R"(/api/models/([^/]+)/autotune)", handleAutotuneModel);
+    server.Get(R"(/api/models/([^/]+)/autotune)", handleGetAutotune);
 
     // Model config injection
     server.Post("/api/models/config", handleAddModelConfig);
@@ -1088,6 +1403,8 @@ void registerRoutes(httplib::Server &server)
     server.Get("/api/stats", handleGetStats);
     server.Get("/api/stats/history", handleGetStatsHistory);
     server.Get("/api/stats/swaps", handleGetStatsSwaps);
+    server.Get("/api/stats/context-resizes", handleGetStatsContextResizes);
+    server.Get("/api/stats/memory-pressure", handleGetStatsMemoryPressure);
     server.Get("/api/hardware", handleGetHardware);
     server.Post("/api/hardware/vram-override", handleSetVramOverride);
     server.Delete(R"(/api/hardware/vram-override/(\d+))", handleClearVramOverride);
@@ -1115,6 +1432,9 @@ void registerRoutes(httplib::Server &server)
     server.Put("/api/storage/cleanup/config", handleSetCleanupConfig);
     server.Get("/api/downloads", handleGetActiveDownloads);
 
+    // Stored model content for peer servers (GET and HEAD, Range-capable)
+    server.Get(R"(/api/blobs/sha256/([0-9a-fA-F]{64}))", handleGetBlob);
+
     // Dashboard
     server.Get("/dashboard/config", handleDashboardConfig);
     server.Get("/dashboard/storage", handleDashboardStorage);
@@ -1231,6 +1551,24 @@ void handleChatCompletions(const httplib::Request &req, httplib::Response &res)
             arbiterRequest.presence_penalty=requestJson.at("presence_penalty").get<double>();
         if(requestJson.contains("frequency_penalty"))
             arbiterRequest.frequency_penalty=requestJson.at("frequency_penalty").get<double>();
+        // LoRA scales: {"name": scale} or [{"name": ..., "scale": ...}]
+        if(requestJson.contains("lora"))
+        {
+            const nlohmann::json &loraJson=requestJson.at("lora");
+            std::map<std::string, double> scales;
+            if(loraJson.is_array())
+            {
+                for(const nlohmann::json &adapter:loraJson)
+                {
+                    scales[adapter.at("name").get<std::string>()]=adapter.value("scale", 1.0);
+                }
+            }
+            else
+            {
+                scales=loraJson.get<std::map<std::string, double>>();
+            }
+            arbiterRequest.lora=std::move(scales);
+        }
         if(requestJson.contains("stop"))
         {
             if(requestJson.at("stop").is_string())
@@ -1267,7 +1605,23 @@ void handleChatCompletions(const httplib::Request &req, httplib::Response &res)
                 arbiterRequest.tool_choice=requestJson.at("tool_choice").dump();
         }
 
-        // n, response_format, logprobs, user, seed: accepted but not used for inference
+        // Local models queue requests fairly per tenant; "batch" requests
+        // wait until no interactive request is queued
+        arbiterRequest.tenant=requestTenant(req, requestJson);
+        std::string priority=requestJson.contains("priority")?requestJson.at("priority").get<std::string>()
+            :req.get_header_value("X-Priority");
+        if(!priority.empty())
+        {
+            if(priority!="interactive"&&priority!="batch")
+            {
+                res.status=400;
+                res.set_content(errorJson("priority must be \"interactive\" or \"batch\"", "invalid_request_error", "priority", "invalid_request").dump(), "application/json");
+                return;
+            }
+            arbiterRequest.priority=priority=="batch"?RequestPriority::Batch:RequestPriority::Interactive;
+        }
+
+        // n, response_format, logprobs, seed: accepted but not used for inference
         // (prevents client-side errors from unrecognized parameters)
     }
     catch(const nlohmann::json::exception &e)
@@ -1291,6 +1645,13 @@ void handleChatCompletions(const httplib::Request &req, httplib::Response &res)
 
     if(stream)
     {
+        // Turn away requests the model's queue cannot take before the stream
+        // starts; admitted ones report their queue position as SSE comments
+        if(sendQueueRejection(ModelRuntime::instance().checkAdmission(arbiterRequest.model, arbiterRequest.tenant.value_or("")), res))
+        {
+            return;
+        }
+
         res.set_chunked_content_provider(
             "text/event-stream",
             [arbiterRequest, requestId, created, includeUsage, responseModelId](size_t, httplib::DataSink &sink)
@@ -1330,7 +1691,14 @@ void handleChatCompletions(const httplib::Request &req, httplib::Response &res)
                     sink.write(line.c_str(), line.length());
                 };
 
-                ErrorCode err=ArbiterAI::instance().streamingCompletion(arbiterRequest, callback);
+                CompletionRequest queuedRequest=arbiterRequest;
+                queuedRequest.onQueuePosition=[&sink](int position)
+                {
+                    std::string comment=": queue_position "+std::to_string(position)+"\n\n";
+                    sink.write(comment.c_str(), comment.length());
+                };
+
+                ErrorCode err=ArbiterAI::instance().streamingCompletion(queuedRequest, callback);
 
                 std::string finishReason=(err==ErrorCode::Success)?"stop":"error";
 
@@ -1384,9 +1752,23 @@ void handleChatCompletions(const httplib::Request &req, httplib::Response &res)
     }
     else
     {
+        int queuePosition=0;
+        arbiterRequest.onQueuePosition=[&queuePosition](int position)
+        {
+            if(queuePosition==0)
+            {
+                queuePosition=position;
+            }
+        };
+
         CompletionResponse arbiterResponse;
         ErrorCode err=ArbiterAI::instance().completion(arbiterRequest, arbiterResponse);
 
+        if(sendQueueRejection(err, res))
+        {
+            return;
+        }
+
         if(err!=ErrorCode::Success)
         {
             int status=500;
@@ -1465,6 +1847,8 @@ void handleChatCompletions(const httplib::Request &req, httplib::Response &res)
             }}
         };
 
+        // Position the request held when it joined the queue (0 = ran immediately)
+        res.set_header("X-Queue-Position", std::to_string(queuePosition));
         res.set_content(responseJson.dump(), "application/json");
     }
 }
@@ -2167,12 +2551,31 @@ void handleDownloadModel(const httplib::Request &req, httplib::Response &res)
     if(req.has_param("variant"))
         variant=req.get_param_value("variant");
 
-    ErrorCode err=ArbiterAI::instance().downloadModel(modelName, variant);
+    DownloadPriority priority=DownloadPriority::Explicit;
+    if(req.has_param("priority")&&!DownloadScheduler::parsePriority(req.get_param_value("priority"), priority))
+    {
+        res.status=400;
+        res.set_content(errorJson("Invalid priority '"+req.get_param_value("priority")+"' (expected user_blocking, explicit or prefetch)",
+            "invalid_request_error", "priority").dump(), "application/json");
+        return;
+    }
+
+    ErrorCode err=ArbiterAI::instance().downloadModel(modelName, variant, priority);
 
     if(err==ErrorCode::ModelDownloading)
     {
+        nlohmann::json response={{"status", "downloading"}, {"model", modelName}};
+        for(const QueuedDownload &queued:ModelRuntime::instance().getDownloadQueue())
+        {
+            if(queued.model==modelName)
+            {
+                response["priority"]=DownloadScheduler::priorityToString(queued.priority);
+                response["queue_position"]=queued.position;
+                break;
+            }
+        }
         res.status=202;
-        res.set_content(nlohmann::json{{"status", "downloading"}, {"model", modelName}}.dump(), "application/json");
+        res.set_content(response.dump(), "application/json");
     }
     else if(err==ErrorCode::Success)
     {
@@ -2248,11 +2651,84 @@ void handleGetDownloadStatus(const httplib::Request &req, httplib::Response &res
         response["percent_complete"]=snap->percentComplete;
         response["speed_mbps"]=snap->speedMbps;
         response["eta_seconds"]=snap->etaSeconds;
+        response["connections"]=snap->connections;
+        response["files"]=snap->files;
+        response["files_completed"]=snap->filesCompleted;
+    }
+
+    for(const QueuedDownload &queued:ModelRuntime::instance().getDownloadQueue())
+    {
+        if(queued.model==modelName)
+        {
+            response["priority"]=DownloadScheduler::priorityToString(queued.priority);
+            response["queue_position"]=queued.position;
+            break;
+        }
     }
 
     res.set_content(response.dump(), "application/json");
 }
 
+void handleAutotuneModel(const httplib::Request &req, httplib::Response &res)
+{
+    std::string modelName=req.matches[1];
+
+    try
+    {
+        AutotuneConfig config;
+        if(!req.body.empty())
+        {
+            nlohmann::json body=nlohmann::json::parse(req.body);
+            config.promptTokens=std::max(1, body.value("prompt_tokens", config.promptTokens));
+            config.generateTokens=std::max(1, body.value("generate_tokens", config.generateTokens));
+        }
+
+        AutotuneResult result;
+        ErrorCode err=ModelRuntime::instance().autotune(modelName, config, result);
+
+        if(err==ErrorCode::Success)
+        {
+            res.set_content(autotuneResultToJson(result).dump(), "application/json");
+        }
+        else
+        {
+            res.status=(err==ErrorCode::InvalidRequest)?409:400;
+            std::string message=(err==ErrorCode::ModelNotLoaded)
+                ?"Model must be loaded before autotuning"
+                :(err==ErrorCode::InvalidRequest)
+                    ?"Model is serving requests; retry when it is idle"
+                    :"Autotune failed: "+errorCodeToString(err);
+            res.set_content(errorJson(message, "invalid_request_error", "model", errorCodeToString(err)).dump(), "application/json");
+        }
+    }
+    catch(const std::exception &e)
+    {
+        res.status=400;
+        res.set_content(errorJson(std::string("Invalid request: ")+e.what(), "invalid_request_error").dump(), "application/json");
+    }
+}
+
+void handleGetAutotune(const httplib::Request &req, httplib::Response &res)
+{
+    std::string modelName=req.matches[1];
+    std::string fingerprint=Autotuner::hardwareFingerprint(HardwareDetector::instance().getSystemInfo());
+
+    nlohmann::json results=nlohmann::json::array();
+    for(const auto &pair:AutotuneStore::instance().getAll())
+    {
+        if(pair.second.model==modelName&&pair.second.hardwareFingerprint==fingerprint)
+        {
+            results.push_back(autotuneResultToJson(pair.second));
+        }
+    }
+
+    res.set_content(nlohmann::json{
+        {"model", modelName},
+        {"hardware_fingerprint", fingerprint},
+        {"results", results}
+    }.dump(), "application/json");
+}
+
 // ========== Model Config Injection ==========
 
 void handleAddModelConfig(const httplib::Request &req, httplib::Response &res)
@@ -2453,7 +2929,8 @@ void handleGetStats(const httplib::Request &, httplib::Response &res)
         {"avg_tokens_per_second", snapshot.avgTokensPerSecond},
         {"avg_prompt_tokens_per_second", snapshot.avgPromptTokensPerSecond},
         {"avg_generation_tokens_per_second", snapshot.avgGenerationTokensPerSecond},
-        {"active_requests", snapshot.activeRequests}
+        {"active_requests", snapshot.activeRequests},
+        {"memory_pressure", memoryPressureToJson(ModelRuntime::instance().getMemoryPressure())}
     };
 
     res.set_content(response.dump(), "application/json");
@@ -2493,6 +2970,32 @@ void handleGetStatsSwaps(const httplib::Request &, httplib::Response &res)
     res.set_content(arr.dump(), "application/json");
 }
 
+void handleGetStatsContextResizes(const httplib::Request &, httplib::Response &res)
+{
+    std::vector<ContextResizeEvent> resizes=TelemetryCollector::instance().getContextResizeHistory();
+
+    nlohmann::json arr=nlohmann::json::array();
+    for(const ContextResizeEvent &e:resizes)
+    {
+        arr.push_back(contextResizeEventToJson(e));
+    }
+
+    res.set_content(arr.dump(), "application/json");
+}
+
+void handleGetStatsMemoryPressure(const httplib::Request &, httplib::Response &res)
+{
+    std::vector<MemoryPressureEvent> events=TelemetryCollector::instance().getMemoryPressureHistory();
+
+    nlohmann::json arr=nlohmann::json::array();
+    for(const MemoryPressureEvent &e:events)
+    {
+        arr.push_back(memoryPressureEventToJson(e));
+    }
+
+    res.set_content(arr.dump(), "application/json");
+}
+
 void handleGetHardware(const httplib::Request &, httplib::Response &res)
 {
     HardwareDetector::instance().refresh();
@@ -2624,6 +3127,46 @@ nlohmann::json downloadedModelToJson(const DownloadedModelFile &f)
     {
         j["additional_files"]=f.additionalFiles;
     }
+    if(!f.fileHashes.empty())
+    {
+        j["sha256"]=f.fileHashes;
+    }
+    return j;
+}
+
+/// downloadedModelToJson plus page-cache residency of each file (mincore).
+nlohmann::json downloadedModelWithResidencyToJson(const DownloadedModelFile &f)
+{
+    nlohmann::json j=downloadedModelToJson(f);
+
+    std::vector<FileResidency> residency=StorageManager::instance().getResidency(f);
+    int64_t sizeBytes=0;
+    int64_t residentBytes=0;
+    int64_t lockedBytes=0;
+    nlohmann::json files=nlohmann::json::array();
+    for(const FileResidency &r:residency)
+    {
+        sizeBytes+=r.sizeBytes;
+        residentBytes+=r.residentBytes;
+        if(r.locked)
+        {
+            lockedBytes+=r.sizeBytes;
+        }
+        files.push_back({
+            {"filename", std::filesystem::path(r.path).filename().string()},
+            {"resident_bytes", r.residentBytes},
+            {"resident_percent", std::round(r.residentPercent()*10.0)/10.0},
+            {"locked", r.locked}
+        });
+    }
+
+    j["page_cache"]={
+        {"resident_bytes", residentBytes},
+        {"resident_percent", sizeBytes>0?std::round(1000.0*static_cast<double>(residentBytes)/static_cast<double>(sizeBytes))/10.0:0.0},
+        {"locked_bytes", lockedBytes},
+        {"warming", f.hotReady},
+        {"files", files}
+    };
     return j;
 }
 
@@ -2638,6 +3181,8 @@ void handleGetStorage(const httplib::Request &, httplib::Response &res)
         {"total_disk_bytes", info.totalDiskBytes},
         {"free_disk_bytes", info.freeDiskBytes},
         {"used_by_models_bytes", info.usedByModelsBytes},
+        {"deduplicated_bytes", info.deduplicatedBytes},
+        {"blob_count", info.blobCount},
         {"storage_limit_bytes", info.storageLimitBytes},
         {"available_for_models_bytes", info.availableForModelsBytes},
         {"model_count", info.modelCount},
@@ -2675,7 +3220,7 @@ void handleGetStorageModels(const httplib::Request &req, httplib::Response &res)
     nlohmann::json modelsJson=nlohmann::json::array();
     for(const DownloadedModelFile &f:models)
     {
-        modelsJson.push_back(downloadedModelToJson(f));
+        modelsJson.push_back(downloadedModelWithResidencyToJson(f));
         totalSize+=f.fileSizeBytes;
     }
 
@@ -2705,7 +3250,7 @@ void handleGetStorageModel(const httplib::Request &req, httplib::Response &res)
     int64_t totalSize=0;
     for(const DownloadedModelFile &f:variants)
     {
-        variantsJson.push_back(downloadedModelToJson(f));
+        variantsJson.push_back(downloadedModelWithResidencyToJson(f));
         totalSize+=f.fileSizeBytes;
     }
 
@@ -2733,7 +3278,7 @@ void handleGetStorageModelVariant(const httplib::Request &req, httplib::Response
         return;
     }
 
-    res.set_content(downloadedModelToJson(stats.value()).dump(), "application/json");
+    res.set_content(downloadedModelWithResidencyToJson(stats.value()).dump(), "application/json");
 }
 
 void handleSetStorageLimit(const httplib::Request &req, httplib::Response &res)
@@ -3005,14 +3550,75 @@ void handleSetCleanupConfig(const httplib::Request &req, httplib::Response &res)
     }
 }
 
+void handleGetBlob(const httplib::Request &req, httplib::Response &res)
+{
+    if(!g_peerServing)
+    {
+        res.status=404;
+        res.set_content(errorJson("Serving to peers is disabled", "not_found_error").dump(), "application/json");
+        return;
+    }
+
+    std::string hash=req.matches[1];
+    std::optional<std::filesystem::path> blob=StorageManager::instance().getBlobPath(hash);
+
+    // The open stream keeps the content readable even if the model is
+    // deleted mid-transfer
+    std::shared_ptr<std::ifstream> file;
+    std::error_code ec;
+    uintmax_t size=0;
+    if(blob)
+    {
+        size=std::filesystem::file_size(*blob, ec);
+        file=std::make_shared<std::ifstream>(*blob, std::ios::binary);
+    }
+    if(!blob||ec||!file->is_open())
+    {
+        res.status=404;
+        res.set_content(errorJson("Blob not found: "+hash, "not_found_error").dump(), "application/json");
+        return;
+    }
+
+    // httplib answers Range requests (206) and HEAD from the sized provider
+    res.set_header("Accept-Ranges", "bytes");
+    res.set_header("ETag", "\"sha256-"+hash+"\"");
+    res.set_content_provider(static_cast<size_t>(size), "application/octet-stream",
+        [file](size_t offset, size_t length, httplib::DataSink &sink) -> bool
+        {
+            std::vector<char> buffer(std::min<size_t>(length, 1024*1024));
+            file->seekg(static_cast<std::streamoff>(offset));
+            file->read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            std::streamsize bytesRead=file->gcount();
+            if(bytesRead<=0)
+            {
+                return false;
+            }
+            return sink.write(buffer.data(), static_cast<size_t>(bytesRead));
+        });
+}
+
 void handleGetActiveDownloads(const httplib::Request &, httplib::Response &res)
 {
     // Get snapshots with speed and ETA from ModelRuntime
     std::vector<DownloadProgressSnapshot> snapshots=ModelRuntime::instance().getActiveDownloadSnapshots();
+    std::vector<QueuedDownload> queue=ModelRuntime::instance().getDownloadQueue();
+
+    auto findQueued=[&queue](const std::string &model) -> const QueuedDownload *
+    {
+        for(const QueuedDownload &queued:queue)
+        {
+            if(queued.model==model)
+            {
+                return &queued;
+            }
+        }
+        return nullptr;
+    };
 
     nlohmann::json downloads=nlohmann::json::array();
     for(const DownloadProgressSnapshot &snap:snapshots)
     {
+        const QueuedDownload *queued=findQueued(snap.modelName);
         nlohmann::json dl={
             {"model", snap.modelName},
             {"variant", snap.variant},
@@ -3021,7 +3627,12 @@ void handleGetActiveDownloads(const httplib::Request &, httplib::Response &res)
             {"total_bytes", snap.totalBytes},
             {"percent_complete", snap.percentComplete},
             {"speed_mbps", snap.speedMbps},
-            {"eta_seconds", snap.etaSeconds}
+            {"eta_seconds", snap.etaSeconds},
+            {"connections", snap.connections},
+            {"files", snap.files},
+            {"files_completed", snap.filesCompleted},
+            {"priority", DownloadScheduler::priorityToString(queued?queued->priority:snap.priority)},
+            {"queue_position", queued?queued->position:snap.queuePosition}
         };
         downloads.push_back(dl);
     }
@@ -3048,6 +3659,7 @@ void handleGetActiveDownloads(const httplib::Request &, httplib::Response &res)
 
         if(!alreadyIncluded)
         {
+            const QueuedDownload *queued=findQueued(m.modelName);
             nlohmann::json dl={
                 {"model", m.modelName},
                 {"variant", m.variant},
@@ -3056,7 +3668,12 @@ void handleGetActiveDownloads(const httplib::Request &, httplib::Response &res)
                 {"total_bytes", 0},
                 {"percent_complete", 0.0},
                 {"speed_mbps", 0.0},
-                {"eta_seconds", 0}
+                {"eta_seconds", 0},
+                {"connections", 0},
+                {"files", 0},
+                {"files_completed", 0},
+                {"priority", DownloadScheduler::priorityToString(queued?queued->priority:DownloadPriority::Explicit)},
+                {"queue_position", queued?queued->position:0}
             };
             downloads.push_back(dl);
         }
@@ -3123,6 +3740,97 @@ void handleGetRuntimeOptions(const httplib::Request &, httplib::Response &res)
         {"description", "Tensor override pattern (-ot). Advanced: route specific tensors to CPU/GPU."},
         {"default", nullptr}
     });
+    options.push_back({
+        {"name", "mlock"},
+        {"type", "boolean"},
+        {"description", "Lock model weights in RAM (--mlock). Also locks the Ready-tier weight mapping."},
+        {"default", false}
+    });
+    options.push_back({
+        {"name", "idle_context_timeout_seconds"},
+        {"type", "integer"},
+        {"description", "Free the KV cache and compute buffers after this many idle seconds, keeping the weights loaded. 0 disables."},
+        {"default", nullptr}
+    });
+    options.push_back({
+        {"name", "idle_shrink_context"},
+        {"type", "boolean"},
+        {"description", "When recreating a reclaimed context, size it to recent request lengths instead of the load-time context."},
+        {"default", false}
+    });
+    options.push_back({
+        {"name", "dynamic_context"},
+        {"type", "boolean"},
+        {"description", "Start with initial_context_size and grow the context on demand, up to the hardware-fit limit. Shrinks back under VRAM pressure."},
+        {"default", false}
+    });
+    options.push_back({
+        {"name", "initial_context_size"},
+        {"type", "integer"},
+        {"description", "Starting context size when dynamic_context is enabled."},
+        {"default", 4096}
+    });
+    options.push_back({
+        {"name", "kv_offload"},
+        {"type", "boolean"},
+        {"description", "Keep the KV cache of offloaded layers on the GPU. false keeps it in host memory (--no-kv-offload)."},
+        {"default", nullptr}
+    });
+    options.push_back({
+        {"name", "auto_placement"},
+        {"type", "boolean"},
+        {"description", "Plan n_gpu_layers, override_tensor and kv_offload from GGUF tensor sizes and free VRAM/RAM. Explicit n_gpu_layers or override_tensor disable the plan."},
+        {"default", true}
+    });
+    options.push_back({
+        {"name", "n_threads"},
+        {"type", "integer"},
+        {"description", "Maximum CPU threads for token generation (-t). Cores are shared between models decoding at the same time, so fewer may be used."},
+        {"default", nullptr}
+    });
+    options.push_back({
+        {"name", "n_threads_batch"},
+        {"type", "integer"},
+        {"description", "Maximum CPU threads for prompt processing (-tb)."},
+        {"default", nullptr}
+    });
+    options.push_back({
+        {"name", "n_batch"},
+        {"type", "integer"},
+        {"description", "Logical batch size for prompt processing (-b)."},
+        {"default", 2048}
+    });
+    options.push_back({
+        {"name", "n_ubatch"},
+        {"type", "integer"},
+        {"description", "Physical batch size submitted to the backend (-ub). Must not exceed n_batch."},
+        {"default", 512}
+    });
+    options.push_back({
+        {"name", "autotune"},
+        {"type", "boolean"},
+        {"description", "Apply the options stored by the autotuner for this model, variant and hardware. Explicitly set options still win."},
+        {"default", true}
+    });
+    options.push_back({
+        {"name", "numa_policy"},
+        {"type", "string"},
+        {"description", "NUMA placement of host-resident weights, KV cache and CPU threads on multi-node machines. auto binds to one node when the host part fits its free memory and interleaves otherwise."},
+        {"default", "auto"},
+        {"valid_values", {"auto", "bind", "interleave", "none"}}
+    });
+    options.push_back({
+        {"name", "numa_node"},
+        {"type", "integer"},
+        {"description", "NUMA node to bind to (index into /api/hardware numa_nodes). Default: the node with the most free memory."},
+        {"default", nullptr}
+    });
+    options.push_back({
+        {"name", "warmup"},
+        {"type", "boolean"},
+        {"description", "Read the weights ahead and run a tiny prefill+decode before the model is marked Loaded, so the first request does not pay for page faults and graph setup. Reported as warmup_time_ms."},
+        {"default", true}
+    });
 
     nlohmann::json backendPriorityInfo={
         {"name", "backend_priority"},
@@ -17,6 +17,9 @@ void setServerConfigPath(const std::string &path);
 /// Set the override path for persisting runtime model configs.
 void setOverridePath(const std::string &path);
 
+/// Allow or refuse serving stored model content to peer servers (default: allowed).
+void setPeerServing(bool enabled);
+
 // ========== Chat Completions (OpenAI-compatible) ==========
 
 void handleChatCompletions(const httplib::Request &req, httplib::Response &res);
@@ -51,6 +54,8 @@ void handlePinModel(const httplib::Request &req, httplib::Response &res);
 void handleUnpinModel(const httplib::Request &req, httplib::Response &res);
 void handleDownloadModel(const httplib::Request &req, httplib::Response &res);
 void handleGetDownloadStatus(const httplib::Request &req, httplib::Response &res);
+void handleAutotuneModel(const httplib::Request &req, httplib::Response &res);
+void handleGetAutotune(const httplib::Request &req, httplib::Response &res);
 
 // ========== Model Config Injection ==========
 
@@ -64,6 +69,8 @@ void handleDeleteModelConfig(const httplib::Request &req, httplib::Response &res
 void handleGetStats(const httplib::Request &req, httplib::Response &res);
 void handleGetStatsHistory(const httplib::Request &req, httplib::Response &res);
 void handleGetStatsSwaps(const httplib::Request &req, httplib::Response &res);
+void handleGetStatsContextResizes(const httplib::Request &req, httplib::Response &res);
+void handleGetStatsMemoryPressure(const httplib::Request &req, httplib::Response &res);
 void handleGetHardware(const httplib::Request &req, httplib::Response &res);
 void handleSetVramOverride(const httplib::Request &req, httplib::Response &res);
 void handleClearVramOverride(const httplib::Request &req, httplib::Response &res);
@@ -93,6 +100,7 @@ void handleRunCleanup(const httplib::Request &req, httplib::Response &res);
 void handleGetCleanupConfig(const httplib::Request &req, httplib::Response &res);
 void handleSetCleanupConfig(const httplib::Request &req, httplib::Response &res);
 void handleGetActiveDownloads(const httplib::Request &req, httplib::Response &res);
+void handleGetBlob(const httplib::Request &req, httplib::Response &res);
 
 // ========== Dashboard ==========
 
@@ -0,0 +1,177 @@
+#include "arbiterAI/autotuner.h"
+#include <gtest/gtest.h>
+#include <filesystem>
+
+namespace arbiterAI
+{
+
+class AutotunerTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        AutotuneStore::reset();
+        m_path=std::filesystem::temp_directory_path()/"arbiterai_autotune_test.json";
+        std::filesystem::remove(m_path);
+    }
+
+    void TearDown() override
+    {
+        AutotuneStore::reset();
+        std::filesystem::remove(m_path);
+    }
+
+    std::filesystem::path m_path;
+};
+
+TEST_F(AutotunerTest, ScoreWeighsPrefillAndDecode)
+{
+    AutotuneConfig config;
+    config.promptTokens=500;
+    config.generateTokens=50;
+
+    BenchmarkResult result;
+    result.promptTokensPerSec=1000.0;
+    result.generationTokensPerSec=50.0;
+
+    // 0.5s prefill + 1s decode
+    EXPECT_NEAR(Autotuner::score(result, config), 1.0/1.5, 1e-9);
+
+    result.generationTokensPerSec=0.0;
+    EXPECT_EQ(Autotuner::score(result, config), 0.0);
+}
+
+TEST_F(AutotunerTest, SweepKeepsBestOfEachDimension)
+{
+    AutotuneConfig config;
+
+    // Decode is fastest without flash attention and with half the cores;
+    // prefill is fastest with n_ubatch 256 and all cores
+    int calls=0;
+    AutotuneResult result=Autotuner::sweep(8, config, [&](const RuntimeOptions &options, BenchmarkResult &bench)
+    {
+        ++calls;
+        bench.promptTokensPerSec=1000.0;
+        bench.generationTokensPerSec=50.0;
+        if(!options.flashAttn.value())
+        {
+            bench.generationTokensPerSec+=10.0;
+        }
+        if(options.nUbatch.value()==256)
+        {
+            bench.promptTokensPerSec+=200.0;
+        }
+        if(options.nThreads.value()==4)
+        {
+            bench.generationTokensPerSec+=5.0;
+        }
+        if(options.nThreadsBatch.value()!=8)
+        {
+            bench.promptTokensPerSec-=300.0;
+        }
+        return true;
+    });
+
+    EXPECT_FALSE(result.best.flashAttn.value());
+    EXPECT_EQ(result.best.kvCacheTypeK.value(), "f16");
+    EXPECT_EQ(result.best.nUbatch.value(), 256);
+    EXPECT_EQ(result.best.nThreads.value(), 4);
+    EXPECT_EQ(result.best.nThreadsBatch.value(), 8);
+    EXPECT_NEAR(result.bestResult.generationTokensPerSec, 65.0, 1e-9);
+
+    // Flash attention off skips the quantized KV trial and repeats are not rerun
+    EXPECT_EQ(calls, static_cast<int>(result.trials.size()));
+    for(const AutotuneTrial &trial:result.trials)
+    {
+        EXPECT_EQ(trial.options.kvCacheTypeK.value(), "f16");
+        EXPECT_LE(trial.options.nUbatch.value(), trial.options.nBatch.value());
+    }
+}
+
+TEST_F(AutotunerTest, FailedTrialsNeverWin)
+{
+    AutotuneConfig config;
+    AutotuneResult result=Autotuner::sweep(4, config, [](const RuntimeOptions &options, BenchmarkResult &bench)
+    {
+        // q8_0 would be fastest but the context cannot be created
+        bench.promptTokensPerSec=options.kvCacheTypeK.value()=="q8_0"?5000.0:1000.0;
+        bench.generationTokensPerSec=50.0;
+        return options.kvCacheTypeK.value()!="q8_0";
+    });
+
+    EXPECT_EQ(result.best.kvCacheTypeK.value(), "f16");
+    bool sawFailure=false;
+    for(const AutotuneTrial &trial:result.trials)
+    {
+        if(!trial.ok)
+        {
+            sawFailure=true;
+            EXPECT_EQ(trial.score, 0.0);
+        }
+    }
+    EXPECT_TRUE(sawFailure);
+}
+
+TEST_F(AutotunerTest, FingerprintIgnoresFreeMemory)
+{
+    SystemInfo hw;
+    hw.cpuCores=16;
+    hw.totalRamMb=65300;
+    hw.freeRamMb=30000;
+
+    GpuInfo gpu;
+    gpu.name="RTX 4090";
+    gpu.backend=GpuBackend::CUDA;
+    gpu.vramTotalMb=24564;
+    gpu.vramFreeMb=20000;
+    hw.gpus.push_back(gpu);
+
+    std::string fingerprint=Autotuner::hardwareFingerprint(hw);
+    EXPECT_EQ(fingerprint, "cpu16-ram64g-cuda:RTX 4090:24g");
+
+    hw.freeRamMb=1000;
+    hw.gpus[0].vramFreeMb=100;
+    EXPECT_EQ(Autotuner::hardwareFingerprint(hw), fingerprint);
+
+    hw.gpus.clear();
+    EXPECT_NE(Autotuner::hardwareFingerprint(hw), fingerprint);
+}
+
+TEST_F(AutotunerTest, StorePersistsPerHardware)
+{
+    AutotuneStore::instance().load(m_path);
+
+    AutotuneResult result;
+    result.model="test-model";
+    result.variant="Q4_K_M";
+    result.hardwareFingerprint="cpu8-ram32g";
+    result.best.flashAttn=true;
+    result.best.nBatch=1024;
+    result.best.nUbatch=256;
+    result.bestResult.promptTokensPerSec=1234.5;
+    result.bestScore=2.0;
+    AutotuneTrial trial;
+    trial.options=result.best;
+    trial.ok=true;
+    result.trials.push_back(trial);
+    AutotuneStore::instance().record(result);
+
+    // Reload from disk
+    AutotuneStore::reset();
+    AutotuneStore::instance().load(m_path);
+
+    std::optional<AutotuneResult> loaded=AutotuneStore::instance().get("test-model", "Q4_K_M", "cpu8-ram32g");
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_TRUE(loaded->best.flashAttn.value());
+    EXPECT_EQ(loaded->best.nBatch.value(), 1024);
+    EXPECT_EQ(loaded->best.nUbatch.value(), 256);
+    EXPECT_FALSE(loaded->best.nThreads.has_value());
+    EXPECT_NEAR(loaded->bestResult.promptTokensPerSec, 1234.5, 1e-9);
+    ASSERT_EQ(loaded->trials.size(), 1u);
+    EXPECT_TRUE(loaded->trials[0].ok);
+
+    EXPECT_FALSE(AutotuneStore::instance().get("test-model", "Q4_K_M", "cpu16-ram64g").has_value());
+    EXPECT_FALSE(AutotuneStore::instance().get("test-model", "Q8_0", "cpu8-ram32g").has_value());
+}
+
+} // namespace arbiterAI
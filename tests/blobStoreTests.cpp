@@ -0,0 +1,114 @@
+#include "arbiterAI/blobStore.h"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+
+namespace arbiterAI
+{
+
+class BlobStoreTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_testDir="blob_store_test";
+        std::filesystem::create_directories(m_testDir);
+        m_store.setRoot(m_testDir/"blobs");
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(m_testDir);
+    }
+
+    std::filesystem::path writeFile(const std::string &name, const std::string &content)
+    {
+        std::filesystem::path path=m_testDir/name;
+        std::ofstream out(path, std::ios::binary);
+        out<<content;
+        return path;
+    }
+
+    const std::string m_hash="9f86d081884c7d659a2feaa0c55ad015a3bf4f1b2b0b822cd15d6c15b0f00a08";
+    std::filesystem::path m_testDir;
+    BlobStore m_store;
+};
+
+TEST_F(BlobStoreTest, ValidatesHashes)
+{
+    EXPECT_TRUE(BlobStore::isValidHash(m_hash));
+    EXPECT_TRUE(BlobStore::isValidHash("9F86D081884C7D659A2FEAA0C55AD015A3BF4F1B2B0B822CD15D6C15B0F00A08"));
+    EXPECT_FALSE(BlobStore::isValidHash(""));
+    EXPECT_FALSE(BlobStore::isValidHash("9f86d081"));
+    EXPECT_FALSE(BlobStore::isValidHash(std::string(64, 'z')));
+}
+
+TEST_F(BlobStoreTest, SecondCopyBecomesALink)
+{
+    std::filesystem::path first=writeFile("model-a-Q4.gguf", "weights");
+    std::filesystem::path second=writeFile("model-b-Q4.gguf", "weights");
+
+    ASSERT_TRUE(m_store.adopt(m_hash, first));
+    EXPECT_TRUE(m_store.contains(m_hash));
+    EXPECT_EQ(m_store.refCount(m_hash), 1);
+    EXPECT_EQ(m_store.blobSize(m_hash), 7);
+
+    int64_t duplicateBytes=0;
+    ASSERT_TRUE(m_store.adopt(m_hash, second, &duplicateBytes));
+    EXPECT_EQ(duplicateBytes, 7);
+    EXPECT_EQ(m_store.refCount(m_hash), 2);
+    EXPECT_TRUE(std::filesystem::equivalent(first, second));
+
+    // Adopting an already linked path changes nothing
+    ASSERT_TRUE(m_store.adopt(m_hash, second, &duplicateBytes));
+    EXPECT_EQ(duplicateBytes, 0);
+    EXPECT_EQ(m_store.refCount(m_hash), 2);
+}
+
+TEST_F(BlobStoreTest, LinkNeedsStoredContent)
+{
+    EXPECT_FALSE(m_store.link(m_hash, m_testDir/"alias.gguf"));
+
+    m_store.adopt(m_hash, writeFile("model.gguf", "weights"));
+    ASSERT_TRUE(m_store.link(m_hash, m_testDir/"alias.gguf"));
+    EXPECT_EQ(m_store.refCount(m_hash), 2);
+    EXPECT_EQ(std::filesystem::file_size(m_testDir/"alias.gguf"), 7u);
+}
+
+TEST_F(BlobStoreTest, BlobIsDeletedWithItsLastReference)
+{
+    std::filesystem::path first=writeFile("model-a.gguf", "weights");
+    m_store.adopt(m_hash, first);
+    std::filesystem::path second=m_testDir/"model-b.gguf";
+    m_store.link(m_hash, second);
+
+    EXPECT_EQ(m_store.release(m_hash, first), 0);
+    EXPECT_FALSE(std::filesystem::exists(first));
+    EXPECT_TRUE(m_store.contains(m_hash));
+    EXPECT_EQ(m_store.refCount(m_hash), 1);
+
+    EXPECT_EQ(m_store.release(m_hash, second), 7);
+    EXPECT_FALSE(std::filesystem::exists(second));
+    EXPECT_FALSE(m_store.contains(m_hash));
+}
+
+TEST_F(BlobStoreTest, ReleaseRemovesUnstoredFiles)
+{
+    std::filesystem::path path=writeFile("plain.gguf", "weights!");
+    EXPECT_EQ(m_store.release("", path), 8);
+    EXPECT_FALSE(std::filesystem::exists(path));
+}
+
+TEST_F(BlobStoreTest, GarbageCollectionDropsOrphans)
+{
+    std::filesystem::path path=writeFile("model.gguf", "weights");
+    m_store.adopt(m_hash, path);
+    EXPECT_EQ(m_store.collectGarbage(), 0);
+
+    // Model file deleted behind the store's back
+    std::filesystem::remove(path);
+    EXPECT_EQ(m_store.collectGarbage(), 7);
+    EXPECT_FALSE(m_store.contains(m_hash));
+}
+
+} // namespace arbiterAI
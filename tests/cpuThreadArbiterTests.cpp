@@ -0,0 +1,125 @@
+#include "arbiterAI/cpuThreadArbiter.h"
+#include <gtest/gtest.h>
+
+namespace arbiterAI
+{
+
+class CpuThreadArbiterTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_arbiter.setNodes({{0, 1, 2, 3, 4, 5, 6, 7}});
+    }
+
+    CpuThreadArbiter m_arbiter;
+};
+
+TEST_F(CpuThreadArbiterTest, SingleModelGetsEveryCore)
+{
+    m_arbiter.begin("a");
+
+    CpuThreadShare share=m_arbiter.share("a");
+    EXPECT_EQ(share.nThreads, 8);
+    EXPECT_EQ(share.nThreadsBatch, 8);
+    EXPECT_EQ(share.node, 0);
+}
+
+TEST_F(CpuThreadArbiterTest, ConcurrentModelsSplitByQueueDepth)
+{
+    m_arbiter.begin("a");
+    m_arbiter.begin("b");
+    EXPECT_EQ(m_arbiter.share("a").nThreads, 4);
+    EXPECT_EQ(m_arbiter.share("b").nThreads, 4);
+
+    // Three requests in flight on "a" against one on "b"
+    m_arbiter.begin("a");
+    m_arbiter.begin("a");
+    EXPECT_EQ(m_arbiter.queueDepth("a"), 3);
+    EXPECT_EQ(m_arbiter.share("a").nThreads, 6);
+    EXPECT_EQ(m_arbiter.share("b").nThreads, 2);
+
+    // "b" finishing hands its cores back
+    m_arbiter.end("b");
+    EXPECT_EQ(m_arbiter.share("a").nThreads, 8);
+}
+
+TEST_F(CpuThreadArbiterTest, PerModelCapsAreSeparateForPrefillAndDecode)
+{
+    m_arbiter.begin("a");
+
+    CpuThreadShare share=m_arbiter.share("a", 2, 6);
+    EXPECT_EQ(share.nThreads, 2);
+    EXPECT_EQ(share.nThreadsBatch, 6);
+}
+
+TEST_F(CpuThreadArbiterTest, MaxThreadsLimitsEveryShare)
+{
+    m_arbiter.setMaxThreads(4);
+    m_arbiter.begin("a");
+
+    EXPECT_EQ(m_arbiter.share("a").nThreads, 4);
+    EXPECT_EQ(m_arbiter.nodeCpus(0).size(), 4u);
+}
+
+TEST_F(CpuThreadArbiterTest, ModelsSpreadAcrossNumaNodes)
+{
+    m_arbiter.setNodes({{0, 1, 2, 3}, {4, 5, 6, 7}});
+    m_arbiter.begin("a");
+    m_arbiter.begin("b");
+
+    CpuThreadShare a=m_arbiter.share("a");
+    CpuThreadShare b=m_arbiter.share("b");
+    EXPECT_NE(a.node, b.node);
+
+    // Each model owns its node's cores instead of sharing all eight
+    EXPECT_EQ(a.nThreads, 4);
+    EXPECT_EQ(b.nThreads, 4);
+
+    m_arbiter.remove("a");
+    m_arbiter.begin("c");
+    EXPECT_EQ(m_arbiter.share("c").node, a.node);
+}
+
+TEST_F(CpuThreadArbiterTest, InterleavedModelSharesEveryNode)
+{
+    m_arbiter.setNodes({{0, 1, 2, 3}, {4, 5, 6, 7}});
+    m_arbiter.setHomeNode("wide", CpuThreadArbiter::ALL_NODES);
+    m_arbiter.setHomeNode("local", 1);
+    m_arbiter.begin("wide");
+
+    CpuThreadShare wide=m_arbiter.share("wide");
+    EXPECT_EQ(wide.node, CpuThreadArbiter::ALL_NODES);
+    EXPECT_EQ(wide.nThreads, 8);
+    EXPECT_EQ(m_arbiter.nodeCpus(CpuThreadArbiter::ALL_NODES).size(), 8u);
+
+    // A model bound to one node competes with the interleaved one there
+    m_arbiter.begin("local");
+    EXPECT_EQ(m_arbiter.share("local").node, 1);
+    EXPECT_EQ(m_arbiter.share("local").nThreads, 2);
+    EXPECT_EQ(m_arbiter.share("wide").nThreads, 4);
+
+    // Invalid nodes are ignored
+    m_arbiter.setHomeNode("other", 5);
+    m_arbiter.begin("other");
+    EXPECT_NE(m_arbiter.share("other").node, 5);
+}
+
+TEST_F(CpuThreadArbiterTest, GenerationMovesWhenSharesMayChange)
+{
+    m_arbiter.setNodes({{0, 1, 2, 3}});
+    uint64_t start=m_arbiter.generation();
+
+    // Asking for a share changes nothing
+    m_arbiter.share("a");
+    EXPECT_EQ(m_arbiter.generation(), start);
+
+    m_arbiter.begin("a");
+    uint64_t begun=m_arbiter.generation();
+    EXPECT_NE(begun, start);
+
+    m_arbiter.end("a");
+    EXPECT_NE(m_arbiter.generation(), begun);
+}
+
+} // namespace arbiterAI
@@ -0,0 +1,157 @@
+#include "arbiterAI/directoryIndex.h"
+#include "arbiterAI/directoryWatcher.h"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+namespace arbiterAI
+{
+
+class DirectoryIndexTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_testDir="directory_index_test";
+        std::filesystem::create_directories(m_testDir);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(m_testDir);
+    }
+
+    void writeFile(const std::string &name, const std::string &content)
+    {
+        std::ofstream out(m_testDir/name, std::ios::binary);
+        out<<content;
+    }
+
+    static bool isGguf(const std::string &filename)
+    {
+        return filename.size()>5&&filename.substr(filename.size()-5)==".gguf";
+    }
+
+    std::filesystem::path m_testDir;
+};
+
+TEST_F(DirectoryIndexTest, RefreshIndexesMatchingFiles)
+{
+    writeFile("a-Q4.gguf", "aaaa");
+    writeFile("notes.txt", "ignored");
+
+    DirectoryIndex index;
+    ASSERT_TRUE(index.refresh(m_testDir, isGguf));
+    ASSERT_EQ(index.size(), 1u);
+
+    const IndexedFile *record=index.find("a-Q4.gguf");
+    ASSERT_NE(record, nullptr);
+    EXPECT_EQ(record->sizeBytes, 4);
+    EXPECT_GT(record->mtimeNs, 0);
+    EXPECT_TRUE(index.isDirty());
+    EXPECT_EQ(index.find("notes.txt"), nullptr);
+}
+
+TEST_F(DirectoryIndexTest, SavedIndexSkipsKnownFiles)
+{
+    writeFile("a-Q4.gguf", "aaaa");
+
+    DirectoryIndex index;
+    index.refresh(m_testDir, isGguf);
+    index.setHash("a-Q4.gguf", std::string(64, 'a'));
+    ASSERT_TRUE(index.save(m_testDir/"index.json"));
+    EXPECT_FALSE(index.isDirty());
+
+    // Known names keep their record without being stat()ed again
+    writeFile("a-Q4.gguf", "grown since");
+    DirectoryIndex reloaded;
+    ASSERT_TRUE(reloaded.load(m_testDir/"index.json"));
+    ASSERT_TRUE(reloaded.refresh(m_testDir, isGguf));
+    EXPECT_FALSE(reloaded.isDirty());
+    EXPECT_EQ(reloaded.find("a-Q4.gguf")->sizeBytes, 4);
+    EXPECT_EQ(reloaded.find("a-Q4.gguf")->sha256, std::string(64, 'a'));
+
+    // ...but checking it shows it changed, and an update drops the hash
+    EXPECT_FALSE(reloaded.isCurrent(m_testDir, "a-Q4.gguf"));
+    std::optional<IndexedFile> updated=reloaded.update(m_testDir, "a-Q4.gguf");
+    ASSERT_TRUE(updated.has_value());
+    EXPECT_EQ(updated->sizeBytes, 11);
+    EXPECT_TRUE(updated->sha256.empty());
+    EXPECT_TRUE(reloaded.isCurrent(m_testDir, "a-Q4.gguf"));
+}
+
+TEST_F(DirectoryIndexTest, RemovedFilesLeaveTheIndex)
+{
+    writeFile("a-Q4.gguf", "aaaa");
+    writeFile("b-Q4.gguf", "bbbb");
+
+    DirectoryIndex index;
+    index.refresh(m_testDir, isGguf);
+    std::filesystem::remove(m_testDir/"a-Q4.gguf");
+
+    EXPECT_FALSE(index.update(m_testDir, "a-Q4.gguf").has_value());
+    EXPECT_EQ(index.filenames(), std::vector<std::string>{"b-Q4.gguf"});
+
+    std::filesystem::remove(m_testDir/"b-Q4.gguf");
+    index.refresh(m_testDir, isGguf);
+    EXPECT_EQ(index.size(), 0u);
+}
+
+TEST_F(DirectoryIndexTest, UnreadableIndexLoadsEmpty)
+{
+    writeFile("index.json", "{not json");
+
+    DirectoryIndex index;
+    EXPECT_FALSE(index.load(m_testDir/"index.json"));
+    EXPECT_EQ(index.size(), 0u);
+    EXPECT_FALSE(index.load(m_testDir/"missing.json"));
+}
+
+#ifdef __linux__
+TEST_F(DirectoryIndexTest, WatcherReportsSettledChanges)
+{
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<DirectoryChange> seen;
+
+    DirectoryWatcher watcher;
+    ASSERT_TRUE(watcher.start(m_testDir, [&](const std::vector<DirectoryChange> &changes, bool)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        seen.insert(seen.end(), changes.begin(), changes.end());
+        cv.notify_all();
+    }, std::chrono::milliseconds(50)));
+
+    // Written in several steps, reported once
+    {
+        std::ofstream out(m_testDir/"copied-Q4.gguf", std::ios::binary);
+        out<<"part one";
+        out.flush();
+        out<<"part two";
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    ASSERT_TRUE(cv.wait_for(lock, std::chrono::seconds(5), [&]() { return !seen.empty(); }));
+    ASSERT_EQ(seen.size(), 1u);
+    EXPECT_EQ(seen[0].filename, "copied-Q4.gguf");
+    EXPECT_TRUE(seen[0].exists);
+    seen.clear();
+    lock.unlock();
+
+    std::filesystem::remove(m_testDir/"copied-Q4.gguf");
+
+    lock.lock();
+    ASSERT_TRUE(cv.wait_for(lock, std::chrono::seconds(5), [&]() { return !seen.empty(); }));
+    EXPECT_EQ(seen[0].filename, "copied-Q4.gguf");
+    EXPECT_FALSE(seen[0].exists);
+    lock.unlock();
+
+    watcher.stop();
+    EXPECT_FALSE(watcher.isRunning());
+}
+#endif
+
+} // namespace arbiterAI
@@ -0,0 +1,134 @@
+#include "arbiterAI/downloadScheduler.h"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+#include <mutex>
+#include <chrono>
+
+namespace arbiterAI
+{
+
+class DownloadSchedulerTest : public ::testing::Test
+{
+protected:
+    /// Start a thread that takes a connection and records the order it got one.
+    std::thread startWaiter(DownloadPriority priority, const std::string &name)
+    {
+        return std::thread([this, priority, name]()
+        {
+            m_scheduler.acquire(priority);
+            {
+                std::lock_guard<std::mutex> lock(m_orderMutex);
+                m_order.push_back(name);
+            }
+            m_scheduler.release();
+        });
+    }
+
+    DownloadScheduler m_scheduler;
+    std::mutex m_orderMutex;
+    std::vector<std::string> m_order;
+};
+
+TEST_F(DownloadSchedulerTest, ParsesPriorityNames)
+{
+    DownloadPriority priority=DownloadPriority::Explicit;
+    EXPECT_TRUE(DownloadScheduler::parsePriority("user_blocking", priority));
+    EXPECT_EQ(priority, DownloadPriority::UserBlocking);
+    EXPECT_TRUE(DownloadScheduler::parsePriority("prefetch", priority));
+    EXPECT_EQ(priority, DownloadPriority::Prefetch);
+    EXPECT_TRUE(DownloadScheduler::parsePriority("explicit", priority));
+    EXPECT_EQ(priority, DownloadPriority::Explicit);
+    EXPECT_FALSE(DownloadScheduler::parsePriority("urgent", priority));
+
+    EXPECT_EQ(DownloadScheduler::priorityToString(DownloadPriority::UserBlocking), "user_blocking");
+}
+
+TEST_F(DownloadSchedulerTest, WaitersAreServedByPriority)
+{
+    m_scheduler.setMaxConnections(1);
+    m_scheduler.acquire(DownloadPriority::Explicit);
+    EXPECT_EQ(m_scheduler.inUse(), 1);
+
+    std::thread prefetch=startWaiter(DownloadPriority::Prefetch, "prefetch");
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    std::thread blocking=startWaiter(DownloadPriority::UserBlocking, "user_blocking");
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    // The holder is asked to make way for the user-blocking waiter only
+    EXPECT_TRUE(m_scheduler.shouldYield(DownloadPriority::Explicit));
+    EXPECT_FALSE(m_scheduler.shouldYield(DownloadPriority::UserBlocking));
+
+    m_scheduler.release();
+    prefetch.join();
+    blocking.join();
+
+    ASSERT_EQ(m_order.size(), 2u);
+    EXPECT_EQ(m_order[0], "user_blocking");
+    EXPECT_EQ(m_order[1], "prefetch");
+    EXPECT_EQ(m_scheduler.inUse(), 0);
+    EXPECT_FALSE(m_scheduler.shouldYield(DownloadPriority::Prefetch));
+}
+
+TEST_F(DownloadSchedulerTest, OnlyAsManyHoldersYieldAsNeeded)
+{
+    m_scheduler.setMaxConnections(3);
+    for(int i=0; i<3; ++i)
+    {
+        m_scheduler.acquire(DownloadPriority::Prefetch);
+    }
+
+    std::thread first=startWaiter(DownloadPriority::UserBlocking, "first");
+    std::thread second=startWaiter(DownloadPriority::UserBlocking, "second");
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    // Two waiters need two connections; the third holder keeps downloading
+    EXPECT_TRUE(m_scheduler.shouldYield(DownloadPriority::Prefetch));
+    EXPECT_TRUE(m_scheduler.shouldYield(DownloadPriority::Prefetch));
+    EXPECT_FALSE(m_scheduler.shouldYield(DownloadPriority::Prefetch));
+
+    m_scheduler.release();
+    m_scheduler.release();
+    first.join();
+    second.join();
+
+    EXPECT_EQ(m_order.size(), 2u);
+    EXPECT_EQ(m_scheduler.inUse(), 1);
+    EXPECT_FALSE(m_scheduler.shouldYield(DownloadPriority::Prefetch));
+    m_scheduler.release();
+}
+
+TEST_F(DownloadSchedulerTest, ThrottleHoldsTransferToLimit)
+{
+    // 1 MB/s with a single transfer: 512 KB beyond the initial burst takes ~0.5s
+    m_scheduler.setBandwidthLimit(1024*1024);
+    int id=m_scheduler.addTransfer(DownloadPriority::Explicit);
+
+    std::chrono::steady_clock::time_point start=std::chrono::steady_clock::now();
+    for(int i=0; i<12; ++i)
+    {
+        m_scheduler.throttle(id, 64*1024);
+    }
+    double elapsed=std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+    m_scheduler.removeTransfer(id);
+
+    EXPECT_GE(elapsed, 0.4);
+    EXPECT_LT(elapsed, 2.0);
+}
+
+TEST_F(DownloadSchedulerTest, UnlimitedBandwidthDoesNotSleep)
+{
+    int id=m_scheduler.addTransfer(DownloadPriority::Prefetch);
+
+    std::chrono::steady_clock::time_point start=std::chrono::steady_clock::now();
+    for(int i=0; i<100; ++i)
+    {
+        m_scheduler.throttle(id, 1024*1024);
+    }
+    double elapsed=std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+    m_scheduler.removeTransfer(id);
+
+    EXPECT_LT(elapsed, 0.1);
+}
+
+} // namespace arbiterAI
@@ -0,0 +1,129 @@
+#include "arbiterAI/downloadWriter.h"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace arbiterAI
+{
+
+class DownloadWriterTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_testDir="download_writer_test";
+        std::filesystem::create_directories(m_testDir);
+        m_path=(m_testDir/"model.bin.partial").string();
+
+        for(int i=0; i<300*1024; ++i)
+        {
+            m_content.push_back(static_cast<char>('a'+(i*13)%26));
+        }
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(m_testDir);
+    }
+
+    std::string readFile()
+    {
+        std::ifstream file(m_path, std::ios::binary);
+        std::stringstream buffer;
+        buffer<<file.rdbuf();
+        return buffer.str();
+    }
+
+    /// Feed content to writer in chunks the size a transfer delivers.
+    void writeChunks(BufferedFileWriter &writer, const std::string &content, size_t chunk)
+    {
+        for(size_t pos=0; pos<content.size(); pos+=chunk)
+        {
+            size_t size=std::min(chunk, content.size()-pos);
+            ASSERT_TRUE(writer.write(content.data()+pos, size));
+        }
+    }
+
+    std::filesystem::path m_testDir;
+    std::string m_path;
+    std::string m_content;
+};
+
+TEST_F(DownloadWriterTest, PreallocatesKnownSize)
+{
+    DownloadFile file;
+    ASSERT_TRUE(file.open(m_path, 1024*1024, true, DownloadWriteConfig()));
+    EXPECT_EQ(std::filesystem::file_size(m_path), 1024u*1024u);
+
+    // Trimmed to what was actually written when finished
+    BufferedFileWriter writer(file, 0, 64*1024);
+    writeChunks(writer, m_content, 16*1024);
+    ASSERT_TRUE(writer.flush());
+    ASSERT_TRUE(file.finish(writer.offset()));
+
+    EXPECT_EQ(readFile(), m_content);
+}
+
+TEST_F(DownloadWriterTest, DoubleBufferedWritesMatchUnbuffered)
+{
+    // Odd chunk sizes straddle buffer boundaries
+    for(size_t bufferBytes:{static_cast<size_t>(0), static_cast<size_t>(4096), static_cast<size_t>(64*1024)})
+    {
+        DownloadFile file;
+        ASSERT_TRUE(file.open(m_path, 0, true, DownloadWriteConfig()));
+
+        std::atomic<int64_t> published{0};
+        BufferedFileWriter writer(file, 0, bufferBytes, &published);
+        writeChunks(writer, m_content, 10000);
+        EXPECT_EQ(writer.offset(), static_cast<int64_t>(m_content.size()));
+
+        ASSERT_TRUE(writer.flush());
+        EXPECT_EQ(published.load(), static_cast<int64_t>(m_content.size()));
+        ASSERT_TRUE(file.finish(writer.offset()));
+
+        EXPECT_EQ(readFile(), m_content) << "buffer " << bufferBytes;
+    }
+}
+
+TEST_F(DownloadWriterTest, SegmentsWriteAtTheirOffsets)
+{
+    // Two writers into one file from unaligned offsets, as segments do
+    DownloadWriteConfig config;
+    config.directIo=true;   // falls back to buffered writes where unsupported
+
+    DownloadFile file;
+    ASSERT_TRUE(file.open(m_path, static_cast<int64_t>(m_content.size()), true, config));
+
+    size_t split=100001;
+    {
+        BufferedFileWriter tail(file, static_cast<int64_t>(split), 8*1024);
+        BufferedFileWriter head(file, 0, 8*1024);
+        writeChunks(tail, m_content.substr(split), 7000);
+        writeChunks(head, m_content.substr(0, split), 3000);
+        ASSERT_TRUE(head.flush());
+        ASSERT_TRUE(tail.flush());
+    }
+    ASSERT_TRUE(file.finish(static_cast<int64_t>(m_content.size())));
+
+    EXPECT_EQ(readFile(), m_content);
+}
+
+TEST_F(DownloadWriterTest, ResumeKeepsExistingData)
+{
+    {
+        std::ofstream out(m_path, std::ios::binary);
+        out.write(m_content.data(), 5000);
+    }
+
+    DownloadFile file;
+    ASSERT_TRUE(file.open(m_path, static_cast<int64_t>(m_content.size()), false, DownloadWriteConfig()));
+    BufferedFileWriter writer(file, 5000, 16*1024);
+    writeChunks(writer, m_content.substr(5000), 16*1024);
+    ASSERT_TRUE(writer.flush());
+    ASSERT_TRUE(file.finish(static_cast<int64_t>(m_content.size())));
+
+    EXPECT_EQ(readFile(), m_content);
+}
+
+} // namespace arbiterAI
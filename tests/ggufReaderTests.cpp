@@ -0,0 +1,299 @@
+#include "arbiterAI/ggufReader.h"
+#include "arbiterAI/memoryCalibration.h"
+#include "arbiterAI/modelFitCalculator.h"
+#include <gtest/gtest.h>
+#include <fstream>
+#include <filesystem>
+
+namespace arbiterAI
+{
+
+/// Minimal GGUF writer for building test headers.
+class GgufWriter
+{
+public:
+    void addString(const std::string &key, const std::string &value)
+    {
+        writeString(m_kv, key);
+        writePod<uint32_t>(m_kv, 8);
+        writeString(m_kv, value);
+        m_kvCount++;
+    }
+
+    void addUint32(const std::string &key, uint32_t value)
+    {
+        writeString(m_kv, key);
+        writePod<uint32_t>(m_kv, 4);
+        writePod<uint32_t>(m_kv, value);
+        m_kvCount++;
+    }
+
+    void addStringArray(const std::string &key, const std::vector<std::string> &values)
+    {
+        writeString(m_kv, key);
+        writePod<uint32_t>(m_kv, 9);
+        writePod<uint32_t>(m_kv, 8);
+        writePod<uint64_t>(m_kv, values.size());
+        for(const std::string &v:values)
+        {
+            writeString(m_kv, v);
+        }
+        m_kvCount++;
+    }
+
+    void addTensor(const std::string &name, uint64_t sizeBytes)
+    {
+        writeString(m_tensors, name);
+        writePod<uint32_t>(m_tensors, 1);
+        writePod<uint64_t>(m_tensors, sizeBytes/2);
+        writePod<uint32_t>(m_tensors, 1); // GGML_TYPE_F16
+        writePod<uint64_t>(m_tensors, m_dataSize);
+        m_dataSize+=sizeBytes;
+        m_tensorCount++;
+    }
+
+    void write(const std::filesystem::path &path)
+    {
+        std::string out="GGUF";
+        writePod<uint32_t>(out, 3);
+        writePod<uint64_t>(out, m_tensorCount);
+        writePod<uint64_t>(out, m_kvCount);
+        out+=m_kv;
+        out+=m_tensors;
+        out.resize((out.size()+31)/32*32, '\0');
+        out.resize(out.size()+m_dataSize, '\0');
+
+        std::ofstream file(path, std::ios::binary);
+        file.write(out.data(), static_cast<std::streamsize>(out.size()));
+    }
+
+private:
+    template<typename T>
+    static void writePod(std::string &out, T value)
+    {
+        out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    static void writeString(std::string &out, const std::string &value)
+    {
+        writePod<uint64_t>(out, value.size());
+        out+=value;
+    }
+
+    std::string m_kv;
+    std::string m_tensors;
+    uint64_t m_kvCount=0;
+    uint64_t m_tensorCount=0;
+    uint64_t m_dataSize=0;
+};
+
+class GgufReaderTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        GgufMetadataCache::reset();
+        MemoryCalibration::reset();
+
+        m_testDir="gguf_test_models";
+        std::filesystem::create_directories(m_testDir);
+    }
+
+    void TearDown() override
+    {
+        GgufMetadataCache::reset();
+        MemoryCalibration::reset();
+        std::filesystem::remove_all(m_testDir);
+    }
+
+    /// 4-layer llama-style model: 8 heads, 2 KV heads, head dim 32.
+    void writeLlamaModel(const std::string &filename, uint64_t tensorBytes)
+    {
+        GgufWriter writer;
+        writer.addString("general.architecture", "llama");
+        writer.addUint32("llama.block_count", 4);
+        writer.addUint32("llama.embedding_length", 256);
+        writer.addUint32("llama.attention.head_count", 8);
+        writer.addUint32("llama.attention.head_count_kv", 2);
+        writer.addUint32("llama.context_length", 8192);
+        writer.addStringArray("tokenizer.ggml.tokens", {"<s>", "</s>", "hello"});
+        writer.addTensor("token_embd.weight", tensorBytes/2);
+        writer.addTensor("blk.0.attn_q.weight", tensorBytes/2);
+        writer.write(m_testDir/filename);
+    }
+
+    std::filesystem::path m_testDir;
+};
+
+TEST_F(GgufReaderTest, ReadsHyperparameters)
+{
+    writeLlamaModel("tiny.gguf", 4096);
+
+    GgufModelInfo info;
+    ASSERT_TRUE(GgufReader::read((m_testDir/"tiny.gguf").string(), info));
+
+    EXPECT_EQ(info.architecture, "llama");
+    EXPECT_EQ(info.nLayer, 4);
+    EXPECT_EQ(info.nHead, 8);
+    EXPECT_EQ(info.nHeadKv, 2);
+    EXPECT_EQ(info.headDimK, 32);
+    EXPECT_EQ(info.headDimV, 32);
+    EXPECT_EQ(info.contextLength, 8192);
+    EXPECT_EQ(info.tensors.size(), 2u);
+    EXPECT_EQ(info.weightBytes, 4096);
+    EXPECT_EQ(info.tensors[0].sizeBytes, 2048);
+}
+
+TEST_F(GgufReaderTest, KvBytesFollowLayerLayout)
+{
+    writeLlamaModel("tiny.gguf", 4096);
+
+    GgufModelInfo info;
+    ASSERT_TRUE(GgufReader::read((m_testDir/"tiny.gguf").string(), info));
+
+    // 4 layers * 2 KV heads * (32 + 32) dims * 2 bytes
+    EXPECT_DOUBLE_EQ(info.kvBytesPerToken(2.0), 1024.0);
+    EXPECT_EQ(info.kvCacheBytes(1000, 2.0), 1024000);
+
+    // Sliding-window layers cap at the window
+    info.slidingWindow=128;
+    info.swaLayers={true, false, true, false};
+    EXPECT_EQ(info.kvCacheBytes(1000, 2.0), 2*256*128+2*256*1000);
+    EXPECT_EQ(info.kvCacheBytes(1000, 2.0, true), 1024000);
+}
+
+TEST_F(GgufReaderTest, RejectsNonGgufFile)
+{
+    std::ofstream(m_testDir/"bad.gguf")<<"not a gguf file";
+
+    GgufModelInfo info;
+    EXPECT_FALSE(GgufReader::read((m_testDir/"bad.gguf").string(), info));
+    EXPECT_FALSE(GgufReader::read((m_testDir/"missing.gguf").string(), info));
+}
+
+TEST_F(GgufReaderTest, SplitModelSumsShards)
+{
+    writeLlamaModel("split-00001-of-00002.gguf", 4096);
+    writeLlamaModel("split-00002-of-00002.gguf", 2048);
+
+    GgufModelInfo info;
+    ASSERT_TRUE(GgufReader::readFiles({
+        (m_testDir/"split-00001-of-00002.gguf").string(),
+        (m_testDir/"split-00002-of-00002.gguf").string()}, info));
+
+    EXPECT_EQ(info.nLayer, 4);
+    EXPECT_EQ(info.tensors.size(), 4u);
+    EXPECT_EQ(info.weightBytes, 6144);
+}
+
+TEST_F(GgufReaderTest, MetadataCacheResolvesVariantFiles)
+{
+    writeLlamaModel("tiny.gguf", 4096);
+    GgufMetadataCache::instance().setModelsDir(m_testDir);
+
+    ModelVariant variant;
+    variant.quantization="F16";
+    variant.download.filename="tiny.gguf";
+
+    std::optional<GgufModelInfo> info=GgufMetadataCache::instance().get(variant);
+    ASSERT_TRUE(info.has_value());
+    EXPECT_EQ(info->nLayer, 4);
+
+    variant.download.filename="absent.gguf";
+    EXPECT_FALSE(GgufMetadataCache::instance().get(variant).has_value());
+}
+
+TEST_F(GgufReaderTest, FitUsesGgufWhenVariantIsOnDisk)
+{
+    writeLlamaModel("tiny.gguf", 4096);
+    GgufMetadataCache::instance().setModelsDir(m_testDir);
+
+    ModelInfo model;
+    model.model="tiny";
+    model.provider="llama";
+    model.contextWindow=8192;
+
+    ModelVariant variant;
+    variant.quantization="F16";
+    variant.minVramMb=100000; // hand-maintained number is ignored
+    variant.download.filename="tiny.gguf";
+
+    SystemInfo hw;
+    hw.totalRamMb=32000;
+    hw.freeRamMb=24000;
+    GpuInfo gpu;
+    gpu.index=0;
+    gpu.vramTotalMb=8000;
+    gpu.vramFreeMb=8000;
+    hw.gpus.push_back(gpu);
+
+    ModelFit fit=ModelFitCalculator::calculateModelFit(model, variant, hw);
+
+    EXPECT_TRUE(fit.canRun);
+    EXPECT_EQ(fit.estimateSource, "gguf");
+    EXPECT_EQ(fit.maxContextSize, 8192);
+    EXPECT_EQ(fit.perGpuVramMb.size(), 1u);
+    EXPECT_EQ(fit.perGpuVramMb[0], fit.estimatedVramUsageMb);
+}
+
+TEST_F(GgufReaderTest, CpuOnlyFitSurvivesDownload)
+{
+    writeLlamaModel("tiny.gguf", 4096);
+    GgufMetadataCache::instance().setModelsDir(m_testDir);
+
+    ModelInfo model;
+    model.model="tiny";
+    model.provider="llama";
+    model.contextWindow=8192;
+
+    ModelVariant variant;
+    variant.quantization="F16";
+    variant.minVramMb=0;
+    variant.download.filename="tiny.gguf";
+
+    SystemInfo hw;
+    hw.totalRamMb=32000;
+    hw.freeRamMb=24000;
+
+    // Sized from the header against system RAM, not gated on VRAM
+    ModelFit fit=ModelFitCalculator::calculateModelFit(model, variant, hw);
+    EXPECT_TRUE(fit.canRun);
+    EXPECT_EQ(fit.estimateSource, "gguf");
+    EXPECT_EQ(fit.maxContextSize, 8192);
+    EXPECT_TRUE(fit.gpuIndices.empty());
+    EXPECT_EQ(fit.estimatedVramUsageMb, 0);
+
+    // A cap below one 256-token step falls back to the config estimate
+    model.contextWindow=128;
+    fit=ModelFitCalculator::calculateModelFit(model, variant, hw);
+    EXPECT_TRUE(fit.canRun);
+    EXPECT_EQ(fit.estimateSource, "config");
+    EXPECT_EQ(fit.maxContextSize, 128);
+}
+
+TEST_F(GgufReaderTest, CalibrationIsPersisted)
+{
+    std::filesystem::path path=m_testDir/"memory_calibration.json";
+    MemoryCalibration::instance().load(path);
+
+    // Measured 1100MB of weights against a 1000MB estimate
+    MemoryCalibration::instance().record("tiny", "F16",
+        int64_t(1000)*1024*1024, 1100, int64_t(200)*1024*1024, 100, 300);
+
+    std::optional<MemoryCalibrationEntry> entry=MemoryCalibration::instance().get("tiny", "F16");
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_NEAR(entry->weightFactor, 1.1, 1e-6);
+    EXPECT_NEAR(entry->kvFactor, 0.5, 1e-6);
+    EXPECT_EQ(entry->computeBufferMb, 300);
+    ASSERT_TRUE(std::filesystem::exists(path));
+
+    MemoryCalibration::reset();
+    MemoryCalibration::instance().load(path);
+
+    entry=MemoryCalibration::instance().get("tiny", "F16");
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_NEAR(entry->weightFactor, 1.1, 1e-6);
+    EXPECT_EQ(entry->samples, 1);
+}
+
+} // namespace arbiterAI
@@ -2,6 +2,8 @@
 #include "arbiterAI/modelFitCalculator.h"
 #include "arbiterAI/modelManager.h"
 #include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
 
 namespace arbiterAI
 {
@@ -106,6 +108,48 @@ TEST_F(HardwareDetectorTest, GpuInfoFieldsValid)
     }
 }
 
+TEST_F(HardwareDetectorTest, ParseCpuList)
+{
+    EXPECT_EQ(HardwareDetector::parseCpuList("0-3,8,10-11\n"), (std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+    EXPECT_EQ(HardwareDetector::parseCpuList("5"), (std::vector<int>{5}));
+    EXPECT_TRUE(HardwareDetector::parseCpuList("").empty());
+}
+
+TEST_F(HardwareDetectorTest, ReadNumaNodesFromSysfs)
+{
+    std::filesystem::path root=std::filesystem::temp_directory_path()/"arbiterai_numa_test";
+    std::filesystem::remove_all(root);
+
+    auto writeNode=[&root](int id, const std::string &cpulist, long long totalKb, long long freeKb, long long inactiveFileKb)
+    {
+        std::filesystem::path dir=root/("node"+std::to_string(id));
+        std::filesystem::create_directories(dir);
+        std::ofstream(dir/"cpulist")<<cpulist<<"\n";
+        std::ofstream meminfo(dir/"meminfo");
+        meminfo<<"Node "<<id<<" MemTotal:       "<<totalKb<<" kB\n";
+        meminfo<<"Node "<<id<<" MemFree:        "<<freeKb<<" kB\n";
+        meminfo<<"Node "<<id<<" Inactive(file): "<<inactiveFileKb<<" kB\n";
+    };
+    writeNode(1, "8-15", 32*1024*1024, 8*1024*1024, 1024*1024);
+    writeNode(0, "0-7", 32*1024*1024, 16*1024*1024, 0);
+    writeNode(2, "", 64*1024*1024, 64*1024*1024, 0); // memory-only node
+    std::filesystem::create_directories(root/"power");
+
+    std::vector<NumaNode> nodes=HardwareDetector::readNumaNodes(root.string());
+    std::filesystem::remove_all(root);
+
+    ASSERT_EQ(nodes.size(), 2u);
+    EXPECT_EQ(nodes[0].id, 0);
+    EXPECT_EQ(nodes[0].cpus.size(), 8u);
+    EXPECT_EQ(nodes[0].totalRamMb, 32*1024);
+    EXPECT_EQ(nodes[0].freeRamMb, 16*1024);
+    EXPECT_EQ(nodes[1].id, 1);
+    EXPECT_EQ(nodes[1].cpus.front(), 8);
+    EXPECT_EQ(nodes[1].freeRamMb, 9*1024);
+
+    EXPECT_TRUE(HardwareDetector::readNumaNodes((root/"missing").string()).empty());
+}
+
 // --- ModelFitCalculator tests ---
 
 class ModelFitCalculatorTest : public ::testing::Test
@@ -344,6 +388,87 @@ TEST_F(ModelFitCalculatorTest, PreferFewerGpus)
     EXPECT_EQ(fit.gpuIndices[0], 0);
 }
 
+TEST_F(ModelFitCalculatorTest, QuantizedKvCacheExtendsContext)
+{
+    GpuInfo gpu=makeGpu(0, 12000, 10000);
+    SystemInfo hw=makeSystemInfo(32000, 24000, {gpu});
+
+    ModelInfo model=makeLocalModel("llama-7b", 8192, "7B", 4096, 131072, 256);
+    ModelVariant variant=makeVariant("Q4_K_M", 4370, 4096, 8192);
+
+    ModelFit f16=ModelFitCalculator::calculateModelFit(model, variant, hw);
+    ModelFit q8=ModelFitCalculator::calculateModelFit(model, variant, hw, "q8_0");
+    ModelFit q4=ModelFitCalculator::calculateModelFit(model, variant, hw, "q4_0");
+
+    EXPECT_EQ(f16.kvCacheType, "f16");
+    EXPECT_EQ(q8.kvCacheType, "q8_0");
+    // 5904MB spare: 23 1K blocks at 256MB (f16), 43 at 136MB (q8_0)
+    EXPECT_EQ(f16.maxContextSize, 4096+23*1024);
+    EXPECT_EQ(q8.maxContextSize, 4096+43*1024);
+    EXPECT_GT(q4.maxContextSize, q8.maxContextSize);
+}
+
+TEST_F(ModelFitCalculatorTest, KvBytesPerTokenScalesWithType)
+{
+    ContextScaling scaling;
+    scaling.vramPer1kContextMb=128;
+
+    double f16=ModelFitCalculator::kvBytesPerToken(scaling, "f16");
+    EXPECT_DOUBLE_EQ(f16, 128.0*1024.0);
+    EXPECT_DOUBLE_EQ(ModelFitCalculator::kvBytesPerToken(scaling, "q8_0"), f16*34.0/64.0);
+    EXPECT_DOUBLE_EQ(ModelFitCalculator::kvBytesPerToken(scaling, "q4_0"), f16*18.0/64.0);
+    EXPECT_DOUBLE_EQ(ModelFitCalculator::kvBytesPerElement("unknown"), 0.0);
+}
+
+TEST_F(ModelFitCalculatorTest, SelectBestFitKeepsF16WhenContextFits)
+{
+    GpuInfo gpu=makeGpu(0, 12000, 10000);
+    SystemInfo hw=makeSystemInfo(32000, 24000, {gpu});
+
+    ModelInfo model=makeLocalModel("llama-7b", 8192, "7B", 4096, 131072, 256);
+    model.variants.push_back(makeVariant("Q4_K_M", 4370, 4096, 8192));
+
+    ModelFit fit=ModelFitCalculator::selectBestFit(model, hw, 16384);
+
+    EXPECT_TRUE(fit.canRun);
+    EXPECT_EQ(fit.kvCacheType, "f16");
+    EXPECT_GE(fit.maxContextSize, 16384);
+}
+
+TEST_F(ModelFitCalculatorTest, SelectBestFitQuantizesKvToReachContext)
+{
+    GpuInfo gpu=makeGpu(0, 12000, 10000);
+    SystemInfo hw=makeSystemInfo(32000, 24000, {gpu});
+
+    ModelInfo model=makeLocalModel("llama-7b", 8192, "7B", 4096, 131072, 256);
+    model.variants.push_back(makeVariant("Q4_K_M", 4370, 4096, 8192));
+    model.variants.push_back(makeVariant("Q3_K_M", 3500, 3500, 6000));
+
+    // f16 tops out at 27648; q8_0 on the better variant reaches 32768
+    ModelFit fit=ModelFitCalculator::selectBestFit(model, hw, 32768);
+
+    EXPECT_TRUE(fit.canRun);
+    EXPECT_EQ(fit.variant, "Q4_K_M");
+    EXPECT_EQ(fit.kvCacheType, "q8_0");
+    EXPECT_GE(fit.maxContextSize, 32768);
+}
+
+TEST_F(ModelFitCalculatorTest, SelectBestFitHonorsPinnedKvType)
+{
+    GpuInfo gpu=makeGpu(0, 12000, 10000);
+    SystemInfo hw=makeSystemInfo(32000, 24000, {gpu});
+
+    ModelInfo model=makeLocalModel("llama-7b", 8192, "7B", 4096, 131072, 256);
+    model.variants.push_back(makeVariant("Q4_K_M", 4370, 4096, 8192));
+
+    // Nothing reaches 128K with f16 — the largest f16 fit is returned
+    ModelFit fit=ModelFitCalculator::selectBestFit(model, hw, 131072, "", std::string("f16"));
+
+    EXPECT_TRUE(fit.canRun);
+    EXPECT_EQ(fit.kvCacheType, "f16");
+    EXPECT_EQ(fit.maxContextSize, 4096+23*1024);
+}
+
 // --- Unified memory (APU) tests ---
 
 TEST_F(ModelFitCalculatorTest, UnifiedMemoryUsesAccessibleRam)
@@ -0,0 +1,156 @@
+#include "arbiterAI/memoryPressureMonitor.h"
+#include <gtest/gtest.h>
+#include <fstream>
+#include <filesystem>
+
+namespace arbiterAI
+{
+
+class MemoryPressureMonitorTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_testDir="mpm_test_root";
+        std::filesystem::create_directories(m_testDir/"proc"/"pressure");
+        std::filesystem::create_directories(m_testDir/"proc"/"self");
+        std::filesystem::create_directories(m_testDir/"cgroup"/"arbiter.slice");
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(m_testDir);
+    }
+
+    void writeFile(const std::filesystem::path &path, const std::string &text)
+    {
+        std::ofstream out(path);
+        out<<text;
+    }
+
+    static std::string psiText(double someAvg10, double fullAvg10)
+    {
+        return "some avg10="+std::to_string(someAvg10)+" avg60=0.00 avg300=0.00 total=1000\n"
+            "full avg10="+std::to_string(fullAvg10)+" avg60=0.00 avg300=0.00 total=10\n";
+    }
+
+    void writePsi(double someAvg10, double fullAvg10)
+    {
+        writeFile(m_testDir/"proc"/"pressure"/"memory", psiText(someAvg10, fullAvg10));
+    }
+
+    void writeCgroup(const std::string &current, const std::string &max)
+    {
+        writeFile(m_testDir/"proc"/"self"/"cgroup", "0::/arbiter.slice\n");
+        writeFile(m_testDir/"cgroup"/"arbiter.slice"/"memory.current", current+"\n");
+        writeFile(m_testDir/"cgroup"/"arbiter.slice"/"memory.max", max+"\n");
+    }
+
+    MemoryPressureMonitor monitor()
+    {
+        return MemoryPressureMonitor((m_testDir/"proc").string(), (m_testDir/"cgroup").string());
+    }
+
+    std::filesystem::path m_testDir;
+};
+
+TEST_F(MemoryPressureMonitorTest, ParsesPsi)
+{
+    double some=0.0;
+    double full=0.0;
+    EXPECT_TRUE(MemoryPressureMonitor::parsePsi(
+        "some avg10=12.50 avg60=3.00 avg300=1.00 total=123\n"
+        "full avg10=4.25 avg60=1.00 avg300=0.50 total=45\n", some, full));
+    EXPECT_DOUBLE_EQ(some, 12.5);
+    EXPECT_DOUBLE_EQ(full, 4.25);
+
+    EXPECT_FALSE(MemoryPressureMonitor::parsePsi("some avg10=1.00 avg60=0.00 avg300=0.00 total=1\n", some, full));
+    EXPECT_FALSE(MemoryPressureMonitor::parsePsi("", some, full));
+}
+
+TEST_F(MemoryPressureMonitorTest, MissingSourcesMeanNoPressure)
+{
+    MemoryPressureSample sample=monitor().sample();
+    EXPECT_FALSE(sample.psiAvailable);
+    EXPECT_FALSE(sample.cgroupLimited);
+    EXPECT_EQ(sample.level, MemoryPressureLevel::None);
+}
+
+TEST_F(MemoryPressureMonitorTest, PsiStallsRaiseTheLevel)
+{
+    writePsi(0.5, 0.0);
+    EXPECT_EQ(monitor().sample().level, MemoryPressureLevel::None);
+
+    writePsi(15.0, 1.0);
+    MemoryPressureSample sample=monitor().sample();
+    EXPECT_TRUE(sample.psiAvailable);
+    EXPECT_DOUBLE_EQ(sample.someAvg10, 15.0);
+    EXPECT_EQ(sample.level, MemoryPressureLevel::Moderate);
+
+    writePsi(40.0, 8.0);
+    EXPECT_EQ(monitor().sample().level, MemoryPressureLevel::Critical);
+}
+
+TEST_F(MemoryPressureMonitorTest, CgroupUsageRaisesTheLevel)
+{
+    writeCgroup("500", "max");
+    MemoryPressureSample sample=monitor().sample();
+    EXPECT_FALSE(sample.cgroupLimited);
+    EXPECT_EQ(sample.level, MemoryPressureLevel::None);
+
+    writeCgroup("880", "1000");
+    sample=monitor().sample();
+    EXPECT_TRUE(sample.cgroupLimited);
+    EXPECT_EQ(sample.cgroupCurrentBytes, 880);
+    EXPECT_EQ(sample.cgroupMaxBytes, 1000);
+    EXPECT_DOUBLE_EQ(sample.cgroupUsagePercent(), 88.0);
+    EXPECT_EQ(sample.level, MemoryPressureLevel::Moderate);
+
+    writeCgroup("990", "1000");
+    EXPECT_EQ(monitor().sample().level, MemoryPressureLevel::Critical);
+
+    // Thresholds are configurable
+    MemoryPressureMonitor relaxed=monitor();
+    MemoryPressureThresholds thresholds;
+    thresholds.cgroupModeratePercent=99.5;
+    thresholds.cgroupCriticalPercent=99.9;
+    relaxed.setThresholds(thresholds);
+    EXPECT_EQ(relaxed.sample().level, MemoryPressureLevel::None);
+}
+
+TEST_F(MemoryPressureMonitorTest, InactiveFileCacheIsNotCounted)
+{
+    // Mostly reclaimable page cache (e.g. mmapped weights read once)
+    writeCgroup("990", "1000");
+    writeFile(m_testDir/"cgroup"/"arbiter.slice"/"memory.stat",
+        "anon 300\nfile 690\nactive_file 90\ninactive_file 600\n");
+
+    MemoryPressureSample sample=monitor().sample();
+    EXPECT_EQ(sample.cgroupCurrentBytes, 990);
+    EXPECT_EQ(sample.cgroupInactiveFileBytes, 600);
+    EXPECT_EQ(sample.cgroupWorkingSetBytes(), 390);
+    EXPECT_DOUBLE_EQ(sample.cgroupUsagePercent(), 39.0);
+    EXPECT_EQ(sample.level, MemoryPressureLevel::None);
+
+    writeFile(m_testDir/"cgroup"/"arbiter.slice"/"memory.stat", "anon 900\ninactive_file 60\n");
+    EXPECT_EQ(monitor().sample().level, MemoryPressureLevel::Moderate);
+}
+
+TEST_F(MemoryPressureMonitorTest, CgroupPsiIsPreferred)
+{
+    // The host is stalling, but this server's cgroup is not
+    writePsi(40.0, 8.0);
+    writeCgroup("100", "max");
+    writeFile(m_testDir/"cgroup"/"arbiter.slice"/"memory.pressure", psiText(0.5, 0.0));
+
+    MemoryPressureSample sample=monitor().sample();
+    EXPECT_TRUE(sample.psiAvailable);
+    EXPECT_DOUBLE_EQ(sample.someAvg10, 0.5);
+    EXPECT_EQ(sample.level, MemoryPressureLevel::None);
+
+    // Without it the system-wide file is used
+    std::filesystem::remove(m_testDir/"cgroup"/"arbiter.slice"/"memory.pressure");
+    EXPECT_EQ(monitor().sample().level, MemoryPressureLevel::Critical);
+}
+
+} // namespace arbiterAI
@@ -6,6 +6,10 @@
 #include "arbiterAI/fileVerifier.h"
 #include <httplib.h>
 #include <thread>
+#include <atomic>
+#include <sstream>
+#include <iostream>
+#include <chrono>
 
 namespace arbiterAI
 {
@@ -15,11 +19,59 @@ public:
     MOCK_METHOD(bool, verifyFile, (const std::string&, const std::string&), (override));
 };
 
+// Real verifier that records whether the file had to be read back
+class RecordingFileVerifier : public FileVerifier {
+public:
+    bool verifyFile(const std::string &filePath, const std::string &expectedHash) override
+    {
+        ++fileReads;
+        return FileVerifier::verifyFile(filePath, expectedHash);
+    }
+
+    bool verifyComputedHash(const std::string &filePath, const std::string &computedHash, const std::string &expectedHash) override
+    {
+        lastComputedHash=computedHash;
+        return FileVerifier::verifyComputedHash(filePath, computedHash, expectedHash);
+    }
+
+    int fileReads=0;
+    std::string lastComputedHash;
+};
+
 class ModelDownloaderTest : public ::testing::Test
 {
 protected:
     std::unique_ptr<httplib::Server> svr;
     std::unique_ptr<std::thread> svr_thread;
+    std::string rangedContent;
+    std::atomic<int> rangeRequests{0};
+    std::atomic<int> failRangeRequests{0};
+    std::string firstRangeHeader;
+    std::atomic<int> inFlight{0};
+    std::atomic<int> maxInFlight{0};
+    std::string benchContent;
+
+    // Second server standing in for a peer arbiterAI server
+    std::unique_ptr<httplib::Server> peer;
+    std::unique_ptr<std::thread> peerThread;
+    std::atomic<int> peerRequests{0};
+
+    /// Serve content as the stored blob hash on localhost:1235, the way
+    /// GET /api/blobs/sha256/{hash} does.
+    void startPeer(const std::string &hash, const std::string &content)
+    {
+        peer=std::make_unique<httplib::Server>();
+        peer->Get("/api/blobs/sha256/"+hash, [this, content](const httplib::Request &, httplib::Response &res) {
+            ++peerRequests;
+            res.set_header("Accept-Ranges", "bytes");
+            res.set_header("ETag", "\"peer\"");
+            res.set_content(content, "application/octet-stream");
+        });
+        peerThread=std::make_unique<std::thread>([this]() {
+            peer->listen("localhost", 1235);
+        });
+        peer->wait_until_ready();
+    }
 
     void SetUp() override
     {
@@ -35,6 +87,49 @@ protected:
             res.set_content(content, "application/octet-stream");
         });
 
+        // Range-capable stand-in for a model CDN; httplib answers Range
+        // requests on set_content bodies with 206 partial content
+        for(int i=0; i<256*1024; ++i)
+        {
+            rangedContent.push_back(static_cast<char>('a'+(i*7)%26));
+        }
+        svr->Get("/ranged_model.bin", [this](const httplib::Request &req, httplib::Response &res) {
+            if(req.has_header("Range"))
+            {
+                int current=++inFlight;
+                int seen=maxInFlight.load();
+                while(current>seen&&!maxInFlight.compare_exchange_weak(seen, current))
+                {
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                --inFlight;
+
+                if(++rangeRequests==1)
+                {
+                    firstRangeHeader=req.get_header_value("Range");
+                }
+                if(failRangeRequests>0)
+                {
+                    --failRangeRequests;
+                    res.status=503;
+                    return;
+                }
+            }
+            res.set_header("Accept-Ranges", "bytes");
+            res.set_header("ETag", "\"v1\"");
+            res.set_content(rangedContent, "application/octet-stream");
+        });
+
+        svr->Get("/slow_shard.bin", [this](const httplib::Request &, httplib::Response &res) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(300));
+            res.set_content(rangedContent, "application/octet-stream");
+        });
+
+        // Large single-stream file for write throughput measurements
+        svr->Get("/bench_model.bin", [this](const httplib::Request &, httplib::Response &res) {
+            res.set_content(benchContent, "application/octet-stream");
+        });
+
         svr_thread = std::make_unique<std::thread>([&]() {
             svr->listen("localhost", 1234);
         });
@@ -56,6 +151,14 @@ protected:
         {
             svr_thread->join();
         }
+        if(peer)
+        {
+            peer->stop();
+        }
+        if(peerThread&&peerThread->joinable())
+        {
+            peerThread->join();
+        }
     std::remove("dummy_model.bin");
     std::filesystem::remove_all("cache_dir");
 }
@@ -139,6 +242,468 @@ TEST_F(ModelDownloaderTest, DownloadModelWithInvalidUrl)
     EXPECT_FALSE(result.get());
 }
 
+TEST_F(ModelDownloaderTest, PlanSegmentsCoversWholeFile)
+{
+    SegmentedDownloadConfig config;
+    config.maxSegments=4;
+    config.minSegmentBytes=1000;
+
+    std::vector<std::pair<int64_t, int64_t>> segments=ModelDownloader::planSegments(10003, config);
+    ASSERT_EQ(segments.size(), 4u);
+    EXPECT_EQ(segments.front().first, 0);
+    EXPECT_EQ(segments.back().second, 10002);
+    for(size_t i=1; i<segments.size(); ++i)
+    {
+        EXPECT_EQ(segments[i].first, segments[i-1].second+1);
+    }
+
+    // Never split below the minimum segment size
+    EXPECT_EQ(ModelDownloader::planSegments(2500, config).size(), 2u);
+    EXPECT_EQ(ModelDownloader::planSegments(500, config).size(), 1u);
+    EXPECT_TRUE(ModelDownloader::planSegments(0, config).empty());
+}
+
+TEST_F(ModelDownloaderTest, SegmentedDownloadMatchesSource)
+{
+    ModelDownloader downloader;
+    SegmentedDownloadConfig config;
+    config.maxSegments=4;
+    config.minSegmentBytes=16*1024;
+    downloader.setSegmentConfig(config);
+
+    std::string filePath="/tmp/segmented_model.bin";
+    std::future<bool> result=downloader.downloadModelWithProgress(
+        "http://localhost:1234/ranged_model.bin", filePath, std::nullopt, nullptr, "segmented", "");
+    ASSERT_TRUE(result.get());
+
+    std::ifstream file(filePath, std::ios::binary);
+    std::stringstream downloaded;
+    downloaded<<file.rdbuf();
+    EXPECT_EQ(downloaded.str(), rangedContent);
+    EXPECT_EQ(rangeRequests.load(), 4);
+    EXPECT_EQ(downloader.getDownloadState("segmented")->bytesDownloaded.load(), static_cast<int64_t>(rangedContent.size()));
+
+    std::remove(filePath.c_str());
+}
+
+TEST_F(ModelDownloaderTest, FailedSegmentIsRetriedOnItsOwn)
+{
+    ModelDownloader downloader;
+    SegmentedDownloadConfig config;
+    config.maxSegments=4;
+    config.minSegmentBytes=16*1024;
+    config.segmentRetries=2;
+    downloader.setSegmentConfig(config);
+
+    failRangeRequests=1;
+
+    std::string filePath="/tmp/segmented_model.bin";
+    std::future<bool> result=downloader.downloadModelWithProgress(
+        "http://localhost:1234/ranged_model.bin", filePath, std::nullopt, nullptr, "segmented", "");
+    ASSERT_TRUE(result.get());
+
+    std::ifstream file(filePath, std::ios::binary);
+    std::stringstream downloaded;
+    downloaded<<file.rdbuf();
+    EXPECT_EQ(downloaded.str(), rangedContent);
+
+    // Only the failed segment was fetched again
+    EXPECT_EQ(rangeRequests.load(), 5);
+
+    std::remove(filePath.c_str());
+}
+
+TEST_F(ModelDownloaderTest, InterruptedDownloadResumesFromCheckpoint)
+{
+    ModelDownloader downloader;
+    SegmentedDownloadConfig config;
+    config.maxSegments=1;
+    downloader.setSegmentConfig(config);
+
+    // Leave behind the first half of the file, as a crashed download would
+    std::string filePath="/tmp/resumed_model.bin";
+    int64_t half=static_cast<int64_t>(rangedContent.size()/2);
+    {
+        std::ofstream partial(filePath+".partial", std::ios::binary);
+        partial.write(rangedContent.data(), half);
+    }
+
+    DownloadCheckpoint checkpoint;
+    checkpoint.url="http://localhost:1234/ranged_model.bin";
+    checkpoint.etag="\"v1\"";
+    checkpoint.totalBytes=static_cast<int64_t>(rangedContent.size());
+    checkpoint.segments.push_back({0, checkpoint.totalBytes-1, half});
+    ASSERT_TRUE(ModelDownloader::saveCheckpoint(filePath, checkpoint));
+    EXPECT_EQ(downloader.getPartialDownloadSize(filePath), half);
+
+    std::future<bool> result=downloader.downloadModelWithProgress(
+        checkpoint.url, filePath, std::nullopt, nullptr, "resumed", "");
+    ASSERT_TRUE(result.get());
+
+    EXPECT_EQ(firstRangeHeader, "bytes="+std::to_string(half)+"-"+std::to_string(checkpoint.totalBytes-1));
+
+    std::ifstream file(filePath, std::ios::binary);
+    std::stringstream downloaded;
+    downloaded<<file.rdbuf();
+    EXPECT_EQ(downloaded.str(), rangedContent);
+    EXPECT_FALSE(std::filesystem::exists(ModelDownloader::checkpointPath(filePath)));
+
+    std::remove(filePath.c_str());
+}
+
+TEST_F(ModelDownloaderTest, StaleCheckpointIsDiscarded)
+{
+    ModelDownloader downloader;
+    SegmentedDownloadConfig config;
+    config.maxSegments=1;
+    downloader.setSegmentConfig(config);
+
+    std::string filePath="/tmp/resumed_model.bin";
+    int64_t half=static_cast<int64_t>(rangedContent.size()/2);
+    {
+        std::ofstream partial(filePath+".partial", std::ios::binary);
+        partial<<std::string(static_cast<size_t>(half), 'x');
+    }
+
+    // The server's ETag no longer matches the one the partial data came from
+    DownloadCheckpoint checkpoint;
+    checkpoint.url="http://localhost:1234/ranged_model.bin";
+    checkpoint.etag="\"v0\"";
+    checkpoint.totalBytes=static_cast<int64_t>(rangedContent.size());
+    checkpoint.segments.push_back({0, checkpoint.totalBytes-1, half});
+    ASSERT_TRUE(ModelDownloader::saveCheckpoint(filePath, checkpoint));
+
+    std::future<bool> result=downloader.downloadModelWithProgress(
+        checkpoint.url, filePath, std::nullopt, nullptr, "resumed", "");
+    ASSERT_TRUE(result.get());
+
+    EXPECT_EQ(firstRangeHeader, "bytes=0-"+std::to_string(checkpoint.totalBytes-1));
+
+    std::ifstream file(filePath, std::ios::binary);
+    std::stringstream downloaded;
+    downloaded<<file.rdbuf();
+    EXPECT_EQ(downloaded.str(), rangedContent);
+
+    std::remove(filePath.c_str());
+}
+
+TEST_F(ModelDownloaderTest, HashFileStreamsKnownDigest)
+{
+    std::string filePath="/tmp/hash_input.bin";
+    {
+        std::ofstream file(filePath, std::ios::binary);
+        file<<"abc";
+    }
+
+    std::optional<std::string> hash=FileVerifier::hashFile(filePath);
+    ASSERT_TRUE(hash.has_value());
+    EXPECT_EQ(*hash, "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+
+    FileVerifier verifier;
+    EXPECT_TRUE(verifier.verifyFile(filePath, "BA7816BF8F01CFEA414140DE5DAE2223B00361A396177A9CB410FF61F20015AD"));
+    EXPECT_FALSE(verifier.verifyFile(filePath, std::string(64, '0')));
+    EXPECT_FALSE(FileVerifier::hashFile("/tmp/does_not_exist.bin").has_value());
+
+    std::remove(filePath.c_str());
+}
+
+TEST_F(ModelDownloaderTest, SegmentedDownloadIsHashedWhileWriting)
+{
+    Sha256Hasher hasher;
+    hasher.update(rangedContent.data(), rangedContent.size());
+    std::string expected=hasher.finalizeHex();
+
+    std::shared_ptr<RecordingFileVerifier> verifier=std::make_shared<RecordingFileVerifier>();
+    ModelDownloader downloader(verifier);
+    SegmentedDownloadConfig config;
+    config.maxSegments=4;
+    config.minSegmentBytes=16*1024;
+    downloader.setSegmentConfig(config);
+
+    std::string filePath="/tmp/segmented_model.bin";
+    std::future<bool> result=downloader.downloadModelWithProgress(
+        "http://localhost:1234/ranged_model.bin", filePath, expected, nullptr, "segmented", "");
+    ASSERT_TRUE(result.get());
+
+    // Verified from the digest computed during the download, not by re-reading
+    EXPECT_EQ(verifier->lastComputedHash, expected);
+    EXPECT_EQ(verifier->fileReads, 0);
+
+    std::remove(filePath.c_str());
+}
+
+TEST_F(ModelDownloaderTest, CorruptDownloadNeverReachesFinalPath)
+{
+    std::string wrong(64, '0');
+
+    ModelDownloader downloader;
+    SegmentedDownloadConfig config;
+    config.maxSegments=4;
+    config.minSegmentBytes=16*1024;
+    downloader.setSegmentConfig(config);
+
+    std::string filePath="/tmp/corrupt_model.bin";
+    std::remove(filePath.c_str());
+    std::future<bool> result=downloader.downloadModelWithProgress(
+        "http://localhost:1234/ranged_model.bin", filePath, wrong, nullptr, "corrupt", "");
+    EXPECT_FALSE(result.get());
+
+    EXPECT_FALSE(std::filesystem::exists(filePath));
+    EXPECT_FALSE(std::filesystem::exists(filePath+".partial"));
+    EXPECT_EQ(downloader.getDownloadState("corrupt")->error, "SHA256 verification failed");
+}
+
+TEST_F(ModelDownloaderTest, ConnectionPoolBoundsSegments)
+{
+    ModelDownloader downloader;
+    SegmentedDownloadConfig config;
+    config.maxSegments=4;
+    config.minSegmentBytes=16*1024;
+    downloader.setSegmentConfig(config);
+    downloader.setMaxConnections(1);
+
+    std::string filePath="/tmp/segmented_model.bin";
+    std::future<bool> result=downloader.downloadModelWithProgress(
+        "http://localhost:1234/ranged_model.bin", filePath, std::nullopt, nullptr, "segmented", "");
+    ASSERT_TRUE(result.get());
+
+    // Four segments, but never more than one connection open
+    EXPECT_EQ(rangeRequests.load(), 4);
+    EXPECT_EQ(maxInFlight.load(), 1);
+
+    std::ifstream file(filePath, std::ios::binary);
+    std::stringstream downloaded;
+    downloaded<<file.rdbuf();
+    EXPECT_EQ(downloaded.str(), rangedContent);
+
+    std::remove(filePath.c_str());
+}
+
+TEST_F(ModelDownloaderTest, ShardsShareOneVariantSnapshot)
+{
+    ModelDownloader downloader;
+
+    std::future<bool> first=downloader.downloadModelWithProgress(
+        "http://localhost:1234/slow_shard.bin", "/tmp/shard-00001-of-00002.bin", std::nullopt, nullptr, "sharded", "Q4_K_M");
+    std::future<bool> second=downloader.downloadModelWithProgress(
+        "http://localhost:1234/slow_shard.bin", "/tmp/shard-00002-of-00002.bin", std::nullopt, nullptr, "sharded", "Q4_K_M");
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    std::vector<DownloadProgressSnapshot> snapshots=downloader.getActiveSnapshots();
+    ASSERT_EQ(snapshots.size(), 1u);
+    EXPECT_EQ(snapshots[0].modelName, "sharded");
+    EXPECT_EQ(snapshots[0].variant, "Q4_K_M");
+    EXPECT_EQ(snapshots[0].files, 2);
+
+    ASSERT_TRUE(first.get());
+    ASSERT_TRUE(second.get());
+    EXPECT_FALSE(downloader.getProgressSnapshot("sharded").has_value());
+
+    std::remove("/tmp/shard-00001-of-00002.bin");
+    std::remove("/tmp/shard-00002-of-00002.bin");
+}
+
+TEST_F(ModelDownloaderTest, PeerBlobUrlNormalizesHashAndBase)
+{
+    EXPECT_EQ(ModelDownloader::peerBlobUrl("http://10.0.0.5:8080/", "ABCDEF"),
+        "http://10.0.0.5:8080/api/blobs/sha256/abcdef");
+}
+
+TEST_F(ModelDownloaderTest, PeerIsTriedBeforeOrigin)
+{
+    Sha256Hasher hasher;
+    hasher.update(rangedContent.data(), rangedContent.size());
+    std::string expected=hasher.finalizeHex();
+    startPeer(expected, rangedContent);
+
+    ModelDownloader downloader;
+    SegmentedDownloadConfig config;
+    config.maxSegments=4;
+    config.minSegmentBytes=16*1024;
+    downloader.setSegmentConfig(config);
+
+    // The first peer isn't running and is skipped
+    downloader.setPeers({"http://localhost:1299", "http://localhost:1235/"});
+
+    std::string filePath="/tmp/peer_model.bin";
+    std::future<bool> result=downloader.downloadModelWithProgress(
+        "http://localhost:1234/ranged_model.bin", filePath, expected, nullptr, "peer", "");
+    ASSERT_TRUE(result.get());
+
+    std::ifstream file(filePath, std::ios::binary);
+    std::stringstream downloaded;
+    downloaded<<file.rdbuf();
+    EXPECT_EQ(downloaded.str(), rangedContent);
+
+    // Fetched from the peer in segments; the origin was never asked
+    EXPECT_GT(peerRequests.load(), 1);
+    EXPECT_EQ(rangeRequests.load(), 0);
+
+    std::remove(filePath.c_str());
+}
+
+TEST_F(ModelDownloaderTest, CorruptPeerFallsBackToOrigin)
+{
+    Sha256Hasher hasher;
+    hasher.update(rangedContent.data(), rangedContent.size());
+    std::string expected=hasher.finalizeHex();
+
+    std::string corrupt=rangedContent;
+    corrupt[1000]^=0x20;
+    startPeer(expected, corrupt);
+
+    ModelDownloader downloader;
+    SegmentedDownloadConfig config;
+    config.maxSegments=4;
+    config.minSegmentBytes=16*1024;
+    downloader.setSegmentConfig(config);
+    downloader.setPeers({"http://localhost:1235"});
+
+    std::string filePath="/tmp/peer_model.bin";
+    std::future<bool> result=downloader.downloadModelWithProgress(
+        "http://localhost:1234/ranged_model.bin", filePath, expected, nullptr, "peer", "");
+    ASSERT_TRUE(result.get());
+
+    std::ifstream file(filePath, std::ios::binary);
+    std::stringstream downloaded;
+    downloaded<<file.rdbuf();
+    EXPECT_EQ(downloaded.str(), rangedContent);
+    EXPECT_GT(peerRequests.load(), 0);
+    EXPECT_EQ(rangeRequests.load(), 4);
+    EXPECT_EQ(downloader.getDownloadState("peer")->status.load(), DownloadStatus::Completed);
+
+    std::remove(filePath.c_str());
+}
+
+TEST_F(ModelDownloaderTest, FailedPeerKeepsOriginCheckpoint)
+{
+    Sha256Hasher hasher;
+    hasher.update(rangedContent.data(), rangedContent.size());
+    std::string expected=hasher.finalizeHex();
+
+    std::string corrupt=rangedContent;
+    corrupt[1000]^=0x20;
+    startPeer(expected, corrupt);
+
+    ModelDownloader downloader;
+    SegmentedDownloadConfig config;
+    config.maxSegments=1;
+    downloader.setSegmentConfig(config);
+    downloader.setPeers({"http://localhost:1235"});
+
+    // Half of the file already came from the origin
+    std::string filePath="/tmp/peer_resumed_model.bin";
+    int64_t half=static_cast<int64_t>(rangedContent.size()/2);
+    {
+        std::ofstream partial(filePath+".partial", std::ios::binary);
+        partial.write(rangedContent.data(), half);
+    }
+
+    DownloadCheckpoint checkpoint;
+    checkpoint.url="http://localhost:1234/ranged_model.bin";
+    checkpoint.etag="\"v1\"";
+    checkpoint.totalBytes=static_cast<int64_t>(rangedContent.size());
+    checkpoint.segments.push_back({0, checkpoint.totalBytes-1, half});
+    ASSERT_TRUE(ModelDownloader::saveCheckpoint(filePath, checkpoint));
+
+    std::future<bool> result=downloader.downloadModelWithProgress(
+        checkpoint.url, filePath, expected, nullptr, "peer", "");
+    ASSERT_TRUE(result.get());
+
+    // The peer's bad copy did not cost the origin its progress
+    EXPECT_GT(peerRequests.load(), 0);
+    EXPECT_EQ(firstRangeHeader, "bytes="+std::to_string(half)+"-"+std::to_string(checkpoint.totalBytes-1));
+
+    std::ifstream file(filePath, std::ios::binary);
+    std::stringstream downloaded;
+    downloaded<<file.rdbuf();
+    EXPECT_EQ(downloaded.str(), rangedContent);
+    EXPECT_FALSE(std::filesystem::exists(filePath+".peer.partial"));
+
+    std::remove(filePath.c_str());
+}
+
+TEST_F(ModelDownloaderTest, WriteConfigsProduceSameContents)
+{
+    // Small buffers so the double-buffered path swaps many times and ends
+    // on a partial buffer
+    benchContent.resize(1024*1024+17);
+    for(size_t i=0; i<benchContent.size(); ++i)
+    {
+        benchContent[i]=static_cast<char>('a'+(i*31)%26);
+    }
+
+    DownloadWriteConfig perChunk;
+    perChunk.bufferBytes=0;
+    perChunk.preallocate=false;
+
+    DownloadWriteConfig buffered;
+    buffered.bufferBytes=64*1024;
+
+    std::string filePath="/tmp/bench_model.bin";
+    for(const DownloadWriteConfig &config:{perChunk, buffered})
+    {
+        ModelDownloader downloader;
+        downloader.setWriteConfig(config);
+
+        std::future<bool> result=downloader.downloadModelWithProgress(
+            "http://localhost:1234/bench_model.bin", filePath, std::nullopt, nullptr, "bench", "");
+        ASSERT_TRUE(result.get());
+
+        std::ifstream file(filePath, std::ios::binary);
+        std::stringstream downloaded;
+        downloaded<<file.rdbuf();
+        EXPECT_TRUE(downloaded.str()==benchContent) << "buffer bytes " << config.bufferBytes;
+
+        std::remove(filePath.c_str());
+    }
+}
+
+// Not part of the regular run; use --gtest_also_run_disabled_tests
+TEST_F(ModelDownloaderTest, DISABLED_WriteThroughputBenchmark)
+{
+    // Compares writing every received chunk as it arrives (the old path)
+    // with preallocated, double-buffered writes. Reports MB/s only; the
+    // numbers depend on the disk, so just the contents are asserted.
+    benchContent.resize(64*1024*1024);
+    for(size_t i=0; i<benchContent.size(); ++i)
+    {
+        benchContent[i]=static_cast<char>('a'+(i*31)%26);
+    }
+
+    DownloadWriteConfig perChunk;
+    perChunk.bufferBytes=0;
+    perChunk.preallocate=false;
+
+    std::vector<std::pair<std::string, DownloadWriteConfig>> configs={
+        {"per-chunk writes", perChunk},
+        {"preallocated, double-buffered", DownloadWriteConfig()}
+    };
+
+    std::string filePath="/tmp/bench_model.bin";
+    for(const std::pair<std::string, DownloadWriteConfig> &config:configs)
+    {
+        ModelDownloader downloader;
+        downloader.setWriteConfig(config.second);
+
+        std::chrono::steady_clock::time_point start=std::chrono::steady_clock::now();
+        std::future<bool> result=downloader.downloadModelWithProgress(
+            "http://localhost:1234/bench_model.bin", filePath, std::nullopt, nullptr, "bench", "");
+        ASSERT_TRUE(result.get());
+        double seconds=std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+
+        std::cout<<"[ BENCH    ] "<<config.first<<": "
+            <<static_cast<double>(benchContent.size())/(1024.0*1024.0)/seconds<<" MB/s"<<std::endl;
+
+        std::ifstream file(filePath, std::ios::binary);
+        std::stringstream downloaded;
+        downloaded<<file.rdbuf();
+        EXPECT_TRUE(downloaded.str()==benchContent) << config.first;
+
+        std::remove(filePath.c_str());
+    }
+}
+
 TEST_F(ModelDownloaderTest, DownloadModelFailsWithTooLowClientVersion)
 {
     ModelDownloader downloader;
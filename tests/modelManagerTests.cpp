@@ -484,6 +484,40 @@ TEST_F(ModelManagerConfigInjectionTest, ModelInfoToJson_RoundTrip)
     EXPECT_EQ(serialized["max_output_tokens"], 2048);
 }
 
+TEST_F(ModelManagerConfigInjectionTest, ParseLoraConfig)
+{
+    nlohmann::json modelJson={
+        {"model", "support-ft"},
+        {"provider", "llama"},
+        {"lora", {
+            {"base_model", "base-7b"},
+            {"adapters", {
+                {{"file", "loras/support-v3.gguf"}},
+                {{"file", "/srv/loras/tone.gguf"}, {"name", "tone"}, {"scale", 0.5}}
+            }}
+        }}
+    };
+
+    std::string error;
+    ASSERT_TRUE(ModelManager::instance().addModelFromJson(modelJson, error))<<error;
+
+    auto info=ModelManager::instance().getModelInfo("support-ft");
+    ASSERT_TRUE(info.has_value());
+    ASSERT_TRUE(info->lora.has_value());
+    EXPECT_EQ(info->lora->baseModel, "base-7b");
+    ASSERT_EQ(info->lora->adapters.size(), 2u);
+    EXPECT_EQ(info->lora->adapters[0].name, "support-v3");
+    EXPECT_EQ(info->lora->adapters[0].file, "loras/support-v3.gguf");
+    EXPECT_FLOAT_EQ(info->lora->adapters[0].scale, 1.0f);
+    EXPECT_EQ(info->lora->adapters[1].name, "tone");
+    EXPECT_FLOAT_EQ(info->lora->adapters[1].scale, 0.5f);
+
+    nlohmann::json serialized=ModelManager::modelInfoToJson(info.value());
+    EXPECT_EQ(serialized["lora"]["base_model"], "base-7b");
+    ASSERT_EQ(serialized["lora"]["adapters"].size(), 2u);
+    EXPECT_EQ(serialized["lora"]["adapters"][1]["name"], "tone");
+}
+
 TEST_F(ModelManagerConfigInjectionTest, ModelInfoToJson_WithVariants)
 {
     nlohmann::json modelJson={
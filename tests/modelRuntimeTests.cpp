@@ -2,9 +2,12 @@
 #include "arbiterAI/modelManager.h"
 #include "arbiterAI/hardwareDetector.h"
 #include "arbiterAI/storageManager.h"
+#include "arbiterAI/telemetryCollector.h"
 #include <gtest/gtest.h>
 #include <fstream>
 #include <filesystem>
+#include <thread>
+#include <chrono>
 
 namespace arbiterAI
 {
@@ -354,6 +357,171 @@ TEST_F(ModelRuntimeTest, BeginEndInferenceTracksState)
     EXPECT_FALSE(rt.isInferenceActive());
 }
 
+TEST_F(ModelRuntimeTest, EndInferenceRefreshesLastUsed)
+{
+    ModelRuntime &rt=ModelRuntime::instance();
+
+    rt.loadModel("mock-model");
+    rt.beginInference("mock-model");
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    std::chrono::steady_clock::time_point finished=std::chrono::steady_clock::now();
+    rt.endInference("mock-model");
+
+    // Idle time starts when the request ends
+    std::optional<LoadedModel> state=rt.getModelState("mock-model");
+    ASSERT_TRUE(state.has_value());
+    EXPECT_GE(state->lastUsed, finished);
+}
+
+// --- Request queue ---
+
+TEST_F(ModelRuntimeTest, RequestQueueRunsOneRequestPerInstance)
+{
+    ModelRuntime &rt=ModelRuntime::instance();
+
+    RequestQueueConfig config;
+    config.slotsPerInstance=4;
+    config.maxDepth=8;
+    rt.setRequestQueueConfig(config);
+
+    RequestQueueConfig applied=rt.getRequestQueueConfig();
+    EXPECT_EQ(applied.slotsPerInstance, 1);
+    EXPECT_EQ(applied.maxDepth, 8);
+
+    rt.setRequestQueueConfig(RequestQueueConfig{});
+}
+
+// --- Replicas ---
+
+TEST_F(ModelRuntimeTest, AcquireInstanceWithoutReplicasUsesModel)
+{
+    ModelRuntime &rt=ModelRuntime::instance();
+
+    rt.loadModel("mock-model");
+    std::string instance=rt.acquireInstance("mock-model");
+    EXPECT_EQ(instance, "mock-model");
+    EXPECT_TRUE(rt.isInferenceActive());
+    EXPECT_EQ(rt.getInFlightRequests("mock-model"), 1);
+
+    rt.endInference(instance);
+    EXPECT_FALSE(rt.isInferenceActive());
+    EXPECT_EQ(rt.getInFlightRequests("mock-model"), 0);
+}
+
+TEST_F(ModelRuntimeTest, ReplicaPolicyIsClamped)
+{
+    ModelRuntime &rt=ModelRuntime::instance();
+
+    EXPECT_FALSE(rt.getReplicaPolicy("mock-model").has_value());
+
+    ReplicaPolicy policy;
+    policy.minReplicas=2;
+    policy.maxReplicas=1;
+    policy.scaleUpQueueDepth=0;
+    rt.setReplicaPolicy("mock-model", policy);
+
+    std::optional<ReplicaPolicy> stored=rt.getReplicaPolicy("mock-model");
+    ASSERT_TRUE(stored.has_value());
+    EXPECT_EQ(stored->minReplicas, 2);
+    EXPECT_EQ(stored->maxReplicas, 2);
+    EXPECT_EQ(stored->scaleUpQueueDepth, 1);
+
+    ModelRuntime::reset();
+    EXPECT_FALSE(rt.getReplicaPolicy("mock-model").has_value());
+}
+
+TEST_F(ModelRuntimeTest, ScaleReplicasSkipsModelsWithoutLlamaHandles)
+{
+    ModelRuntime &rt=ModelRuntime::instance();
+
+    ReplicaPolicy policy;
+    policy.minReplicas=2;
+    policy.maxReplicas=2;
+    rt.setReplicaPolicy("mock-model", policy);
+
+    rt.loadModel("mock-model");
+    EXPECT_EQ(rt.scaleReplicas(), 0);
+    EXPECT_TRUE(rt.getReplicaStates("mock-model").empty());
+    EXPECT_EQ(rt.getModelStates().size(), 1u);
+}
+
+// --- LoRA adapter models ---
+
+TEST_F(ModelRuntimeTest, AdapterModelLoadsBaseModel)
+{
+    ModelRuntime &rt=ModelRuntime::instance();
+
+    nlohmann::json adapterJson={
+        {"model", "mock-model-ft"},
+        {"provider", "mock"},
+        {"lora", {
+            {"base_model", "mock-model"},
+            {"adapters", {{{"file", "support.gguf"}}}}
+        }}
+    };
+    std::string error;
+    ASSERT_TRUE(ModelManager::instance().addModelFromJson(adapterJson, error))<<error;
+
+    EXPECT_EQ(rt.loadModel("mock-model-ft"), ErrorCode::Success);
+
+    auto base=rt.getModelState("mock-model");
+    ASSERT_TRUE(base.has_value());
+    EXPECT_EQ(base->state, ModelState::Loaded);
+    EXPECT_FALSE(rt.getModelState("mock-model-ft").has_value());
+}
+
+TEST_F(ModelRuntimeTest, ResolveLoraAdapters)
+{
+    ModelRuntime &rt=ModelRuntime::instance();
+
+    nlohmann::json adapterJson={
+        {"model", "mock-model-ft"},
+        {"provider", "mock"},
+        {"lora", {
+            {"base_model", "mock-model"},
+            {"adapters", {
+                {{"file", "support.gguf"}},
+                {{"file", "/abs/tone.gguf"}, {"name", "tone"}, {"scale", 0.5}}
+            }}
+        }}
+    };
+    std::string error;
+    ASSERT_TRUE(ModelManager::instance().addModelFromJson(adapterJson, error))<<error;
+
+    std::string baseModel;
+    std::vector<LoraSelection> adapters;
+
+    // Plain models resolve to themselves
+    EXPECT_EQ(rt.resolveLoraAdapters("mock-model", {}, baseModel, adapters), ErrorCode::Success);
+    EXPECT_EQ(baseModel, "mock-model");
+    EXPECT_TRUE(adapters.empty());
+    EXPECT_EQ(rt.resolveLoraAdapters("mock-model", {{"tone", 1.0}}, baseModel, adapters), ErrorCode::InvalidRequest);
+
+    ASSERT_EQ(rt.resolveLoraAdapters("mock-model-ft", {}, baseModel, adapters), ErrorCode::Success);
+    EXPECT_EQ(baseModel, "mock-model");
+    ASSERT_EQ(adapters.size(), 2u);
+    EXPECT_EQ(adapters[0].path, rt.getModelsDir()+"support.gguf");
+    EXPECT_FLOAT_EQ(adapters[0].scale, 1.0f);
+    EXPECT_EQ(adapters[1].path, "/abs/tone.gguf");
+    EXPECT_FLOAT_EQ(adapters[1].scale, 0.5f);
+
+    // Per-request scales override the config; 0 drops the adapter
+    ASSERT_EQ(rt.resolveLoraAdapters("mock-model-ft", {{"support", 0.0}, {"tone", 2.0}}, baseModel, adapters),
+        ErrorCode::Success);
+    ASSERT_EQ(adapters.size(), 1u);
+    EXPECT_EQ(adapters[0].path, "/abs/tone.gguf");
+    EXPECT_FLOAT_EQ(adapters[0].scale, 2.0f);
+
+    EXPECT_EQ(rt.resolveLoraAdapters("mock-model-ft", {{"missing", 1.0}}, baseModel, adapters),
+        ErrorCode::InvalidRequest);
+
+    // Nothing to apply on a model without a llama context
+    rt.loadModel("mock-model");
+    EXPECT_EQ(rt.applyLoraAdapters("mock-model", {}), ErrorCode::Success);
+    EXPECT_EQ(rt.getLoraCacheUsage(), 0);
+}
+
 // --- GetModelStates ---
 
 TEST_F(ModelRuntimeTest, GetModelStatesReturnsAll)
@@ -397,6 +565,89 @@ TEST_F(ModelRuntimeTest, DefaultReadyRamBudgetIsHalfSystemRam)
     EXPECT_EQ(rt.getReadyRamBudget(), expected);
 }
 
+TEST_F(ModelRuntimeTest, MemoryPressureLevelChangesAreRecorded)
+{
+    ModelRuntime &rt=ModelRuntime::instance();
+    TelemetryCollector::reset();
+
+    rt.loadModel("mock-model");
+    rt.pinModel("mock-model");
+    rt.unloadModel("mock-model");
+
+    MemoryPressureSample sample;
+    sample.psiAvailable=true;
+    sample.someAvg10=60.0;
+    sample.fullAvg10=20.0;
+    sample.level=MemoryPressureLevel::Critical;
+    rt.applyMemoryPressure(sample);
+
+    EXPECT_EQ(rt.getMemoryPressureLevel(), MemoryPressureLevel::Critical);
+    EXPECT_DOUBLE_EQ(rt.getMemoryPressure().someAvg10, 60.0);
+
+    // Pinned models keep their Ready slot even under critical pressure
+    auto state=rt.getModelState("mock-model");
+    ASSERT_TRUE(state.has_value());
+    EXPECT_EQ(state->state, ModelState::Ready);
+
+    rt.applyMemoryPressure(MemoryPressureSample{});
+    EXPECT_EQ(rt.getMemoryPressureLevel(), MemoryPressureLevel::None);
+
+    std::vector<MemoryPressureEvent> events=TelemetryCollector::instance().getMemoryPressureHistory();
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[0].action, "level");
+    EXPECT_EQ(events[0].level, "critical");
+    EXPECT_DOUBLE_EQ(events[0].fullAvg10, 20.0);
+    EXPECT_EQ(events[1].level, "none");
+
+    TelemetryCollector::reset();
+}
+
+// --- Idle context reclamation ---
+
+TEST_F(ModelRuntimeTest, SetDefaultIdleContextTimeout)
+{
+    ModelRuntime &rt=ModelRuntime::instance();
+
+    EXPECT_EQ(rt.getDefaultIdleContextTimeout(), 0);
+
+    rt.setDefaultIdleContextTimeout(300);
+    EXPECT_EQ(rt.getDefaultIdleContextTimeout(), 300);
+
+    rt.setDefaultIdleContextTimeout(-5);
+    EXPECT_EQ(rt.getDefaultIdleContextTimeout(), 0);
+}
+
+TEST_F(ModelRuntimeTest, ReclaimIdleContextsSkipsModelsWithoutContext)
+{
+    ModelRuntime &rt=ModelRuntime::instance();
+
+    rt.setDefaultIdleContextTimeout(1);
+    rt.loadModel("mock-model");
+
+    // Cloud models have no llama_context to reclaim
+    EXPECT_EQ(rt.reclaimIdleContexts(), 0);
+
+    auto state=rt.getModelState("mock-model");
+    ASSERT_TRUE(state.has_value());
+    EXPECT_EQ(state->state, ModelState::Loaded);
+    EXPECT_FALSE(state->contextReclaimed);
+}
+
+TEST_F(ModelRuntimeTest, EnsureContextCapacityRequiresLlamaModel)
+{
+    ModelRuntime &rt=ModelRuntime::instance();
+
+    EXPECT_EQ(rt.ensureContextCapacity("mock-model", 1024), ErrorCode::ModelNotLoaded);
+
+    // Cloud models are tracked but have no llama_context to grow
+    rt.loadModel("mock-model");
+    EXPECT_EQ(rt.ensureContextCapacity("mock-model", 1024), ErrorCode::ModelNotLoaded);
+
+    auto state=rt.getModelState("mock-model");
+    ASSERT_TRUE(state.has_value());
+    EXPECT_EQ(state->contextLimit, 0);
+}
+
 // --- Promote from Ready to Loaded ---
 
 TEST_F(ModelRuntimeTest, LoadReadyModelPromotesToLoaded)
@@ -419,6 +670,23 @@ TEST_F(ModelRuntimeTest, LoadReadyModelPromotesToLoaded)
     state=rt.getModelState("mock-model");
     ASSERT_TRUE(state.has_value());
     EXPECT_EQ(state->state, ModelState::Loaded);
+    EXPECT_EQ(state->loadedFrom, "Ready");
+}
+
+TEST_F(ModelRuntimeTest, ReadyModelWithoutResidentWeightsReportsNoRam)
+{
+    ModelRuntime &rt=ModelRuntime::instance();
+
+    rt.loadModel("mock-model");
+    rt.pinModel("mock-model");
+    rt.unloadModel("mock-model");
+
+    // Cloud models hold nothing in host RAM; the Ready tier reports measured
+    // usage rather than an estimate derived from VRAM.
+    auto state=rt.getModelState("mock-model");
+    ASSERT_TRUE(state.has_value());
+    EXPECT_EQ(state->state, ModelState::Ready);
+    EXPECT_EQ(state->ramUsageMb, 0);
 }
 
 // --- Reset ---
@@ -485,6 +753,33 @@ TEST_F(ModelRuntimeTest, LoadLocalModelInvalidVariantFails)
     EXPECT_EQ(result, ErrorCode::ModelNotFound);
 }
 
+TEST_F(ModelRuntimeTest, AutotunedKvCacheTypeSurvivesFit)
+{
+    // The fit would shrink the KV cache to q4_0 to reach the context
+    ModelFit fit;
+    fit.kvCacheType="q4_0";
+
+    RuntimeOptions config;
+    EXPECT_TRUE(ModelRuntime::autoSelectsKvCache(config));
+
+    // Merged the way loadModel applies a stored autotune result
+    RuntimeOptions tuned;
+    tuned.flashAttn=true;
+    tuned.kvCacheTypeK="q8_0";
+    tuned.kvCacheTypeV="f16";
+    tuned.mergeFrom(config);
+    EXPECT_FALSE(ModelRuntime::autoSelectsKvCache(tuned));
+
+    EXPECT_FALSE(ModelRuntime::applyKvCacheFit(tuned, fit));
+    EXPECT_EQ(tuned.kvCacheTypeK.value(), "q8_0");
+    EXPECT_EQ(tuned.kvCacheTypeV.value(), "f16");
+
+    // Without a tuned or pinned type the fit's choice is applied
+    EXPECT_TRUE(ModelRuntime::applyKvCacheFit(config, fit));
+    EXPECT_EQ(config.kvCacheTypeK.value(), "q4_0");
+    EXPECT_EQ(config.kvCacheTypeV.value(), "q4_0");
+}
+
 // --- Download concurrency settings ---
 
 TEST_F(ModelRuntimeTest, DefaultMaxConcurrentDownloadsIsTwo)
@@ -0,0 +1,120 @@
+#include "arbiterAI/pageCacheWarmer.h"
+#include <gtest/gtest.h>
+#include <fstream>
+#include <filesystem>
+
+namespace arbiterAI
+{
+
+class PageCacheWarmerTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_testDir="pcw_test_models";
+        std::filesystem::create_directories(m_testDir);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(m_testDir);
+    }
+
+    std::string createFile(const std::string &filename, int64_t sizeBytes)
+    {
+        std::filesystem::path path=m_testDir/filename;
+        std::ofstream out(path, std::ios::binary);
+        std::string data(static_cast<size_t>(sizeBytes), 'x');
+        out.write(data.data(), sizeBytes);
+        out.close();
+        return path.string();
+    }
+
+    std::filesystem::path m_testDir;
+};
+
+TEST_F(PageCacheWarmerTest, HeldFilesAreMappedOnUpdate)
+{
+    std::string path=createFile("model-Q4_K_M.gguf", 256*1024);
+
+    PageCacheWarmer warmer;
+    warmer.hold("model-Q4_K_M.gguf", {path});
+    EXPECT_TRUE(warmer.hasPending());
+    EXPECT_FALSE(warmer.residency(path).held);
+
+    EXPECT_EQ(warmer.update(), 1);
+    EXPECT_FALSE(warmer.hasPending());
+
+    FileResidency residency=warmer.residency(path);
+    EXPECT_TRUE(residency.held);
+    EXPECT_FALSE(residency.locked);
+    EXPECT_EQ(residency.sizeBytes, 256*1024);
+    EXPECT_LE(residency.residentBytes, residency.sizeBytes);
+
+    // Fully resident files are not re-warmed
+    if(residency.residentPercent()>=100.0)
+    {
+        EXPECT_EQ(warmer.update(), 0);
+    }
+
+    warmer.release("model-Q4_K_M.gguf");
+    residency=warmer.residency(path);
+    EXPECT_FALSE(residency.held);
+    EXPECT_EQ(residency.sizeBytes, 256*1024);
+}
+
+TEST_F(PageCacheWarmerTest, LocksStayWithinBudget)
+{
+    std::string first=createFile("first.gguf", 64*1024);
+    std::string second=createFile("second.gguf", 64*1024);
+
+    PageCacheWarmer warmer;
+    warmer.setLockBudget(64*1024);
+    warmer.hold("first.gguf", {first});
+    warmer.hold("second.gguf", {second});
+    warmer.update();
+
+    // Only the first held file fits (mlock may still be refused by RLIMIT_MEMLOCK)
+    EXPECT_LE(warmer.lockedBytes(), 64*1024);
+    EXPECT_FALSE(warmer.residency(second).locked);
+    EXPECT_EQ(warmer.residency(first).locked, warmer.lockedBytes()==64*1024);
+
+    warmer.setLockBudget(0);
+    warmer.update();
+    EXPECT_EQ(warmer.lockedBytes(), 0);
+    EXPECT_FALSE(warmer.residency(first).locked);
+}
+
+TEST_F(PageCacheWarmerTest, UnlockAllIsUndoneByNextUpdate)
+{
+    std::string path=createFile("pressure.gguf", 64*1024);
+
+    PageCacheWarmer warmer;
+    warmer.setLockBudget(64*1024);
+    warmer.hold("pressure.gguf", {path});
+    warmer.update();
+    bool locked=warmer.residency(path).locked;
+
+    EXPECT_EQ(warmer.unlockAll(), locked?64*1024:0);
+    EXPECT_EQ(warmer.lockedBytes(), 0);
+    EXPECT_TRUE(warmer.residency(path).held);
+
+    warmer.update();
+    EXPECT_EQ(warmer.residency(path).locked, locked);
+}
+
+TEST_F(PageCacheWarmerTest, MissingFileIsNotResident)
+{
+    PageCacheWarmer warmer;
+    std::string path=(m_testDir/"missing.gguf").string();
+    warmer.hold("missing.gguf", {path});
+    EXPECT_EQ(warmer.update(), 0);
+
+    FileResidency residency=warmer.residency(path);
+    EXPECT_FALSE(residency.held);
+    EXPECT_EQ(residency.sizeBytes, 0);
+    EXPECT_EQ(residency.residentBytes, 0);
+    EXPECT_EQ(residency.residentPercent(), 0.0);
+}
+
+} // namespace arbiterAI
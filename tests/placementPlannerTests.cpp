@@ -0,0 +1,151 @@
+#include "arbiterAI/placementPlanner.h"
+#include <gtest/gtest.h>
+#include <regex>
+
+namespace arbiterAI
+{
+
+class PlacementPlannerTest : public ::testing::Test
+{
+protected:
+    static constexpr int64_t MB=1024*1024;
+
+    /// Dense model: 8 layers of 1000MB, 500MB embeddings, 500MB output head.
+    /// 8 KV heads of dim 128 → 4KB per token per layer at f16.
+    static GgufModelInfo denseModel()
+    {
+        GgufModelInfo info;
+        info.architecture="llama";
+        info.nLayer=8;
+        info.nHeadKv=8;
+        info.headDimK=128;
+        info.headDimV=128;
+        info.contextLength=32768;
+        info.tensors.push_back({"token_embd.weight", 0, {}, 0, 500*MB});
+        for(int il=0; il<info.nLayer; ++il)
+        {
+            std::string prefix="blk."+std::to_string(il)+".";
+            info.tensors.push_back({prefix+"attn_q.weight", 0, {}, 0, 400*MB});
+            info.tensors.push_back({prefix+"ffn_up.weight", 0, {}, 0, 600*MB});
+        }
+        info.tensors.push_back({"output.weight", 0, {}, 0, 500*MB});
+        return info;
+    }
+
+    /// MoE model: 8 layers of 200MB attention plus 2000MB of experts, 8 of 64 active.
+    static GgufModelInfo moeModel()
+    {
+        GgufModelInfo info=denseModel();
+        info.expertCount=64;
+        info.expertUsedCount=8;
+        info.tensors.clear();
+        info.tensors.push_back({"token_embd.weight", 0, {}, 0, 500*MB});
+        for(int il=0; il<info.nLayer; ++il)
+        {
+            std::string prefix="blk."+std::to_string(il)+".";
+            info.tensors.push_back({prefix+"attn_q.weight", 0, {}, 0, 200*MB});
+            info.tensors.push_back({prefix+"ffn_up_exps.weight", 0, {}, 0, 1000*MB});
+            info.tensors.push_back({prefix+"ffn_down_exps.weight", 0, {}, 0, 1000*MB});
+        }
+        info.tensors.push_back({"output.weight", 0, {}, 0, 500*MB});
+        return info;
+    }
+
+    static PlacementBudget budget(int gpuVramMb, int ramMb=64000)
+    {
+        PlacementBudget b;
+        b.gpuVramMb=gpuVramMb;
+        b.ramMb=ramMb;
+        return b;
+    }
+};
+
+TEST_F(PlacementPlannerTest, FullGpuWhenEverythingFits)
+{
+    // 8000 + 500 weights + 32 KV + 512 compute
+    PlacementPlan plan=PlacementPlanner::plan(denseModel(), 1024, 2.0, budget(24000));
+
+    EXPECT_TRUE(plan.fits);
+    EXPECT_EQ(plan.strategy, "full_gpu");
+    EXPECT_EQ(plan.nGpuLayers, 9);
+    EXPECT_TRUE(plan.kvOffload);
+    EXPECT_TRUE(plan.overrideTensor.empty());
+    EXPECT_EQ(plan.gpuMb, 8000+500+32+512);
+    EXPECT_EQ(plan.cpuMb, 500);
+}
+
+TEST_F(PlacementPlannerTest, DenseModelOffloadsWholeLayers)
+{
+    PlacementPlan plan=PlacementPlanner::plan(denseModel(), 1024, 2.0, budget(6000));
+
+    EXPECT_TRUE(plan.fits);
+    EXPECT_EQ(plan.strategy, "partial_layers");
+    EXPECT_EQ(plan.nGpuLayers, 5);
+    EXPECT_LE(plan.gpuMb, 6000);
+    EXPECT_TRUE(plan.overrideTensor.empty());
+}
+
+TEST_F(PlacementPlannerTest, KvMovesToHostWhenItBuysLayers)
+{
+    // 128K context: 512MB of KV per layer; keeping it in host memory frees
+    // room for two more layers of weights
+    PlacementPlan plan=PlacementPlanner::plan(denseModel(), 131072, 2.0, budget(6000));
+
+    EXPECT_TRUE(plan.fits);
+    EXPECT_EQ(plan.strategy, "partial_layers");
+    EXPECT_FALSE(plan.kvOffload);
+    EXPECT_EQ(plan.nGpuLayers, 5);
+
+    // A pinned kv_offload is respected
+    PlacementBudget pinned=budget(6000);
+    pinned.kvOffload=true;
+    plan=PlacementPlanner::plan(denseModel(), 131072, 2.0, pinned);
+    EXPECT_TRUE(plan.kvOffload);
+    EXPECT_EQ(plan.nGpuLayers, 3);
+}
+
+TEST_F(PlacementPlannerTest, MoeExpertsMoveToHostBeforeLayers)
+{
+    // 18600MB of weights; attention and output fit easily, experts do not
+    PlacementPlan plan=PlacementPlanner::plan(moeModel(), 1024, 2.0, budget(12000));
+
+    EXPECT_TRUE(plan.fits);
+    EXPECT_EQ(plan.strategy, "moe_experts_cpu");
+    EXPECT_EQ(plan.nGpuLayers, 9);
+    EXPECT_TRUE(plan.kvOffload);
+    ASSERT_EQ(plan.overrideTensor.size(), 1u);
+    EXPECT_LE(plan.gpuMb, 12000);
+
+    // The pattern moves only the expert tensors of the planned layers
+    std::string entry=plan.overrideTensor[0];
+    ASSERT_EQ(entry.substr(entry.size()-4), "=CPU");
+    std::regex pattern(entry.substr(0, entry.size()-4));
+    EXPECT_TRUE(std::regex_search("blk.0.ffn_up_exps.weight", pattern));
+    EXPECT_FALSE(std::regex_search("blk.0.attn_q.weight", pattern));
+    EXPECT_TRUE(std::regex_search("blk.3.ffn_down_exps.weight", pattern));
+    EXPECT_FALSE(std::regex_search("blk.4.ffn_down_exps.weight", pattern));
+}
+
+TEST_F(PlacementPlannerTest, CpuOnlyWithoutVram)
+{
+    PlacementPlan plan=PlacementPlanner::plan(denseModel(), 1024, 2.0, budget(0));
+
+    EXPECT_TRUE(plan.fits);
+    EXPECT_EQ(plan.strategy, "cpu_only");
+    EXPECT_EQ(plan.nGpuLayers, 0);
+    EXPECT_EQ(plan.gpuMb, 0);
+
+    plan=PlacementPlanner::plan(denseModel(), 1024, 2.0, budget(0, 4000));
+    EXPECT_FALSE(plan.fits);
+}
+
+TEST_F(PlacementPlannerTest, ExpertPatternListsLayers)
+{
+    EXPECT_EQ(PlacementPlanner::expertOverridePattern({0, 1, 12}), "blk\\.(0|1|12)\\.ffn_.*_exps\\.");
+
+    PlacementPlan plan;
+    plan.overrideTensor={"a=CPU", "b=CUDA0"};
+    EXPECT_EQ(plan.overrideTensorString(), "a=CPU,b=CUDA0");
+}
+
+} // namespace arbiterAI
@@ -0,0 +1,203 @@
+#include "arbiterAI/requestQueue.h"
+#include <gtest/gtest.h>
+#include <thread>
+#include <chrono>
+
+namespace arbiterAI
+{
+
+class RequestQueueTest : public ::testing::Test
+{
+protected:
+    void TearDown() override
+    {
+        for(std::thread &thread:m_threads)
+        {
+            thread.join();
+        }
+    }
+
+    // Start a request that waits for "m" and records its label once admitted.
+    // Returns after the request is queued so arrival order is deterministic.
+    void enqueue(const std::string &label, const std::string &tenant, RequestPriority priority)
+    {
+        int waiting=m_queue.stats("m").waiting;
+        m_threads.emplace_back([this, label, tenant, priority]()
+            {
+                if(m_queue.acquire("m", tenant, priority)==ErrorCode::Success)
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_admitted.push_back(label);
+                }
+            });
+        waitFor([&]()
+            {
+                return m_queue.stats("m").waiting>waiting;
+            });
+    }
+
+    // Release one slot and return the label of the request admitted into it.
+    std::string releaseNext()
+    {
+        size_t count=admittedCount();
+        m_queue.release("m");
+        waitFor([&]()
+            {
+                return admittedCount()>count;
+            });
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_admitted.back();
+    }
+
+    size_t admittedCount()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_admitted.size();
+    }
+
+    template<typename Predicate>
+    void waitFor(Predicate predicate)
+    {
+        auto deadline=std::chrono::steady_clock::now()+std::chrono::seconds(5);
+        while(!predicate()&&std::chrono::steady_clock::now()<deadline)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        ASSERT_TRUE(predicate());
+    }
+
+    RequestQueue m_queue;
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::vector<std::string> m_admitted;
+};
+
+TEST_F(RequestQueueTest, AdmitsImmediatelyWhileSlotsAreFree)
+{
+    RequestQueueConfig config;
+    config.slotsPerInstance=2;
+    m_queue.setConfig(config);
+
+    EXPECT_EQ(m_queue.acquire("m", "a", RequestPriority::Interactive), ErrorCode::Success);
+    EXPECT_EQ(m_queue.acquire("m", "b", RequestPriority::Batch), ErrorCode::Success);
+
+    RequestQueueStats stats=m_queue.stats("m");
+    EXPECT_EQ(stats.running, 2);
+    EXPECT_EQ(stats.waiting, 0);
+    EXPECT_EQ(stats.slots, 2);
+
+    // Each loaded replica adds slots
+    m_queue.setInstances("m", 2);
+    EXPECT_EQ(m_queue.stats("m").slots, 4);
+
+    m_queue.release("m");
+    m_queue.release("m");
+    EXPECT_EQ(m_queue.stats("m").running, 0);
+}
+
+TEST_F(RequestQueueTest, RejectsWhenDepthLimitsAreReached)
+{
+    RequestQueueConfig config;
+    config.maxDepth=2;
+    config.maxPerTenant=1;
+    m_queue.setConfig(config);
+
+    ASSERT_EQ(m_queue.acquire("m", "x", RequestPriority::Interactive), ErrorCode::Success);
+    EXPECT_EQ(m_queue.checkAdmission("m", "a"), ErrorCode::Success);
+
+    enqueue("a1", "a", RequestPriority::Interactive);
+    EXPECT_EQ(m_queue.checkAdmission("m", "a"), ErrorCode::TooManyRequests);
+    EXPECT_EQ(m_queue.acquire("m", "a", RequestPriority::Interactive), ErrorCode::TooManyRequests);
+
+    enqueue("b1", "b", RequestPriority::Interactive);
+    EXPECT_EQ(m_queue.checkAdmission("m", "c"), ErrorCode::QueueFull);
+    EXPECT_EQ(m_queue.acquire("m", "c", RequestPriority::Interactive), ErrorCode::QueueFull);
+
+    // Other models have their own queue
+    EXPECT_EQ(m_queue.checkAdmission("other", "c"), ErrorCode::Success);
+
+    EXPECT_EQ(releaseNext(), "a1");
+    EXPECT_EQ(releaseNext(), "b1");
+    m_queue.release("m");
+}
+
+TEST_F(RequestQueueTest, InteractiveRunsBeforeBatch)
+{
+    ASSERT_EQ(m_queue.acquire("m", "x", RequestPriority::Interactive), ErrorCode::Success);
+
+    enqueue("batch1", "a", RequestPriority::Batch);
+    enqueue("batch2", "b", RequestPriority::Batch);
+    enqueue("chat", "c", RequestPriority::Interactive);
+
+    EXPECT_EQ(releaseNext(), "chat");
+    EXPECT_EQ(releaseNext(), "batch1");
+    EXPECT_EQ(releaseNext(), "batch2");
+    m_queue.release("m");
+}
+
+TEST_F(RequestQueueTest, TenantsShareByWeight)
+{
+    RequestQueueConfig config;
+    config.tenantWeights["heavy"]=2.0;
+    m_queue.setConfig(config);
+
+    ASSERT_EQ(m_queue.acquire("m", "light", RequestPriority::Interactive), ErrorCode::Success);
+
+    // "light" floods the queue first; "heavy" still gets two turns per
+    // turn of "light" instead of waiting behind the whole backlog
+    enqueue("l1", "light", RequestPriority::Interactive);
+    enqueue("l2", "light", RequestPriority::Interactive);
+    enqueue("l3", "light", RequestPriority::Interactive);
+    enqueue("h1", "heavy", RequestPriority::Interactive);
+    enqueue("h2", "heavy", RequestPriority::Interactive);
+    enqueue("h3", "heavy", RequestPriority::Interactive);
+    enqueue("h4", "heavy", RequestPriority::Interactive);
+
+    std::vector<std::string> order;
+    for(int i=0; i<7; ++i)
+    {
+        order.push_back(releaseNext());
+    }
+    m_queue.release("m");
+
+    EXPECT_EQ(order, (std::vector<std::string>{"h1", "h2", "l1", "h3", "h4", "l2", "l3"}));
+}
+
+TEST_F(RequestQueueTest, ReportsPositionWhileWaiting)
+{
+    ASSERT_EQ(m_queue.acquire("m", "x", RequestPriority::Interactive), ErrorCode::Success);
+    enqueue("first", "a", RequestPriority::Interactive);
+
+    std::mutex positionsMutex;
+    std::vector<int> positions;
+    m_threads.emplace_back([&]()
+        {
+            m_queue.acquire("m", "b", RequestPriority::Interactive, [&](int position)
+                {
+                    std::lock_guard<std::mutex> lock(positionsMutex);
+                    positions.push_back(position);
+                });
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_admitted.push_back("second");
+        });
+    waitFor([&]()
+        {
+            std::lock_guard<std::mutex> lock(positionsMutex);
+            return !positions.empty();
+        });
+
+    EXPECT_EQ(releaseNext(), "first");
+    waitFor([&]()
+        {
+            std::lock_guard<std::mutex> lock(positionsMutex);
+            return positions.size()==2;
+        });
+    EXPECT_EQ(releaseNext(), "second");
+    m_queue.release("m");
+
+    std::lock_guard<std::mutex> lock(positionsMutex);
+    EXPECT_EQ(positions, (std::vector<int>{2, 1}));
+}
+
+} // namespace arbiterAI
@@ -189,6 +189,79 @@ TEST_F(StorageManagerTest, RecordUsageForUnknownVariantIsNoOp)
     EXPECT_EQ(models.size(), 0u);
 }
 
+TEST_F(StorageManagerTest, UsageIsCompactedIntoSnapshotOnFlush)
+{
+    StorageManager::instance().initialize(m_testDir);
+
+    createDummyGguf("test-q4.gguf", 1024);
+    StorageManager::instance().registerDownload("test-model", "Q4_K_M", "test-q4.gguf", 1024);
+    StorageManager::instance().recordUsage("test-model", "Q4_K_M");
+    StorageManager::instance().recordUsage("test-model", "Q4_K_M");
+    StorageManager::instance().flush();
+
+    EXPECT_TRUE(std::filesystem::exists(m_testDir/"model_usage.json"));
+    EXPECT_EQ(std::filesystem::file_size(m_testDir/"model_usage.journal"), 0u);
+
+    StorageManager::instance().shutdown();
+    StorageManager::reset();
+    StorageManager::instance().initialize(m_testDir);
+
+    std::optional<DownloadedModelFile> stats=StorageManager::instance().getVariantStats("test-model", "Q4_K_M");
+    ASSERT_TRUE(stats.has_value());
+    EXPECT_EQ(stats->usageCount, 2);
+}
+
+TEST_F(StorageManagerTest, UsageJournalIsReplayedAfterCrash)
+{
+    // Snapshot holding journal records up to 1, as left by a crash
+    // between writing it and truncating the journal
+    {
+        std::ofstream snapshot(m_testDir/"model_usage.json");
+        snapshot<<R"({"version":1,"journal_sequence":1,"models":[)"
+            <<R"({"model":"test-model","variant":"Q4_K_M","filename":"test-q4.gguf","usage_count":5}]})";
+    }
+    {
+        std::ofstream journal(m_testDir/"model_usage.journal");
+        journal<<R"({"seq":1,"model":"test-model","variant":"Q4_K_M","count":5,"last_used_ms":1000})"<<"\n";
+        journal<<R"({"seq":2,"model":"test-model","variant":"Q4_K_M","count":3,"last_used_ms":2000})"<<"\n";
+        journal<<R"({"seq":3,"model":"gone-model","variant":"Q4_K_M","count":7,"last_used_ms":2000})"<<"\n";
+    }
+    createDummyGguf("test-q4.gguf", 1024);
+
+    StorageManager::instance().initialize(m_testDir);
+
+    std::optional<DownloadedModelFile> stats=StorageManager::instance().getVariantStats("test-model", "Q4_K_M");
+    ASSERT_TRUE(stats.has_value());
+    EXPECT_EQ(stats->usageCount, 8);
+}
+
+TEST_F(StorageManagerTest, ConcurrentUsageIsCounted)
+{
+    StorageManager::instance().initialize(m_testDir);
+    StorageManager::instance().registerDownload("test-model", "Q4_K_M", "test-q4.gguf", 1024*1024LL);
+
+    std::vector<std::thread> threads;
+    for(int t=0; t<4; ++t)
+    {
+        threads.emplace_back([]()
+        {
+            for(int i=0; i<1000; ++i)
+            {
+                StorageManager::instance().recordUsage("test-model", "Q4_K_M");
+            }
+        });
+    }
+    StorageManager::instance().flush();
+    for(std::thread &thread:threads)
+    {
+        thread.join();
+    }
+
+    std::optional<DownloadedModelFile> stats=StorageManager::instance().getVariantStats("test-model", "Q4_K_M");
+    ASSERT_TRUE(stats.has_value());
+    EXPECT_EQ(stats->usageCount, 4000);
+}
+
 // ========== Model/Variant Stats ==========
 
 TEST_F(StorageManagerTest, GetModelStatsReturnsAllVariants)
@@ -243,6 +316,34 @@ TEST_F(StorageManagerTest, ClearHotReadyOnVariant)
     EXPECT_FALSE(stats->hotReady);
 }
 
+TEST_F(StorageManagerTest, HotReadyFilesAreWarmedInBackground)
+{
+    createDummyGguf("model-Q4_K_M.gguf", 128*1024);
+    StorageManager::instance().initialize(m_testDir);
+
+    std::optional<DownloadedModelFile> stats=StorageManager::instance().getVariantStats("model", "Q4_K_M");
+    ASSERT_TRUE(stats.has_value());
+
+    std::vector<FileResidency> residency=StorageManager::instance().getResidency(stats.value());
+    ASSERT_EQ(residency.size(), 1u);
+    EXPECT_FALSE(residency[0].held);
+    EXPECT_EQ(residency[0].sizeBytes, 128*1024);
+
+    StorageManager::instance().setHotReady("model", "Q4_K_M", true);
+
+    // The background timer maps pending files on its next tick
+    for(int i=0; i<30&&!residency[0].held; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        residency=StorageManager::instance().getResidency(stats.value());
+    }
+    EXPECT_TRUE(residency[0].held);
+
+    StorageManager::instance().setHotReady("model", "Q4_K_M", false);
+    residency=StorageManager::instance().getResidency(stats.value());
+    EXPECT_FALSE(residency[0].held);
+}
+
 TEST_F(StorageManagerTest, SetHotReadyOnUnknownVariantReturnsFalse)
 {
     StorageManager::instance().initialize(m_testDir);
@@ -399,6 +500,72 @@ TEST_F(StorageManagerTest, ScanPicksUpUntrackedGgufFiles)
     EXPECT_EQ(models[0].fileSizeBytes, 2048);
 }
 
+TEST_F(StorageManagerTest, ScanRegistersCompleteShardSetsOnce)
+{
+    createDummyGguf("big-Q4-00001-of-00002.gguf", 1024);
+    createDummyGguf("big-Q4-00002-of-00002.gguf", 512);
+    createDummyGguf("partial-Q4-00001-of-00003.gguf", 256);
+
+    StorageManager::instance().initialize(m_testDir);
+
+    std::vector<DownloadedModelFile> models=StorageManager::instance().getDownloadedModels();
+
+    // The incomplete set waits for its remaining shards
+    ASSERT_EQ(models.size(), 1u);
+    EXPECT_EQ(models[0].filename, "big-Q4-00001-of-00002.gguf");
+    EXPECT_EQ(models[0].fileSizeBytes, 1536);
+    ASSERT_EQ(models[0].additionalFiles.size(), 1u);
+    EXPECT_EQ(models[0].additionalFiles[0], "big-Q4-00002-of-00002.gguf");
+}
+
+TEST_F(StorageManagerTest, ScanIndexIsSavedOnFlush)
+{
+    createDummyGguf("indexed-model.gguf", 1024);
+
+    StorageManager::instance().initialize(m_testDir);
+    StorageManager::instance().flush();
+
+    EXPECT_TRUE(std::filesystem::exists(m_testDir/"models_index.json"));
+
+    // A restart picks the file up from the index
+    StorageManager::instance().shutdown();
+    StorageManager::reset();
+    StorageManager::instance().initialize(m_testDir);
+
+    std::vector<DownloadedModelFile> models=StorageManager::instance().getDownloadedModels();
+    ASSERT_EQ(models.size(), 1u);
+    EXPECT_EQ(models[0].fileSizeBytes, 1024);
+}
+
+#ifdef __linux__
+TEST_F(StorageManagerTest, WatcherTracksFilesAddedAndRemoved)
+{
+    StorageManager::instance().initialize(m_testDir);
+    ASSERT_TRUE(StorageManager::instance().getDownloadedModels().empty());
+
+    createDummyGguf("copied-model.gguf", 4096);
+
+    std::vector<DownloadedModelFile> models;
+    for(int i=0; i<100&&models.empty(); ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        models=StorageManager::instance().getDownloadedModels();
+    }
+    ASSERT_EQ(models.size(), 1u);
+    EXPECT_EQ(models[0].filename, "copied-model.gguf");
+    EXPECT_EQ(models[0].fileSizeBytes, 4096);
+
+    std::filesystem::remove(m_testDir/"copied-model.gguf");
+
+    for(int i=0; i<100&&!models.empty(); ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        models=StorageManager::instance().getDownloadedModels();
+    }
+    EXPECT_TRUE(models.empty());
+}
+#endif
+
 // ========== Cleanup ==========
 
 TEST_F(StorageManagerTest, SetAndGetCleanupPolicy)
@@ -548,6 +715,38 @@ TEST_F(StorageManagerTest, DeleteAllVariantsOfModel)
     EXPECT_EQ(models.size(), 0u);
 }
 
+TEST_F(StorageManagerTest, SameContentIsStoredOnce)
+{
+    StorageManager::instance().initialize(m_testDir);
+
+    std::string hash="2c26b46b68ffc68ff99b453c1d30413413422d706483bfa0f98a5e886266e7ae";
+    createDummyGguf("model-a-q4.gguf", 4096);
+    createDummyGguf("model-b-q4.gguf", 4096);
+    StorageManager::instance().registerDownload("model-a", "Q4_K_M", "model-a-q4.gguf", 4096, {}, {hash});
+    StorageManager::instance().registerDownload("model-b", "Q4_K_M", "model-b-q4.gguf", 4096, {}, {hash});
+
+    StorageInfo info=StorageManager::instance().getStorageInfo();
+    EXPECT_EQ(info.usedByModelsBytes, 4096);
+    EXPECT_EQ(info.deduplicatedBytes, 4096);
+    EXPECT_EQ(info.blobCount, 1);
+    EXPECT_TRUE(std::filesystem::equivalent(m_testDir/"model-a-q4.gguf", m_testDir/"model-b-q4.gguf"));
+
+    // A third name for the same content needs no download
+    EXPECT_TRUE(StorageManager::instance().linkFromStore(hash, m_testDir/"model-c-q4.gguf"));
+    EXPECT_FALSE(StorageManager::instance().linkFromStore(std::string(64, '0'), m_testDir/"other.gguf"));
+    std::filesystem::remove(m_testDir/"model-c-q4.gguf");
+
+    // Content stays until its last user is deleted
+    int64_t freed=0;
+    EXPECT_TRUE(StorageManager::instance().deleteModelFile("model-a", "Q4_K_M", freed));
+    EXPECT_EQ(freed, 0);
+    EXPECT_TRUE(std::filesystem::exists(m_testDir/"model-b-q4.gguf"));
+
+    EXPECT_TRUE(StorageManager::instance().deleteModelFile("model-b", "Q4_K_M", freed));
+    EXPECT_EQ(freed, 4096);
+    EXPECT_EQ(StorageManager::instance().getStorageInfo().blobCount, 0);
+}
+
 TEST_F(StorageManagerTest, DeleteAllVariantsFailsIfAnyGuarded)
 {
     StorageManager::instance().initialize(m_testDir);
@@ -318,6 +318,71 @@ TEST_F(TelemetryCollectorTest, SwapModelRecordsTelemetry)
     EXPECT_EQ(swaps[0].from, "tel-mock-1");
     EXPECT_EQ(swaps[0].to, "tel-mock-2");
     EXPECT_GT(swaps[0].timeMs, 0.0);
+    EXPECT_EQ(swaps[0].loadedFrom, "Unloaded");
+}
+
+TEST_F(TelemetryCollectorTest, SwapToReadyModelRecordsReadyPromotion)
+{
+    TelemetryCollector &tc=TelemetryCollector::instance();
+
+    ModelRuntime::instance().loadModel("tel-mock-1");
+    ModelRuntime::instance().pinModel("tel-mock-1");
+    ModelRuntime::instance().swapModel("tel-mock-2");
+    ModelRuntime::instance().swapModel("tel-mock-1");
+
+    std::vector<SwapEvent> swaps=tc.getSwapHistory();
+    ASSERT_EQ(swaps.size(), 2u);
+    EXPECT_EQ(swaps[1].to, "tel-mock-1");
+    EXPECT_EQ(swaps[1].loadedFrom, "Ready");
+    EXPECT_LE(swaps[1].loadTimeMs, swaps[1].timeMs);
+}
+
+TEST_F(TelemetryCollectorTest, RecordContextResize)
+{
+    TelemetryCollector &tc=TelemetryCollector::instance();
+
+    ContextResizeEvent event;
+    event.model="tel-mock-1";
+    event.fromContext=4096;
+    event.toContext=8192;
+    event.reason="grow";
+    event.stateCarried=true;
+    event.timeMs=12.5;
+    event.when=std::chrono::system_clock::now();
+    tc.recordContextResize(event);
+
+    std::vector<ContextResizeEvent> resizes=tc.getContextResizeHistory();
+    ASSERT_EQ(resizes.size(), 1u);
+    EXPECT_EQ(resizes[0].model, "tel-mock-1");
+    EXPECT_EQ(resizes[0].toContext, 8192);
+    EXPECT_EQ(resizes[0].reason, "grow");
+    EXPECT_TRUE(resizes[0].stateCarried);
+
+    TelemetryCollector::reset();
+    EXPECT_TRUE(tc.getContextResizeHistory().empty());
+}
+
+TEST_F(TelemetryCollectorTest, RecordMemoryPressure)
+{
+    TelemetryCollector &tc=TelemetryCollector::instance();
+
+    MemoryPressureEvent event;
+    event.action="evict_ready";
+    event.level="moderate";
+    event.model="tel-mock-1";
+    event.freedMb=2048;
+    event.someAvg10=14.0;
+    event.when=std::chrono::system_clock::now();
+    tc.recordMemoryPressure(event);
+
+    std::vector<MemoryPressureEvent> events=tc.getMemoryPressureHistory();
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events[0].action, "evict_ready");
+    EXPECT_EQ(events[0].model, "tel-mock-1");
+    EXPECT_EQ(events[0].freedMb, 2048);
+
+    TelemetryCollector::reset();
+    EXPECT_TRUE(tc.getMemoryPressureHistory().empty());
 }
 
 } // namespace arbiterAI
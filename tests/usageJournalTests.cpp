@@ -0,0 +1,189 @@
+#include "arbiterAI/usageCounters.h"
+#include "arbiterAI/usageJournal.h"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace arbiterAI
+{
+
+class UsageJournalTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_testDir="usage_journal_test";
+        std::filesystem::create_directories(m_testDir);
+        m_journalPath=m_testDir/"model_usage.journal";
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(m_testDir);
+    }
+
+    static UsageRecord makeRecord(const std::string &model, const std::string &variant, int count)
+    {
+        UsageRecord record;
+        record.modelName=model;
+        record.variant=variant;
+        record.count=count;
+        record.lastUsedAt=std::chrono::system_clock::now();
+        return record;
+    }
+
+    std::filesystem::path m_testDir;
+    std::filesystem::path m_journalPath;
+};
+
+// ========== Counters ==========
+
+TEST_F(UsageJournalTest, CountersAreDrainedOnce)
+{
+    UsageCounters counters;
+    uint64_t key=UsageCounters::keyFor("model", "Q4_K_M");
+    auto now=std::chrono::system_clock::now();
+
+    EXPECT_TRUE(counters.record(key, now));
+    EXPECT_TRUE(counters.record(key, now));
+    EXPECT_EQ(counters.pending(key).count, 2);
+
+    std::vector<UsageTally> tallies=counters.drain();
+    ASSERT_EQ(tallies.size(), 1u);
+    EXPECT_EQ(tallies[0].key, key);
+    EXPECT_EQ(tallies[0].count, 2);
+    EXPECT_GE(tallies[0].lastUsedAt, now-std::chrono::milliseconds(1));
+
+    EXPECT_TRUE(counters.drain().empty());
+    EXPECT_EQ(counters.pending(key).count, 0);
+}
+
+TEST_F(UsageJournalTest, KeysSeparateModelAndVariant)
+{
+    EXPECT_NE(UsageCounters::keyFor("ab", "c"), UsageCounters::keyFor("a", "bc"));
+    EXPECT_EQ(UsageCounters::keyFor("a", "bc"), UsageCounters::keyFor("a", "bc"));
+}
+
+TEST_F(UsageJournalTest, ConcurrentRecordsAreAllCounted)
+{
+    UsageCounters counters;
+    std::vector<uint64_t> keys{UsageCounters::keyFor("a", "Q4"), UsageCounters::keyFor("b", "Q4"), UsageCounters::keyFor("c", "Q8")};
+
+    constexpr int perThread=10000;
+    std::vector<std::thread> threads;
+    int drained=0;
+    for(int t=0; t<4; ++t)
+    {
+        threads.emplace_back([&counters, &keys, t]()
+        {
+            for(int i=0; i<perThread; ++i)
+            {
+                counters.record(keys[(i+t)%keys.size()], std::chrono::system_clock::now());
+            }
+        });
+    }
+
+    // Drain while recording is under way; nothing is lost or counted twice
+    for(int i=0; i<50; ++i)
+    {
+        for(const UsageTally &tally:counters.drain())
+        {
+            drained+=tally.count;
+        }
+    }
+    for(std::thread &thread:threads)
+    {
+        thread.join();
+    }
+    for(const UsageTally &tally:counters.drain())
+    {
+        drained+=tally.count;
+    }
+
+    EXPECT_EQ(drained, 4*perThread);
+}
+
+TEST_F(UsageJournalTest, FullTableRefusesNewKeys)
+{
+    UsageCounters counters;
+    auto now=std::chrono::system_clock::now();
+
+    for(uint64_t key=1; key<=UsageCounters::Capacity; ++key)
+    {
+        ASSERT_TRUE(counters.record(key, now));
+    }
+    EXPECT_FALSE(counters.record(UsageCounters::Capacity+1, now));
+    EXPECT_TRUE(counters.record(1, now));
+
+    counters.clear();
+    EXPECT_TRUE(counters.record(UsageCounters::Capacity+1, now));
+}
+
+// ========== Journal ==========
+
+TEST_F(UsageJournalTest, AppendedRecordsReadBack)
+{
+    UsageJournal journal;
+    ASSERT_TRUE(journal.open(m_journalPath, 0));
+
+    std::vector<UsageRecord> first{makeRecord("a", "Q4", 3), makeRecord("b", "Q8", 1)};
+    ASSERT_TRUE(journal.append(first));
+    std::vector<UsageRecord> second{makeRecord("a", "Q4", 2)};
+    ASSERT_TRUE(journal.append(second));
+
+    EXPECT_EQ(journal.lastSequence(), 3u);
+    EXPECT_EQ(journal.recordCount(), 3u);
+    journal.close();
+
+    std::vector<UsageRecord> records=UsageJournal::read(m_journalPath, 0);
+    ASSERT_EQ(records.size(), 3u);
+    EXPECT_EQ(records[0].sequence, 1u);
+    EXPECT_EQ(records[0].modelName, "a");
+    EXPECT_EQ(records[0].count, 3);
+    EXPECT_EQ(records[2].count, 2);
+
+    // Records a snapshot already holds are skipped
+    records=UsageJournal::read(m_journalPath, 2);
+    ASSERT_EQ(records.size(), 1u);
+    EXPECT_EQ(records[0].sequence, 3u);
+}
+
+TEST_F(UsageJournalTest, TornLastLineIsDropped)
+{
+    {
+        UsageJournal journal;
+        journal.open(m_journalPath, 0);
+        std::vector<UsageRecord> records{makeRecord("a", "Q4", 1)};
+        journal.append(records);
+    }
+    {
+        std::ofstream out(m_journalPath, std::ios::app);
+        out<<"{\"seq\":2,\"model\":\"a\",\"vari";
+    }
+
+    std::vector<UsageRecord> records=UsageJournal::read(m_journalPath, 0);
+    ASSERT_EQ(records.size(), 1u);
+    EXPECT_EQ(records[0].sequence, 1u);
+}
+
+TEST_F(UsageJournalTest, TruncateKeepsSequence)
+{
+    UsageJournal journal;
+    journal.open(m_journalPath, 10);
+
+    std::vector<UsageRecord> records{makeRecord("a", "Q4", 1)};
+    journal.append(records);
+    EXPECT_EQ(records[0].sequence, 11u);
+
+    ASSERT_TRUE(journal.truncate());
+    EXPECT_EQ(journal.recordCount(), 0u);
+    EXPECT_TRUE(UsageJournal::read(m_journalPath, 0).empty());
+
+    records={makeRecord("a", "Q4", 1)};
+    journal.append(records);
+    EXPECT_EQ(records[0].sequence, 12u);
+    EXPECT_EQ(UsageJournal::read(m_journalPath, 0).size(), 1u);
+}
+
+} // namespace arbiterAI